@@ -0,0 +1,82 @@
+// Offline order throughput and ack latency through the Alpaca-style adapter
+// against the bundled mock broker, or against a running frontier_venue_sim
+// when its port is given.
+//
+// Usage: bench_broker_adapter [orders] [pool_size] [pipeline_depth] [ack_latency_us] [venue_port]
+
+#include "frontier/alpaca_adapter.hpp"
+#include "frontier/mock_broker.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+int main(int argc, char** argv) {
+    size_t orders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    size_t pool_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+    size_t depth = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 16;
+    long ack_latency_us = argc > 4 ? std::strtol(argv[4], nullptr, 10) : 0;
+    long venue_port = argc > 5 ? std::strtol(argv[5], nullptr, 10) : 0;
+
+    frontier::MockBrokerServer::Config broker_config;
+    broker_config.ack_latency = std::chrono::microseconds(ack_latency_us);
+    frontier::MockBrokerServer broker(broker_config);
+    if (venue_port == 0) {
+        broker.start();
+    }
+
+    frontier::AlpacaConfig config;
+    config.port = venue_port ? static_cast<uint16_t>(venue_port) : broker.port();
+    config.pool_size = pool_size;
+    config.max_pipeline_depth = depth;
+    config.enable_stream = false;
+    frontier::AlpacaBrokerAdapter adapter(config);
+    if (!adapter.start()) {
+        std::fprintf(stderr, "adapter failed to start\n");
+        return 1;
+    }
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<int64_t> latencies;
+    latencies.reserve(orders);
+    size_t rejected = 0;
+    std::vector<std::chrono::steady_clock::time_point> sent(orders);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < orders; ++i) {
+        frontier::BrokerOrderRequest order;
+        order.client_order_id = "b" + std::to_string(i);
+        order.symbol = "AAPL";
+        order.quantity = 1;
+        sent[i] = std::chrono::steady_clock::now();
+        adapter.submit_order(order, [&, i](const frontier::BrokerOrderAck& ack) {
+            auto latency = std::chrono::steady_clock::now() - sent[i];
+            std::lock_guard<std::mutex> lock(mutex);
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+            rejected += ack.accepted ? 0 : 1;
+            if (latencies.size() == orders) {
+                done.notify_one();
+            }
+        });
+    }
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return latencies.size() == orders; });
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    adapter.stop();
+    broker.stop();
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(p * (latencies.size() - 1))] / 1000.0;
+    };
+    std::printf("orders=%zu pool=%zu depth=%zu rejected=%zu\n", orders, pool_size, depth, rejected);
+    std::printf("throughput=%.0f orders/s\n", orders / seconds);
+    std::printf("ack latency us: p50=%.1f p99=%.1f max=%.1f\n", percentile(0.50), percentile(0.99),
+                percentile(1.0));
+    return rejected == 0 ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+// Circuit breaker cost per tick over a large universe: random-walk prices
+// for every symbol, ticks round-robin at a fixed simulated rate, so each
+// symbol's window holds a realistic mix of live and expiring buckets.
+//
+// Usage: bench_circuit_breaker [symbols] [ticks]
+
+#include "frontier/circuit_breaker.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+int main(int argc, char** argv) {
+    size_t symbols = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    size_t ticks = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 20000000;
+
+    frontier::CircuitBreakerConfig config;
+    config.expected_symbols = symbols;
+    frontier::VolatilityCircuitBreaker breaker(config);
+
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 0.0005);
+    std::vector<double> prices(symbols, 100.0);
+    std::vector<double> steps(4096);
+    for (double& s : steps) {
+        s = step(rng);
+    }
+
+    // 1M ticks per simulated second across the universe
+    constexpr int64_t kTickSpacingNs = 1000;
+    frontier::CircuitBreakerEvent event;
+    size_t trips = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < ticks; ++i) {
+        size_t s = i % symbols;
+        prices[s] *= 1.0 + steps[i % steps.size()];
+        trips += breaker.on_tick(static_cast<uint32_t>(s), prices[s], static_cast<int64_t>(i) * kTickSpacingNs, event);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("symbols=%zu ticks=%zu trips=%zu\n", symbols, ticks, trips);
+    std::printf("%.1f ns/tick, %.1fM ticks/s\n", elapsed * 1e9 / ticks, ticks / elapsed / 1e6);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Watchlist fan-out at scale: sessions subscribe to symbols drawn from a
+// universe with a few hot names, ticks arrive at random symbols, and the
+// IO side flushes every `batch` ticks. Reports publish cost per tick,
+// flush cost, and bytes handed to sessions.
+//
+// Usage: bench_fanout [sessions] [symbols_per_session] [universe] [ticks] [batch]
+
+#include "frontier/market_data_fanout.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+int main(int argc, char** argv) {
+    size_t sessions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000;
+    size_t per_session = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50;
+    size_t universe = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 5000;
+    size_t ticks = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1000000;
+    size_t batch = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 1000;
+
+    std::vector<std::string> symbols;
+    for (size_t i = 0; i < universe; ++i) {
+        symbols.push_back("SYM" + std::to_string(i));
+    }
+    std::mt19937_64 rng(11);
+    // Half of each watchlist from the 100 most popular names, half from anywhere
+    std::uniform_int_distribution<size_t> hot(0, std::min<size_t>(100, universe) - 1);
+    std::uniform_int_distribution<size_t> any(0, universe - 1);
+
+    frontier::MarketDataFanout fanout;
+    auto setup_start = std::chrono::steady_clock::now();
+    std::vector<std::string> watchlist;
+    for (size_t s = 0; s < sessions; ++s) {
+        watchlist.clear();
+        for (size_t i = 0; i < per_session; ++i) {
+            watchlist.push_back(symbols[i % 2 ? hot(rng) : any(rng)]);
+        }
+        fanout.subscribe(fanout.open_session(), watchlist);
+    }
+    double setup = std::chrono::duration<double>(std::chrono::steady_clock::now() - setup_start).count();
+
+    frontier::MarketData data;
+    data.bid = 100.0;
+    data.ask = 100.02;
+    data.volume = 1000;
+    size_t bytes = 0;
+    size_t writes = 0;
+    auto sink = [&](uint64_t, std::string_view out) { bytes += out.size(); };
+    double publish_seconds = 0.0;
+    double flush_seconds = 0.0;
+    for (size_t t = 0; t < ticks; t += batch) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < batch; ++i) {
+            data.symbol = symbols[any(rng)];
+            data.last = 100.0 + static_cast<double>(i % 100) / 100.0;
+            fanout.publish(data, static_cast<int64_t>(t + i));
+        }
+        auto middle = std::chrono::steady_clock::now();
+        writes += fanout.flush(sink);
+        auto end = std::chrono::steady_clock::now();
+        publish_seconds += std::chrono::duration<double>(middle - start).count();
+        flush_seconds += std::chrono::duration<double>(end - middle).count();
+    }
+
+    std::printf("%zu sessions x %zu symbols over %zu names, subscribed in %.2fs\n", sessions, per_session, universe,
+                setup);
+    std::printf("%zu ticks: publish %.0f ns/tick, flush %.2f ms per %zu-tick batch, %zu session writes, %.1f MB\n",
+                ticks, publish_seconds / static_cast<double>(ticks) * 1e9,
+                flush_seconds / static_cast<double>(ticks / batch) * 1e3, batch, writes, bytes / 1e6);
+    return 0;
+}
@@ -0,0 +1,65 @@
+// FIX tag parser throughput on one core: frame and tokenise a buffer of
+// NewOrderSingle messages, then frame + decode into EngineCommands.
+//
+// Usage: bench_fix_parser [messages] [passes]
+
+#include "fix/fix_message.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    int passes = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::string buffer;
+    for (size_t i = 0; i < count; ++i) {
+        trading::FixFields fields;
+        fields.add(trading::fixtag::SenderCompID, "CLIENT")
+            .add(trading::fixtag::TargetCompID, "FRONTIER")
+            .add(trading::fixtag::MsgSeqNum, static_cast<uint64_t>(i + 1))
+            .add(trading::fixtag::SendingTime, "20260105-14:30:00.123")
+            .add(trading::fixtag::ClOrdID, "ORD-" + std::to_string(i))
+            .add(trading::fixtag::Account, "ACCT-7")
+            .add(trading::fixtag::Symbol, i % 2 ? "AAPL" : "MSFT")
+            .add(trading::fixtag::Side, i % 2 ? '1' : '2')
+            .add(trading::fixtag::OrderQty, static_cast<int64_t>(100 + i % 900))
+            .add(trading::fixtag::OrdType, '2')
+            .add(trading::fixtag::Price, 150.0 + static_cast<double>(i % 100) / 100.0)
+            .add(trading::fixtag::TimeInForce, '0');
+        buffer += trading::fixFrame("FIX.4.4", "D", fields.str());
+    }
+
+    auto run = [&](bool decode) {
+        trading::FixMessage message;
+        trading::FixOrderCommand command;
+        std::string error;
+        size_t parsed = 0;
+        double checksum = 0.0;  // Keeps the work observable
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            size_t offset = 0;
+            size_t consumed = 0;
+            while (offset < buffer.size() &&
+                   trading::FixParser::parse(buffer.data() + offset, buffer.size() - offset, message, consumed) ==
+                       trading::FixParseStatus::OK) {
+                offset += consumed;
+                ++parsed;
+                if (decode && trading::decodeOrderCommand(message, command, error)) {
+                    checksum += command.command.order.quantity.value;
+                } else {
+                    checksum += static_cast<double>(message.fieldCount());
+                }
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-14s %zu msgs in %.3fs: %.2fM msgs/s, %.0f MB/s (check %.0f)\n",
+                    decode ? "parse+decode" : "parse", parsed, seconds, parsed / seconds / 1e6,
+                    static_cast<double>(buffer.size()) * passes / seconds / 1e6, checksum);
+    };
+
+    std::printf("%zu messages, %zu bytes, %d passes\n", count, buffer.size(), passes);
+    run(false);
+    run(true);
+    return 0;
+}
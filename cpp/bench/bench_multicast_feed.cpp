@@ -0,0 +1,99 @@
+// Feed receiver throughput on one core. First sequencing + decode of
+// in-memory packets, which is the receiver's own cost, then the same stream
+// over loopback UDP through recvmmsg, sender and receiver taking turns on
+// this thread. Every 1000th packet is held back and sent late to exercise
+// the reorder ring.
+//
+// Usage: bench_multicast_feed [ticks] [passes]
+
+#include "feed/multicast_feed.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <unistd.h>
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    int passes = argc > 2 ? std::atoi(argv[2]) : 5;
+    spdlog::set_level(spdlog::level::warn);
+
+    const char* symbols[] = {"AAPL", "MSFT", "NVDA", "AMZN", "GOOG", "META", "TSLA", "AMD"};
+    const size_t perPacket = trading::feedwire::MAX_TICKS_PER_PACKET;
+    std::vector<std::string> packets;
+    std::vector<trading::feedwire::Tick> ticks(perPacket);
+    uint64_t sequence = 1;
+    for (size_t sent = 0; sent < count; sent += perPacket) {
+        for (size_t i = 0; i < perPacket; ++i) {
+            trading::MarketTick tick;
+            tick.asset.symbol = symbols[(sent + i) % 8];
+            tick.bid = trading::Price(100.0 + static_cast<double>((sent + i) % 500) / 100.0);
+            tick.ask = trading::Price(tick.bid.value + 0.01);
+            tick.last = tick.ask;
+            tick.bidSize = trading::Quantity(100);
+            tick.askSize = trading::Quantity(200);
+            tick.timestamp = std::chrono::system_clock::now();
+            trading::feedwire::encodeTick(tick, ticks[i]);
+        }
+        char out[trading::feedwire::MAX_PACKET];
+        size_t length = trading::feedwire::encodePacket(trading::feedwire::PacketType::TICKS, sequence, ticks.data(),
+                                                        perPacket, 0, out);
+        packets.emplace_back(out, length);
+        sequence += perPacket;
+    }
+    // Swap neighbours so one packet in a thousand arrives after its successor
+    for (size_t i = 999; i + 1 < packets.size(); i += 1000) {
+        std::swap(packets[i], packets[i + 1]);
+    }
+    size_t total = packets.size() * perPacket;
+
+    double checksum = 0.0;   // Keeps the work observable
+    auto handler = [&](const trading::MarketTick& tick, uint64_t) { checksum += tick.bid.value; };
+
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            trading::MulticastFeedReceiver receiver({}, handler);
+            auto now = trading::MulticastFeedReceiver::Clock::now();
+            for (const std::string& packet : packets) {
+                receiver.processPacket(packet.data(), packet.size(), now);
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-10s %zu ticks x %d in %.3fs: %.2fM ticks/s (check %.0f)\n", "decode", total, passes, seconds,
+                    total * passes / seconds / 1e6, checksum);
+    }
+
+    {
+        trading::MulticastFeedConfig config;
+        config.bindAddress = "127.0.0.1";
+        trading::MulticastFeedReceiver receiver(config, handler);
+        receiver.open();
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        sockaddr_in destination{};
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(receiver.getPort());
+        destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        constexpr size_t BURST = 64;   // Stay well inside the socket buffer
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < packets.size(); i += BURST) {
+            size_t end = std::min(packets.size(), i + BURST);
+            for (size_t j = i; j < end; ++j) {
+                sendto(fd, packets[j].data(), packets[j].size(), 0, reinterpret_cast<sockaddr*>(&destination),
+                       sizeof(destination));
+            }
+            while (receiver.poll(0) > 0) {
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const trading::FeedStats& stats = receiver.getStats();
+        std::printf("%-10s %llu ticks in %.3fs: %.2fM ticks/s, %llu packets, %llu reordered, %llu gaps\n", "loopback",
+                    static_cast<unsigned long long>(stats.messages), seconds, stats.messages / seconds / 1e6,
+                    static_cast<unsigned long long>(stats.packets), static_cast<unsigned long long>(stats.reordered),
+                    static_cast<unsigned long long>(stats.gaps));
+        close(fd);
+    }
+    return 0;
+}
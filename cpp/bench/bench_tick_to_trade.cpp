@@ -0,0 +1,189 @@
+// Tick-to-trade latency through the in-process path, stage by stage:
+//
+//   decode    feed packet -> MarketTick -> MarketData
+//   update    TradingEngine::update_market_data
+//   strategy  test strategy decides side and size
+//   order     TradingEngine::place_market_order (risk + booking)
+//   outbound  NewOrderSingle framed and written to a socket
+//
+// Each stage is stamped with the TSC (calibrated against steady_clock) and
+// reported as a latency distribution, so a regression shows up in the stage
+// that caused it. The strategy is a toy that trades every tick, alternating
+// buy and sell, so each sample covers every stage.
+//
+// Usage: bench_tick_to_trade [ticks] [warmup]
+
+#include "feed/multicast_feed.h"
+#include "fix/fix_message.h"
+#include "frontier/engine.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+inline uint64_t readTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+// TSC ticks per nanosecond, measured over `window`
+double calibrateTsc(std::chrono::milliseconds window) {
+    auto wallStart = std::chrono::steady_clock::now();
+    uint64_t tscStart = readTsc();
+    while (std::chrono::steady_clock::now() - wallStart < window) {
+    }
+    uint64_t tscEnd = readTsc();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - wallStart).count();
+    return static_cast<double>(tscEnd - tscStart) / ns;
+}
+
+enum Stage { DECODE, UPDATE, STRATEGY, ORDER, OUTBOUND, TOTAL, STAGE_COUNT };
+const char* STAGE_NAMES[STAGE_COUNT] = {"decode", "update", "strategy", "order", "outbound", "tick-to-trade"};
+
+void report(const char* name, std::vector<uint64_t>& cycles, double ticksPerNs) {
+    if (cycles.empty()) {
+        return;
+    }
+    std::sort(cycles.begin(), cycles.end());
+    auto at = [&](double q) {
+        size_t index = std::min(cycles.size() - 1, static_cast<size_t>(q * static_cast<double>(cycles.size())));
+        return static_cast<double>(cycles[index]) / ticksPerNs;
+    };
+    double sum = 0.0;
+    for (uint64_t c : cycles) {
+        sum += static_cast<double>(c);
+    }
+    std::printf("%-14s %9.0f %9.0f %9.0f %9.0f %9.0f %9.0f %9.0f\n", name, at(0.0), at(0.5), at(0.9), at(0.99),
+                at(0.999), static_cast<double>(cycles.back()) / ticksPerNs,
+                sum / static_cast<double>(cycles.size()) / ticksPerNs);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t warmup = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+
+    frontier::TradingEngine engine;
+    spdlog::set_level(spdlog::level::err);   // Per-order info logging would dominate
+    double ticksPerNs = calibrateTsc(std::chrono::milliseconds(200));
+
+    int sockets[2];
+    if (socketpair(AF_UNIX, SOCK_DGRAM, 0, sockets) != 0) {
+        std::perror("socketpair");
+        return 1;
+    }
+
+    // One tick per packet, as a venue sends a top-of-book change; the price
+    // alternates so the strategy alternates sides
+    std::vector<std::string> packets;
+    packets.reserve(count + warmup);
+    for (size_t i = 0; i < count + warmup; ++i) {
+        trading::MarketTick tick;
+        tick.asset.symbol = "AAPL";
+        tick.bid = trading::Price(i % 2 ? 150.00 : 150.10);
+        tick.ask = trading::Price(tick.bid.value + 0.02);
+        tick.last = tick.ask;
+        tick.bidSize = trading::Quantity(300);
+        tick.askSize = trading::Quantity(200);
+        trading::feedwire::Tick wire;
+        trading::feedwire::encodeTick(tick, wire);
+        char out[trading::feedwire::MAX_PACKET];
+        size_t length =
+            trading::feedwire::encodePacket(trading::feedwire::PacketType::TICKS, i + 1, &wire, 1, 0, out);
+        packets.emplace_back(out, length);
+    }
+
+    std::vector<uint64_t> samples[STAGE_COUNT];
+    for (auto& stage : samples) {
+        stage.reserve(count);
+    }
+
+    frontier::MarketData data;
+    double lastMid = 0.0;
+    uint64_t clOrdId = 0;
+    uint64_t injected = 0;
+    size_t rejected = 0;
+    char drain[1024];
+
+    trading::MulticastFeedReceiver receiver({}, [&](const trading::MarketTick& tick, uint64_t sequence) {
+        data.symbol = tick.asset.symbol;
+        data.bid = tick.bid.value;
+        data.ask = tick.ask.value;
+        data.last = tick.last.value;
+        data.volume = tick.volume.value;
+        uint64_t decoded = readTsc();
+
+        engine.update_market_data(data);
+        uint64_t updated = readTsc();
+
+        // Buy the dip, sell the pop; one share keeps risk checks passing forever
+        double mid = data.mid_price();
+        bool buy = mid < lastMid;
+        bool trade = lastMid > 0.0 && (buy || engine.get_position(data.symbol) != nullptr);
+        lastMid = mid;
+        double price = buy ? data.ask : data.bid;
+        uint64_t decided = readTsc();
+        if (!trade) {
+            return;
+        }
+
+        if (!engine.place_market_order(data.symbol, buy ? frontier::Side::Buy : frontier::Side::Sell, 1.0, price)) {
+            ++rejected;
+            return;
+        }
+        uint64_t booked = readTsc();
+
+        trading::FixFields fields;
+        fields.add(trading::fixtag::ClOrdID, ++clOrdId)
+            .add(trading::fixtag::Symbol, data.symbol)
+            .add(trading::fixtag::Side, buy ? '1' : '2')
+            .add(trading::fixtag::OrderQty, 1)
+            .add(trading::fixtag::OrdType, '1');
+        std::string order = trading::fixFrame("FIX.4.4", "D", fields.str());
+        if (write(sockets[0], order.data(), order.size()) < 0) {
+            return;
+        }
+        uint64_t sent = readTsc();
+
+        if (sequence > warmup) {
+            samples[DECODE].push_back(decoded - injected);
+            samples[UPDATE].push_back(updated - decoded);
+            samples[STRATEGY].push_back(decided - updated);
+            samples[ORDER].push_back(booked - decided);
+            samples[OUTBOUND].push_back(sent - booked);
+            samples[TOTAL].push_back(sent - injected);
+        }
+    });
+
+    auto now = trading::MulticastFeedReceiver::Clock::now();
+    auto wallStart = std::chrono::steady_clock::now();
+    for (const std::string& packet : packets) {
+        injected = readTsc();
+        receiver.processPacket(packet.data(), packet.size(), now);
+        while (recv(sockets[1], drain, sizeof(drain), MSG_DONTWAIT) > 0) {
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+
+    std::printf("%zu ticks (+%zu warmup) in %.3fs, %zu orders sent, %zu rejected, TSC %.3f GHz\n", count, warmup,
+                seconds, static_cast<size_t>(clOrdId), rejected, ticksPerNs);
+    std::printf("%-14s %9s %9s %9s %9s %9s %9s %9s   (ns)\n", "stage", "min", "p50", "p90", "p99", "p99.9", "max",
+                "mean");
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        report(STAGE_NAMES[stage], samples[stage], ticksPerNs);
+    }
+    close(sockets[0]);
+    close(sockets[1]);
+    return 0;
+}
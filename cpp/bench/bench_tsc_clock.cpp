@@ -0,0 +1,38 @@
+// Per-stamp cost of TscClock against system_clock, the clock it replaces
+// for order and trade timestamps. Each loop folds the stamps into a sum so
+// the reads cannot be dropped.
+//
+// Usage: bench_tsc_clock [stamps]
+
+#include "engine/tsc_clock.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+template <typename Clock>
+double nsPerStamp(size_t stamps, int64_t& sink) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < stamps; ++i) {
+        sink += Clock::now().time_since_epoch().count();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / stamps;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t stamps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+
+    int64_t sink = 0;
+    trading::TscClock::now();  // Calibrate outside the timed loop
+    double system = nsPerStamp<std::chrono::system_clock>(stamps, sink);
+    double tsc = nsPerStamp<trading::TscClock>(stamps, sink);
+
+    std::printf("tsc=%s ticks/ns=%.4f stamps=%zu (sink %lld)\n", trading::TscClock::usesTsc() ? "yes" : "no",
+                trading::TscClock::ticksPerNs(), stamps, static_cast<long long>(sink & 1));
+    std::printf("system_clock %.2f ns/stamp\n", system);
+    std::printf("TscClock     %.2f ns/stamp (%.1fx)\n", tsc, system / tsc);
+    return 0;
+}
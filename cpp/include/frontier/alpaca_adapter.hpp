@@ -0,0 +1,129 @@
+#pragma once
+
+#include "broker_adapter.hpp"
+#include "http_wire.hpp"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+namespace frontier {
+
+struct AlpacaConfig {
+    std::string host = "127.0.0.1";
+    uint16_t port = 80;
+    std::string key_id;
+    std::string secret_key;
+    size_t pool_size = 4;             // Persistent REST connections
+    size_t max_pipeline_depth = 16;   // Unanswered requests per connection
+    std::string orders_path = "/v2/orders";
+    bool enable_stream = true;        // trade_updates over WebSocket
+    std::string stream_path = "/stream";
+    std::chrono::milliseconds reconnect_delay{250};
+};
+
+// Alpaca-style REST/WebSocket adapter. One I/O thread drives a pool of
+// keep-alive connections; each request goes to the least loaded connection
+// and is pipelined behind the ones already in flight there, so a burst costs
+// one write per connection instead of a round trip per order. Responses are
+// matched to requests in order. A dropped connection fails its in-flight
+// requests (they are not retried: a submit may or may not have reached the
+// broker) and is reopened after reconnect_delay.
+//
+// Plain TCP only. For a TLS endpoint, run through a local TLS-terminating
+// proxy.
+class AlpacaBrokerAdapter : public BrokerAdapter {
+public:
+    explicit AlpacaBrokerAdapter(AlpacaConfig config);
+    ~AlpacaBrokerAdapter() override;
+
+    bool start() override;
+    void stop() override;
+
+    void submit_order(const BrokerOrderRequest& order, BrokerAckHandler on_ack) override;
+    void cancel_order(const std::string& broker_order_id, BrokerCancelHandler on_result) override;
+    void cancel_orders(const std::vector<std::string>& broker_order_ids,
+                       BrokerBatchCancelHandler on_results) override;
+    void set_execution_handler(BrokerExecutionHandler handler) override;
+
+    size_t in_flight() const override { return in_flight_.load(std::memory_order_relaxed); }
+    bool stream_ready() const { return stream_ready_.load(std::memory_order_acquire); }
+    uint64_t requests_sent() const { return requests_sent_.load(std::memory_order_relaxed); }
+
+    // Request/response body codecs, exposed for tests and other Alpaca-like venues
+    static std::string encode_order(const BrokerOrderRequest& order);
+    static BrokerOrderAck decode_ack(const wire::HttpMessage& response);
+    static bool decode_trade_update(const std::string& message, BrokerExecutionReport& report);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    // nullptr response: the request failed in transport
+    using ResponseHandler = std::function<void(const wire::HttpMessage*, int64_t latency_ns)>;
+
+    struct Request {
+        std::string bytes;
+        ResponseHandler on_response;
+        Clock::time_point sent_at;
+    };
+
+    struct Connection {
+        int fd = -1;
+        bool connecting = false;
+        std::string out;
+        size_t out_offset = 0;
+        wire::HttpParser parser{false};
+        std::deque<Request> in_flight;
+        Clock::time_point retry_at;
+    };
+
+    enum class StreamState { Closed, Connecting, Handshake, Open };
+
+    struct Stream {
+        int fd = -1;
+        StreamState state = StreamState::Closed;
+        std::string out;
+        size_t out_offset = 0;
+        wire::HttpParser handshake{false};
+        wire::WsParser parser;
+        Clock::time_point retry_at;
+    };
+
+    AlpacaConfig config_;
+    wire::Headers auth_headers_;
+    std::shared_ptr<spdlog::logger> logger_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    wire::Waker waker_;
+
+    std::mutex submit_mutex_;
+    std::vector<Request> submitted_;
+    BrokerExecutionHandler execution_handler_;
+    std::mutex handler_mutex_;
+
+    // I/O thread only
+    std::deque<Request> backlog_;    // Waiting for pipeline room
+    std::vector<Connection> pool_;
+    Stream stream_;
+
+    std::atomic<size_t> in_flight_{0};
+    std::atomic<uint64_t> requests_sent_{0};
+    std::atomic<bool> stream_ready_{false};
+
+    void enqueue(Request request);
+    void run();
+    void assign_backlog();
+    void open(Connection& connection);
+    void on_readable(Connection& connection);
+    void fail(Connection& connection);
+    void respond(Request& request, const wire::HttpMessage* response, int64_t latency_ns);
+    void open_stream();
+    void on_stream_readable();
+    void close_stream();
+};
+
+} // namespace frontier
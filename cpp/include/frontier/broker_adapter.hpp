@@ -0,0 +1,82 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace frontier {
+
+// Order as sent to an external broker
+struct BrokerOrderRequest {
+    std::string client_order_id;
+    std::string symbol;
+    Side side = Side::Buy;
+    OrderType type = OrderType::Market;
+    double quantity = 0.0;
+    double limit_price = 0.0;   // Limit orders only
+    double stop_price = 0.0;    // Stop orders only
+    std::string time_in_force = "day";
+};
+
+// Broker's synchronous answer to a submit
+struct BrokerOrderAck {
+    bool accepted = false;
+    int http_status = 0;            // 0 when the request never got an answer
+    std::string broker_order_id;
+    std::string client_order_id;
+    std::string status;             // Broker's order status, e.g. "accepted"
+    std::string error;
+    int64_t latency_ns = 0;         // Request written to response parsed
+};
+
+struct BrokerCancelResult {
+    std::string broker_order_id;
+    bool accepted = false;
+    int http_status = 0;
+    std::string error;
+};
+
+// Asynchronous order lifecycle event from the broker's stream
+struct BrokerExecutionReport {
+    std::string event;              // new, fill, partial_fill, canceled, rejected, ...
+    std::string broker_order_id;
+    std::string client_order_id;
+    std::string symbol;
+    Side side = Side::Buy;
+    std::string order_status;
+    double fill_price = 0.0;        // This fill, for fill events
+    double fill_quantity = 0.0;
+    double filled_quantity = 0.0;   // Cumulative
+    double average_fill_price = 0.0;
+};
+
+using BrokerAckHandler = std::function<void(const BrokerOrderAck&)>;
+using BrokerCancelHandler = std::function<void(const BrokerCancelResult&)>;
+using BrokerBatchCancelHandler = std::function<void(const std::vector<BrokerCancelResult>&)>;
+using BrokerExecutionHandler = std::function<void(const BrokerExecutionReport&)>;
+
+// Outbound connection to a broker or venue. Calls never block on the network:
+// requests are queued and handlers run later on the adapter's I/O thread, so
+// they must not call back into the adapter synchronously for long.
+class BrokerAdapter {
+public:
+    virtual ~BrokerAdapter() = default;
+
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+
+    virtual void submit_order(const BrokerOrderRequest& order, BrokerAckHandler on_ack) = 0;
+    virtual void cancel_order(const std::string& broker_order_id, BrokerCancelHandler on_result) = 0;
+    // One handler call once every cancel is answered, results in input order
+    virtual void cancel_orders(const std::vector<std::string>& broker_order_ids,
+                               BrokerBatchCancelHandler on_results) = 0;
+
+    virtual void set_execution_handler(BrokerExecutionHandler handler) = 0;
+
+    // Requests sent or queued that have not been answered yet
+    virtual size_t in_flight() const = 0;
+};
+
+} // namespace frontier
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "http_wire.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+namespace frontier {
+
+// Local HTTP/1.1 + WebSocket server for broker stand-ins. One poll thread
+// owns every socket. Handlers run on that thread and answer through
+// respond(), possibly later and from any thread; pipelined responses still
+// leave each connection in request order, each no earlier than its `at`.
+class BrokerServer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct ResponseToken {
+        uint64_t connection = 0;
+        uint64_t sequence = 0;
+    };
+
+    using RequestHandler = std::function<void(const wire::HttpMessage&, ResponseToken)>;
+    // Text or binary message from a stream client
+    using StreamHandler = std::function<void(uint64_t client, const std::string&)>;
+
+    explicit BrokerServer(const std::string& name, std::string host = "127.0.0.1", uint16_t port = 0);
+    ~BrokerServer();
+
+    BrokerServer(const BrokerServer&) = delete;
+    BrokerServer& operator=(const BrokerServer&) = delete;
+
+    // Set before start()
+    void set_request_handler(RequestHandler handler) { request_handler_ = std::move(handler); }
+    void set_stream_handler(StreamHandler handler) { stream_handler_ = std::move(handler); }
+    void set_stream_path(std::string path) { stream_path_ = std::move(path); }
+
+    void start();
+    void stop();
+    uint16_t port() const { return port_; }
+
+    // Thread-safe
+    void respond(ResponseToken token, int status, std::string body, Clock::time_point at = {});
+    void send_stream(uint64_t client, std::string text, Clock::time_point at = {});
+    void broadcast(std::string text, Clock::time_point at = {});
+
+    size_t connection_count() const { return connection_count_.load(std::memory_order_relaxed); }
+    // Most requests seen waiting on one connection at once
+    size_t max_pipeline_depth() const { return max_pipeline_depth_.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        uint64_t id = 0;
+        int fd = -1;
+        std::string out;
+        size_t out_offset = 0;
+        wire::HttpParser parser{true};
+        wire::WsParser stream_parser;
+        bool stream = false;
+        bool closing = false;
+        uint64_t next_sequence = 0;      // Next request's sequence
+        uint64_t next_to_send = 0;       // Sequence whose response goes out next
+        std::unordered_map<uint64_t, std::string> ready;  // Finished responses waiting their turn
+    };
+
+    // Work posted to the poll thread
+    struct Outbound {
+        Clock::time_point at;
+        uint64_t order;            // Post order, keeps equal deadlines FIFO
+        uint64_t connection;       // 0 with stream = broadcast
+        uint64_t sequence;
+        bool stream;
+        std::string payload;
+
+        bool operator>(const Outbound& other) const {
+            return at != other.at ? at > other.at : order > other.order;
+        }
+    };
+
+    std::string host_;
+    uint16_t port_ = 0;
+    std::string stream_path_ = "/stream";
+    int listen_fd_ = -1;
+    RequestHandler request_handler_;
+    StreamHandler stream_handler_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    wire::Waker waker_;
+
+    std::mutex post_mutex_;
+    std::vector<Outbound> posted_;
+    uint64_t post_counter_ = 0;
+
+    // Poll thread only
+    std::priority_queue<Outbound, std::vector<Outbound>, std::greater<Outbound>> scheduled_;
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections_;
+    uint64_t next_connection_id_ = 1;
+
+    std::atomic<size_t> connection_count_{0};
+    std::atomic<size_t> max_pipeline_depth_{0};
+    std::shared_ptr<spdlog::logger> logger_;
+
+    void run();
+    void post(Outbound item);
+    void deliver(Outbound& item);
+    void accept_connections();
+    void on_readable(Connection& connection);
+    void handle_request(Connection& connection, wire::HttpMessage& request);
+    void upgrade(Connection& connection, const wire::HttpMessage& request);
+    void flush_responses(Connection& connection);
+    void close_connection(uint64_t id);
+};
+
+} // namespace frontier
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace frontier {
+
+struct CircuitBreakerConfig {
+    int64_t window_ns = 60'000'000'000;   // Look-back for the reference high/low
+    double threshold_pct = 0.10;          // Move from the window high or low that trips
+    int64_t pause_ns = 300'000'000'000;   // How long a tripped symbol stays halted
+    size_t expected_symbols = 10000;      // Reserved up front
+};
+
+struct CircuitBreakerEvent {
+    std::string_view symbol;              // Valid during the callback
+    uint32_t symbol_id = 0;
+    double price = 0.0;
+    double reference_price = 0.0;         // Window high for a drop, low for a spike
+    double move_pct = 0.0;                // Signed
+    int64_t timestamp_ns = 0;
+    int64_t halted_until_ns = 0;
+};
+
+// Detects a symbol moving threshold_pct away from its high or low of the
+// last window_ns. Each symbol keeps two monotonic deques (running max and
+// min) over time buckets of window_ns / kBuckets: a tick only touches the
+// back and front of each, and samples in one bucket collapse into one
+// entry, so each deque is a fixed ring of kBuckets and ticks never
+// allocate. The window is therefore accurate to one bucket.
+//
+// Symbols are indexed by SymbolStateTable ids; state for a new id is added
+// on its first tick.
+class VolatilityCircuitBreaker {
+public:
+    static constexpr size_t kBuckets = 32;
+
+    explicit VolatilityCircuitBreaker(const CircuitBreakerConfig& config = {});
+
+    const CircuitBreakerConfig& config() const { return config_; }
+
+    // True when this tick breaches; `event` gets price, reference and move.
+    // A breach clears the symbol's window so trading reopens from scratch.
+    bool on_tick(uint32_t id, double price, int64_t now_ns, CircuitBreakerEvent& event);
+    void reset(uint32_t id);
+
+    // 0 when the symbol has no samples in the window
+    double window_high(uint32_t id) const;
+    double window_low(uint32_t id) const;
+
+private:
+    struct Sample {
+        uint32_t bucket;   // now_ns / bucket_ns_, truncated; only differences matter
+        float price;
+    };
+    struct Ring {
+        std::array<Sample, kBuckets> samples;
+        uint8_t head = 0;
+        uint8_t size = 0;
+
+        const Sample& front() const { return samples[head]; }
+        const Sample& back() const { return samples[(head + size - 1) % kBuckets]; }
+        void pop_front() { head = static_cast<uint8_t>((head + 1) % kBuckets); --size; }
+        void pop_back() { --size; }
+        void push_back(Sample s) { samples[(head + size) % kBuckets] = s; ++size; }
+    };
+    struct Window {
+        Ring high;   // Prices decreasing front to back
+        Ring low;    // Prices increasing front to back
+    };
+
+    CircuitBreakerConfig config_;
+    int64_t bucket_ns_;
+    std::vector<Window> windows_;
+};
+
+} // namespace frontier
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace frontier {
+
+__extension__ typedef __int128 int128;
+
+// Exact decimal value stored as an integer count of 10^-scale units.
+// Converts implicitly to double so read-only callers keep working; all
+// bookkeeping arithmetic stays in integers and rounds half away from zero.
+struct Decimal {
+    int64_t units = 0;
+    int32_t scale = 0;
+
+    constexpr Decimal() = default;
+    constexpr Decimal(int64_t u, int32_t s) : units(u), scale(s) {}
+
+    static int64_t pow10(int32_t exponent) {
+        int64_t result = 1;
+        for (int32_t i = 0; i < exponent; ++i) {
+            result *= 10;
+        }
+        return result;
+    }
+
+    static Decimal from_double(double value, int32_t scale) {
+        return Decimal(std::llround(value * static_cast<double>(pow10(scale))), scale);
+    }
+
+    double to_double() const { return static_cast<double>(units) / static_cast<double>(pow10(scale)); }
+    operator double() const { return to_double(); }
+
+    bool is_zero() const { return units == 0; }
+
+    Decimal rescale(int32_t new_scale) const {
+        if (new_scale >= scale) {
+            return Decimal(units * pow10(new_scale - scale), new_scale);
+        }
+        return Decimal(divide_rounded(units, pow10(scale - new_scale)), new_scale);
+    }
+
+    // this * numerator / denominator at this scale, with a 128-bit intermediate
+    Decimal mul_div(int64_t numerator, int64_t denominator) const {
+        return Decimal(divide_rounded(static_cast<int128>(units) * numerator, denominator), scale);
+    }
+
+    // a * b rounded to result_scale
+    static Decimal multiply(Decimal a, Decimal b, int32_t result_scale) {
+        int128 product = static_cast<int128>(a.units) * b.units;
+        int32_t product_scale = a.scale + b.scale;
+        if (product_scale >= result_scale) {
+            return Decimal(divide_rounded(product, pow10(product_scale - result_scale)), result_scale);
+        }
+        return Decimal(static_cast<int64_t>(product * pow10(result_scale - product_scale)), result_scale);
+    }
+
+    Decimal operator-() const { return Decimal(-units, scale); }
+    Decimal& operator+=(Decimal other) {
+        units += other.rescale(scale).units;
+        return *this;
+    }
+    Decimal& operator-=(Decimal other) {
+        units -= other.rescale(scale).units;
+        return *this;
+    }
+    Decimal operator+(Decimal other) const { return Decimal(*this) += other; }
+    Decimal operator-(Decimal other) const { return Decimal(*this) -= other; }
+
+    std::string to_string() const {
+        uint64_t magnitude = units < 0 ? 0 - static_cast<uint64_t>(units) : static_cast<uint64_t>(units);
+        std::string digits = std::to_string(magnitude);
+        if (scale > 0) {
+            if (digits.size() <= static_cast<size_t>(scale)) {
+                digits.insert(0, static_cast<size_t>(scale) + 1 - digits.size(), '0');
+            }
+            digits.insert(digits.size() - static_cast<size_t>(scale), ".");
+        }
+        return units < 0 ? "-" + digits : digits;
+    }
+
+private:
+    static int64_t divide_rounded(int128 value, int64_t divisor) {
+        int128 quotient = value / divisor;
+        int128 remainder = value % divisor;
+        if (2 * (remainder < 0 ? -remainder : remainder) >= divisor) {
+            quotient += value < 0 ? -1 : 1;
+        }
+        return static_cast<int64_t>(quotient);
+    }
+};
+
+} // namespace frontier
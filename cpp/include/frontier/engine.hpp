@@ -1,43 +1,168 @@
 #pragma once
 
 #include "types.hpp"
+#include "market_data_bus.hpp"
+#include "market_data_fanout.hpp"
+#include "execution_algo.hpp"
+#include "strategy_plugin.hpp"
+#include "screener.hpp"
+#include "trading_calendar.hpp"
+#include "guardrails.hpp"
+#include "symbol_state.hpp"
+#include "circuit_breaker.hpp"
+#include <functional>
 #include <memory>
 #include <spdlog/spdlog.h>
 
+namespace trading {
+class Clock;
+}
+
 namespace frontier {
 
-class TradingEngine {
+class TradingEngine : public StrategyContext {
 public:
     TradingEngine();
-    ~TradingEngine() = default;
+    // Every time-dependent decision (sessions, algos, halts, stamps) reads
+    // `clock`; pass a trading::VirtualClock to replay time at full speed
+    explicit TradingEngine(std::shared_ptr<trading::Clock> clock);
+    ~TradingEngine() override = default;
     
     // Core trading functions
-    bool place_market_order(const std::string& symbol, Side side, double quantity, double price);
+    bool place_market_order(const std::string& symbol, Side side, double quantity, double price) override;
     void mark_to_market(const std::map<std::string, double>& prices);
     
     // Account management
-    const Account& get_account() const { return account_; }
-    const Position* get_position(const std::string& symbol) const;
+    const Account& get_account() const override { return account_; }
+    const Position* get_position(const std::string& symbol) const override;
+    
+    // Quantity precision per symbol; unregistered symbols containing '/' are crypto pairs
+    void set_asset_type(const std::string& symbol, AssetType type) { asset_types_[symbol] = type; }
+    AssetType get_asset_type(const std::string& symbol) const;
+    
+    // Short selling is off by default, like RiskLimits::allowShortSelling
+    void set_allow_short_selling(bool allowed) { allow_short_selling_ = allowed; }
+    bool allow_short_selling() const { return allow_short_selling_; }
+    // Annualized borrow fee on open short market value (0.03 = 3%/year)
+    void set_borrow_rate(const std::string& symbol, double annual_rate) { borrow_rates_[symbol] = annual_rate; }
+    void set_default_borrow_rate(double annual_rate) { default_borrow_rate_ = annual_rate; }
+    // Charge borrow fees on every short up to `now`; fills accrue their own position first
+    void accrue_borrow_costs(std::chrono::system_clock::time_point now);
+    
+    // Orders outside the symbol's venue session are rejected once a calendar
+    // is attached; without one every market is treated as open
+    void attach_trading_calendar(std::shared_ptr<const TradingCalendar> calendar) {
+        trading_calendar_ = std::move(calendar);
+    }
+    const TradingCalendar* trading_calendar() const { return trading_calendar_.get(); }
+    void set_allow_extended_hours(bool allowed) { allow_extended_hours_ = allowed; }
+    MarketSession market_session(const std::string& symbol, std::chrono::system_clock::time_point now) const;
+    bool is_market_open(const std::string& symbol, std::chrono::system_clock::time_point now) const;
     
     // Market data
     void update_market_data(const MarketData& data);
-    const MarketData* get_market_data(const std::string& symbol) const;
+    const MarketData* get_market_data(const std::string& symbol) const override;
+    
+    // Publish every market data update to a shared-memory bus for local readers
+    void attach_market_data_bus(std::shared_ptr<MarketDataBusWriter> bus) { market_data_bus_ = std::move(bus); }
+    // Push every market data update to subscribed client sessions
+    void attach_market_data_fanout(std::shared_ptr<MarketDataFanout> fanout) {
+        market_data_fanout_ = std::move(fanout);
+    }
+    
+    // Live per-symbol features for screening. Ticks maintain last, bid, ask,
+    // volume, spread_bps and (once prev_close is set) change_pct; anything
+    // else (vol_z, high_20d, ...) is pushed in with set_feature.
+    void set_feature(const std::string& symbol, const std::string& name, double value) {
+        features_.set(symbol, name, value);
+    }
+    const FeatureTable& features() const { return features_; }
+    ScreenResult screen(const ScreenQuery& query) const { return features_.query(query); }
+    
+    // Execution algorithms: parent orders are sliced into market orders
+    uint64_t submit_algo_order(const ParentOrderSpec& spec);
+    bool cancel_algo_order(uint64_t parent_id);
+    const ParentOrder* get_algo_order(uint64_t parent_id) const;
+    void set_volume_profile(const std::string& symbol, VolumeProfile profile);
+    void process_timers();
+    
+    // In-process strategies from shared libraries (FRONTIER_EXPORT_STRATEGY).
+    // They see every tick and every process_timers() call on the engine
+    // thread, and the fills of orders they placed themselves;
+    // process_timers() also reloads any whose library changed.
+    uint64_t load_strategy(const std::string& path, const std::string& config = "");  // Throws on a bad library
+    bool unload_strategy(uint64_t id);
+    size_t reload_changed_strategies();
+    StrategyPlugin* get_strategy(uint64_t id);
+    size_t strategy_count() const { return strategies_.size(); }
     
     // Risk management
     bool check_risk_limits(const std::string& symbol, Side side, double quantity, double price) const;
+    // Halts, side blocks and LULD bands; ticks move the bands and orders are checked against them
+    SymbolStateTable& symbol_states() { return symbol_states_; }
+    const SymbolStateTable& symbol_states() const { return symbol_states_; }
+    SymbolGate check_symbol_state(const std::string& symbol, Side side, double price) const;
+    // Halt a symbol for pause_ns when a tick moves threshold_pct from its
+    // high or low of the last window_ns; the handler hears about each trip
+    void enable_circuit_breaker(const CircuitBreakerConfig& config) {
+        circuit_breaker_ = std::make_unique<VolatilityCircuitBreaker>(config);
+    }
+    void set_circuit_breaker_handler(std::function<void(const CircuitBreakerEvent&)> handler) {
+        circuit_breaker_handler_ = std::move(handler);
+    }
+    const VolatilityCircuitBreaker* circuit_breaker() const { return circuit_breaker_.get(); }
+    void set_guardrail_limits(const GuardrailLimits& limits) { guardrail_limits_ = limits; }
+    const GuardrailLimits& guardrail_limits() const { return guardrail_limits_; }
+    // Equity change since start_trading_day() (or construction)
+    double daily_pnl() const { return account_.equity - day_start_equity_; }
+    void start_trading_day() { day_start_equity_ = account_.equity; }
+    // Position, daily loss and market hours checks plus sizing for many
+    // candidates at once, all against the same account snapshot. Candidates
+    // are independent: two for one symbol are not added together.
+    std::vector<GuardrailResult> evaluate_guardrails(const std::vector<GuardrailCandidate>& candidates,
+                                                     std::chrono::system_clock::time_point now) const;
+    
+    const trading::Clock& clock() const { return *clock_; }
     
     // Reporting
     void print_account_summary() const;
     void print_positions() const;
     
 private:
+    std::shared_ptr<trading::Clock> clock_;
     Account account_;
     std::map<std::string, MarketData> market_data_;
+    std::map<std::string, AssetType> asset_types_;
+    std::map<std::string, double> borrow_rates_;
+    double default_borrow_rate_ = 0.0;
+    bool allow_short_selling_ = false;
+    bool allow_extended_hours_ = false;
+    GuardrailLimits guardrail_limits_;
+    double day_start_equity_ = 0.0;
+    std::shared_ptr<const TradingCalendar> trading_calendar_;
+    std::shared_ptr<MarketDataBusWriter> market_data_bus_;
+    std::shared_ptr<MarketDataFanout> market_data_fanout_;
+    std::unique_ptr<ExecutionAlgoEngine> algo_engine_;
+    std::map<uint64_t, std::unique_ptr<StrategyPlugin>> strategies_;
+    FeatureTable features_;
+    SymbolStateTable symbol_states_;
+    std::unique_ptr<VolatilityCircuitBreaker> circuit_breaker_;
+    std::function<void(const CircuitBreakerEvent&)> circuit_breaker_handler_;
+    struct TickColumns {
+        int last, bid, ask, volume, spread_bps, prev_close, change_pct;
+    } tick_columns_{};
+    uint64_t next_strategy_id_ = 1;
+    uint64_t active_strategy_ = 0;   // Strategy whose callback is running; 0 for none
     std::shared_ptr<spdlog::logger> logger_;
     
     // Internal helper functions
-    void update_position(const std::string& symbol, Side side, double quantity, double price);
+    bool update_position(const std::string& symbol, Side side, double quantity, double price);
+    void accrue_borrow(Position& position, std::chrono::system_clock::time_point now);
     void calculate_unrealized_pnl();
+    template <typename Callback>
+    void call_strategy(uint64_t id, StrategyPlugin& plugin, const char* event, Callback&& callback);
+    template <typename Callback>
+    void dispatch_strategies(const char* event, Callback&& callback);
 };
 
 } // namespace frontier
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "types.hpp"
+#include "timer_wheel.hpp"
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace frontier {
+
+enum class AlgoType {
+    TWAP,   // Even slices over [start, end]
+    VWAP,   // Slices follow the symbol's historical intraday volume profile
+    POV     // Child size tracks a fraction of live traded volume
+};
+
+enum class AlgoStatus {
+    Working,
+    Completed,
+    Cancelled,
+    Expired     // End time reached with quantity left
+};
+
+struct ParentOrderSpec {
+    std::string symbol;
+    Side side = Side::Buy;
+    double quantity = 0.0;
+    AlgoType algo = AlgoType::TWAP;
+    TimerWheel::TimePoint start_time;
+    TimerWheel::TimePoint end_time;
+    std::chrono::milliseconds slice_interval{std::chrono::seconds(60)};  // TWAP/VWAP
+    double participation_rate = 0.1;  // POV
+    double min_child_quantity = 1.0;  // Smaller remainders wait for the next slice
+    double limit_price = 0.0;         // 0 = no limit
+};
+
+struct ParentOrder {
+    uint64_t id = 0;
+    ParentOrderSpec spec;
+    AlgoStatus status = AlgoStatus::Working;
+    double executed_quantity = 0.0;
+    double executed_notional = 0.0;
+    size_t child_count = 0;
+
+    double remaining() const { return spec.quantity - executed_quantity; }
+    double average_price() const {
+        return executed_quantity > 0 ? executed_notional / executed_quantity : 0.0;
+    }
+};
+
+// Historical intraday volume: equal-width buckets starting at session_open
+// (offset from midnight UTC), each holding a relative weight.
+struct VolumeProfile {
+    std::chrono::minutes session_open{std::chrono::hours(13) + std::chrono::minutes(30)};
+    std::chrono::minutes bucket_width{1};
+    std::vector<double> weights;
+};
+
+// Sends one child order. Returns the executed quantity (0 if rejected).
+using ChildOrderSink = std::function<double(const ParentOrder& parent, double quantity, double price)>;
+
+// Slices parent orders into children. Schedules are driven by a timer wheel
+// advanced from the caller's event loop and from the tick flow; POV parents
+// are indexed per symbol so a tick only touches the parents trading it.
+class ExecutionAlgoEngine {
+public:
+    explicit ExecutionAlgoEngine(ChildOrderSink sink,
+                                 std::chrono::milliseconds resolution = std::chrono::milliseconds(100),
+                                 TimerWheel::TimePoint start = std::chrono::system_clock::now());
+
+    uint64_t submit(const ParentOrderSpec& spec, TimerWheel::TimePoint now);
+    bool cancel(uint64_t parent_id);
+
+    void set_volume_profile(const std::string& symbol, VolumeProfile profile);
+
+    // Fire due slices. Cheap when nothing is due.
+    void on_timer(TimerWheel::TimePoint now);
+    // Track reference prices and traded volume; POV parents react immediately
+    void on_tick(const MarketData& tick, TimerWheel::TimePoint now);
+
+    const ParentOrder* get(uint64_t parent_id) const;
+    size_t active_count() const { return active_count_; }
+
+    // Finished parents stay visible to get() until this many newer ones have
+    // finished (100000 by default); older ones are forgotten
+    void set_finished_retention(size_t parents);
+    size_t finished_count() const { return finished_.size(); }
+
+private:
+    struct SymbolState {
+        double bid = 0.0;
+        double ask = 0.0;
+        double last = 0.0;
+        double cumulative_volume = -1.0;  // Unknown until the first tick
+        std::vector<uint32_t> pov_parents;
+        VolumeProfile profile;
+        std::vector<double> profile_cumulative;  // Prefix sums of profile weights
+    };
+
+    static constexpr TimerWheel::TimerId kNoTimer = UINT64_MAX;
+
+    struct Slot {
+        ParentOrder order;
+        uint32_t generation = 0;
+        bool in_use = false;
+        TimerWheel::TimerId timer = kNoTimer;
+        double pov_owed = 0.0;        // POV quantity accrued but not yet sent
+        size_t pov_index = SIZE_MAX;  // Position in SymbolState::pov_parents
+    };
+
+    ChildOrderSink sink_;
+    TimerWheel wheel_;
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> free_slots_;
+    std::unordered_map<std::string, SymbolState> symbols_;
+    std::unordered_map<uint64_t, ParentOrder> finished_;
+    std::deque<uint64_t> finish_order_;   // Ids in finished_, oldest first
+    size_t finished_retention_ = 100000;
+    size_t active_count_ = 0;
+
+    Slot* find(uint64_t parent_id);
+    void on_slice(uint32_t index, TimerWheel::TimePoint now);
+    double send_child(Slot& slot, double quantity);
+    void finish(uint32_t index, AlgoStatus status);
+    void evict_finished();
+    double target_fraction(const Slot& slot, TimerWheel::TimePoint at) const;
+    double profile_volume_until(const SymbolState& state, TimerWheel::TimePoint day_start,
+                                TimerWheel::TimePoint at) const;
+    double reference_price(const SymbolState& state, Side side) const;
+};
+
+} // namespace frontier
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace frontier {
+
+struct GuardrailLimits {
+    double max_position_fraction = 0.2;   // Of equity, per symbol
+    double max_daily_loss = 5000.0;       // Same default as RiskLimits::maxDailyLoss
+    double risk_per_trade = 0.01;         // Of equity lost if the stop is hit, for optimal sizing
+};
+
+// A proposed trade. Quantity is signed (negative sells); a limit of 0 prices
+// it at the current quote. Stop and win/loss statistics are optional and
+// feed the daily loss check and the sizing suggestions.
+struct GuardrailCandidate {
+    std::string symbol;
+    double quantity = 0.0;
+    double limit_price = 0.0;
+    double stop_price = 0.0;
+    double win_rate = 0.0;
+    double avg_win = 0.0;
+    double avg_loss = 0.0;
+};
+
+struct GuardrailResult {
+    bool max_pos_ok = false;
+    bool daily_loss_ok = false;
+    bool mkt_hours_ok = false;
+    double price = 0.0;                    // Price the checks used
+    double projected_position_value = 0.0;
+    double kelly_fraction = 0.0;           // RiskCalculator::calculateKellyCriterion
+    double kelly_quantity = 0.0;           // Both sizes are unsigned and capped at the position limit
+    double optimal_quantity = 0.0;         // RiskCalculator::calculateOptimalPositionSize, 0 without a stop
+};
+
+// Flag kernel over candidates laid out column by column (structure of
+// arrays), two per SSE2 instruction. For each i:
+//   max_pos_ok[i]    = |position[i] + quantity[i]| * price[i] <= max_position_value
+//   daily_loss_ok[i] = |quantity[i]| * |price[i] - stop[i]| <= loss_headroom  (stop 0: no loss)
+// loss_headroom is what the day may still lose: daily P&L + max daily loss.
+void evaluate_guardrail_flags(const double* position, const double* quantity, const double* price,
+                              const double* stop, size_t count, double max_position_value,
+                              double loss_headroom, uint8_t* max_pos_ok, uint8_t* daily_loss_ok);
+
+// Fills the Kelly and stop-based sizes of `result` (whose price is already set)
+void size_guardrail_candidate(const GuardrailCandidate& candidate, double equity, const GuardrailLimits& limits,
+                              GuardrailResult& result);
+
+} // namespace frontier
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace frontier {
+
+// Minimal HTTP/1.1 and WebSocket wire handling for the broker adapters and
+// the local broker servers. Plain TCP only; bodies are Content-Length or
+// chunked. Everything here is synchronous and allocation-light so it can run
+// inside a poll loop.
+namespace wire {
+
+using Headers = std::vector<std::pair<std::string, std::string>>;
+
+struct HttpMessage {
+    // Requests fill method/target, responses status/reason
+    std::string method;
+    std::string target;
+    int status = 0;
+    std::string reason;
+    Headers headers;
+    std::string body;
+
+    // Case-insensitive lookup; nullptr when absent
+    const std::string* header(std::string_view name) const;
+};
+
+// Incremental parser for a stream of pipelined messages in one direction.
+// A body (Content-Length or chunked total) over `max_body` bytes fails the
+// parser with too_large() set; servers should answer 413 and close.
+class HttpParser {
+public:
+    static constexpr size_t kDefaultMaxBody = 16 * 1024 * 1024;
+
+    explicit HttpParser(bool parse_requests, size_t max_body = kDefaultMaxBody)
+        : requests_(parse_requests), max_body_(max_body) {}
+
+    void feed(const char* data, size_t size) { buffer_.append(data, size); }
+    // Pop the next complete message. Returns false when more bytes are needed
+    // or the stream is malformed (check failed()).
+    bool next(HttpMessage& out);
+    bool failed() const { return failed_; }
+    bool too_large() const { return too_large_; }
+    // Bytes received after the last parsed message, e.g. after an upgrade
+    std::string take_remaining();
+    void reset();
+
+private:
+    bool requests_;
+    size_t max_body_;
+    bool failed_ = false;
+    bool too_large_ = false;
+    std::string buffer_;
+    size_t offset_ = 0;
+
+    bool decode_chunked(size_t start, std::string& body, size_t& end);
+    bool fail_too_large();
+};
+
+std::string format_request(std::string_view method, std::string_view target, std::string_view host,
+                           const Headers& headers, std::string_view body);
+std::string format_response(int status, std::string_view reason, std::string_view body,
+                            const Headers& headers = {});
+std::string_view status_reason(int status);
+
+// ---- WebSocket ----
+
+enum class WsOpcode : uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xA
+};
+
+struct WsFrame {
+    WsOpcode opcode = WsOpcode::Text;
+    bool fin = true;
+    std::string payload;
+};
+
+std::string websocket_key();
+std::string websocket_accept(std::string_view key);
+// Clients must mask, servers must not
+std::string encode_frame(WsOpcode opcode, std::string_view payload, bool mask);
+// Close frame payload: 2-byte status code, e.g. 1009 (message too big)
+std::string close_payload(uint16_t code);
+
+// Reassembles frames and fragmented messages from a byte stream. A frame
+// or reassembled message over `max_message` bytes fails the parser with
+// too_large() set; the peer should get a 1009 close.
+class WsParser {
+public:
+    static constexpr size_t kDefaultMaxMessage = 16 * 1024 * 1024;
+
+    explicit WsParser(size_t max_message = kDefaultMaxMessage) : max_message_(max_message) {}
+
+    void feed(const char* data, size_t size) { buffer_.append(data, size); }
+    void feed(const std::string& data) { buffer_ += data; }
+    // Next complete message (control frames are returned as they arrive)
+    bool next(WsFrame& out);
+    bool failed() const { return failed_; }
+    bool too_large() const { return too_large_; }
+
+private:
+    std::string buffer_;
+    size_t offset_ = 0;
+    size_t max_message_;
+    bool failed_ = false;
+    bool too_large_ = false;
+    WsFrame partial_;
+    bool in_message_ = false;
+};
+
+// ---- Sockets ----
+
+// Non-blocking TCP with Nagle disabled. Connect returns while the handshake
+// is in flight; wait for POLLOUT and check connect_finished().
+int tcp_connect(const std::string& host, uint16_t port);
+bool connect_finished(int fd);
+// Listening socket; `bound_port` receives the port actually bound (for port 0)
+int tcp_listen(const std::string& host, uint16_t port, uint16_t* bound_port);
+int tcp_accept(int listen_fd);
+void close_fd(int& fd);
+
+// Read what is available; returns false on EOF or a hard error
+bool read_available(int fd, std::string& into);
+// Write as much of `data` from `offset` as the socket takes; false on error
+bool write_pending(int fd, const std::string& data, size_t& offset);
+
+// eventfd used to wake a poll loop from other threads
+class Waker {
+public:
+    Waker();
+    ~Waker();
+    Waker(const Waker&) = delete;
+    Waker& operator=(const Waker&) = delete;
+
+    void notify();
+    void drain();
+    int fd() const { return fd_; }
+
+private:
+    int fd_ = -1;
+};
+
+} // namespace wire
+
+} // namespace frontier
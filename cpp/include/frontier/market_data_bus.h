@@ -0,0 +1,56 @@
+/*
+ * C ABI for reading the engine's shared-memory market data bus.
+ *
+ * The engine publishes its latest-quote table and tick stream into a POSIX
+ * shared-memory region (see market_data_bus.hpp). This header lets non-C++
+ * consumers (Python via ctypes, Rust via FFI) read it. After
+ * frontier_bus_open() no call makes a syscall.
+ */
+#ifndef FRONTIER_MARKET_DATA_BUS_H
+#define FRONTIER_MARKET_DATA_BUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FRONTIER_BUS_SYMBOL_LENGTH 16
+
+typedef struct frontier_bus frontier_bus;
+
+typedef struct frontier_bus_quote {
+    char symbol[FRONTIER_BUS_SYMBOL_LENGTH];
+    double bid;
+    double ask;
+    double last;
+    double volume;
+    int64_t timestamp_ns;
+    uint32_t slot;
+} frontier_bus_quote;
+
+/* Map an existing bus read-only. Returns NULL if it does not exist or the
+ * layout version does not match. */
+frontier_bus* frontier_bus_open(const char* name);
+void frontier_bus_close(frontier_bus* bus);
+
+/* Slot index for a symbol, or -1 if the engine has not published it yet.
+ * Slot indexes never change, so callers should look a symbol up once. */
+int32_t frontier_bus_find_symbol(const frontier_bus* bus, const char* symbol);
+
+/* Latest quote in a slot. Returns 1 on success, 0 if the slot is unused or
+ * a consistent read could not be taken. */
+int frontier_bus_read_quote(const frontier_bus* bus, uint32_t slot, frontier_bus_quote* out);
+
+/* Copy up to max_ticks ticks published since the previous call into out.
+ * Returns the number copied. Ticks that were overwritten before this reader
+ * got to them are added to *dropped (may be NULL). */
+size_t frontier_bus_poll_ticks(frontier_bus* bus, frontier_bus_quote* out, size_t max_ticks,
+                               uint64_t* dropped);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FRONTIER_MARKET_DATA_BUS_H */
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "types.hpp"
+#include "market_data_bus.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace frontier {
+
+// Shared-memory layout of the market data bus. One writer (the engine) and
+// any number of readers in other processes. The region is:
+//
+//   [BusHeader][BusQuoteSlot x slot_capacity][BusTickRecord x ring_capacity]
+//
+// Quote slots are seqlocked: the sequence is odd while a write is in
+// progress. Tick records carry 2 * position + 2 once written, so a reader can
+// tell both torn reads and records that were overwritten by a later lap.
+namespace bus {
+
+constexpr uint32_t kMagic = 0x46424D44;  // "FBMD"
+constexpr uint32_t kVersion = 1;
+
+struct alignas(64) BusHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_capacity;
+    uint32_t ring_capacity;  // Power of two
+    std::atomic<uint32_t> slot_count;
+    alignas(64) std::atomic<uint64_t> ring_head;  // Next ring position to write
+};
+
+struct alignas(64) BusQuoteSlot {
+    std::atomic<uint64_t> sequence;
+    char symbol[FRONTIER_BUS_SYMBOL_LENGTH];  // Written once before the slot is published
+    double bid;
+    double ask;
+    double last;
+    double volume;
+    int64_t timestamp_ns;
+};
+
+struct alignas(64) BusTickRecord {
+    std::atomic<uint64_t> sequence;
+    uint32_t slot;
+    double bid;
+    double ask;
+    double last;
+    double volume;
+    int64_t timestamp_ns;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "bus requires lock-free 64-bit atomics");
+static_assert(sizeof(BusQuoteSlot) == 64 && sizeof(BusTickRecord) == 64);
+
+size_t region_size(uint32_t slot_capacity, uint32_t ring_capacity);
+
+} // namespace bus
+
+// Engine side of the bus. Creates (and on destruction unlinks) the region.
+// Not thread-safe: publish from the thread that owns the engine.
+class MarketDataBusWriter {
+public:
+    MarketDataBusWriter(const std::string& name, uint32_t slot_capacity = 4096,
+                        uint32_t ring_capacity = 65536);
+    ~MarketDataBusWriter();
+
+    MarketDataBusWriter(const MarketDataBusWriter&) = delete;
+    MarketDataBusWriter& operator=(const MarketDataBusWriter&) = delete;
+
+    // Update the symbol's quote slot and append a tick to the ring. Returns
+    // false if the symbol does not fit or the slot table is full.
+    bool publish(const MarketData& data, int64_t timestamp_ns);
+
+    const std::string& name() const { return name_; }
+    uint32_t slot_count() const { return header_->slot_count.load(std::memory_order_relaxed); }
+
+private:
+    std::string name_;
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    bus::BusHeader* header_ = nullptr;
+    bus::BusQuoteSlot* slots_ = nullptr;
+    bus::BusTickRecord* ring_ = nullptr;
+    std::unordered_map<std::string, uint32_t> slot_index_;
+
+    int32_t slot_for(const std::string& symbol);
+};
+
+// Reader side. Maps the region read-only; after construction no method
+// makes a syscall. Each reader keeps its own tick cursor.
+class MarketDataBusReader {
+public:
+    explicit MarketDataBusReader(const std::string& name);
+    ~MarketDataBusReader();
+
+    MarketDataBusReader(const MarketDataBusReader&) = delete;
+    MarketDataBusReader& operator=(const MarketDataBusReader&) = delete;
+
+    int32_t find_symbol(std::string_view symbol) const;
+    bool read_quote(uint32_t slot, frontier_bus_quote& out) const;
+    size_t poll_ticks(frontier_bus_quote* out, size_t max_ticks, uint64_t* dropped = nullptr);
+
+    uint32_t slot_count() const { return header_->slot_count.load(std::memory_order_acquire); }
+
+private:
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    const bus::BusHeader* header_ = nullptr;
+    const bus::BusQuoteSlot* slots_ = nullptr;
+    const bus::BusTickRecord* ring_ = nullptr;
+    uint64_t cursor_ = 0;
+};
+
+} // namespace frontier
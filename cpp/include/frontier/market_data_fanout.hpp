@@ -0,0 +1,87 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace frontier {
+
+// Pushes quotes to client sessions (watchlists, market data panels) by
+// symbol. An inverted index maps each symbol to its subscribers, so a tick
+// costs one serialization plus one dirty-mark per interested session, no
+// matter how many sessions exist. Sessions coalesce: between flushes they
+// only remember which symbols changed, and flush() writes the latest quote
+// of each into the session's reusable outbound buffer in one piece.
+//
+// Quotes are JSON objects, each already wrapped as a WebSocket text frame
+// unless websocket_frames is false (then newline-delimited). Thread-safe.
+class MarketDataFanout {
+public:
+    // Receives one session's coalesced bytes, valid only during the call. It
+    // runs under the fanout's lock, so it should queue the bytes, not call back in.
+    using Sink = std::function<void(uint64_t session_id, std::string_view bytes)>;
+
+    explicit MarketDataFanout(bool websocket_frames = true);
+
+    uint64_t open_session();
+    void close_session(uint64_t session_id);
+    // Unknown or closed sessions are ignored; returns symbols actually added/removed
+    size_t subscribe(uint64_t session_id, const std::vector<std::string>& symbols);
+    size_t unsubscribe(uint64_t session_id, const std::vector<std::string>& symbols);
+
+    // Serialize once and mark every subscriber; ticks nobody watches cost a lookup
+    void publish(const MarketData& data, int64_t timestamp_ns);
+    // Hand each session with pending quotes its buffer; returns sessions written
+    size_t flush(const Sink& sink);
+
+    size_t session_count() const;
+    size_t subscriber_count(const std::string& symbol) const;
+    uint64_t frames_serialized() const;
+
+private:
+    struct Subscription {
+        uint32_t symbol;
+        uint32_t position;   // Index in the symbol's subscriber list
+        bool dirty;
+    };
+    struct Session {
+        uint32_t generation = 0;
+        bool open = false;
+        bool queued = false;              // In pending_
+        std::vector<Subscription> subscriptions;
+        std::vector<uint32_t> dirty;      // Indices into subscriptions
+        std::string outbound;             // Reused across flushes
+    };
+    struct Subscriber {
+        uint32_t session;
+        uint32_t slot;                    // Index in the session's subscriptions
+    };
+    struct SymbolEntry {
+        std::string symbol;
+        std::string quoted;               // Symbol as an escaped JSON string
+        std::string frame;                // Latest serialized quote
+        std::vector<Subscriber> subscribers;
+    };
+
+    bool websocket_frames_;
+    mutable std::mutex mutex_;
+    std::vector<Session> sessions_;
+    std::vector<uint32_t> free_sessions_;
+    std::vector<SymbolEntry> symbols_;
+    std::unordered_map<std::string, uint32_t> symbol_index_;
+    std::vector<uint32_t> pending_;
+    std::string scratch_;                 // Quotes that miss serialize's fast path
+    size_t open_sessions_ = 0;
+    uint64_t frames_serialized_ = 0;
+
+    Session* find_session(uint64_t session_id);
+    void remove_subscription(uint32_t session, uint32_t slot);
+    void serialize(SymbolEntry& entry, const MarketData& data, int64_t timestamp_ns);
+};
+
+} // namespace frontier
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "broker_server.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+namespace frontier {
+
+// Offline stand-in for an Alpaca-style broker, for adapter tests and
+// throughput benchmarks. Serves POST /v2/orders, GET and DELETE
+// /v2/orders/{id} and DELETE /v2/orders, and pushes trade_updates to stream
+// clients. Market orders fill at once at `fill_price`; limit orders rest
+// until cancelled.
+class MockBrokerServer {
+public:
+    struct Config {
+        std::string host = "127.0.0.1";
+        uint16_t port = 0;                          // 0 picks a free port
+        std::chrono::microseconds ack_latency{0};   // Added to every response
+        double fill_price = 100.0;
+        bool fill_market_orders = true;
+    };
+
+    explicit MockBrokerServer(Config config);
+    MockBrokerServer() : MockBrokerServer(Config{}) {}
+
+    void start() { server_.start(); }
+    void stop() { server_.stop(); }
+    uint16_t port() const { return server_.port(); }
+
+    uint64_t orders_received() const { return orders_received_.load(std::memory_order_relaxed); }
+    uint64_t cancels_received() const { return cancels_received_.load(std::memory_order_relaxed); }
+    size_t connection_count() const { return server_.connection_count(); }
+    size_t max_pipeline_depth() const { return server_.max_pipeline_depth(); }
+
+private:
+    struct MockOrder {
+        std::string id;
+        std::string client_order_id;
+        std::string symbol;
+        std::string side;
+        std::string type;
+        std::string quantity;
+        std::string status;
+    };
+
+    Config config_;
+    BrokerServer server_;
+    std::unordered_map<std::string, MockOrder> orders_;  // Server thread only
+    uint64_t next_order_id_ = 1;
+    std::atomic<uint64_t> orders_received_{0};
+    std::atomic<uint64_t> cancels_received_{0};
+
+    void on_request(const wire::HttpMessage& request, BrokerServer::ResponseToken token);
+    void on_stream(uint64_t client, const std::string& message);
+    void submit(const wire::HttpMessage& request, BrokerServer::ResponseToken token);
+    int cancel(const std::string& id, BrokerServer::Clock::time_point at);
+    void publish(const char* event, const MockOrder& order, BrokerServer::Clock::time_point at);
+};
+
+} // namespace frontier
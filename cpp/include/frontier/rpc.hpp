@@ -1,15 +1,23 @@
 #pragma once
 #include <string>
 #include <memory>
+#include <stdexcept>
 #include <nlohmann/json.hpp>
 #include "frontier/engine.hpp"
 
+namespace trading {
+class OrderManager;
+}
+
 namespace frontier {
 
 class RpcServer {
 public:
     explicit RpcServer(std::shared_ptr<TradingEngine> engine);
     
+    // Source of the order books behind get_book_signals
+    void attach_order_manager(std::shared_ptr<trading::OrderManager> orders) { orders_ = std::move(orders); }
+    
     // Main RPC handler
     std::string handle_request(const std::string& request);
     
@@ -22,9 +30,19 @@ public:
     nlohmann::json get_account(const nlohmann::json& params);
     nlohmann::json simulate_order(const nlohmann::json& params);
     nlohmann::json check_risk_limits(const nlohmann::json& params);
+    nlohmann::json screen(const nlohmann::json& params);
+    nlohmann::json set_features(const nlohmann::json& params);
+    nlohmann::json get_market_status(const nlohmann::json& params);
+    nlohmann::json evaluate_guardrails(const nlohmann::json& params);
+    nlohmann::json halt_symbol(const nlohmann::json& params);
+    nlohmann::json resume_symbol(const nlohmann::json& params);
+    nlohmann::json set_price_band(const nlohmann::json& params);
+    nlohmann::json get_symbol_state(const nlohmann::json& params);
+    nlohmann::json get_book_signals(const nlohmann::json& params);
 
 private:
     std::shared_ptr<TradingEngine> engine_;
+    std::shared_ptr<trading::OrderManager> orders_;
     std::shared_ptr<spdlog::logger> logger_;
     
     // Helper methods
@@ -69,4 +87,14 @@ enum class RpcErrorCode {
     PositionNotFound = -32006,
 };
 
+// Thrown by RPC methods to answer with a specific error code instead of InternalError
+class RpcError : public std::runtime_error {
+public:
+    RpcError(RpcErrorCode code, const std::string& message) : std::runtime_error(message), code_(code) {}
+    RpcErrorCode code() const { return code_; }
+
+private:
+    RpcErrorCode code_;
+};
+
 } // namespace frontier
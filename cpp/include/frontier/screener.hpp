@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace frontier {
+
+enum class ScreenOp {
+    GT,
+    GE,
+    LT,
+    LE,
+    BETWEEN   // value <= x <= upper
+};
+
+// `column OP value`, or with relative_to set, `column OP value * relative_to`
+// ("last >= 0.98 * high_20d"). Rows missing either column never match.
+struct ScreenPredicate {
+    std::string column;
+    ScreenOp op = ScreenOp::GT;
+    double value = 0.0;
+    double upper = 0.0;
+    std::string relative_to;
+};
+
+struct ScreenQuery {
+    std::vector<ScreenPredicate> where;   // ANDed
+    std::string order_by;                 // Empty keeps symbol order
+    bool descending = true;
+    size_t limit = 50;
+    std::vector<std::string> select;      // Extra columns returned per row
+};
+
+struct ScreenRow {
+    std::string symbol;
+    std::vector<double> values;           // order_by first (if any), then select; NaN when unset
+};
+
+struct ScreenResult {
+    std::vector<ScreenRow> rows;
+    size_t matched = 0;
+    size_t scanned = 0;
+};
+
+// Per-symbol live features stored column by column: one float array per
+// feature, rows padded to 64 with NaN. A query ANDs its predicates into a
+// row bitmask four rows per SSE compare, 64 rows per mask word, skipping
+// words already empty, then ranks only the survivors. Floats keep a 10k
+// symbol column at 40 KB, so a scan stays in cache.
+class FeatureTable {
+public:
+    // Column id for `name`, created on first use
+    int column(const std::string& name);
+    int find_column(const std::string& name) const;
+    const std::vector<std::string>& column_names() const { return column_names_; }
+
+    // Row id for `symbol`, created on first use
+    uint32_t row(const std::string& symbol);
+    int64_t find_row(const std::string& symbol) const;
+    const std::string& symbol(uint32_t row) const { return symbols_[row]; }
+    size_t size() const { return symbols_.size(); }
+
+    void set(uint32_t row, int column, double value) { columns_[column][row] = static_cast<float>(value); }
+    void set(const std::string& symbol, const std::string& column_name, double value);
+    double get(uint32_t row, int column) const { return columns_[column][row]; }
+    // NaN when the symbol or column is unknown or unset
+    double get(const std::string& symbol, const std::string& column_name) const;
+
+    // Throws std::invalid_argument naming an unknown column
+    ScreenResult query(const ScreenQuery& query) const;
+
+private:
+    std::vector<std::string> column_names_;
+    std::unordered_map<std::string, int> column_index_;
+    std::vector<std::vector<float>> columns_;
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, uint32_t> row_index_;
+    size_t capacity_ = 0;   // Rows allocated per column, a multiple of 64
+
+    int require_column(const std::string& name) const;
+};
+
+} // namespace frontier
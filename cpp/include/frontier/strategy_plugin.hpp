@@ -0,0 +1,106 @@
+#pragma once
+
+#include "types.hpp"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <sys/types.h>
+
+namespace frontier {
+
+// Bumped whenever Strategy or StrategyContext change layout; the loader
+// refuses libraries built against another version.
+constexpr int kStrategyAbiVersion = 1;
+
+struct StrategyFill {
+    std::string symbol;
+    Side side = Side::Buy;
+    double quantity = 0.0;
+    double price = 0.0;
+    std::chrono::system_clock::time_point timestamp;
+};
+
+// What a strategy may do from inside a callback. Virtual so plug-ins call
+// back into the engine without linking against it.
+class StrategyContext {
+public:
+    virtual ~StrategyContext() = default;
+    virtual bool place_market_order(const std::string& symbol, Side side, double quantity, double price) = 0;
+    virtual const Position* get_position(const std::string& symbol) const = 0;
+    virtual const MarketData* get_market_data(const std::string& symbol) const = 0;
+    virtual const Account& get_account() const = 0;
+};
+
+// In-process strategy. Callbacks run on the engine thread between ticks,
+// so they must not block.
+class Strategy {
+public:
+    virtual ~Strategy() = default;
+    virtual void on_tick(const MarketData& data, StrategyContext& context) = 0;
+    virtual void on_fill(const StrategyFill& fill, StrategyContext& context) { (void)fill; (void)context; }
+    virtual void on_timer(std::chrono::system_clock::time_point now, StrategyContext& context) {
+        (void)now;
+        (void)context;
+    }
+    // Carried across a hot reload: the old instance saves, the new one restores
+    virtual std::string save_state() const { return {}; }
+    virtual void restore_state(const std::string& state) { (void)state; }
+};
+
+// Plug-in entry points, resolved with dlsym
+extern "C" {
+using StrategyAbiVersionFn = int (*)();
+using CreateStrategyFn = Strategy* (*)(const char* config);
+using DestroyStrategyFn = void (*)(Strategy*);
+}
+
+// Export a Strategy subclass constructible from a config string
+#define FRONTIER_EXPORT_STRATEGY(StrategyClass)                                               \
+    extern "C" int frontier_strategy_abi_version() { return ::frontier::kStrategyAbiVersion; } \
+    extern "C" ::frontier::Strategy* frontier_create_strategy(const char* config) {           \
+        return new StrategyClass(config ? config : "");                                      \
+    }                                                                                         \
+    extern "C" void frontier_destroy_strategy(::frontier::Strategy* strategy) { delete strategy; }
+
+// One strategy shared library. The library is copied before dlopen so a
+// rebuilt file at the same path loads as a new image rather than the
+// cached one; reload() swaps instances and carries save_state() across.
+class StrategyPlugin {
+public:
+    // Throws std::runtime_error when the library cannot be loaded
+    StrategyPlugin(std::string path, std::string config);
+    ~StrategyPlugin();
+
+    StrategyPlugin(const StrategyPlugin&) = delete;
+    StrategyPlugin& operator=(const StrategyPlugin&) = delete;
+
+    Strategy& strategy() { return *strategy_; }
+    const std::string& path() const { return path_; }
+    uint64_t generation() const { return generation_; }
+
+    // True when the file on disk differs from the last one loaded or tried
+    bool changed_on_disk() const;
+    // Load the current file; on failure the old instance keeps running and false is returned
+    bool reload(std::string* error = nullptr);
+
+private:
+    struct Image {
+        void* handle = nullptr;
+        std::string copy_path;
+        DestroyStrategyFn destroy = nullptr;
+        ~Image();
+    };
+
+    std::string path_;
+    std::string config_;
+    std::unique_ptr<Image> image_;
+    Strategy* strategy_ = nullptr;
+    int64_t loaded_mtime_ns_ = 0;
+    off_t loaded_size_ = 0;
+    uint64_t generation_ = 0;
+
+    bool load(std::unique_ptr<Image>& image, Strategy*& strategy, std::string& error);
+    void release();
+};
+
+} // namespace frontier
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "types.hpp"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace frontier {
+
+// Bits of SymbolState::flags
+struct SymbolFlags {
+    static constexpr uint32_t Halted = 1u << 0;        // No orders until resumed or halt_until_ns
+    static constexpr uint32_t BuyBlocked = 1u << 1;
+    static constexpr uint32_t SellBlocked = 1u << 2;
+    static constexpr uint32_t LimitState = 1u << 3;    // Last price outside the bands
+};
+
+enum class HaltReason : uint32_t {
+    None,
+    Admin,
+    LimitUpLimitDown,   // Limit state held past the LULD grace period
+    CircuitBreaker,     // VolatilityCircuitBreaker trip
+};
+
+enum class SymbolGate {
+    Ok,
+    Halted,
+    SideBlocked,
+    OutsideBand
+};
+
+const char* to_string(HaltReason reason);
+const char* to_string(SymbolGate gate);
+
+// Everything the order path needs about one symbol, in one cache line
+struct alignas(64) SymbolState {
+    uint32_t flags = 0;
+    HaltReason halt_reason = HaltReason::None;
+    double reference_price = 0.0;
+    double lower_band = 0.0;
+    double upper_band = 0.0;
+    double band_pct = 0.0;           // 0 disables the bands
+    int64_t reference_ns = 0;        // When the reference was last set
+    int64_t halt_until_ns = 0;       // 0 halts until resumed
+    int64_t limit_state_since_ns = 0;
+};
+static_assert(sizeof(SymbolState) == 64, "SymbolState must stay one cache line");
+
+// LULD-style configuration. Bands are reference * (1 -/+ band_pct); the
+// reference resets to the last price every reference_interval while the
+// symbol is inside its bands. A limit state lasting limit_state_grace
+// becomes a trading pause of pause_duration.
+struct PriceBandConfig {
+    double default_band_pct = 0.0;                   // Applied to symbols first seen on a tick
+    int64_t reference_interval_ns = 30'000'000'000;
+    int64_t limit_state_grace_ns = 15'000'000'000;
+    int64_t pause_duration_ns = 300'000'000'000;
+};
+
+// Per-symbol halts, side blocks and price bands. Symbols get a dense id the
+// first time they are seen; checks by id touch only that id's SymbolState.
+// Symbols never seen are tradable.
+class SymbolStateTable {
+public:
+    explicit SymbolStateTable(PriceBandConfig config = {}) : config_(config) {}
+
+    void set_config(const PriceBandConfig& config) { config_ = config; }
+    const PriceBandConfig& config() const { return config_; }
+
+    // Id for `symbol`, created on first use with the default band
+    uint32_t id(const std::string& symbol);
+    int64_t find(const std::string& symbol) const;
+    const SymbolState& state(uint32_t id) const { return states_[id]; }
+    const SymbolState* find_state(const std::string& symbol) const;
+    size_t size() const { return states_.size(); }
+
+    // Admin controls
+    void halt(const std::string& symbol, HaltReason reason, int64_t until_ns = 0) {
+        halt(id(symbol), reason, until_ns);
+    }
+    void halt(uint32_t id, HaltReason reason, int64_t until_ns = 0);
+    void resume(const std::string& symbol);
+    void set_flags(const std::string& symbol, uint32_t set, uint32_t clear);
+    // Band of 0 disables; a positive reference also re-centers the bands
+    void set_price_band(const std::string& symbol, double band_pct, double reference_price, int64_t now_ns);
+
+    // Moves the reference and limit state with the tick flow; may start a LULD pause
+    void on_tick(uint32_t id, double price, int64_t now_ns);
+    void on_tick(const std::string& symbol, double price, int64_t now_ns) { on_tick(id(symbol), price, now_ns); }
+
+    // Price 0 skips the band check
+    SymbolGate check(uint32_t id, Side side, double price, int64_t now_ns) const {
+        return check(states_[id], side, price, now_ns);
+    }
+    SymbolGate check(const std::string& symbol, Side side, double price, int64_t now_ns) const;
+
+    static SymbolGate check(const SymbolState& s, Side side, double price, int64_t now_ns) {
+        if ((s.flags & SymbolFlags::Halted) && (s.halt_until_ns == 0 || now_ns < s.halt_until_ns)) {
+            return SymbolGate::Halted;
+        }
+        if (s.flags & (side == Side::Buy ? SymbolFlags::BuyBlocked : SymbolFlags::SellBlocked)) {
+            return SymbolGate::SideBlocked;
+        }
+        if (s.band_pct > 0.0 && price > 0.0 && s.reference_price > 0.0 &&
+            (side == Side::Buy ? price > s.upper_band : price < s.lower_band)) {
+            return SymbolGate::OutsideBand;
+        }
+        return SymbolGate::Ok;
+    }
+
+private:
+    PriceBandConfig config_;
+    std::vector<SymbolState> states_;
+    std::unordered_map<std::string, uint32_t> index_;
+
+    static void recenter(SymbolState& s, double reference_price, int64_t now_ns);
+};
+
+} // namespace frontier
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace frontier {
+
+// Hashed timing wheel. Scheduling and cancelling are O(1); advance() only
+// visits the slots between the previous and the new time, so thousands of
+// pending timers cost nothing until they are due. Timers further out than
+// one revolution stay in their slot and are skipped until their round comes.
+// Not thread-safe: drive it from the thread that owns it.
+class TimerWheel {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+    using TimerId = uint64_t;
+    using ExpiryHandler = std::function<void(TimerId, uint64_t payload)>;
+
+    explicit TimerWheel(std::chrono::milliseconds resolution = std::chrono::milliseconds(100),
+                        size_t slot_count = 1024, TimePoint start = std::chrono::system_clock::now());
+
+    // Returns an id that stays unique even after the timer fires or is cancelled
+    TimerId schedule(TimePoint when, uint64_t payload);
+    bool cancel(TimerId id);
+
+    // Fire every timer due at or before `now`, in deadline-slot order. A
+    // handler may cancel a timer due in the same batch; it then does not fire.
+    size_t advance(TimePoint now, const ExpiryHandler& on_expire);
+
+    size_t pending() const { return pending_; }
+    TimePoint current_time() const { return to_time(current_tick_); }
+
+private:
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    struct Timer {
+        uint64_t deadline_tick = 0;
+        uint64_t payload = 0;
+        uint32_t generation = 0;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        bool active = false;
+        bool due = false;       // Collected by advance(), unlinked, handler not yet run
+    };
+    struct Due {
+        uint64_t deadline_tick;
+        uint32_t index;
+        uint32_t generation;    // A cancel from an earlier handler bumps it
+        bool operator<(const Due& other) const {
+            return deadline_tick != other.deadline_tick ? deadline_tick < other.deadline_tick : index < other.index;
+        }
+    };
+
+    std::chrono::milliseconds resolution_;
+    TimePoint origin_;
+    uint64_t current_tick_ = 0;
+    std::vector<uint32_t> slots_;     // Head timer index per slot
+    std::vector<Timer> timers_;       // Pool; ids encode index and generation
+    std::vector<uint32_t> free_list_;
+    std::vector<Due> due_;            // Scratch for advance()
+    size_t pending_ = 0;
+
+    uint64_t to_tick(TimePoint when) const;
+    TimePoint to_time(uint64_t tick) const;
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+};
+
+} // namespace frontier
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "types.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace frontier {
+
+enum class MarketSession : uint8_t {
+    Closed,
+    PreMarket,
+    Regular,
+    PostMarket
+};
+
+const char* to_string(MarketSession session);
+
+enum class DstRule {
+    None,
+    UnitedStates   // Second Sunday of March to first Sunday of November
+};
+
+enum class HolidayRule {
+    None,
+    NewYorkStockExchange   // Full closures plus the 13:00 early closes
+};
+
+// Weekly trading hours of a venue in its local time
+struct VenueHours {
+    std::string name;
+    int utc_offset_minutes = 0;        // Standard time
+    DstRule dst = DstRule::None;
+    bool always_open = false;          // 24/7, no holidays
+    // Regular session per weekday (Sunday = 0) as local [open, close)
+    // minutes; open == close is a closed day
+    std::array<std::pair<int, int>, 7> regular{};
+    int pre_open = -1;                 // Extended hours before the open, -1 for none
+    int post_close = -1;               // Extended hours after the close, -1 for none
+    int half_day_close = -1;           // Regular close on early-close days
+    HolidayRule holidays = HolidayRule::None;
+
+    static VenueHours us_equities();   // NYSE/Nasdaq 09:30-16:00 ET, 04:00-20:00 extended
+    static VenueHours crypto();
+    static VenueHours forex();         // Sunday 17:00 to Friday 17:00 ET
+};
+
+// One venue's sessions. Every minute of [first_day, first_day + days) UTC
+// is precomputed as a 2-bit MarketSession (about 130 KB per year), so
+// session() is a subtraction, a shift and a mask. Times outside the window
+// fall back to evaluating the rules, which is correct but slower.
+// Configure holidays before sharing the calendar across threads.
+class VenueCalendar {
+public:
+    using Clock = std::chrono::system_clock;
+
+    // Days since 1970-01-01 UTC
+    VenueCalendar(VenueHours hours, int64_t first_day, int64_t days);
+    // `years` either side of `center`
+    static std::shared_ptr<VenueCalendar> around(VenueHours hours, Clock::time_point center, int years = 1);
+
+    MarketSession session(Clock::time_point t) const;
+    bool is_open(Clock::time_point t, bool extended_hours = false) const;
+
+    // Ad hoc closures (e.g. a national day of mourning); rebuilds that day
+    void add_holiday(int year, unsigned month, unsigned day);
+    void add_half_day(int year, unsigned month, unsigned day);
+    bool is_trading_day(int year, unsigned month, unsigned day) const;
+
+    const VenueHours& hours() const { return hours_; }
+
+private:
+    struct Window {
+        int64_t start;                 // UTC minutes since the epoch
+        int64_t end;
+        MarketSession session;
+    };
+
+    VenueHours hours_;
+    std::set<int64_t> extra_holidays_;      // Local days
+    std::set<int64_t> extra_half_days_;
+    int64_t base_minute_ = 0;
+    int64_t minutes_ = 0;
+    std::vector<uint64_t> sessions_;        // 32 minutes per word
+
+    void mark_day(int64_t local_day, bool set);
+    void day_windows(int64_t local_day, std::vector<Window>& out) const;
+    MarketSession evaluate(int64_t minute) const;
+    bool is_holiday(int64_t local_day) const;
+    bool is_half_day(int64_t local_day) const;
+    int offset_minutes(int64_t local_day) const;
+};
+
+// Venue per asset class, indexed by AssetType so the lookup is an array
+// read. Asset classes without a venue are treated as always open.
+class TradingCalendar {
+public:
+    using Clock = std::chrono::system_clock;
+
+    // US equities for stocks, ETFs and options, 24/7 crypto, forex; futures unrestricted
+    static std::shared_ptr<TradingCalendar> standard(Clock::time_point center = Clock::now(), int years = 1);
+
+    void set_venue(AssetType type, std::shared_ptr<VenueCalendar> venue);
+    VenueCalendar* venue(AssetType type) const { return venues_[static_cast<size_t>(type)].get(); }
+
+    MarketSession session(AssetType type, Clock::time_point t) const;
+    bool is_open(AssetType type, Clock::time_point t, bool extended_hours = false) const;
+
+private:
+    std::array<std::shared_ptr<VenueCalendar>, 6> venues_{};
+};
+
+} // namespace frontier
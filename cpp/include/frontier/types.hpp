@@ -1,5 +1,7 @@
 #pragma once
 
+#include "decimal.hpp"
+#include <chrono>
 #include <string>
 #include <map>
 #include <vector>
@@ -20,13 +22,44 @@ enum class OrderType {
     Stop
 };
 
+enum class AssetType {
+    STOCK,
+    ETF,
+    CRYPTO,
+    FOREX,
+    FUTURES,
+    OPTIONS
+};
+
+// Decimal places quantities are kept to; finer fills round to this grid
+inline int32_t quantity_scale(AssetType type) {
+    switch (type) {
+        case AssetType::CRYPTO: return 8;
+        case AssetType::STOCK:
+        case AssetType::ETF: return 6;     // Fractional shares
+        case AssetType::FOREX: return 2;
+        case AssetType::FUTURES:
+        case AssetType::OPTIONS: return 0;  // Whole contracts
+    }
+    return 6;
+}
+
+constexpr int32_t kPriceScale = 8;  // Sub-cent crypto prices
+constexpr int32_t kMoneyScale = 8;  // Cost basis and P&L
+
 struct Position {
     std::string symbol;
-    double quantity = 0.0;
-    double average_price = 0.0;
+    AssetType asset_type = AssetType::STOCK;
+    Decimal quantity{0, quantity_scale(AssetType::STOCK)};  // Negative when short
+    Decimal cost_basis{0, kMoneyScale};  // Exact signed cost of the open quantity
+    double average_price = 0.0;          // cost_basis / quantity, for display
     double market_price = 0.0;  // Current market price for P&L calculation
-    double realized_pnl = 0.0;
-    double unrealized_pnl = 0.0;
+    Decimal realized_pnl{0, kMoneyScale};  // Includes borrow costs
+    Decimal unrealized_pnl{0, kMoneyScale};
+    Decimal borrow_cost{0, kMoneyScale};   // Accrued while short
+    std::chrono::system_clock::time_point borrow_accrued_until;
+    
+    bool is_short() const { return quantity.units < 0; }
     
     double market_value() const {
         return quantity * market_price;
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "broker_server.hpp"
+#include "types.hpp"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace frontier {
+
+// Latency in microseconds drawn per event. Spec strings, as accepted by
+// parse(): "fixed:50", "uniform:20,80", "normal:50,10" (mean, stddev),
+// "lognormal:50,0.5" (median, sigma) and "exp:50" (mean).
+struct LatencyDistribution {
+    enum class Kind { Fixed, Uniform, Normal, LogNormal, Exponential };
+
+    Kind kind = Kind::Fixed;
+    double a = 0.0;
+    double b = 0.0;
+
+    std::chrono::microseconds sample(std::mt19937_64& rng) const;
+
+    // Throws std::invalid_argument on a malformed spec or a normal/lognormal
+    // spread that is not positive
+    static LatencyDistribution parse(const std::string& spec);
+};
+
+// Top of book for one symbol. A size of 0 means unlimited liquidity.
+struct VenueTick {
+    std::string symbol;
+    double bid = 0.0;
+    double ask = 0.0;
+    double bid_size = 0.0;
+    double ask_size = 0.0;
+    double last = 0.0;
+};
+
+// Reads "symbol,bid,ask,bid_size,ask_size,last" lines; a header line and
+// lines starting with '#' are skipped. Throws std::runtime_error if the file
+// cannot be opened.
+std::vector<VenueTick> load_venue_ticks(const std::string& path);
+
+// Random-walk quotes for a fixed symbol list, emitted round robin
+class SyntheticTickSource {
+public:
+    SyntheticTickSource(std::vector<std::string> symbols, double start_price = 100.0, double volatility_bps = 5.0,
+                        double spread_bps = 2.0, double size = 500.0, uint64_t seed = 1);
+
+    VenueTick next();
+
+private:
+    std::vector<std::string> symbols_;
+    std::vector<double> mids_;
+    double volatility_;
+    double spread_;
+    double size_;
+    size_t cursor_ = 0;
+    std::mt19937_64 rng_;
+    std::normal_distribution<double> step_{0.0, 1.0};
+};
+
+// Exchange stand-in behind the same REST/WebSocket protocol the broker
+// adapters speak. Each symbol's book is the latest tick plus the orders
+// resting against it: marketable orders fill at the touch up to its
+// displayed size, the remainder of a limit order rests, and resting orders
+// fill in price-time priority when a later tick crosses them. Stop orders
+// trigger on the touch and fill as market orders. Acks and stream events are
+// released after latencies drawn from the configured distributions, and one
+// order's events never overtake each other.
+class VenueSimulator {
+public:
+    struct Config {
+        std::string host = "127.0.0.1";
+        uint16_t port = 0;                   // 0 picks a free port
+        LatencyDistribution ack_latency;     // Request to response and "new"
+        LatencyDistribution fill_latency;    // Match to fill report
+        uint64_t seed = 42;
+    };
+
+    explicit VenueSimulator(Config config);
+    VenueSimulator() : VenueSimulator(Config{}) {}
+
+    void start() { server_.start(); }
+    void stop() { server_.stop(); }
+    uint16_t port() const { return server_.port(); }
+
+    // Thread-safe; matches resting orders against the new quote
+    void on_tick(const VenueTick& tick);
+
+    size_t resting_orders() const;
+    uint64_t orders_received() const { return orders_received_.load(std::memory_order_relaxed); }
+    uint64_t fills_sent() const { return fills_sent_.load(std::memory_order_relaxed); }
+    size_t connection_count() const { return server_.connection_count(); }
+
+private:
+    using Clock = BrokerServer::Clock;
+
+    struct SimOrder {
+        std::string id;
+        std::string client_order_id;
+        std::string symbol;
+        Side side = Side::Buy;
+        OrderType type = OrderType::Market;
+        double quantity = 0.0;
+        double limit_price = 0.0;
+        double stop_price = 0.0;
+        double filled = 0.0;
+        double notional = 0.0;        // Sum of fill price * quantity
+        std::string status;
+        Clock::time_point last_event; // Keeps this order's events in order
+    };
+
+    // Price-time priority; equal keys keep insertion order
+    using BuyQueue = std::multimap<double, std::string, std::greater<double>>;
+    using SellQueue = std::multimap<double, std::string, std::less<double>>;
+
+    struct Book {
+        VenueTick quote;
+        bool has_quote = false;
+        double bid_available = 0.0;   // Quote size not yet taken this tick
+        double ask_available = 0.0;
+        BuyQueue bids;
+        SellQueue asks;
+        std::vector<std::string> stops;     // Untriggered
+        std::vector<std::string> pending;   // Market orders waiting for liquidity
+    };
+
+    Config config_;
+    BrokerServer server_;
+
+    mutable std::mutex mutex_;
+    std::mt19937_64 rng_;
+    std::unordered_map<std::string, Book> books_;
+    std::unordered_map<std::string, SimOrder> orders_;
+    uint64_t next_order_id_ = 1;
+
+    std::atomic<uint64_t> orders_received_{0};
+    std::atomic<uint64_t> fills_sent_{0};
+
+    void on_request(const wire::HttpMessage& request, BrokerServer::ResponseToken token);
+    void on_stream(uint64_t client, const std::string& message);
+    void submit(const wire::HttpMessage& request, BrokerServer::ResponseToken token, Clock::time_point at);
+    int cancel(const std::string& id, Clock::time_point at);
+
+    // Fills up to the displayed size at the touch; returns false if the order
+    // is not marketable against the current quote
+    bool take_liquidity(SimOrder& order, Book& book, Clock::time_point now);
+    bool triggered(const SimOrder& order, const Book& book) const;
+    void rest(SimOrder& order, Book& book);
+    void unrest(const SimOrder& order, Book& book);
+    void fill(SimOrder& order, double price, double quantity, Clock::time_point now);
+    void publish(const char* event, SimOrder& order, Clock::time_point at, double price = 0.0,
+                 double quantity = 0.0);
+};
+
+} // namespace frontier
@@ -0,0 +1,508 @@
+#include "frontier/alpaca_adapter.hpp"
+#include <nlohmann/json.hpp>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <cstdio>
+#include <poll.h>
+
+namespace frontier {
+
+namespace {
+
+constexpr int kIdlePollMs = 50;
+
+// Alpaca takes quantities and prices as decimal strings
+std::string format_number(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    return buffer;
+}
+
+double number_field(const nlohmann::json& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end() || it->is_null()) {
+        return 0.0;
+    }
+    if (it->is_string()) {
+        return std::strtod(it->get_ref<const std::string&>().c_str(), nullptr);
+    }
+    return it->is_number() ? it->get<double>() : 0.0;
+}
+
+std::string string_field(const nlohmann::json& object, const char* key) {
+    auto it = object.find(key);
+    return it != object.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+} // namespace
+
+AlpacaBrokerAdapter::AlpacaBrokerAdapter(AlpacaConfig config) : config_(std::move(config)) {
+    static std::atomic<int> instance_count{0};
+    logger_ = spdlog::stdout_color_mt("alpaca_adapter_" + std::to_string(instance_count++));
+    logger_->set_level(spdlog::level::info);
+
+    config_.pool_size = std::max<size_t>(config_.pool_size, 1);
+    config_.max_pipeline_depth = std::max<size_t>(config_.max_pipeline_depth, 1);
+    auth_headers_ = {{"APCA-API-KEY-ID", config_.key_id},
+                     {"APCA-API-SECRET-KEY", config_.secret_key},
+                     {"Content-Type", "application/json"}};
+}
+
+AlpacaBrokerAdapter::~AlpacaBrokerAdapter() {
+    stop();
+}
+
+bool AlpacaBrokerAdapter::start() {
+    if (running_.exchange(true)) {
+        return true;
+    }
+    pool_.clear();
+    pool_.resize(config_.pool_size);
+    thread_ = std::thread([this] { run(); });
+    logger_->info("Connecting to {}:{} with {} pooled connections", config_.host, config_.port, config_.pool_size);
+    return true;
+}
+
+void AlpacaBrokerAdapter::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    waker_.notify();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // Everything still pending fails here, on the stopping thread
+    for (auto& connection : pool_) {
+        fail(connection);
+    }
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        for (auto& request : submitted_) {
+            backlog_.push_back(std::move(request));
+        }
+        submitted_.clear();
+    }
+    for (auto& request : backlog_) {
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+        request.on_response(nullptr, 0);
+    }
+    backlog_.clear();
+    close_stream();
+}
+
+void AlpacaBrokerAdapter::set_execution_handler(BrokerExecutionHandler handler) {
+    std::lock_guard<std::mutex> lock(handler_mutex_);
+    execution_handler_ = std::move(handler);
+}
+
+void AlpacaBrokerAdapter::submit_order(const BrokerOrderRequest& order, BrokerAckHandler on_ack) {
+    std::string request =
+        wire::format_request("POST", config_.orders_path, config_.host, auth_headers_, encode_order(order));
+    enqueue(Request{std::move(request),
+                    [on_ack = std::move(on_ack), client_id = order.client_order_id](
+                        const wire::HttpMessage* response, int64_t latency_ns) {
+                        BrokerOrderAck ack;
+                        if (response) {
+                            ack = decode_ack(*response);
+                        } else {
+                            ack.error = "connection lost before the broker answered";
+                        }
+                        if (ack.client_order_id.empty()) {
+                            ack.client_order_id = client_id;
+                        }
+                        ack.latency_ns = latency_ns;
+                        on_ack(ack);
+                    },
+                    {}});
+}
+
+void AlpacaBrokerAdapter::cancel_order(const std::string& broker_order_id, BrokerCancelHandler on_result) {
+    std::string request = wire::format_request("DELETE", config_.orders_path + "/" + broker_order_id,
+                                               config_.host, auth_headers_, "");
+    enqueue(Request{std::move(request),
+                    [on_result = std::move(on_result), broker_order_id](const wire::HttpMessage* response,
+                                                                         int64_t) {
+                        BrokerCancelResult result;
+                        result.broker_order_id = broker_order_id;
+                        if (!response) {
+                            result.error = "connection lost before the broker answered";
+                        } else {
+                            result.http_status = response->status;
+                            result.accepted = response->status == 200 || response->status == 204;
+                            if (!result.accepted) {
+                                auto body = nlohmann::json::parse(response->body, nullptr, false);
+                                result.error = body.is_object() ? string_field(body, "message") : response->body;
+                            }
+                        }
+                        on_result(result);
+                    },
+                    {}});
+}
+
+void AlpacaBrokerAdapter::cancel_orders(const std::vector<std::string>& broker_order_ids,
+                                        BrokerBatchCancelHandler on_results) {
+    if (broker_order_ids.empty()) {
+        on_results({});
+        return;
+    }
+
+    // Fanned out as pipelined DELETEs across the pool; all results land on
+    // the I/O thread, so the shared state needs no lock
+    struct Batch {
+        std::vector<BrokerCancelResult> results;
+        size_t remaining;
+        BrokerBatchCancelHandler on_results;
+    };
+    auto batch = std::make_shared<Batch>(
+        Batch{std::vector<BrokerCancelResult>(broker_order_ids.size()), broker_order_ids.size(), std::move(on_results)});
+    for (size_t i = 0; i < broker_order_ids.size(); ++i) {
+        cancel_order(broker_order_ids[i], [batch, i](const BrokerCancelResult& result) {
+            batch->results[i] = result;
+            if (--batch->remaining == 0) {
+                batch->on_results(batch->results);
+            }
+        });
+    }
+}
+
+void AlpacaBrokerAdapter::enqueue(Request request) {
+    in_flight_.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        submitted_.push_back(std::move(request));
+    }
+    waker_.notify();
+}
+
+void AlpacaBrokerAdapter::run() {
+    std::vector<pollfd> fds;
+    std::vector<Request> incoming;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(submit_mutex_);
+            incoming.swap(submitted_);
+        }
+        for (auto& request : incoming) {
+            backlog_.push_back(std::move(request));
+        }
+        incoming.clear();
+
+        auto now = Clock::now();
+        for (auto& connection : pool_) {
+            if (connection.fd < 0 && now >= connection.retry_at) {
+                open(connection);
+            }
+        }
+        if (config_.enable_stream && stream_.fd < 0 && now >= stream_.retry_at) {
+            open_stream();
+        }
+        assign_backlog();
+
+        fds.clear();
+        fds.push_back({waker_.fd(), POLLIN, 0});
+        for (auto& connection : pool_) {
+            short events = POLLIN;
+            if (connection.connecting || connection.out_offset < connection.out.size()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({connection.fd, events, 0});  // Negative fds are ignored by poll
+        }
+        short stream_events = POLLIN;
+        if (stream_.state == StreamState::Connecting || stream_.out_offset < stream_.out.size()) {
+            stream_events |= POLLOUT;
+        }
+        fds.push_back({stream_.fd, stream_events, 0});
+
+        if (poll(fds.data(), fds.size(), kIdlePollMs) < 0) {
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            waker_.drain();
+        }
+
+        for (size_t i = 0; i < pool_.size(); ++i) {
+            Connection& connection = pool_[i];
+            short revents = fds[i + 1].revents;
+            if (connection.fd < 0 || revents == 0) {
+                continue;
+            }
+            if (connection.connecting) {
+                if (!wire::connect_finished(connection.fd)) {
+                    logger_->warn("Connection to {}:{} failed", config_.host, config_.port);
+                    fail(connection);
+                    continue;
+                }
+                connection.connecting = false;
+            }
+            if (revents & POLLIN) {
+                on_readable(connection);
+            }
+            if (connection.fd >= 0 && !wire::write_pending(connection.fd, connection.out, connection.out_offset)) {
+                fail(connection);
+            }
+            if (connection.fd >= 0 && connection.out_offset == connection.out.size()) {
+                connection.out.clear();
+                connection.out_offset = 0;
+            }
+        }
+
+        short revents = fds.back().revents;
+        if (stream_.fd >= 0 && revents != 0) {
+            if (stream_.state == StreamState::Connecting) {
+                if (!wire::connect_finished(stream_.fd)) {
+                    close_stream();
+                    continue;
+                }
+                stream_.state = StreamState::Handshake;
+                stream_.out += wire::format_request("GET", config_.stream_path, config_.host,
+                                                    {{"Upgrade", "websocket"},
+                                                     {"Connection", "Upgrade"},
+                                                     {"Sec-WebSocket-Key", wire::websocket_key()},
+                                                     {"Sec-WebSocket-Version", "13"}},
+                                                    "");
+            }
+            if (revents & POLLIN) {
+                on_stream_readable();
+            }
+            if (stream_.fd >= 0 && !wire::write_pending(stream_.fd, stream_.out, stream_.out_offset)) {
+                close_stream();
+            }
+        }
+    }
+}
+
+void AlpacaBrokerAdapter::assign_backlog() {
+    auto now = Clock::now();
+    while (!backlog_.empty()) {
+        Connection* target = nullptr;
+        for (auto& connection : pool_) {
+            if (connection.fd >= 0 && connection.in_flight.size() < config_.max_pipeline_depth &&
+                (!target || connection.in_flight.size() < target->in_flight.size())) {
+                target = &connection;
+            }
+        }
+        if (!target) {
+            return;  // Every pipeline is full or reconnecting
+        }
+        Request request = std::move(backlog_.front());
+        backlog_.pop_front();
+        target->out += request.bytes;
+        request.bytes.clear();
+        request.sent_at = now;
+        target->in_flight.push_back(std::move(request));
+        requests_sent_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AlpacaBrokerAdapter::open(Connection& connection) {
+    connection.fd = wire::tcp_connect(config_.host, config_.port);
+    if (connection.fd < 0) {
+        connection.retry_at = Clock::now() + config_.reconnect_delay;
+        return;
+    }
+    connection.connecting = true;
+}
+
+void AlpacaBrokerAdapter::on_readable(Connection& connection) {
+    std::string data;
+    bool open = wire::read_available(connection.fd, data);
+    connection.parser.feed(data.data(), data.size());
+
+    wire::HttpMessage response;
+    bool close_after = false;
+    while (connection.parser.next(response)) {
+        if (connection.in_flight.empty()) {
+            open = false;  // Unsolicited response: the stream is out of step
+            break;
+        }
+        Request request = std::move(connection.in_flight.front());
+        connection.in_flight.pop_front();
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+        auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - request.sent_at);
+        respond(request, &response, latency.count());
+
+        const std::string* connection_header = response.header("Connection");
+        if (connection_header && *connection_header == "close") {
+            close_after = true;
+            break;
+        }
+    }
+    if (!open || close_after || connection.parser.failed()) {
+        fail(connection);
+    }
+}
+
+void AlpacaBrokerAdapter::fail(Connection& connection) {
+    wire::close_fd(connection.fd);
+    connection.connecting = false;
+    connection.out.clear();
+    connection.out_offset = 0;
+    connection.parser.reset();
+    connection.retry_at = Clock::now() + config_.reconnect_delay;
+
+    auto failed = std::move(connection.in_flight);
+    connection.in_flight.clear();
+    for (auto& request : failed) {
+        in_flight_.fetch_sub(1, std::memory_order_relaxed);
+        respond(request, nullptr, 0);
+    }
+}
+
+// A throwing handler must not take down the I/O thread or the other requests
+void AlpacaBrokerAdapter::respond(Request& request, const wire::HttpMessage* response, int64_t latency_ns) {
+    try {
+        request.on_response(response, latency_ns);
+    } catch (const std::exception& e) {
+        logger_->error("Response handler failed: {}", e.what());
+    }
+}
+
+void AlpacaBrokerAdapter::open_stream() {
+    stream_.fd = wire::tcp_connect(config_.host, config_.port);
+    if (stream_.fd < 0) {
+        stream_.retry_at = Clock::now() + config_.reconnect_delay;
+        return;
+    }
+    stream_.state = StreamState::Connecting;
+}
+
+void AlpacaBrokerAdapter::on_stream_readable() {
+    std::string data;
+    bool open = wire::read_available(stream_.fd, data);
+
+    if (stream_.state == StreamState::Handshake) {
+        stream_.handshake.feed(data.data(), data.size());
+        wire::HttpMessage response;
+        if (!stream_.handshake.next(response)) {
+            if (!open || stream_.handshake.failed()) {
+                close_stream();
+            }
+            return;
+        }
+        if (response.status != 101) {
+            logger_->warn("Stream upgrade refused with HTTP {}", response.status);
+            close_stream();
+            return;
+        }
+        stream_.state = StreamState::Open;
+        data = stream_.handshake.take_remaining();
+        nlohmann::json auth = {{"action", "auth"}, {"key", config_.key_id}, {"secret", config_.secret_key}};
+        nlohmann::json listen = {{"action", "listen"}, {"data", {{"streams", {"trade_updates"}}}}};
+        stream_.out += wire::encode_frame(wire::WsOpcode::Text, auth.dump(), true);
+        stream_.out += wire::encode_frame(wire::WsOpcode::Text, listen.dump(), true);
+    }
+
+    stream_.parser.feed(data);
+    wire::WsFrame frame;
+    while (stream_.parser.next(frame)) {
+        switch (frame.opcode) {
+            case wire::WsOpcode::Text:
+            case wire::WsOpcode::Binary: {
+                BrokerExecutionReport report;
+                if (decode_trade_update(frame.payload, report)) {
+                    std::lock_guard<std::mutex> lock(handler_mutex_);
+                    if (execution_handler_) {
+                        try {
+                            execution_handler_(report);
+                        } catch (const std::exception& e) {
+                            logger_->error("Execution handler failed on order {}: {}", report.client_order_id,
+                                           e.what());
+                        }
+                    }
+                } else if (frame.payload.find("\"listening\"") != std::string::npos) {
+                    stream_ready_.store(true, std::memory_order_release);
+                }
+                break;
+            }
+            case wire::WsOpcode::Ping:
+                stream_.out += wire::encode_frame(wire::WsOpcode::Pong, frame.payload, true);
+                break;
+            case wire::WsOpcode::Close:
+                open = false;
+                break;
+            default:
+                break;
+        }
+    }
+    if (!open || stream_.parser.failed()) {
+        close_stream();
+    }
+}
+
+void AlpacaBrokerAdapter::close_stream() {
+    if (stream_.fd >= 0) {
+        logger_->warn("Trade update stream closed; reconnecting");
+    }
+    wire::close_fd(stream_.fd);
+    stream_.state = StreamState::Closed;
+    stream_.out.clear();
+    stream_.out_offset = 0;
+    stream_.handshake.reset();
+    stream_.parser = wire::WsParser();
+    stream_.retry_at = Clock::now() + config_.reconnect_delay;
+    stream_ready_.store(false, std::memory_order_release);
+}
+
+std::string AlpacaBrokerAdapter::encode_order(const BrokerOrderRequest& order) {
+    nlohmann::json body = {{"symbol", order.symbol},
+                           {"qty", format_number(order.quantity)},
+                           {"side", order.side == Side::Buy ? "buy" : "sell"},
+                           {"time_in_force", order.time_in_force}};
+    switch (order.type) {
+        case OrderType::Market:
+            body["type"] = "market";
+            break;
+        case OrderType::Limit:
+            body["type"] = "limit";
+            body["limit_price"] = format_number(order.limit_price);
+            break;
+        case OrderType::Stop:
+            body["type"] = "stop";
+            body["stop_price"] = format_number(order.stop_price);
+            break;
+    }
+    if (!order.client_order_id.empty()) {
+        body["client_order_id"] = order.client_order_id;
+    }
+    return body.dump();
+}
+
+BrokerOrderAck AlpacaBrokerAdapter::decode_ack(const wire::HttpMessage& response) {
+    BrokerOrderAck ack;
+    ack.http_status = response.status;
+    auto body = nlohmann::json::parse(response.body, nullptr, false);
+    if (response.status / 100 == 2 && body.is_object()) {
+        ack.accepted = true;
+        ack.broker_order_id = string_field(body, "id");
+        ack.client_order_id = string_field(body, "client_order_id");
+        ack.status = string_field(body, "status");
+    } else {
+        ack.error = body.is_object() ? string_field(body, "message") : response.body;
+    }
+    return ack;
+}
+
+bool AlpacaBrokerAdapter::decode_trade_update(const std::string& message, BrokerExecutionReport& report) {
+    auto json = nlohmann::json::parse(message, nullptr, false);
+    if (!json.is_object() || string_field(json, "stream") != "trade_updates" || !json.contains("data")) {
+        return false;
+    }
+    const auto& data = json["data"];
+    report.event = string_field(data, "event");
+    report.fill_price = number_field(data, "price");
+    report.fill_quantity = number_field(data, "qty");
+    if (auto order = data.find("order"); order != data.end() && order->is_object()) {
+        report.broker_order_id = string_field(*order, "id");
+        report.client_order_id = string_field(*order, "client_order_id");
+        report.symbol = string_field(*order, "symbol");
+        report.side = string_field(*order, "side") == "sell" ? Side::Sell : Side::Buy;
+        report.order_status = string_field(*order, "status");
+        report.filled_quantity = number_field(*order, "filled_qty");
+        report.average_fill_price = number_field(*order, "filled_avg_price");
+    }
+    return !report.event.empty();
+}
+
+} // namespace frontier
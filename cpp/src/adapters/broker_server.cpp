@@ -0,0 +1,325 @@
+#include "frontier/broker_server.hpp"
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <poll.h>
+
+namespace frontier {
+
+namespace {
+
+constexpr int kIdlePollMs = 50;
+
+} // namespace
+
+BrokerServer::BrokerServer(const std::string& name, std::string host, uint16_t port)
+    : host_(std::move(host)), port_(port) {
+    static std::atomic<int> instance_count{0};
+    logger_ = spdlog::stdout_color_mt(name + "_" + std::to_string(instance_count++));
+    logger_->set_level(spdlog::level::info);
+}
+
+BrokerServer::~BrokerServer() {
+    stop();
+}
+
+void BrokerServer::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    listen_fd_ = wire::tcp_listen(host_, port_, &port_);
+    thread_ = std::thread([this] { run(); });
+    logger_->info("Listening on {}:{}", host_, port_);
+}
+
+void BrokerServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    waker_.notify();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (auto& [id, connection] : connections_) {
+        wire::close_fd(connection->fd);
+    }
+    connections_.clear();
+    connection_count_ = 0;
+    wire::close_fd(listen_fd_);
+}
+
+void BrokerServer::respond(ResponseToken token, int status, std::string body, Clock::time_point at) {
+    post(Outbound{at, 0, token.connection, token.sequence, false,
+                  wire::format_response(status, wire::status_reason(status), body)});
+}
+
+void BrokerServer::send_stream(uint64_t client, std::string text, Clock::time_point at) {
+    post(Outbound{at, 0, client, 0, true, wire::encode_frame(wire::WsOpcode::Text, text, false)});
+}
+
+void BrokerServer::broadcast(std::string text, Clock::time_point at) {
+    post(Outbound{at, 0, 0, 0, true, wire::encode_frame(wire::WsOpcode::Text, text, false)});
+}
+
+void BrokerServer::post(Outbound item) {
+    {
+        std::lock_guard<std::mutex> lock(post_mutex_);
+        item.order = post_counter_++;
+        posted_.push_back(std::move(item));
+    }
+    if (std::this_thread::get_id() != thread_.get_id()) {
+        waker_.notify();
+    }
+}
+
+void BrokerServer::run() {
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    std::vector<Outbound> incoming;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> lock(post_mutex_);
+            incoming.swap(posted_);
+        }
+        for (auto& item : incoming) {
+            scheduled_.push(std::move(item));
+        }
+        incoming.clear();
+
+        // Deliver everything that is due; the rest sets the poll timeout
+        auto now = Clock::now();
+        while (!scheduled_.empty() && scheduled_.top().at <= now) {
+            Outbound item = std::move(const_cast<Outbound&>(scheduled_.top()));
+            scheduled_.pop();
+            deliver(item);
+        }
+        // One write per connection for everything delivered above
+        for (auto& [id, connection] : connections_) {
+            if (!connection->closing && connection->out_offset < connection->out.size() &&
+                !wire::write_pending(connection->fd, connection->out, connection->out_offset)) {
+                connection->closing = true;
+            }
+        }
+        int timeout = kIdlePollMs;
+        if (!scheduled_.empty()) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(scheduled_.top().at - now).count();
+            timeout = static_cast<int>(std::clamp<int64_t>(wait, 0, kIdlePollMs));
+        }
+        {
+            // Handlers answering inline post from this thread without waking it
+            std::lock_guard<std::mutex> lock(post_mutex_);
+            if (!posted_.empty()) {
+                timeout = 0;
+            }
+        }
+
+        fds.clear();
+        ids.clear();
+        fds.push_back({waker_.fd(), POLLIN, 0});
+        fds.push_back({listen_fd_, POLLIN, 0});
+        for (auto& [id, connection] : connections_) {
+            short events = POLLIN;
+            if (connection->out_offset < connection->out.size()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({connection->fd, events, 0});
+            ids.push_back(id);
+        }
+
+        if (poll(fds.data(), fds.size(), timeout) < 0) {
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            waker_.drain();
+        }
+        if (fds[1].revents & POLLIN) {
+            accept_connections();
+        }
+
+        for (size_t i = 0; i < ids.size(); ++i) {
+            auto it = connections_.find(ids[i]);
+            if (it == connections_.end()) {
+                continue;
+            }
+            Connection& connection = *it->second;
+            short revents = fds[i + 2].revents;
+            if (revents & POLLIN) {
+                on_readable(connection);
+            }
+            // A closing connection still gets its last answer (a 413 or close frame) written
+            if (revents & (POLLOUT | POLLIN)) {
+                if (!wire::write_pending(connection.fd, connection.out, connection.out_offset)) {
+                    connection.closing = true;
+                }
+            }
+            if (connection.out_offset == connection.out.size()) {
+                connection.out.clear();
+                connection.out_offset = 0;
+            }
+            if (connection.closing || (revents & (POLLERR | POLLHUP) && !(revents & POLLIN))) {
+                close_connection(ids[i]);
+            }
+        }
+    }
+}
+
+void BrokerServer::deliver(Outbound& item) {
+    if (item.stream) {
+        auto send = [&](Connection& connection) {
+            if (connection.stream) {
+                connection.out += item.payload;
+            }
+        };
+        if (item.connection == 0) {
+            for (auto& [id, connection] : connections_) {
+                send(*connection);
+            }
+        } else if (auto it = connections_.find(item.connection); it != connections_.end()) {
+            send(*it->second);
+        }
+        return;
+    }
+
+    auto it = connections_.find(item.connection);
+    if (it == connections_.end()) {
+        return;  // Client went away; nobody is waiting for this response
+    }
+    it->second->ready.emplace(item.sequence, std::move(item.payload));
+    flush_responses(*it->second);
+}
+
+void BrokerServer::flush_responses(Connection& connection) {
+    for (auto ready = connection.ready.find(connection.next_to_send); ready != connection.ready.end();
+         ready = connection.ready.find(connection.next_to_send)) {
+        connection.out += ready->second;
+        connection.ready.erase(ready);
+        ++connection.next_to_send;
+    }
+}
+
+void BrokerServer::accept_connections() {
+    while (true) {
+        int fd = wire::tcp_accept(listen_fd_);
+        if (fd < 0) {
+            return;
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->id = next_connection_id_++;
+        connection->fd = fd;
+        connections_.emplace(connection->id, std::move(connection));
+        connection_count_ = connections_.size();
+    }
+}
+
+void BrokerServer::on_readable(Connection& connection) {
+    std::string data;
+    if (!wire::read_available(connection.fd, data)) {
+        connection.closing = true;
+    }
+    if (data.empty()) {
+        return;
+    }
+
+    if (connection.stream) {
+        connection.stream_parser.feed(data);
+    } else {
+        connection.parser.feed(data.data(), data.size());
+        wire::HttpMessage request;
+        while (!connection.stream && connection.parser.next(request)) {
+            handle_request(connection, request);
+        }
+        if (connection.parser.failed()) {
+            if (connection.parser.too_large()) {
+                connection.out += wire::format_response(413, wire::status_reason(413), "", {{"Connection", "close"}});
+            }
+            connection.closing = true;
+            return;
+        }
+        if (!connection.stream) {
+            return;
+        }
+        connection.stream_parser.feed(connection.parser.take_remaining());
+    }
+
+    wire::WsFrame frame;
+    while (connection.stream_parser.next(frame)) {
+        switch (frame.opcode) {
+            case wire::WsOpcode::Text:
+            case wire::WsOpcode::Binary:
+                if (stream_handler_) {
+                    try {
+                        stream_handler_(connection.id, frame.payload);
+                    } catch (const std::exception& e) {
+                        logger_->error("Stream handler failed on connection {}: {}", connection.id, e.what());
+                        connection.out += wire::encode_frame(wire::WsOpcode::Close, wire::close_payload(1011), false);
+                        connection.closing = true;
+                        return;
+                    }
+                }
+                break;
+            case wire::WsOpcode::Ping:
+                connection.out += wire::encode_frame(wire::WsOpcode::Pong, frame.payload, false);
+                break;
+            case wire::WsOpcode::Close:
+                connection.out += wire::encode_frame(wire::WsOpcode::Close, "", false);
+                connection.closing = true;
+                break;
+            default:
+                break;
+        }
+    }
+    if (connection.stream_parser.failed()) {
+        uint16_t code = connection.stream_parser.too_large() ? 1009 : 1002;
+        connection.out += wire::encode_frame(wire::WsOpcode::Close, wire::close_payload(code), false);
+        connection.closing = true;
+    }
+}
+
+void BrokerServer::handle_request(Connection& connection, wire::HttpMessage& request) {
+    const std::string* upgrade_header = request.header("Upgrade");
+    if (upgrade_header && request.target == stream_path_) {
+        upgrade(connection, request);
+        return;
+    }
+
+    ResponseToken token{connection.id, connection.next_sequence++};
+    size_t depth = connection.next_sequence - connection.next_to_send;
+    if (depth > max_pipeline_depth_.load(std::memory_order_relaxed)) {
+        max_pipeline_depth_.store(depth, std::memory_order_relaxed);
+    }
+    if (request_handler_) {
+        try {
+            request_handler_(request, token);
+        } catch (const std::exception& e) {
+            // A throwing handler must not have answered the token yet
+            logger_->error("Request handler failed for {} {}: {}", request.method, request.target, e.what());
+            respond(token, 500, R"({"message":"internal error"})");
+        }
+    } else {
+        respond(token, 404, "");
+    }
+}
+
+void BrokerServer::upgrade(Connection& connection, const wire::HttpMessage& request) {
+    const std::string* key = request.header("Sec-WebSocket-Key");
+    if (!key) {
+        connection.out += wire::format_response(400, "Bad Request", "");
+        connection.closing = true;
+        return;
+    }
+    connection.out += "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: " + wire::websocket_accept(*key) + "\r\n\r\n";
+    connection.stream = true;
+}
+
+void BrokerServer::close_connection(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) {
+        return;
+    }
+    wire::close_fd(it->second->fd);
+    connections_.erase(it);
+    connection_count_ = connections_.size();
+}
+
+} // namespace frontier
@@ -0,0 +1,513 @@
+#include "frontier/http_wire.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace frontier {
+
+namespace wire {
+
+namespace {
+
+constexpr std::string_view kWebSocketGuid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+constexpr size_t kMaxHeaderBytes = 64 * 1024;
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+std::string base64(const unsigned char* data, size_t size) {
+    std::string out(4 * ((size + 2) / 3), '\0');
+    int written = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(out.data()), data, static_cast<int>(size));
+    out.resize(static_cast<size_t>(written));
+    return out;
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+void configure_socket(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+} // namespace
+
+const std::string* HttpMessage::header(std::string_view name) const {
+    for (const auto& [key, value] : headers) {
+        if (iequals(key, name)) {
+            return &value;
+        }
+    }
+    return nullptr;
+}
+
+bool HttpParser::next(HttpMessage& out) {
+    if (failed_) {
+        return false;
+    }
+    size_t header_end = buffer_.find("\r\n\r\n", offset_);
+    if (header_end == std::string::npos) {
+        if (buffer_.size() - offset_ > kMaxHeaderBytes) {
+            failed_ = true;
+        }
+        return false;
+    }
+
+    HttpMessage message;
+    std::string_view head(buffer_.data() + offset_, header_end - offset_);
+    size_t line_end = head.find("\r\n");
+    std::string_view start_line = head.substr(0, line_end);
+    size_t first_space = start_line.find(' ');
+    size_t second_space = start_line.find(' ', first_space + 1);
+    if (first_space == std::string_view::npos) {
+        failed_ = true;
+        return false;
+    }
+    if (requests_) {
+        message.method = std::string(start_line.substr(0, first_space));
+        message.target = std::string(start_line.substr(first_space + 1, second_space - first_space - 1));
+    } else {
+        message.status = std::atoi(std::string(start_line.substr(first_space + 1, 3)).c_str());
+        if (second_space != std::string_view::npos) {
+            message.reason = std::string(start_line.substr(second_space + 1));
+        }
+    }
+
+    size_t content_length = 0;
+    bool chunked = false;
+    size_t pos = line_end == std::string_view::npos ? head.size() : line_end + 2;
+    while (pos < head.size()) {
+        size_t end = head.find("\r\n", pos);
+        std::string_view line = head.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        size_t colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            auto name = trim(line.substr(0, colon));
+            auto value = trim(line.substr(colon + 1));
+            if (iequals(name, "Content-Length")) {
+                content_length = static_cast<size_t>(std::strtoull(std::string(value).c_str(), nullptr, 10));
+            } else if (iequals(name, "Transfer-Encoding") && value.find("chunked") != std::string_view::npos) {
+                chunked = true;
+            }
+            message.headers.emplace_back(std::string(name), std::string(value));
+        }
+        pos = end == std::string_view::npos ? head.size() : end + 2;
+    }
+
+    size_t body_start = header_end + 4;
+    size_t message_end;
+    if (chunked) {
+        if (!decode_chunked(body_start, message.body, message_end)) {
+            return false;
+        }
+    } else {
+        if (content_length > max_body_) {
+            return fail_too_large();
+        }
+        if (buffer_.size() - body_start < content_length) {
+            return false;
+        }
+        message.body.assign(buffer_, body_start, content_length);
+        message_end = body_start + content_length;
+    }
+
+    out = std::move(message);
+    offset_ = message_end;
+    if (offset_ == buffer_.size()) {
+        buffer_.clear();
+        offset_ = 0;
+    } else if (offset_ > 64 * 1024) {
+        buffer_.erase(0, offset_);
+        offset_ = 0;
+    }
+    return true;
+}
+
+bool HttpParser::fail_too_large() {
+    failed_ = true;
+    too_large_ = true;
+    return false;
+}
+
+bool HttpParser::decode_chunked(size_t start, std::string& body, size_t& end) {
+    size_t pos = start;
+    while (true) {
+        size_t line_end = buffer_.find("\r\n", pos);
+        if (line_end == std::string::npos) {
+            if (buffer_.size() - pos > kMaxHeaderBytes) {
+                failed_ = true;
+            }
+            return false;
+        }
+        size_t size = std::strtoull(buffer_.substr(pos, line_end - pos).c_str(), nullptr, 16);
+        pos = line_end + 2;
+        if (size > max_body_ - body.size()) {
+            return fail_too_large();
+        }
+        if (size == 0) {
+            // No trailers are expected; the terminating blank line ends the message
+            size_t trailer_end = buffer_.find("\r\n", pos);
+            if (trailer_end == std::string::npos) {
+                return false;
+            }
+            end = trailer_end + 2;
+            return true;
+        }
+        if (buffer_.size() < pos + size + 2) {
+            return false;
+        }
+        body.append(buffer_, pos, size);
+        pos += size + 2;
+    }
+}
+
+std::string HttpParser::take_remaining() {
+    std::string rest = buffer_.substr(offset_);
+    reset();
+    return rest;
+}
+
+void HttpParser::reset() {
+    buffer_.clear();
+    offset_ = 0;
+    failed_ = false;
+    too_large_ = false;
+}
+
+std::string format_request(std::string_view method, std::string_view target, std::string_view host,
+                           const Headers& headers, std::string_view body) {
+    std::string out;
+    out.reserve(128 + body.size());
+    out.append(method).append(" ").append(target).append(" HTTP/1.1\r\nHost: ").append(host).append("\r\n");
+    for (const auto& [name, value] : headers) {
+        out.append(name).append(": ").append(value).append("\r\n");
+    }
+    if (!body.empty() || method == "POST" || method == "PUT" || method == "PATCH") {
+        out.append("Content-Length: ").append(std::to_string(body.size())).append("\r\n");
+    }
+    out.append("\r\n").append(body);
+    return out;
+}
+
+std::string format_response(int status, std::string_view reason, std::string_view body, const Headers& headers) {
+    std::string out;
+    out.reserve(128 + body.size());
+    out.append("HTTP/1.1 ").append(std::to_string(status)).append(" ").append(reason).append("\r\n");
+    for (const auto& [name, value] : headers) {
+        out.append(name).append(": ").append(value).append("\r\n");
+    }
+    if (!body.empty()) {
+        out.append("Content-Type: application/json\r\n");
+    }
+    out.append("Content-Length: ").append(std::to_string(body.size())).append("\r\n\r\n").append(body);
+    return out;
+}
+
+std::string_view status_reason(int status) {
+    switch (status) {
+        case 101: return "Switching Protocols";
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 207: return "Multi-Status";
+        case 400: return "Bad Request";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 413: return "Payload Too Large";
+        case 422: return "Unprocessable Entity";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        default: return status < 400 ? "OK" : "Error";
+    }
+}
+
+// ---- WebSocket ----
+
+std::string websocket_key() {
+    static thread_local std::mt19937_64 rng{std::random_device{}()};
+    unsigned char nonce[16];
+    for (size_t i = 0; i < sizeof(nonce); i += 8) {
+        uint64_t bits = rng();
+        std::memcpy(nonce + i, &bits, 8);
+    }
+    return base64(nonce, sizeof(nonce));
+}
+
+std::string websocket_accept(std::string_view key) {
+    std::string material = std::string(key) + std::string(kWebSocketGuid);
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA1(reinterpret_cast<const unsigned char*>(material.data()), material.size(), digest);
+    return base64(digest, sizeof(digest));
+}
+
+std::string encode_frame(WsOpcode opcode, std::string_view payload, bool mask) {
+    std::string frame;
+    frame.reserve(payload.size() + 14);
+    frame.push_back(static_cast<char>(0x80 | static_cast<uint8_t>(opcode)));
+    uint8_t mask_bit = mask ? 0x80 : 0x00;
+    if (payload.size() < 126) {
+        frame.push_back(static_cast<char>(mask_bit | payload.size()));
+    } else if (payload.size() <= 0xFFFF) {
+        frame.push_back(static_cast<char>(mask_bit | 126));
+        frame.push_back(static_cast<char>(payload.size() >> 8));
+        frame.push_back(static_cast<char>(payload.size() & 0xFF));
+    } else {
+        frame.push_back(static_cast<char>(mask_bit | 127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame.push_back(static_cast<char>((static_cast<uint64_t>(payload.size()) >> shift) & 0xFF));
+        }
+    }
+
+    if (!mask) {
+        frame.append(payload);
+        return frame;
+    }
+    static thread_local std::mt19937 rng{std::random_device{}()};
+    uint32_t key = rng();
+    char key_bytes[4];
+    std::memcpy(key_bytes, &key, 4);
+    frame.append(key_bytes, 4);
+    size_t start = frame.size();
+    frame.append(payload);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        frame[start + i] ^= key_bytes[i & 3];
+    }
+    return frame;
+}
+
+std::string close_payload(uint16_t code) {
+    return std::string{static_cast<char>(code >> 8), static_cast<char>(code & 0xFF)};
+}
+
+bool WsParser::next(WsFrame& out) {
+    while (!failed_) {
+        size_t available = buffer_.size() - offset_;
+        if (available < 2) {
+            return false;
+        }
+        const auto* bytes = reinterpret_cast<const uint8_t*>(buffer_.data() + offset_);
+        bool fin = (bytes[0] & 0x80) != 0;
+        auto opcode = static_cast<WsOpcode>(bytes[0] & 0x0F);
+        bool masked = (bytes[1] & 0x80) != 0;
+        uint64_t length = bytes[1] & 0x7F;
+        size_t header = 2;
+        if (length == 126) {
+            if (available < 4) return false;
+            length = (static_cast<uint64_t>(bytes[2]) << 8) | bytes[3];
+            header = 4;
+        } else if (length == 127) {
+            if (available < 10) return false;
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = (length << 8) | bytes[2 + i];
+            }
+            header = 10;
+        }
+        bool control = static_cast<uint8_t>(opcode) >= 0x8;
+        size_t held = control || opcode != WsOpcode::Continuation ? 0 : partial_.payload.size();
+        if ((control && length > 125) || length > max_message_ - held) {
+            failed_ = true;  // Refused before buffering the payload
+            too_large_ = !control;
+            return false;
+        }
+        size_t mask_offset = header;
+        if (masked) {
+            header += 4;
+        }
+        if (available < header + length) {
+            return false;
+        }
+
+        std::string payload(buffer_, offset_ + header, static_cast<size_t>(length));
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); ++i) {
+                payload[i] ^= static_cast<char>(bytes[mask_offset + (i & 3)]);
+            }
+        }
+        // Drop the consumed frame so a slow trickle of frames cannot grow the buffer
+        buffer_.erase(0, offset_ + header + static_cast<size_t>(length));
+        offset_ = 0;
+
+        if (control) {
+            out = WsFrame{opcode, true, std::move(payload)};
+            return true;
+        }
+        if (opcode == WsOpcode::Continuation) {
+            if (!in_message_) {
+                failed_ = true;
+                return false;
+            }
+            partial_.payload += payload;
+        } else {
+            partial_ = WsFrame{opcode, fin, std::move(payload)};
+            in_message_ = true;
+        }
+        if (fin) {
+            in_message_ = false;
+            partial_.fin = true;
+            out = std::move(partial_);
+            partial_ = WsFrame();
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---- Sockets ----
+
+int tcp_connect(const std::string& host, uint16_t port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || !result) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* ai = result; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        configure_socket(fd);
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0 || errno == EINPROGRESS) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+    return fd;
+}
+
+bool connect_finished(int fd) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    return getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+}
+
+int tcp_listen(const std::string& host, uint16_t port, uint16_t* bound_port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        throw_errno("socket");
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        close(fd);
+        throw std::invalid_argument("listen address must be an IPv4 literal: " + host);
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, 128) != 0) {
+        int saved = errno;
+        close(fd);
+        errno = saved;
+        throw_errno("bind " + host + ":" + std::to_string(port));
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+    if (bound_port) {
+        *bound_port = ntohs(address.sin_port);
+    }
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    return fd;
+}
+
+int tcp_accept(int listen_fd) {
+    int fd = accept(listen_fd, nullptr, nullptr);
+    if (fd >= 0) {
+        configure_socket(fd);
+    }
+    return fd;
+}
+
+void close_fd(int& fd) {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+bool read_available(int fd, std::string& into) {
+    char chunk[16 * 1024];
+    while (true) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            into.append(chunk, static_cast<size_t>(n));
+            if (static_cast<size_t>(n) < sizeof(chunk)) {
+                return true;
+            }
+            continue;
+        }
+        if (n == 0) {
+            return false;
+        }
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+}
+
+bool write_pending(int fd, const std::string& data, size_t& offset) {
+    while (offset < data.size()) {
+        ssize_t n = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            offset += static_cast<size_t>(n);
+            continue;
+        }
+        return n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+    }
+    return true;
+}
+
+Waker::Waker() : fd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+    if (fd_ < 0) {
+        throw_errno("eventfd");
+    }
+}
+
+Waker::~Waker() {
+    close_fd(fd_);
+}
+
+void Waker::notify() {
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = write(fd_, &one, sizeof(one));
+}
+
+void Waker::drain() {
+    uint64_t count;
+    [[maybe_unused]] ssize_t n = read(fd_, &count, sizeof(count));
+}
+
+} // namespace wire
+
+} // namespace frontier
@@ -0,0 +1,150 @@
+#include "frontier/mock_broker.hpp"
+#include <nlohmann/json.hpp>
+
+namespace frontier {
+
+namespace {
+
+constexpr std::string_view kOrdersPath = "/v2/orders";
+
+nlohmann::json order_json(const std::string& id, const std::string& client_order_id, const std::string& symbol,
+                          const std::string& side, const std::string& type, const std::string& quantity,
+                          const std::string& status, const std::string& filled, const std::string& average) {
+    return {{"id", id},         {"client_order_id", client_order_id},
+            {"symbol", symbol}, {"side", side},
+            {"type", type},     {"qty", quantity},
+            {"status", status}, {"filled_qty", filled},
+            {"filled_avg_price", average.empty() ? nlohmann::json(nullptr) : nlohmann::json(average)}};
+}
+
+} // namespace
+
+MockBrokerServer::MockBrokerServer(Config config)
+    : config_(std::move(config)), server_("mock_broker", config_.host, config_.port) {
+    server_.set_request_handler([this](const wire::HttpMessage& request, BrokerServer::ResponseToken token) {
+        on_request(request, token);
+    });
+    server_.set_stream_handler([this](uint64_t client, const std::string& message) { on_stream(client, message); });
+}
+
+void MockBrokerServer::on_request(const wire::HttpMessage& request, BrokerServer::ResponseToken token) {
+    auto at = BrokerServer::Clock::now() + config_.ack_latency;
+    std::string_view target = request.target;
+
+    if (request.method == "POST" && target == kOrdersPath) {
+        submit(request, token);
+        return;
+    }
+    if (request.method == "DELETE" && target == kOrdersPath) {
+        // Cancel all: one status per open order
+        nlohmann::json results = nlohmann::json::array();
+        std::vector<std::string> open;
+        for (const auto& [id, order] : orders_) {
+            if (order.status == "accepted") {
+                open.push_back(id);
+            }
+        }
+        for (const auto& id : open) {
+            results.push_back({{"id", id}, {"status", cancel(id, at)}});
+        }
+        server_.respond(token, 207, results.dump(), at);
+        return;
+    }
+    if (target.size() > kOrdersPath.size() + 1 && target.substr(0, kOrdersPath.size()) == kOrdersPath) {
+        std::string id(target.substr(kOrdersPath.size() + 1));
+        if (request.method == "DELETE") {
+            int status = cancel(id, at);
+            server_.respond(token, status, status == 204 ? "" : R"({"message":"order is not cancelable"})", at);
+            return;
+        }
+        auto it = orders_.find(id);
+        if (request.method == "GET" && it != orders_.end()) {
+            const auto& order = it->second;
+            bool filled = order.status == "filled";
+            server_.respond(token, 200,
+                            order_json(order.id, order.client_order_id, order.symbol, order.side, order.type,
+                                       order.quantity, order.status, filled ? order.quantity : "0",
+                                       filled ? std::to_string(config_.fill_price) : "")
+                                .dump(),
+                            at);
+            return;
+        }
+    }
+    server_.respond(token, 404, R"({"message":"not found"})", at);
+}
+
+void MockBrokerServer::submit(const wire::HttpMessage& request, BrokerServer::ResponseToken token) {
+    auto at = BrokerServer::Clock::now() + config_.ack_latency;
+    orders_received_.fetch_add(1, std::memory_order_relaxed);
+
+    auto body = nlohmann::json::parse(request.body, nullptr, false);
+    if (body.is_discarded() || !body.contains("symbol") || !body.contains("qty") || !body.contains("side")) {
+        server_.respond(token, 422, R"({"message":"invalid order"})", at);
+        return;
+    }
+
+    MockOrder order;
+    order.id = "mock-" + std::to_string(next_order_id_++);
+    order.client_order_id = body.value("client_order_id", "");
+    order.symbol = body["symbol"].get<std::string>();
+    order.side = body["side"].get<std::string>();
+    order.type = body.value("type", "market");
+    order.quantity = body["qty"].is_string() ? body["qty"].get<std::string>() : body["qty"].dump();
+    order.status = "accepted";
+
+    server_.respond(token, 200,
+                    order_json(order.id, order.client_order_id, order.symbol, order.side, order.type, order.quantity,
+                               order.status, "0", "")
+                        .dump(),
+                    at);
+    publish("new", order, at);
+
+    if (config_.fill_market_orders && order.type == "market") {
+        order.status = "filled";
+        publish("fill", order, at);
+    }
+    orders_.emplace(order.id, std::move(order));
+}
+
+int MockBrokerServer::cancel(const std::string& id, BrokerServer::Clock::time_point at) {
+    cancels_received_.fetch_add(1, std::memory_order_relaxed);
+    auto it = orders_.find(id);
+    if (it == orders_.end()) {
+        return 404;
+    }
+    if (it->second.status != "accepted") {
+        return 422;
+    }
+    it->second.status = "canceled";
+    publish("canceled", it->second, at);
+    return 204;
+}
+
+void MockBrokerServer::publish(const char* event, const MockOrder& order, BrokerServer::Clock::time_point at) {
+    bool fill = std::string_view(event) == "fill";
+    std::string price = std::to_string(config_.fill_price);
+    nlohmann::json data = {{"event", event},
+                           {"order", order_json(order.id, order.client_order_id, order.symbol, order.side,
+                                                order.type, order.quantity, order.status,
+                                                fill ? order.quantity : "0", fill ? price : "")}};
+    if (fill) {
+        data["price"] = price;
+        data["qty"] = order.quantity;
+    }
+    server_.broadcast(nlohmann::json{{"stream", "trade_updates"}, {"data", data}}.dump(), at);
+}
+
+void MockBrokerServer::on_stream(uint64_t client, const std::string& message) {
+    auto request = nlohmann::json::parse(message, nullptr, false);
+    if (request.is_discarded()) {
+        return;
+    }
+    std::string action = request.value("action", "");
+    if (action == "auth" || action == "authenticate") {
+        server_.send_stream(client, R"({"stream":"authorization","data":{"status":"authorized","action":"authenticate"}})");
+    } else if (action == "listen") {
+        server_.send_stream(client, R"({"stream":"listening","data":{"streams":["trade_updates"]}})");
+    }
+}
+
+} // namespace frontier
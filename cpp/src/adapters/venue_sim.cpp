@@ -0,0 +1,478 @@
+#include "frontier/venue_sim.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+namespace frontier {
+
+namespace {
+
+constexpr std::string_view kOrdersPath = "/v2/orders";
+
+std::string format_number(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+    return buffer;
+}
+
+double number_field(const nlohmann::json& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end() || it->is_null()) {
+        return 0.0;
+    }
+    if (it->is_string()) {
+        return std::strtod(it->get_ref<const std::string&>().c_str(), nullptr);
+    }
+    return it->is_number() ? it->get<double>() : 0.0;
+}
+
+// Optional string field: `fallback` when absent or null, nullopt when it has another type
+std::optional<std::string> string_field(const nlohmann::json& object, const char* key, const char* fallback) {
+    auto it = object.find(key);
+    if (it == object.end() || it->is_null()) {
+        return std::string(fallback);
+    }
+    if (!it->is_string()) {
+        return std::nullopt;
+    }
+    return it->get<std::string>();
+}
+
+double round_cents(double price) {
+    return std::round(price * 100.0) / 100.0;
+}
+
+bool is_open(const std::string& status) {
+    return status == "new" || status == "partially_filled";
+}
+
+// Alpaca order object; quantities and prices as decimal strings
+template <typename Order>
+nlohmann::json order_json(const Order& order) {
+    static constexpr const char* kTypes[] = {"market", "limit", "stop"};
+    nlohmann::json json = {
+        {"id", order.id},
+        {"client_order_id", order.client_order_id},
+        {"symbol", order.symbol},
+        {"side", order.side == Side::Buy ? "buy" : "sell"},
+        {"type", kTypes[static_cast<int>(order.type)]},
+        {"qty", format_number(order.quantity)},
+        {"status", order.status},
+        {"filled_qty", format_number(order.filled)},
+        {"filled_avg_price",
+         order.filled > 0.0 ? nlohmann::json(format_number(order.notional / order.filled)) : nlohmann::json()}};
+    if (order.type == OrderType::Limit) {
+        json["limit_price"] = format_number(order.limit_price);
+    } else if (order.type == OrderType::Stop) {
+        json["stop_price"] = format_number(order.stop_price);
+    }
+    return json;
+}
+
+} // namespace
+
+std::chrono::microseconds LatencyDistribution::sample(std::mt19937_64& rng) const {
+    double value = a;
+    switch (kind) {
+        case Kind::Fixed:
+            break;
+        case Kind::Uniform:
+            value = std::uniform_real_distribution<double>(a, std::max(a, b))(rng);
+            break;
+        case Kind::Normal:
+            value = std::normal_distribution<double>(a, b)(rng);
+            break;
+        case Kind::LogNormal:
+            value = a > 0.0 ? std::lognormal_distribution<double>(std::log(a), b)(rng) : 0.0;
+            break;
+        case Kind::Exponential:
+            value = a > 0.0 ? std::exponential_distribution<double>(1.0 / a)(rng) : 0.0;
+            break;
+    }
+    return std::chrono::microseconds(std::llround(std::max(value, 0.0)));
+}
+
+LatencyDistribution LatencyDistribution::parse(const std::string& spec) {
+    std::string name = spec;
+    std::vector<double> params;
+    if (auto colon = spec.find(':'); colon != std::string::npos) {
+        name = spec.substr(0, colon);
+        std::stringstream rest(spec.substr(colon + 1));
+        std::string field;
+        while (std::getline(rest, field, ',')) {
+            char* end = nullptr;
+            double value = std::strtod(field.c_str(), &end);
+            if (field.empty() || *end != '\0') {
+                throw std::invalid_argument("Bad latency parameter '" + field + "' in '" + spec + "'");
+            }
+            params.push_back(value);
+        }
+    } else {
+        // A bare number is a fixed latency
+        char* end = nullptr;
+        double value = std::strtod(spec.c_str(), &end);
+        if (!spec.empty() && *end == '\0') {
+            return LatencyDistribution{Kind::Fixed, value, 0.0};
+        }
+    }
+
+    LatencyDistribution distribution;
+    size_t expected = 1;
+    if (name == "fixed") {
+        distribution.kind = Kind::Fixed;
+    } else if (name == "uniform") {
+        distribution.kind = Kind::Uniform;
+        expected = 2;
+    } else if (name == "normal") {
+        distribution.kind = Kind::Normal;
+        expected = 2;
+    } else if (name == "lognormal") {
+        distribution.kind = Kind::LogNormal;
+        expected = 2;
+    } else if (name == "exp" || name == "exponential") {
+        distribution.kind = Kind::Exponential;
+    } else {
+        throw std::invalid_argument("Unknown latency distribution '" + name + "'");
+    }
+    if (params.size() != expected) {
+        throw std::invalid_argument("Latency distribution '" + name + "' takes " + std::to_string(expected) +
+                                    " parameter(s)");
+    }
+    distribution.a = params[0];
+    distribution.b = expected > 1 ? params[1] : 0.0;
+    // The standard distributions are undefined for a spread that is not positive
+    bool spread = distribution.kind == Kind::Normal || distribution.kind == Kind::LogNormal;
+    if (spread && !(distribution.b > 0.0)) {
+        throw std::invalid_argument("Latency distribution '" + name + "' needs a positive spread, got '" + spec + "'");
+    }
+    return distribution;
+}
+
+std::vector<VenueTick> load_venue_ticks(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open tick file " + path);
+    }
+    std::vector<VenueTick> ticks;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#' || line.rfind("symbol", 0) == 0) {
+            continue;
+        }
+        std::stringstream fields(line);
+        std::string symbol;
+        std::getline(fields, symbol, ',');
+        double values[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        std::string field;
+        size_t count = 0;
+        while (count < 5 && std::getline(fields, field, ',')) {
+            values[count++] = std::strtod(field.c_str(), nullptr);
+        }
+        if (symbol.empty() || count < 2) {
+            continue;
+        }
+        VenueTick tick{symbol, values[0], values[1], values[2], values[3], values[4]};
+        if (tick.last <= 0.0) {
+            tick.last = (tick.bid + tick.ask) / 2.0;
+        }
+        ticks.push_back(std::move(tick));
+    }
+    return ticks;
+}
+
+SyntheticTickSource::SyntheticTickSource(std::vector<std::string> symbols, double start_price, double volatility_bps,
+                                         double spread_bps, double size, uint64_t seed)
+    : symbols_(std::move(symbols)), mids_(symbols_.size(), start_price), volatility_(volatility_bps / 10000.0),
+      spread_(spread_bps / 10000.0), size_(size), rng_(seed) {
+    if (symbols_.empty()) {
+        throw std::invalid_argument("SyntheticTickSource needs at least one symbol");
+    }
+}
+
+VenueTick SyntheticTickSource::next() {
+    size_t index = cursor_++ % symbols_.size();
+    double& mid = mids_[index];
+    mid *= std::exp(volatility_ * step_(rng_));
+    double half = std::max(mid * spread_ / 2.0, 0.005);
+
+    VenueTick tick;
+    tick.symbol = symbols_[index];
+    tick.bid = round_cents(mid - half);
+    tick.ask = std::max(round_cents(mid + half), tick.bid + 0.01);
+    tick.bid_size = size_;
+    tick.ask_size = size_;
+    tick.last = round_cents(mid);
+    return tick;
+}
+
+VenueSimulator::VenueSimulator(Config config)
+    : config_(std::move(config)), server_("venue_sim", config_.host, config_.port), rng_(config_.seed) {
+    server_.set_request_handler([this](const wire::HttpMessage& request, BrokerServer::ResponseToken token) {
+        on_request(request, token);
+    });
+    server_.set_stream_handler([this](uint64_t client, const std::string& message) { on_stream(client, message); });
+}
+
+size_t VenueSimulator::resting_orders() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (const auto& [symbol, book] : books_) {
+        count += book.bids.size() + book.asks.size() + book.stops.size() + book.pending.size();
+    }
+    return count;
+}
+
+void VenueSimulator::on_request(const wire::HttpMessage& request, BrokerServer::ResponseToken token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto at = Clock::now() + config_.ack_latency.sample(rng_);
+    std::string_view target = request.target;
+
+    if (request.method == "POST" && target == kOrdersPath) {
+        submit(request, token, at);
+        return;
+    }
+    if (request.method == "DELETE" && target == kOrdersPath) {
+        nlohmann::json results = nlohmann::json::array();
+        std::vector<std::string> open;
+        for (const auto& [id, order] : orders_) {
+            if (is_open(order.status)) {
+                open.push_back(id);
+            }
+        }
+        for (const auto& id : open) {
+            results.push_back({{"id", id}, {"status", cancel(id, at)}});
+        }
+        server_.respond(token, 207, results.dump(), at);
+        return;
+    }
+    if (target.size() > kOrdersPath.size() + 1 && target.substr(0, kOrdersPath.size()) == kOrdersPath) {
+        std::string id(target.substr(kOrdersPath.size() + 1));
+        if (request.method == "DELETE") {
+            int status = cancel(id, at);
+            server_.respond(token, status, status == 204 ? "" : R"({"message":"order is not cancelable"})", at);
+            return;
+        }
+        auto it = orders_.find(id);
+        if (request.method == "GET" && it != orders_.end()) {
+            server_.respond(token, 200, order_json(it->second).dump(), at);
+            return;
+        }
+    }
+    server_.respond(token, 404, R"({"message":"not found"})", at);
+}
+
+void VenueSimulator::submit(const wire::HttpMessage& request, BrokerServer::ResponseToken token,
+                            Clock::time_point at) {
+    orders_received_.fetch_add(1, std::memory_order_relaxed);
+
+    // Every field is type-checked: a malformed body gets a 422, never an exception
+    auto body = nlohmann::json::parse(request.body, nullptr, false);
+    if (!body.is_object()) {
+        server_.respond(token, 422, R"({"message":"invalid order"})", at);
+        return;
+    }
+    auto type = string_field(body, "type", "market");
+    auto symbol = string_field(body, "symbol", "");
+    auto side = string_field(body, "side", "");
+    auto client_order_id = string_field(body, "client_order_id", "");
+    double quantity = number_field(body, "qty");
+    double limit_price = number_field(body, "limit_price");
+    double stop_price = number_field(body, "stop_price");
+    bool valid = type && symbol && !symbol->empty() && side && (*side == "buy" || *side == "sell") &&
+                 client_order_id && std::isfinite(quantity) && quantity > 0.0 && std::isfinite(limit_price) &&
+                 std::isfinite(stop_price) &&
+                 (*type == "market" || (*type == "limit" && limit_price > 0.0) ||
+                  (*type == "stop" && stop_price > 0.0));
+    if (!valid) {
+        server_.respond(token, 422, R"({"message":"invalid order"})", at);
+        return;
+    }
+
+    SimOrder order;
+    order.id = "sim-" + std::to_string(next_order_id_++);
+    order.client_order_id = std::move(*client_order_id);
+    order.symbol = std::move(*symbol);
+    order.side = *side == "sell" ? Side::Sell : Side::Buy;
+    order.type = *type == "limit" ? OrderType::Limit : *type == "stop" ? OrderType::Stop : OrderType::Market;
+    order.quantity = quantity;
+    order.limit_price = limit_price;
+    order.stop_price = stop_price;
+    order.status = "new";
+    order.last_event = at;
+
+    server_.respond(token, 200, order_json(order).dump(), at);
+    publish("new", order, at);
+
+    // Matching happens now; the fill reports trail the ack
+    auto& stored = orders_.emplace(order.id, std::move(order)).first->second;
+    Book& book = books_[stored.symbol];
+    if (stored.type == OrderType::Stop && !triggered(stored, book)) {
+        book.stops.push_back(stored.id);
+        return;
+    }
+    take_liquidity(stored, book, at);
+    if (is_open(stored.status)) {
+        rest(stored, book);
+    }
+}
+
+int VenueSimulator::cancel(const std::string& id, Clock::time_point at) {
+    auto it = orders_.find(id);
+    if (it == orders_.end()) {
+        return 404;
+    }
+    SimOrder& order = it->second;
+    if (!is_open(order.status)) {
+        return 422;
+    }
+    unrest(order, books_[order.symbol]);
+    order.status = "canceled";
+    publish("canceled", order, std::max(at, order.last_event));
+    return 204;
+}
+
+void VenueSimulator::on_tick(const VenueTick& tick) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = Clock::now();
+    Book& book = books_[tick.symbol];
+    book.quote = tick;
+    book.has_quote = tick.bid > 0.0 || tick.ask > 0.0;
+    constexpr double kUnlimited = std::numeric_limits<double>::infinity();
+    book.bid_available = tick.bid_size > 0.0 ? tick.bid_size : kUnlimited;
+    book.ask_available = tick.ask_size > 0.0 ? tick.ask_size : kUnlimited;
+
+    // Triggered stops join the market orders still waiting for liquidity
+    for (auto it = book.stops.begin(); it != book.stops.end();) {
+        if (triggered(orders_.at(*it), book)) {
+            book.pending.push_back(*it);
+            it = book.stops.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (auto it = book.pending.begin(); it != book.pending.end();) {
+        SimOrder& order = orders_.at(*it);
+        take_liquidity(order, book, now);
+        it = is_open(order.status) ? std::next(it) : book.pending.erase(it);
+    }
+
+    // Resting limits the new quote crosses fill at their own price
+    while (!book.bids.empty() && book.quote.ask > 0.0 && book.bids.begin()->first >= book.quote.ask &&
+           book.ask_available > 0.0) {
+        SimOrder& order = orders_.at(book.bids.begin()->second);
+        double quantity = std::min(order.quantity - order.filled, book.ask_available);
+        book.ask_available -= quantity;
+        fill(order, order.limit_price, quantity, now);
+        if (!is_open(order.status)) {
+            book.bids.erase(book.bids.begin());
+        }
+    }
+    while (!book.asks.empty() && book.quote.bid > 0.0 && book.asks.begin()->first <= book.quote.bid &&
+           book.bid_available > 0.0) {
+        SimOrder& order = orders_.at(book.asks.begin()->second);
+        double quantity = std::min(order.quantity - order.filled, book.bid_available);
+        book.bid_available -= quantity;
+        fill(order, order.limit_price, quantity, now);
+        if (!is_open(order.status)) {
+            book.asks.erase(book.asks.begin());
+        }
+    }
+}
+
+bool VenueSimulator::triggered(const SimOrder& order, const Book& book) const {
+    if (!book.has_quote) {
+        return false;
+    }
+    return order.side == Side::Buy ? book.quote.ask >= order.stop_price
+                                   : book.quote.bid > 0.0 && book.quote.bid <= order.stop_price;
+}
+
+bool VenueSimulator::take_liquidity(SimOrder& order, Book& book, Clock::time_point now) {
+    if (!book.has_quote) {
+        return false;
+    }
+    bool buy = order.side == Side::Buy;
+    double touch = buy ? book.quote.ask : book.quote.bid;
+    double& available = buy ? book.ask_available : book.bid_available;
+    if (touch <= 0.0 || available <= 0.0) {
+        return false;
+    }
+    if (order.type == OrderType::Limit && (buy ? order.limit_price < touch : order.limit_price > touch)) {
+        return false;
+    }
+    double quantity = std::min(order.quantity - order.filled, available);
+    available -= quantity;
+    fill(order, touch, quantity, now);
+    return true;
+}
+
+void VenueSimulator::rest(SimOrder& order, Book& book) {
+    if (order.type != OrderType::Limit) {
+        book.pending.push_back(order.id);  // Market or triggered stop: next tick's liquidity
+    } else if (order.side == Side::Buy) {
+        book.bids.emplace(order.limit_price, order.id);
+    } else {
+        book.asks.emplace(order.limit_price, order.id);
+    }
+}
+
+void VenueSimulator::unrest(const SimOrder& order, Book& book) {
+    auto drop = [&](auto& queue) {
+        auto [first, last] = queue.equal_range(order.limit_price);
+        for (auto it = first; it != last; ++it) {
+            if (it->second == order.id) {
+                queue.erase(it);
+                return;
+            }
+        }
+    };
+    if (order.type == OrderType::Limit) {
+        order.side == Side::Buy ? drop(book.bids) : drop(book.asks);
+        return;
+    }
+    for (auto* list : {&book.stops, &book.pending}) {
+        list->erase(std::remove(list->begin(), list->end(), order.id), list->end());
+    }
+}
+
+void VenueSimulator::fill(SimOrder& order, double price, double quantity, Clock::time_point now) {
+    order.filled += quantity;
+    order.notional += price * quantity;
+    bool done = order.filled >= order.quantity - 1e-9;
+    order.status = done ? "filled" : "partially_filled";
+    auto at = std::max(now + config_.fill_latency.sample(rng_), order.last_event);
+    publish(done ? "fill" : "partial_fill", order, at, price, quantity);
+    fills_sent_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void VenueSimulator::publish(const char* event, SimOrder& order, Clock::time_point at, double price,
+                             double quantity) {
+    order.last_event = at;
+    nlohmann::json data = {{"event", event}, {"order", order_json(order)}};
+    if (quantity > 0.0) {
+        data["price"] = format_number(price);
+        data["qty"] = format_number(quantity);
+    }
+    server_.broadcast(nlohmann::json{{"stream", "trade_updates"}, {"data", data}}.dump(), at);
+}
+
+void VenueSimulator::on_stream(uint64_t client, const std::string& message) {
+    auto request = nlohmann::json::parse(message, nullptr, false);
+    if (request.is_discarded()) {
+        return;
+    }
+    std::string action = request.value("action", "");
+    if (action == "auth" || action == "authenticate") {
+        server_.send_stream(client, R"({"stream":"authorization","data":{"status":"authorized","action":"authenticate"}})");
+    } else if (action == "listen") {
+        server_.send_stream(client, R"({"stream":"listening","data":{"streams":["trade_updates"]}})");
+    }
+}
+
+} // namespace frontier
@@ -0,0 +1,80 @@
+#include "frontier/circuit_breaker.hpp"
+#include <algorithm>
+
+namespace frontier {
+
+VolatilityCircuitBreaker::VolatilityCircuitBreaker(const CircuitBreakerConfig& config)
+    : config_(config),
+      bucket_ns_(std::max<int64_t>(config.window_ns / static_cast<int64_t>(kBuckets), 1)) {
+    windows_.reserve(config.expected_symbols);
+}
+
+bool VolatilityCircuitBreaker::on_tick(uint32_t id, double price, int64_t now_ns, CircuitBreakerEvent& event) {
+    if (price <= 0.0) {
+        return false;
+    }
+    if (id >= windows_.size()) {
+        windows_.resize(id + 1);   // Only when a symbol is first seen
+    }
+    Window& window = windows_[id];
+    uint32_t bucket = static_cast<uint32_t>(now_ns / bucket_ns_);
+    float p = static_cast<float>(price);
+
+    // Drop buckets that left the window (unsigned difference survives wraparound)
+    while (window.high.size && bucket - window.high.front().bucket >= kBuckets) {
+        window.high.pop_front();
+    }
+    while (window.low.size && bucket - window.low.front().bucket >= kBuckets) {
+        window.low.pop_front();
+    }
+
+    // Entries that can never be the extreme again go; one entry per bucket
+    while (window.high.size && window.high.back().price <= p) {
+        window.high.pop_back();
+    }
+    if (!window.high.size || window.high.back().bucket != bucket) {
+        window.high.push_back({bucket, p});
+    }
+    while (window.low.size && window.low.back().price >= p) {
+        window.low.pop_back();
+    }
+    if (!window.low.size || window.low.back().bucket != bucket) {
+        window.low.push_back({bucket, p});
+    }
+
+    double high = window.high.front().price;
+    double low = window.low.front().price;
+    double reference;
+    if (price <= high * (1.0 - config_.threshold_pct)) {
+        reference = high;
+    } else if (price >= low * (1.0 + config_.threshold_pct)) {
+        reference = low;
+    } else {
+        return false;
+    }
+    event.symbol_id = id;
+    event.price = price;
+    event.reference_price = reference;
+    event.move_pct = price / reference - 1.0;
+    event.timestamp_ns = now_ns;
+    window.high.size = 0;
+    window.low.size = 0;
+    return true;
+}
+
+void VolatilityCircuitBreaker::reset(uint32_t id) {
+    if (id < windows_.size()) {
+        windows_[id].high.size = 0;
+        windows_[id].low.size = 0;
+    }
+}
+
+double VolatilityCircuitBreaker::window_high(uint32_t id) const {
+    return id < windows_.size() && windows_[id].high.size ? windows_[id].high.front().price : 0.0;
+}
+
+double VolatilityCircuitBreaker::window_low(uint32_t id) const {
+    return id < windows_.size() && windows_[id].low.size ? windows_[id].low.front().price : 0.0;
+}
+
+} // namespace frontier
@@ -1,33 +1,92 @@
 #include "frontier/engine.hpp"
+#include "engine/clock.h"
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <cmath>
 
 namespace frontier {
 
-TradingEngine::TradingEngine() {
+template <typename Callback>
+void TradingEngine::call_strategy(uint64_t id, StrategyPlugin& plugin, const char* event, Callback&& callback) {
+    // Orders placed from inside the callback belong to this strategy
+    uint64_t outer = active_strategy_;
+    active_strategy_ = id;
+    // A throwing strategy must not take the engine thread down with it
+    try {
+        callback(plugin.strategy());
+    } catch (const std::exception& e) {
+        logger_->error("Strategy {} ({}) threw in {}: {}", id, plugin.path(), event, e.what());
+    }
+    active_strategy_ = outer;
+}
+
+template <typename Callback>
+void TradingEngine::dispatch_strategies(const char* event, Callback&& callback) {
+    for (auto& [id, plugin] : strategies_) {
+        call_strategy(id, *plugin, event, callback);
+    }
+}
+
+TradingEngine::TradingEngine() : TradingEngine(trading::defaultClock()) {}
+
+TradingEngine::TradingEngine(std::shared_ptr<trading::Clock> clock)
+    : clock_(std::move(clock)), day_start_equity_(account_.equity) {
     // Initialize logger with unique name
     static int instance_count = 0;
     std::string logger_name = "trading_engine_" + std::to_string(instance_count++);
     logger_ = spdlog::stdout_color_mt(logger_name);
     logger_->set_level(spdlog::level::info);
     
+    // Children execute synchronously in paper mode, so a fill is the whole child
+    algo_engine_ = std::make_unique<ExecutionAlgoEngine>(
+        [this](const ParentOrder& parent, double quantity, double price) {
+            return place_market_order(parent.spec.symbol, parent.spec.side, quantity, price) ? quantity : 0.0;
+        },
+        std::chrono::milliseconds(100), clock_->now());
+    
+    tick_columns_ = {features_.column("last"), features_.column("bid"), features_.column("ask"),
+                     features_.column("volume"), features_.column("spread_bps"), features_.column("prev_close"),
+                     features_.column("change_pct")};
+    
     logger_->info("Frontier Trading Engine initialized (paper mode)");
 }
 
 bool TradingEngine::place_market_order(const std::string& symbol, Side side, double quantity, double price) {
+    if (Decimal::from_double(quantity, quantity_scale(get_asset_type(symbol))).units <= 0) {
+        logger_->warn("Order quantity {} for {} rounds to zero", quantity, symbol);
+        return false;
+    }
+    
+    if (!is_market_open(symbol, clock_->now())) {
+        logger_->warn("Market closed for {} order", symbol);
+        return false;
+    }
+    
     if (!check_risk_limits(symbol, side, quantity, price)) {
         logger_->warn("Risk limit check failed for {} order", symbol);
         return false;
     }
     
-    update_position(symbol, side, quantity, price);
+    if (!update_position(symbol, side, quantity, price)) {
+        return false;
+    }
     calculate_unrealized_pnl();
     account_.update_equity();
     
     logger_->info("Market order executed: {} {} {} shares at ${:.2f}", 
                   side == Side::Buy ? "BUY" : "SELL", quantity, symbol, price);
     
+    // Only the strategy that placed the order hears about its fill
+    auto owner = strategies_.find(active_strategy_);
+    if (owner != strategies_.end()) {
+        StrategyFill fill{symbol, side, quantity, price, clock_->now()};
+        call_strategy(owner->first, *owner->second, "on_fill",
+                      [&](Strategy& strategy) { strategy.on_fill(fill, *this); });
+    }
     return true;
 }
 
@@ -51,8 +110,85 @@ const Position* TradingEngine::get_position(const std::string& symbol) const {
     return it != account_.positions.end() ? &it->second : nullptr;
 }
 
+AssetType TradingEngine::get_asset_type(const std::string& symbol) const {
+    auto it = asset_types_.find(symbol);
+    if (it != asset_types_.end()) {
+        return it->second;
+    }
+    return symbol.find('/') != std::string::npos ? AssetType::CRYPTO : AssetType::STOCK;
+}
+
+MarketSession TradingEngine::market_session(const std::string& symbol,
+                                            std::chrono::system_clock::time_point now) const {
+    return trading_calendar_ ? trading_calendar_->session(get_asset_type(symbol), now) : MarketSession::Regular;
+}
+
+bool TradingEngine::is_market_open(const std::string& symbol, std::chrono::system_clock::time_point now) const {
+    return !trading_calendar_ || trading_calendar_->is_open(get_asset_type(symbol), now, allow_extended_hours_);
+}
+
 void TradingEngine::update_market_data(const MarketData& data) {
     market_data_[data.symbol] = data;
+    auto now = clock_->now();
+    
+    auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch());
+    if (market_data_bus_) {
+        if (!market_data_bus_->publish(data, since_epoch.count())) {
+            logger_->warn("Market data bus {} could not publish {}", market_data_bus_->name(), data.symbol);
+        }
+    }
+    if (market_data_fanout_) {
+        market_data_fanout_->publish(data, since_epoch.count());
+    }
+    
+    uint32_t state_id = symbol_states_.id(data.symbol);
+    double tick_price = data.last > 0 ? data.last : data.mid_price();
+    bool was_halted = symbol_states_.state(state_id).flags & SymbolFlags::Halted;
+    symbol_states_.on_tick(state_id, tick_price, since_epoch.count());
+    const SymbolState& state = symbol_states_.state(state_id);
+    auto held = account_.positions.find(data.symbol);
+    if (held != account_.positions.end() && tick_price > 0) {
+        held->second.market_price = tick_price;
+        calculate_unrealized_pnl();
+        account_.update_equity();
+    }
+    if (!was_halted && (state.flags & SymbolFlags::Halted)) {
+        logger_->warn("{} halted ({}) at {:.4f}, bands {:.4f}-{:.4f}", data.symbol, to_string(state.halt_reason),
+                      tick_price, state.lower_band, state.upper_band);
+    }
+    CircuitBreakerEvent trip;
+    if (circuit_breaker_ && circuit_breaker_->on_tick(state_id, tick_price, since_epoch.count(), trip) &&
+        !(state.flags & SymbolFlags::Halted)) {
+        trip.symbol = data.symbol;
+        trip.halted_until_ns = since_epoch.count() + circuit_breaker_->config().pause_ns;
+        symbol_states_.halt(state_id, HaltReason::CircuitBreaker, trip.halted_until_ns);
+        logger_->warn("{} circuit breaker: {:.4f} is {:+.2f}% from {:.4f}", data.symbol, tick_price,
+                      trip.move_pct * 100.0, trip.reference_price);
+        if (circuit_breaker_handler_) {
+            circuit_breaker_handler_(trip);
+        }
+    }
+    
+    algo_engine_->on_tick(data, now);
+    
+    uint32_t row = features_.row(data.symbol);
+    features_.set(row, tick_columns_.last, data.last);
+    features_.set(row, tick_columns_.bid, data.bid);
+    features_.set(row, tick_columns_.ask, data.ask);
+    features_.set(row, tick_columns_.volume, data.volume);
+    double mid = data.mid_price();
+    if (mid > 0) {
+        features_.set(row, tick_columns_.spread_bps, data.spread() / mid * 1e4);
+    }
+    double prev_close = features_.get(row, tick_columns_.prev_close);
+    if (prev_close > 0 && data.last > 0) {
+        features_.set(row, tick_columns_.change_pct, (data.last / prev_close - 1.0) * 100.0);
+    }
+    
+    if (!strategies_.empty()) {
+        const MarketData& stored = market_data_[data.symbol];
+        dispatch_strategies("on_tick", [&](Strategy& strategy) { strategy.on_tick(stored, *this); });
+    }
 }
 
 const MarketData* TradingEngine::get_market_data(const std::string& symbol) const {
@@ -60,8 +196,85 @@ const MarketData* TradingEngine::get_market_data(const std::string& symbol) cons
     return it != market_data_.end() ? &it->second : nullptr;
 }
 
+uint64_t TradingEngine::submit_algo_order(const ParentOrderSpec& spec) {
+    uint64_t id = algo_engine_->submit(spec, clock_->now());
+    if (id == 0) {
+        logger_->warn("Rejected invalid algo order for {}", spec.symbol);
+    } else {
+        logger_->info("Algo order {} accepted: {} {} {}", id,
+                      spec.side == Side::Buy ? "BUY" : "SELL", spec.quantity, spec.symbol);
+    }
+    return id;
+}
+
+bool TradingEngine::cancel_algo_order(uint64_t parent_id) {
+    return algo_engine_->cancel(parent_id);
+}
+
+const ParentOrder* TradingEngine::get_algo_order(uint64_t parent_id) const {
+    return algo_engine_->get(parent_id);
+}
+
+void TradingEngine::set_volume_profile(const std::string& symbol, VolumeProfile profile) {
+    algo_engine_->set_volume_profile(symbol, std::move(profile));
+}
+
+void TradingEngine::process_timers() {
+    auto now = clock_->now();
+    algo_engine_->on_timer(now);
+    
+    if (!strategies_.empty()) {
+        reload_changed_strategies();
+        dispatch_strategies("on_timer", [&](Strategy& strategy) { strategy.on_timer(now, *this); });
+    }
+}
+
+uint64_t TradingEngine::load_strategy(const std::string& path, const std::string& config) {
+    auto plugin = std::make_unique<StrategyPlugin>(path, config);
+    uint64_t id = next_strategy_id_++;
+    strategies_.emplace(id, std::move(plugin));
+    logger_->info("Strategy {} loaded from {}", id, path);
+    return id;
+}
+
+bool TradingEngine::unload_strategy(uint64_t id) {
+    return strategies_.erase(id) > 0;
+}
+
+StrategyPlugin* TradingEngine::get_strategy(uint64_t id) {
+    auto it = strategies_.find(id);
+    return it != strategies_.end() ? it->second.get() : nullptr;
+}
+
+size_t TradingEngine::reload_changed_strategies() {
+    // Runs between ticks, so no callback is mid-flight in the old image
+    size_t reloaded = 0;
+    for (auto& [id, plugin] : strategies_) {
+        if (!plugin->changed_on_disk()) {
+            continue;
+        }
+        std::string error;
+        if (plugin->reload(&error)) {
+            ++reloaded;
+            logger_->info("Strategy {} reloaded from {} (generation {})", id, plugin->path(), plugin->generation());
+        } else {
+            logger_->error("Strategy {} reload failed, keeping the running version: {}", id, error);
+        }
+    }
+    return reloaded;
+}
+
+SymbolGate TradingEngine::check_symbol_state(const std::string& symbol, Side side, double price) const {
+    return symbol_states_.check(symbol, side, price, clock_->nowNs());
+}
+
 bool TradingEngine::check_risk_limits(const std::string& symbol, Side side, double quantity, double price) const {
-    (void)symbol; // Suppress unused parameter warning
+    SymbolGate gate = check_symbol_state(symbol, side, price);
+    if (gate != SymbolGate::Ok) {
+        logger_->warn("Order for {} blocked: {}", symbol, to_string(gate));
+        return false;
+    }
+    
     double order_value = quantity * price;
     
     // Check if we have enough cash for buy orders
@@ -71,8 +284,8 @@ bool TradingEngine::check_risk_limits(const std::string& symbol, Side side, doub
         return false;
     }
     
-    // Check position size limits (max 20% of account in single position)
-    double max_position_value = account_.equity * 0.2;
+    // Check position size limits (by default max 20% of account in single position)
+    double max_position_value = account_.equity * guardrail_limits_.max_position_fraction;
     if (order_value > max_position_value) {
         logger_->warn("Order value ${:.2f} exceeds position limit ${:.2f}", 
                       order_value, max_position_value);
@@ -82,6 +295,44 @@ bool TradingEngine::check_risk_limits(const std::string& symbol, Side side, doub
     return true;
 }
 
+std::vector<GuardrailResult> TradingEngine::evaluate_guardrails(const std::vector<GuardrailCandidate>& candidates,
+                                                               std::chrono::system_clock::time_point now) const {
+    const double equity = account_.equity;
+    const double max_position_value = equity * guardrail_limits_.max_position_fraction;
+    const double loss_headroom = daily_pnl() + guardrail_limits_.max_daily_loss;
+    
+    // Gather into columns for the flag kernel
+    size_t n = candidates.size();
+    std::vector<double> position(n), quantity(n), price(n), stop(n);
+    for (size_t i = 0; i < n; ++i) {
+        const auto& candidate = candidates[i];
+        const Position* held = get_position(candidate.symbol);
+        position[i] = held ? held->quantity.to_double() : 0.0;
+        quantity[i] = candidate.quantity;
+        price[i] = candidate.limit_price;
+        if (price[i] <= 0.0) {
+            const MarketData* quote = get_market_data(candidate.symbol);
+            price[i] = quote ? (quote->last > 0.0 ? quote->last : quote->mid_price()) : 0.0;
+        }
+        stop[i] = candidate.stop_price;
+    }
+    std::vector<uint8_t> max_pos_ok(n), daily_loss_ok(n);
+    evaluate_guardrail_flags(position.data(), quantity.data(), price.data(), stop.data(), n, max_position_value,
+                             loss_headroom, max_pos_ok.data(), daily_loss_ok.data());
+    
+    std::vector<GuardrailResult> results(n);
+    for (size_t i = 0; i < n; ++i) {
+        GuardrailResult& result = results[i];
+        result.price = price[i];
+        result.max_pos_ok = max_pos_ok[i] && price[i] > 0.0;   // Unpriced candidates can't be checked
+        result.daily_loss_ok = daily_loss_ok[i];
+        result.mkt_hours_ok = is_market_open(candidates[i].symbol, now);
+        result.projected_position_value = std::fabs(position[i] + quantity[i]) * price[i];
+        size_guardrail_candidate(candidates[i], equity, guardrail_limits_, result);
+    }
+    return results;
+}
+
 void TradingEngine::print_account_summary() const {
     std::cout << "\n=== Account Summary ===" << std::endl;
     std::cout << std::fixed << std::setprecision(2);
@@ -118,47 +369,101 @@ void TradingEngine::print_positions() const {
     std::cout << "=====================" << std::endl;
 }
 
-void TradingEngine::update_position(const std::string& symbol, Side side, double quantity, double price) {
-    auto& position = account_.positions[symbol];
-    position.symbol = symbol;
+bool TradingEngine::update_position(const std::string& symbol, Side side, double quantity, double price) {
+    // Book in exact fixed point so a full close leaves exactly zero behind
+    auto it = account_.positions.find(symbol);
+    AssetType type = it != account_.positions.end() ? it->second.asset_type : get_asset_type(symbol);
+    Decimal fill = Decimal::from_double(side == Side::Buy ? quantity : -quantity, quantity_scale(type));
+    Decimal fill_price = Decimal::from_double(price, kPriceScale);
     
-    if (side == Side::Buy) {
-        // Calculate new average price using weighted average
-        double total_cost = position.quantity * position.average_price + quantity * price;
-        double total_quantity = position.quantity + quantity;
-        
-        if (total_quantity > 0) {
-            position.average_price = total_cost / total_quantity;
-        }
-        position.quantity += quantity;
-        account_.cash -= quantity * price;
-    } else {  // Sell
-        if (position.quantity < quantity) {
-            logger_->error("Insufficient shares to sell: have {}, trying to sell {}", 
-                          position.quantity, quantity);
-            return;
-        }
-        
-        // Calculate realized P&L
-        double realized_pnl = (price - position.average_price) * quantity;
-        position.realized_pnl += realized_pnl;
-        
-        position.quantity -= quantity;
-        account_.cash += quantity * price;
+    int64_t held = it != account_.positions.end() ? it->second.quantity.units : 0;
+    if (!allow_short_selling_ && held + fill.units < 0) {
+        logger_->error("Insufficient shares to sell: have {}, trying to sell {} (short selling disabled)",
+                      Decimal(held, fill.scale).to_string(), (-fill).to_string());
+        return false;
+    }
+    
+    auto now = clock_->now();
+    if (it == account_.positions.end()) {
+        Position opened;
+        opened.symbol = symbol;
+        opened.asset_type = type;
+        opened.quantity = Decimal(0, fill.scale);
+        it = account_.positions.emplace(symbol, opened).first;
+    }
+    auto& position = it->second;
+    accrue_borrow(position, now);
+    
+    // Reduce toward zero first: release cost basis pro rata and realize P&L
+    Decimal closing(0, fill.scale);
+    if (position.quantity.units != 0 && (position.quantity.units < 0) != (fill.units < 0)) {
+        int64_t held_abs = std::abs(position.quantity.units);
+        int64_t close_abs = std::min(std::abs(fill.units), held_abs);
+        closing = Decimal(fill.units < 0 ? -close_abs : close_abs, fill.scale);
         
-        // Remove position if quantity becomes zero
-        if (position.quantity == 0) {
-            account_.positions.erase(symbol);
+        Decimal released = close_abs == held_abs ? position.cost_basis
+                                                 : position.cost_basis.mul_div(close_abs, held_abs);
+        Decimal notional = Decimal::multiply(closing, fill_price, kMoneyScale);
+        position.realized_pnl -= notional + released;
+        position.cost_basis -= released;
+        position.quantity += closing;
+        account_.cash -= notional.to_double();
+    }
+    
+    // Whatever is left opens or extends the position, crossing through zero if needed
+    Decimal opening = fill - closing;
+    if (opening.units != 0) {
+        if (position.quantity.units == 0) {
+            position.borrow_accrued_until = now;
         }
+        Decimal notional = Decimal::multiply(opening, fill_price, kMoneyScale);
+        position.cost_basis += notional;
+        position.quantity += opening;
+        account_.cash -= notional.to_double();
+    }
+    
+    // Remove position if quantity becomes zero
+    if (position.quantity.is_zero()) {
+        account_.positions.erase(it);
+    } else {
+        position.average_price = position.cost_basis.to_double() / position.quantity.to_double();
+        position.market_price = price;  // The fill is the latest trade until the next tick
     }
+    return true;
+}
+
+void TradingEngine::accrue_borrow(Position& position, std::chrono::system_clock::time_point now) {
+    if (!position.is_short() || now <= position.borrow_accrued_until) {
+        return;
+    }
+    auto rate_it = borrow_rates_.find(position.symbol);
+    double rate = rate_it != borrow_rates_.end() ? rate_it->second : default_borrow_rate_;
+    double years = std::chrono::duration<double>(now - position.borrow_accrued_until).count() / (365.0 * 86400.0);
+    position.borrow_accrued_until = now;
+    if (rate <= 0) {
+        return;
+    }
+    
+    double reference = position.market_price > 0 ? position.market_price : position.average_price;
+    Decimal fee = Decimal::from_double(-position.quantity.to_double() * reference * rate * years, kMoneyScale);
+    position.borrow_cost += fee;
+    position.realized_pnl -= fee;
+    account_.cash -= fee.to_double();
+}
+
+void TradingEngine::accrue_borrow_costs(std::chrono::system_clock::time_point now) {
+    for (auto& [symbol, position] : account_.positions) {
+        accrue_borrow(position, now);
+    }
+    account_.update_equity();
 }
 
 void TradingEngine::calculate_unrealized_pnl() {
     for (auto& [symbol, position] : account_.positions) {
         if (position.market_price > 0) {
-            double cost_basis = position.quantity * position.average_price;
-            double market_value = position.quantity * position.market_price;
-            position.unrealized_pnl = market_value - cost_basis;
+            Decimal market_value = Decimal::multiply(
+                position.quantity, Decimal::from_double(position.market_price, kPriceScale), kMoneyScale);
+            position.unrealized_pnl = market_value - position.cost_basis;
         }
     }
 }
@@ -0,0 +1,112 @@
+#include "clock.h"
+#include "tsc_clock.h"
+#include <algorithm>
+#include <thread>
+
+namespace trading {
+
+Clock::time_point WallClock::now() const {
+    return TscClock::now();
+}
+
+void WallClock::sleepUntil(time_point when) {
+    std::this_thread::sleep_until(when);
+}
+
+std::shared_ptr<Clock> defaultClock() {
+    static const std::shared_ptr<Clock> clock = std::make_shared<WallClock>();
+    return clock;
+}
+
+VirtualClock::EventId VirtualClock::schedule(time_point when, Event event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return enqueue(toNs(when), Scheduled{std::move(event), 0});
+}
+
+VirtualClock::EventId VirtualClock::scheduleEvery(duration period, Event event) {
+    int64_t periodNs = std::max<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(period).count(), 1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return enqueue(nowNs_.load(std::memory_order_relaxed) + periodNs, Scheduled{std::move(event), periodNs});
+}
+
+VirtualClock::EventId VirtualClock::enqueue(int64_t dueNs, Scheduled scheduled) {
+    EventId id = nextId_++;
+    queue_.emplace(std::make_pair(dueNs, id), std::move(scheduled));
+    dueById_.emplace(id, dueNs);
+    return id;
+}
+
+bool VirtualClock::cancel(EventId id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = dueById_.find(id);
+    if (it == dueById_.end()) {
+        return false;
+    }
+    queue_.erase({it->second, id});
+    dueById_.erase(it);
+    return true;
+}
+
+std::optional<Clock::time_point> VirtualClock::nextEventTime() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty()) {
+        return std::nullopt;
+    }
+    return fromNs(std::max(queue_.begin()->first.first, nowNs_.load(std::memory_order_relaxed)));
+}
+
+size_t VirtualClock::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+bool VirtualClock::popDue(int64_t limitNs, Scheduled& scheduled, EventId& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.empty() || queue_.begin()->first.first > limitNs) {
+        return false;
+    }
+    auto it = queue_.begin();
+    int64_t dueNs = std::max(it->first.first, nowNs_.load(std::memory_order_relaxed));
+    id = it->first.second;
+    scheduled = std::move(it->second);
+    queue_.erase(it);
+    if (scheduled.periodNs > 0) {
+        // Re-armed under the same id before it runs, so the handler can cancel itself
+        queue_.emplace(std::make_pair(dueNs + scheduled.periodNs, id), scheduled);
+        dueById_[id] = dueNs + scheduled.periodNs;
+    } else {
+        dueById_.erase(id);
+    }
+    nowNs_.store(dueNs, std::memory_order_release);
+    return true;
+}
+
+bool VirtualClock::runNext() {
+    auto next = nextEventTime();
+    if (!next) {
+        return false;
+    }
+    runUntil(*next);
+    return true;
+}
+
+size_t VirtualClock::runUntil(time_point until) {
+    int64_t limitNs = toNs(until);
+    size_t ran = 0;
+    Scheduled scheduled;
+    EventId id;
+    while (popDue(limitNs, scheduled, id)) {
+        scheduled.event();  // No lock held: handlers schedule and cancel freely
+        ++ran;
+    }
+    advanceTo(until);
+    return ran;
+}
+
+void VirtualClock::advanceTo(time_point when) {
+    int64_t target = toNs(when);
+    int64_t current = nowNs_.load(std::memory_order_relaxed);
+    while (target > current && !nowNs_.compare_exchange_weak(current, target, std::memory_order_release)) {}
+}
+
+} // namespace trading
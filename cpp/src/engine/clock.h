@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace trading {
+
+// Where the engine gets the time. OrderManager, RiskManager and the
+// frontier TradingEngine read it instead of a chrono clock, so the same
+// code runs against wall time or against a VirtualClock.
+class Clock {
+public:
+    using time_point = std::chrono::system_clock::time_point;
+    using duration = std::chrono::system_clock::duration;
+
+    virtual ~Clock() = default;
+
+    virtual time_point now() const = 0;
+    // Block until `when`. A virtual clock jumps there instead, running
+    // everything scheduled on the way.
+    virtual void sleepUntil(time_point when) = 0;
+
+    int64_t nowNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(now().time_since_epoch()).count();
+    }
+};
+
+// Wall time, stamped through TscClock
+class WallClock : public Clock {
+public:
+    time_point now() const override;
+    void sleepUntil(time_point when) override;
+};
+
+// The process-wide WallClock; what everything uses unless given a clock
+std::shared_ptr<Clock> defaultClock();
+
+// Simulated time. It stands still until advanced, and advancing runs the
+// scheduled events in time order (ties in scheduling order), jumping
+// straight from one to the next. A trading day of timers therefore
+// replays in the time its handlers take.
+//
+// now() may be read from any thread. Scheduling is thread-safe and
+// handlers may schedule or cancel; advance from one thread at a time.
+class VirtualClock : public Clock {
+public:
+    using EventId = uint64_t;
+    using Event = std::function<void()>;
+
+    explicit VirtualClock(time_point start = time_point()) : nowNs_(toNs(start)) {}
+
+    time_point now() const override { return fromNs(nowNs_.load(std::memory_order_acquire)); }
+    void sleepUntil(time_point when) override { runUntil(when); }
+
+    // Times already passed run at the next advance, at the current time
+    EventId schedule(time_point when, Event event);
+    EventId scheduleAfter(duration delay, Event event) { return schedule(now() + delay, std::move(event)); }
+    // First run one period from now; the event repeats until cancelled
+    EventId scheduleEvery(duration period, Event event);
+    bool cancel(EventId id);
+
+    std::optional<time_point> nextEventTime() const;
+    size_t pending() const;
+
+    // Jump to the next event and run every event due at that time.
+    // False when nothing is scheduled.
+    bool runNext();
+    // Run everything due up to `until`, then leave the clock there. Returns events run.
+    size_t runUntil(time_point until);
+    size_t runFor(duration span) { return runUntil(now() + span); }
+    // Move the clock without an event (never backwards)
+    void advanceTo(time_point when);
+
+private:
+    struct Scheduled {
+        Event event;
+        int64_t periodNs = 0;  // 0 = one-shot
+    };
+
+    std::atomic<int64_t> nowNs_;
+    mutable std::mutex mutex_;
+    std::map<std::pair<int64_t, EventId>, Scheduled> queue_;  // (due ns, id): time order, then FIFO
+    std::unordered_map<EventId, int64_t> dueById_;
+    EventId nextId_ = 1;
+
+    static int64_t toNs(time_point t) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+    static time_point fromNs(int64_t ns) {
+        return time_point(std::chrono::duration_cast<duration>(std::chrono::nanoseconds(ns)));
+    }
+    EventId enqueue(int64_t dueNs, Scheduled scheduled);
+    // Pops the first event due at or before `limitNs` and moves the clock to it
+    bool popDue(int64_t limitNs, Scheduled& scheduled, EventId& id);
+};
+
+} // namespace trading
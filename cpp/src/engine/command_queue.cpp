@@ -0,0 +1,71 @@
+#include "command_queue.h"
+#include <algorithm>
+
+namespace trading {
+
+void CommandQueue::push(EngineCommand command, CommandLane lane) {
+    command.enqueuedAt = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto index = static_cast<size_t>(lane);
+        lanes_[index].push_back(std::move(command));
+        auto& stats = stats_[index];
+        ++stats.enqueued;
+        stats.depth = lanes_[index].size();
+        stats.maxDepth = std::max(stats.maxDepth, stats.depth);
+    }
+    ready_.notify_one();
+}
+
+bool CommandQueue::pop(EngineCommand& command, CommandLane* lane) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t index = 0; index < kLaneCount; ++index) {
+        auto& queue = lanes_[index];
+        if (queue.empty()) {
+            continue;
+        }
+        command = std::move(queue.front());
+        queue.pop_front();
+
+        auto& stats = stats_[index];
+        auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - command.enqueuedAt);
+        ++stats.processed;
+        stats.depth = queue.size();
+        stats.totalWait += waited;
+        stats.maxWait = std::max(stats.maxWait, waited);
+        if (lane) {
+            *lane = static_cast<CommandLane>(index);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool CommandQueue::waitForCommand(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return ready_.wait_for(lock, timeout, [this] {
+        for (const auto& queue : lanes_) {
+            if (!queue.empty()) {
+                return true;
+            }
+        }
+        return false;
+    });
+}
+
+size_t CommandQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t total = 0;
+    for (const auto& queue : lanes_) {
+        total += queue.size();
+    }
+    return total;
+}
+
+LaneStats CommandQueue::getStats(CommandLane lane) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_[static_cast<size_t>(lane)];
+}
+
+} // namespace trading
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+namespace trading {
+
+// Scope of a mass cancel; unset fields match every order
+struct MassCancelScope {
+    std::optional<std::string> accountId;
+    std::optional<std::string> symbol;
+    std::optional<OrderSide> side;
+};
+
+enum class CommandType {
+    NEW_ORDER,
+    AMEND,
+    CANCEL,
+    MASS_CANCEL
+};
+
+// Intake lanes, drained strictly in this order
+enum class CommandLane {
+    PRIORITY,   // Cancels, mass cancels and risk-reducing orders
+    AMEND,
+    NEW_ORDER,
+    COUNT
+};
+
+// One request to the order manager, as decoded from any ingress
+struct EngineCommand {
+    CommandType type = CommandType::NEW_ORDER;
+    Order order;                            // NEW_ORDER
+    std::string orderId;                    // AMEND, CANCEL
+    std::optional<double> newQuantity;      // AMEND
+    std::optional<Price> newLimitPrice;     // AMEND
+    MassCancelScope scope;                  // MASS_CANCEL
+    std::chrono::steady_clock::time_point enqueuedAt;
+};
+
+// Queue depth and wait time of one lane
+struct LaneStats {
+    size_t depth = 0;
+    size_t maxDepth = 0;
+    uint64_t enqueued = 0;
+    uint64_t processed = 0;
+    std::chrono::nanoseconds totalWait{0};
+    std::chrono::nanoseconds maxWait{0};
+
+    std::chrono::nanoseconds averageWait() const {
+        return processed ? totalWait / static_cast<int64_t>(processed) : std::chrono::nanoseconds(0);
+    }
+};
+
+// Multi-producer command intake with one FIFO per lane. A pop always takes
+// from the highest-priority non-empty lane, so a cancel waits behind other
+// cancels only, however deep the new-order lane gets.
+class CommandQueue {
+private:
+    static constexpr size_t kLaneCount = static_cast<size_t>(CommandLane::COUNT);
+
+    mutable std::mutex mutex_;
+    std::condition_variable ready_;
+    std::array<std::deque<EngineCommand>, kLaneCount> lanes_;
+    std::array<LaneStats, kLaneCount> stats_;
+
+public:
+    void push(EngineCommand command, CommandLane lane);
+    // Non-blocking; reports the lane the command came from
+    bool pop(EngineCommand& command, CommandLane* lane = nullptr);
+    // Block until a command is queued or the timeout passes
+    bool waitForCommand(std::chrono::milliseconds timeout);
+
+    size_t size() const;
+    LaneStats getStats(CommandLane lane) const;
+};
+
+} // namespace trading
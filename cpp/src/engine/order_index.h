@@ -0,0 +1,140 @@
+#pragma once
+
+#include "types.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+
+namespace trading {
+
+// Secondary indexes over active orders. Each active order carries one link
+// per index, so keeping the indexes current is O(1) per state transition and
+// a query walks only the orders it returns.
+enum class OrderIndexKind : uint8_t {
+    SYMBOL,
+    ACCOUNT,
+    STATUS,
+    COUNT
+};
+
+class OrderList;
+
+// An order and its index links. The map node moves from activeOrders to
+// completedOrders as is when the order finishes; the links are unused there.
+struct OrderNode {
+    struct Link {
+        OrderNode* prev = nullptr;
+        OrderNode* next = nullptr;
+    };
+
+    Order order;
+    OrderStatus indexedStatus;  // Status list the order is linked into
+    std::array<Link, static_cast<size_t>(OrderIndexKind::COUNT)> links;
+    OrderList* symbolList = nullptr;   // Lists this order is linked into, so
+    OrderList* accountList = nullptr;  // removal needs no key lookups
+
+    explicit OrderNode(const Order& o) : order(o), indexedStatus(o.status) {}
+    OrderNode(const OrderNode&) = delete;
+    OrderNode& operator=(const OrderNode&) = delete;
+};
+
+// Intrusive doubly linked list threaded through one of the OrderNode links.
+// Orders appear in insertion order; nodes are owned elsewhere.
+class OrderList {
+private:
+    OrderNode* head_ = nullptr;
+    OrderNode* tail_ = nullptr;
+    size_t size_ = 0;
+    uint8_t link_;
+
+public:
+    explicit OrderList(OrderIndexKind kind) : link_(static_cast<uint8_t>(kind)) {}
+
+    void pushBack(OrderNode& node) {
+        auto& link = node.links[link_];
+        link.prev = tail_;
+        link.next = nullptr;
+        if (tail_) {
+            tail_->links[link_].next = &node;
+        } else {
+            head_ = &node;
+        }
+        tail_ = &node;
+        ++size_;
+    }
+
+    void remove(OrderNode& node) {
+        auto& link = node.links[link_];
+        (link.prev ? link.prev->links[link_].next : head_) = link.next;
+        (link.next ? link.next->links[link_].prev : tail_) = link.prev;
+        link.prev = link.next = nullptr;
+        --size_;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    // Visit the nodes themselves, for callers that go on to unlink them
+    template <typename Visitor>
+    void forEachNode(Visitor&& visit) const {
+        for (OrderNode* node = head_; node; node = node->links[link_].next) {
+            visit(*node);
+        }
+    }
+
+    class const_iterator {
+    private:
+        const OrderNode* node_;
+        uint8_t link_;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Order;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Order*;
+        using reference = const Order&;
+
+        const_iterator(const OrderNode* node, uint8_t link) : node_(node), link_(link) {}
+
+        reference operator*() const { return node_->order; }
+        pointer operator->() const { return &node_->order; }
+        const_iterator& operator++() {
+            node_ = node_->links[link_].next;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        }
+        bool operator==(const const_iterator& other) const { return node_ == other.node_; }
+        bool operator!=(const const_iterator& other) const { return node_ != other.node_; }
+    };
+
+    const_iterator begin() const { return const_iterator(head_, link_); }
+    const_iterator end() const { return const_iterator(nullptr, link_); }
+};
+
+// Zero-copy result of an index query. It holds the order lock while alive, so
+// iterate, copy out what is needed and let it go; calling back into the
+// OrderManager while a view is held deadlocks.
+class OrderView {
+private:
+    std::unique_lock<std::mutex> lock_;
+    const OrderList* list_;  // nullptr when nothing matched
+
+public:
+    OrderView(std::unique_lock<std::mutex> lock, const OrderList* list)
+        : lock_(std::move(lock)), list_(list && !list->empty() ? list : nullptr) {}
+
+    OrderList::const_iterator begin() const {
+        return list_ ? list_->begin() : OrderList::const_iterator(nullptr, 0);
+    }
+    OrderList::const_iterator end() const { return OrderList::const_iterator(nullptr, 0); }
+    size_t size() const { return list_ ? list_->size() : 0; }
+    bool empty() const { return list_ == nullptr; }
+};
+
+} // namespace trading
@@ -0,0 +1,1649 @@
+#include "order_manager.h"
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+
+namespace trading {
+
+namespace {
+
+constexpr double kQuantityEpsilon = 1e-9;
+
+double remainingQuantity(const Order& order) {
+    return order.quantity.value - order.filledQuantity.value;
+}
+
+// Exact, as the book keys its levels. Price == allows a tick of slack, so an
+// amend inside it would keep priority here yet move to a new book level.
+bool samePrice(const Price& a, const Price& b) {
+    return !(a < b) && !(a > b);
+}
+
+// Only live limit orders rest in the book. A stop-limit joins it as a
+// limit when it triggers; until then it is invisible to matching and signals.
+bool isBookedAtPrice(const Order& order) {
+    return order.limitPrice.has_value() && order.type == OrderType::LIMIT;
+}
+
+} // namespace
+
+// ---- OrderBookSide ----
+
+std::optional<Price> pegPrice(const PegKey& peg, OrderSide side, const MarketTick& tick) {
+    bool buy = side == OrderSide::BUY;
+    double reference = 0.0;
+    switch (peg.type) {
+        case PegType::PRIMARY:
+            reference = (buy ? tick.bid : tick.ask).value;
+            break;
+        case PegType::MARKET:
+            reference = (buy ? tick.ask : tick.bid).value;
+            break;
+        case PegType::MIDPOINT:
+            if (tick.bid.value > 0 && tick.ask.value > 0) {
+                reference = (tick.bid.value + tick.ask.value) / 2.0;
+            }
+            break;
+        case PegType::NONE:
+            break;
+    }
+    double price = buy ? reference - peg.offset : reference + peg.offset;
+    if (reference <= 0 || price <= 0) {
+        return std::nullopt;
+    }
+    return Price(price, tick.bid.precision);
+}
+
+OrderBookSide::OrderBookSide(const OrderBookSide& other)
+    : entries(other.entries), bidSide_(other.bidSide_), totalQuantity_(other.totalQuantity_),
+      depthLevels_(other.depthLevels_), depth_(other.depth_) {
+    rebuildIndex();
+}
+
+OrderBookSide& OrderBookSide::operator=(const OrderBookSide& other) {
+    if (this != &other) {
+        entries = other.entries;
+        bidSide_ = other.bidSide_;
+        totalQuantity_ = other.totalQuantity_;
+        depthLevels_ = other.depthLevels_;
+        depth_ = other.depth_;
+        rebuildIndex();
+    }
+    return *this;
+}
+
+bool OrderBookSide::withinDepth(double price) const {
+    return depth_.levels < depthLevels_ || (bidSide_ ? price >= depth_.boundary : price <= depth_.boundary);
+}
+
+void OrderBookSide::touched(double price) {
+    if (withinDepth(price)) {
+        refreshDepth();
+    }
+}
+
+void OrderBookSide::refreshDepth() {
+    // Walks at most N prices from the best; equal-price levels (peg groups) merge
+    DepthSummary depth;
+    double price = 0.0;
+    double quantity = 0.0;
+    bool pending = false;
+    auto close = [&]() {
+        double weight = 1.0 - static_cast<double>(depth.levels) / static_cast<double>(depthLevels_);
+        if (depth.levels == 0) {
+            depth.bestPrice = price;
+            depth.bestQuantity = quantity;
+        }
+        depth.weightedQuantity += weight * quantity;
+        depth.boundary = price;
+        ++depth.levels;
+    };
+    auto visit = [&](const auto& level) {
+        if (pending && level.first.value == price) {
+            quantity += level.second.totalQuantity;
+            return true;
+        }
+        if (pending) {
+            close();
+            if (depth.levels == depthLevels_) {
+                return false;
+            }
+        }
+        price = level.first.value;
+        quantity = level.second.totalQuantity;
+        pending = true;
+        return true;
+    };
+    bool more = true;
+    if (bidSide_) {
+        for (auto it = entries.begin(); it != entries.end() && (more = visit(*it)); ++it) {}
+    } else {
+        for (auto it = entries.rbegin(); it != entries.rend() && (more = visit(*it)); ++it) {}
+    }
+    if (more && pending) {
+        close();
+    }
+    depth_ = depth;
+}
+
+void OrderBookSide::setDepthLevels(size_t levels) {
+    depthLevels_ = std::max<size_t>(levels, 1);
+    refreshDepth();
+}
+
+void OrderBookSide::rebuildIndex() {
+    // Copied levels are new nodes, so the positions have to be re-taken
+    index_.clear();
+    pegGroups_.clear();
+    for (auto levelIt = entries.begin(); levelIt != entries.end(); ++levelIt) {
+        auto& level = levelIt->second;
+        if (level.peg) {
+            pegGroups_.emplace(*level.peg, levelIt);
+        }
+        for (auto it = level.orders.begin(); it != level.orders.end(); ++it) {
+            index_.emplace(it->orderId, EntryRef{&level, it});
+        }
+    }
+}
+
+OrderBookSide::Levels::iterator OrderBookSide::levelFor(const Order& order) {
+    const Price& price = *order.limitPrice;
+    if (order.pegType != PegType::NONE) {
+        PegKey key{order.pegType, order.pegOffset};
+        auto group = pegGroups_.find(key);
+        if (group != pegGroups_.end()) {
+            return group->second;  // Joins the group at its current price
+        }
+        auto levelIt = entries.emplace(price, PriceLevel());
+        levelIt->second.price = price;
+        levelIt->second.peg = key;
+        pegGroups_.emplace(key, levelIt);
+        return levelIt;
+    }
+    return plainLevel(price);
+}
+
+OrderBookSide::Levels::iterator OrderBookSide::plainLevel(const Price& price) {
+    auto [first, last] = entries.equal_range(price);
+    for (auto it = first; it != last; ++it) {
+        if (!it->second.peg) {
+            return it;
+        }
+    }
+    auto levelIt = entries.emplace_hint(last, price, PriceLevel());
+    levelIt->second.price = price;
+    return levelIt;
+}
+
+OrderBookSide::Levels::iterator OrderBookSide::findLevel(const PriceLevel& level) {
+    if (level.peg) {
+        return pegGroups_.at(*level.peg);
+    }
+    auto [first, last] = entries.equal_range(level.price);
+    for (auto it = first; it != last; ++it) {
+        if (&it->second == &level) {
+            return it;
+        }
+    }
+    return entries.end();
+}
+
+void OrderBookSide::eraseLevel(Levels::iterator levelIt) {
+    if (levelIt->second.peg) {
+        pegGroups_.erase(*levelIt->second.peg);
+    }
+    entries.erase(levelIt);
+}
+
+void OrderBookSide::addOrder(const Order& order) {
+    double remaining = remainingQuantity(order);
+    auto& level = levelFor(order)->second;
+    level.orders.emplace_back(level.price, Quantity(remaining), order.id);
+    level.orders.back().timestamp = order.timestamp;
+    level.totalQuantity += remaining;
+    totalQuantity_ += remaining;
+    index_.insert_or_assign(order.id, EntryRef{&level, std::prev(level.orders.end())});
+    touched(level.price.value);
+}
+
+void OrderBookSide::eraseEntry(std::unordered_map<std::string, EntryRef>::iterator ref) {
+    auto [level, entry] = ref->second;
+    double price = level->price.value;
+    level->totalQuantity -= entry->quantity.value;
+    totalQuantity_ -= entry->quantity.value;
+    level->orders.erase(entry);
+    if (level->orders.empty()) {
+        eraseLevel(findLevel(*level));
+    }
+    index_.erase(ref);
+    touched(price);
+}
+
+void OrderBookSide::removeOrder(const Order& order) {
+    auto ref = index_.find(order.id);
+    if (ref != index_.end()) {
+        eraseEntry(ref);
+    }
+}
+
+void OrderBookSide::removeOrders(const std::vector<const Order*>& orders) {
+    // Group the entries by level, then settle each level once: a level losing
+    // every order is dropped whole, otherwise just those nodes are unlinked.
+    // The depth summary is refreshed once for the batch.
+    std::unordered_map<PriceLevel*, std::vector<std::unordered_map<std::string, EntryRef>::iterator>> byLevel;
+    for (const Order* order : orders) {
+        auto ref = index_.find(order->id);
+        if (ref != index_.end()) {
+            byLevel[ref->second.level].push_back(ref);
+        }
+    }
+
+    bool refresh = false;
+    for (auto& [level, refs] : byLevel) {
+        std::sort(refs.begin(), refs.end(), [](auto a, auto b) { return &*a < &*b; });
+        refs.erase(std::unique(refs.begin(), refs.end()), refs.end());
+        refresh = refresh || withinDepth(level->price.value);
+        if (refs.size() == level->orders.size()) {
+            totalQuantity_ -= level->totalQuantity;
+            for (auto ref : refs) {
+                index_.erase(ref);
+            }
+            eraseLevel(findLevel(*level));
+            continue;
+        }
+        double removed = 0.0;
+        for (auto ref : refs) {
+            removed += ref->second.entry->quantity.value;
+            level->orders.erase(ref->second.entry);
+            index_.erase(ref);
+        }
+        level->totalQuantity -= removed;
+        totalQuantity_ -= removed;
+    }
+    if (refresh) {
+        refreshDepth();
+    }
+}
+
+void OrderBookSide::updateOrder(const Order& order) {
+    double remaining = remainingQuantity(order);
+    auto ref = index_.find(order.id);
+    if (ref == index_.end()) {
+        return;
+    }
+    if (remaining <= kQuantityEpsilon) {
+        eraseEntry(ref);
+        return;
+    }
+
+    auto [level, entry] = ref->second;
+    level->totalQuantity += remaining - entry->quantity.value;
+    totalQuantity_ += remaining - entry->quantity.value;
+    entry->quantity.value = remaining;
+    touched(level->price.value);
+}
+
+bool OrderBookSide::amendOrder(const std::string& orderId, const Price& newPrice, double newRemaining) {
+    auto ref = index_.find(orderId);
+    if (ref == index_.end() || newRemaining <= kQuantityEpsilon) {
+        return false;
+    }
+
+    auto& [level, entry] = ref->second;
+    double delta = newRemaining - entry->quantity.value;
+    totalQuantity_ += delta;
+    entry->quantity.value = newRemaining;
+
+    if (samePrice(level->price, newPrice)) {
+        level->totalQuantity += delta;
+        if (delta > kQuantityEpsilon) {
+            // Size up goes to the back of the queue
+            level->orders.splice(level->orders.end(), level->orders, entry);
+        }
+        touched(level->price.value);
+        return true;
+    }
+    if (level->peg) {
+        return false;  // A peg group's price follows the quote
+    }
+    double oldPrice = level->price.value;
+
+    // Move the node itself to the back of the new level
+    auto& target = plainLevel(newPrice)->second;
+    PriceLevel* from = level;
+    from->totalQuantity -= newRemaining - delta;
+    target.orders.splice(target.orders.end(), from->orders, entry);
+    target.totalQuantity += newRemaining;
+    entry->price = newPrice;
+    if (from->orders.empty()) {
+        eraseLevel(findLevel(*from));
+    }
+    level = &target;
+    touched(bidSide_ ? std::max(oldPrice, newPrice.value) : std::min(oldPrice, newPrice.value));
+    return true;
+}
+
+size_t OrderBookSide::repricePegs(const MarketTick& tick) {
+    size_t moved = 0;
+    OrderSide side = bidSide_ ? OrderSide::BUY : OrderSide::SELL;
+    for (auto& [key, levelIt] : pegGroups_) {
+        auto price = pegPrice(key, side, tick);
+        if (!price || price->value == levelIt->first.value) {
+            continue;  // No reference: the group rests where it is
+        }
+        // Re-key the map node in place; the entries and the index are untouched.
+        // It lands behind any levels already resting at the new price.
+        auto node = entries.extract(levelIt);
+        node.key() = *price;
+        node.mapped().price = *price;
+        levelIt = entries.insert(std::move(node));
+        ++moved;
+    }
+    if (moved > 0) {
+        refreshDepth();
+    }
+    return moved;
+}
+
+std::optional<Price> OrderBookSide::getRestingPrice(const std::string& orderId) const {
+    auto ref = index_.find(orderId);
+    if (ref == index_.end()) {
+        return std::nullopt;
+    }
+    return ref->second.level->price;
+}
+
+std::vector<OrderBookEntry> OrderBookSide::getTopLevels(size_t levels) const {
+    std::vector<OrderBookEntry> result;
+    auto emit = [&](const auto& level) {
+        if (!result.empty() && result.back().price.value == level.first.value) {
+            result.back().quantity.value += level.second.totalQuantity;  // Peg group at a plain price
+            return true;
+        }
+        if (result.size() == levels) {
+            return false;
+        }
+        result.emplace_back(level.first, Quantity(level.second.totalQuantity), "");
+        return true;
+    };
+
+    if (bidSide_) {
+        for (auto it = entries.begin(); it != entries.end() && emit(*it); ++it) {}
+    } else {
+        for (auto it = entries.rbegin(); it != entries.rend() && emit(*it); ++it) {}
+    }
+    return result;
+}
+
+Price OrderBookSide::getBestPrice() const {
+    if (entries.empty()) {
+        return Price(0.0);
+    }
+    return bidSide_ ? entries.begin()->first : entries.rbegin()->first;
+}
+
+bool OrderBookSide::isEmpty() const {
+    return entries.empty();
+}
+
+void OrderBookSide::clear() {
+    entries.clear();
+    index_.clear();
+    pegGroups_.clear();
+    totalQuantity_ = 0.0;
+    depth_ = DepthSummary();
+}
+
+std::vector<std::pair<std::string, double>> OrderBookSide::allocate(const Price& limit, double volume) {
+    std::vector<std::pair<std::string, double>> allocations;
+
+    while (volume > kQuantityEpsilon && !entries.empty()) {
+        // Asks walk from the back, but levels sharing a price still fill in arrival order
+        auto levelIt = bidSide_ ? entries.begin() : entries.lower_bound(std::prev(entries.end())->first);
+        if (bidSide_ ? levelIt->first < limit : levelIt->first > limit) {
+            break;
+        }
+
+        auto& level = levelIt->second;
+        auto first = level.orders.begin();
+        auto current = first;
+        while (current != level.orders.end() && volume > kQuantityEpsilon) {
+            double quantity = std::min(current->quantity.value, volume);
+            allocations.emplace_back(current->orderId, quantity);
+            volume -= quantity;
+            level.totalQuantity -= quantity;
+            totalQuantity_ -= quantity;
+            current->quantity.value -= quantity;
+            if (current->quantity.value > kQuantityEpsilon) {
+                break;  // Partially filled order keeps its place at the front
+            }
+            index_.erase(current->orderId);
+            ++current;
+        }
+        level.orders.erase(first, current);
+        if (level.orders.empty()) {
+            eraseLevel(levelIt);
+        }
+    }
+
+    if (!allocations.empty()) {
+        refreshDepth();  // Fills come off the top
+    }
+    return allocations;
+}
+
+// ---- OrderBook ----
+
+void OrderBook::addOrder(const Order& order) {
+    if (isBookedAtPrice(order)) {
+        (order.side == OrderSide::BUY ? bids : asks).addOrder(order);
+        refreshSignals();
+    } else if (order.type == OrderType::MARKET && phase_ == TradingPhase::AUCTION) {
+        auto& queue = order.side == OrderSide::BUY ? auctionMarketBuys_ : auctionMarketSells_;
+        double remaining = remainingQuantity(order);
+        queue.emplace_back(Price(0.0), Quantity(remaining), order.id);
+        queue.back().timestamp = order.timestamp;
+        (order.side == OrderSide::BUY ? auctionMarketBuyQuantity_ : auctionMarketSellQuantity_) += remaining;
+    }
+}
+
+void OrderBook::removeOrder(const Order& order) {
+    if (isBookedAtPrice(order)) {
+        (order.side == OrderSide::BUY ? bids : asks).removeOrder(order);
+        refreshSignals();
+        return;
+    }
+
+    auto& queue = order.side == OrderSide::BUY ? auctionMarketBuys_ : auctionMarketSells_;
+    auto it = std::find_if(queue.begin(), queue.end(),
+                           [&](const OrderBookEntry& e) { return e.orderId == order.id; });
+    if (it != queue.end()) {
+        (order.side == OrderSide::BUY ? auctionMarketBuyQuantity_ : auctionMarketSellQuantity_) -= it->quantity.value;
+        queue.erase(it);
+    }
+}
+
+void OrderBook::removeOrders(const std::vector<const Order*>& orders) {
+    std::vector<const Order*> bidOrders, askOrders;
+    std::unordered_set<std::string_view> marketIds;
+    for (const Order* order : orders) {
+        if (isBookedAtPrice(*order)) {
+            (order->side == OrderSide::BUY ? bidOrders : askOrders).push_back(order);
+        } else {
+            marketIds.insert(order->id);
+        }
+    }
+    if (!bidOrders.empty()) {
+        bids.removeOrders(bidOrders);
+    }
+    if (!askOrders.empty()) {
+        asks.removeOrders(askOrders);
+    }
+    refreshSignals();
+    if (marketIds.empty()) {
+        return;
+    }
+
+    // Auction market orders (anything else was never queued and is skipped)
+    for (bool buy : {true, false}) {
+        auto& queue = buy ? auctionMarketBuys_ : auctionMarketSells_;
+        auto& total = buy ? auctionMarketBuyQuantity_ : auctionMarketSellQuantity_;
+        auto kept = std::remove_if(queue.begin(), queue.end(), [&](const OrderBookEntry& e) {
+            if (marketIds.count(e.orderId) == 0) {
+                return false;
+            }
+            total -= e.quantity.value;
+            return true;
+        });
+        queue.erase(kept, queue.end());
+    }
+}
+
+bool OrderBook::amendOrder(const Order& order, const Price& newPrice, double newRemaining) {
+    if (isBookedAtPrice(order)) {
+        bool amended = (order.side == OrderSide::BUY ? bids : asks).amendOrder(order.id, newPrice, newRemaining);
+        refreshSignals();
+        return amended;
+    }
+
+    // Queued auction market orders can only change size
+    auto& queue = order.side == OrderSide::BUY ? auctionMarketBuys_ : auctionMarketSells_;
+    auto& total = order.side == OrderSide::BUY ? auctionMarketBuyQuantity_ : auctionMarketSellQuantity_;
+    auto it = std::find_if(queue.begin(), queue.end(), [&](const OrderBookEntry& e) { return e.orderId == order.id; });
+    if (it == queue.end()) {
+        return false;
+    }
+    total += newRemaining - it->quantity.value;
+    it->quantity.value = newRemaining;
+    if (newRemaining > remainingQuantity(order) + kQuantityEpsilon) {
+        std::rotate(it, it + 1, queue.end());
+    }
+    return true;
+}
+
+size_t OrderBook::repricePegs(const MarketTick& tick) {
+    size_t moved = bids.repricePegs(tick) + asks.repricePegs(tick);
+    if (moved > 0) {
+        refreshSignals();
+    }
+    return moved;
+}
+
+std::optional<Price> OrderBook::getRestingPrice(const Order& order) const {
+    return (order.side == OrderSide::BUY ? bids : asks).getRestingPrice(order.id);
+}
+
+void OrderBook::updateOrder(const Order& order) {
+    if (isBookedAtPrice(order)) {
+        (order.side == OrderSide::BUY ? bids : asks).updateOrder(order);
+        refreshSignals();
+        return;
+    }
+
+    auto& queue = order.side == OrderSide::BUY ? auctionMarketBuys_ : auctionMarketSells_;
+    auto& total = order.side == OrderSide::BUY ? auctionMarketBuyQuantity_ : auctionMarketSellQuantity_;
+    double remaining = remainingQuantity(order);
+    for (auto it = queue.begin(); it != queue.end(); ++it) {
+        if (it->orderId == order.id) {
+            total += std::max(remaining, 0.0) - it->quantity.value;
+            if (remaining <= kQuantityEpsilon) {
+                queue.erase(it);
+            } else {
+                it->quantity.value = remaining;
+            }
+            return;
+        }
+    }
+}
+
+std::pair<std::vector<OrderBookEntry>, std::vector<OrderBookEntry>>
+OrderBook::getTopLevels(size_t levels) const {
+    return {bids.getTopLevels(levels), asks.getTopLevels(levels)};
+}
+
+Price OrderBook::getBestBid() const {
+    return bids.getBestPrice();
+}
+
+Price OrderBook::getBestAsk() const {
+    return asks.getBestPrice();
+}
+
+Price OrderBook::getSpread() const {
+    if (bids.isEmpty() || asks.isEmpty()) {
+        return Price(0.0);
+    }
+    return getBestAsk() - getBestBid();
+}
+
+AuctionUncross OrderBook::calculateUncross(std::optional<Price> referencePrice) const {
+    AuctionUncross best;
+
+    auto consider = [&](const Price& price, double demand, double supply) {
+        double matched = std::min(demand, supply);
+        if (matched <= kQuantityEpsilon) {
+            return;
+        }
+
+        bool better = !best.valid || matched > best.matchedQuantity + kQuantityEpsilon;
+        if (!better && matched >= best.matchedQuantity - kQuantityEpsilon) {
+            double imbalance = std::abs(demand - supply);
+            double bestImbalance = std::abs(best.imbalance());
+            if (imbalance < bestImbalance - kQuantityEpsilon) {
+                better = true;
+            } else if (referencePrice && imbalance <= bestImbalance + kQuantityEpsilon) {
+                better = std::abs(price.value - referencePrice->value) <
+                         std::abs(best.price.value - referencePrice->value);
+            }
+        }
+
+        if (better) {
+            best.valid = true;
+            best.price = price;
+            best.matchedQuantity = matched;
+            best.buyQuantity = demand;
+            best.sellQuantity = supply;
+        }
+    };
+
+    // Both sides are keyed highest price first, so one merged walk from the top
+    // builds the cumulative curves: demand at p is every bid priced >= p, and
+    // supply at p is every ask priced <= p (total asks minus those above p).
+    const auto& bidLevels = bids.getLevels();
+    const auto& askLevels = asks.getLevels();
+    auto bidIt = bidLevels.begin();
+    auto askIt = askLevels.begin();
+    double demand = auctionMarketBuyQuantity_;
+    double totalSupply = auctionMarketSellQuantity_ + asks.getTotalQuantity();
+    double supplyAbove = 0.0;
+
+    while (bidIt != bidLevels.end() || askIt != askLevels.end()) {
+        Price price;
+        if (askIt == askLevels.end() || (bidIt != bidLevels.end() && bidIt->first > askIt->first)) {
+            price = bidIt->first;
+        } else {
+            price = askIt->first;
+        }
+
+        double askAtPrice = 0.0;
+        while (bidIt != bidLevels.end() && bidIt->first.value == price.value) {
+            demand += bidIt->second.totalQuantity;
+            ++bidIt;
+        }
+        while (askIt != askLevels.end() && askIt->first.value == price.value) {
+            askAtPrice += askIt->second.totalQuantity;
+            ++askIt;
+        }
+
+        consider(price, demand, totalSupply - supplyAbove);
+        supplyAbove += askAtPrice;
+    }
+
+    // Market orders only: they cross at the reference price
+    if (!best.valid && referencePrice && referencePrice->value > 0) {
+        consider(*referencePrice, auctionMarketBuyQuantity_, auctionMarketSellQuantity_);
+    }
+
+    return best;
+}
+
+std::pair<std::vector<std::pair<std::string, double>>, std::vector<std::pair<std::string, double>>>
+OrderBook::allocateUncross(const AuctionUncross& uncross) {
+    auto allocateSide = [&](std::vector<OrderBookEntry>& marketQueue, double& marketTotal,
+                            OrderBookSide& side) {
+        std::vector<std::pair<std::string, double>> allocations;
+        double volume = uncross.matchedQuantity;
+
+        // Market orders have priority over every limit price
+        auto current = marketQueue.begin();
+        while (current != marketQueue.end() && volume > kQuantityEpsilon) {
+            double quantity = std::min(current->quantity.value, volume);
+            allocations.emplace_back(current->orderId, quantity);
+            volume -= quantity;
+            marketTotal -= quantity;
+            current->quantity.value -= quantity;
+            if (current->quantity.value > kQuantityEpsilon) {
+                break;
+            }
+            ++current;
+        }
+        marketQueue.erase(marketQueue.begin(), current);
+
+        auto limitAllocations = side.allocate(uncross.price, volume);
+        allocations.insert(allocations.end(), limitAllocations.begin(), limitAllocations.end());
+        return allocations;
+    };
+
+    if (!uncross.valid) {
+        return {};
+    }
+    std::pair<std::vector<std::pair<std::string, double>>, std::vector<std::pair<std::string, double>>> result{
+        allocateSide(auctionMarketBuys_, auctionMarketBuyQuantity_, bids),
+        allocateSide(auctionMarketSells_, auctionMarketSellQuantity_, asks)};
+    refreshSignals();
+    return result;
+}
+
+void OrderBook::setSignalDepth(size_t levels) {
+    bids.setDepthLevels(levels);
+    asks.setDepthLevels(levels);
+    signals_.depthLevels = std::max<size_t>(levels, 1);
+    refreshSignals();
+}
+
+void OrderBook::refreshSignals() {
+    const DepthSummary& bid = bids.getDepth();
+    const DepthSummary& ask = asks.getDepth();
+
+    double top = bid.bestQuantity + ask.bestQuantity;
+    signals_.topImbalance = top > 0.0 ? (bid.bestQuantity - ask.bestQuantity) / top : 0.0;
+    signals_.microprice = bid.levels > 0 && ask.levels > 0
+        ? (bid.bestPrice * ask.bestQuantity + ask.bestPrice * bid.bestQuantity) / top
+        : 0.0;
+    double depth = bid.weightedQuantity + ask.weightedQuantity;
+    signals_.depthImbalance = depth > 0.0 ? (bid.weightedQuantity - ask.weightedQuantity) / depth : 0.0;
+
+    // OFI: a better or same bid adds its size, a worse or same bid removes the
+    // old size; mirrored for the ask. An emptied side counts as price 0.
+    if (bid.bestPrice == lastBidPrice_ && bid.bestQuantity == lastBidQuantity_ &&
+        ask.bestPrice == lastAskPrice_ && ask.bestQuantity == lastAskQuantity_) {
+        return;
+    }
+    double flow = 0.0;
+    if (bid.bestPrice >= lastBidPrice_) flow += bid.bestQuantity;
+    if (bid.bestPrice <= lastBidPrice_) flow -= lastBidQuantity_;
+    bool askUp = ask.levels == 0 || (lastAskPrice_ > 0.0 && ask.bestPrice >= lastAskPrice_);
+    bool askDown = lastAskPrice_ == 0.0 || (ask.levels > 0 && ask.bestPrice <= lastAskPrice_);
+    if (askDown) flow -= ask.bestQuantity;
+    if (askUp) flow += lastAskQuantity_;
+    signals_.orderFlowImbalance += flow;
+    ++signals_.topUpdates;
+    lastBidPrice_ = bid.bestPrice;
+    lastBidQuantity_ = bid.bestQuantity;
+    lastAskPrice_ = ask.bestPrice;
+    lastAskQuantity_ = ask.bestQuantity;
+}
+
+std::vector<std::string> OrderBook::takeAuctionMarketOrders() {
+    std::vector<std::string> ids;
+    for (const auto& entry : auctionMarketBuys_) ids.push_back(entry.orderId);
+    for (const auto& entry : auctionMarketSells_) ids.push_back(entry.orderId);
+    auctionMarketBuys_.clear();
+    auctionMarketSells_.clear();
+    auctionMarketBuyQuantity_ = 0.0;
+    auctionMarketSellQuantity_ = 0.0;
+    return ids;
+}
+
+// ---- OrderManager ----
+
+OrderManager::OrderManager(std::shared_ptr<Clock> clock) : clock_(std::move(clock)) {
+    static std::atomic<int> instance_count{0};
+    logger_ = spdlog::stdout_color_mt("order_manager_" + std::to_string(instance_count++));
+    logger_->set_level(spdlog::level::info);
+}
+
+std::string OrderManager::generateOrderId() {
+    return "ORD-" + std::to_string(++orderIdCounter_);
+}
+
+std::string OrderManager::generateTradeId() {
+    return "TRD-" + std::to_string(++tradeIdCounter_);
+}
+
+bool OrderManager::checkOrderValidity(const Order& order) const {
+    if (order.asset.symbol.empty() || order.quantity.value <= 0) {
+        return false;
+    }
+
+    if (order.pegType != PegType::NONE && order.type != OrderType::LIMIT) {
+        return false;
+    }
+
+    switch (order.type) {
+        case OrderType::LIMIT:
+            return order.limitPrice && order.limitPrice->value > 0;
+        case OrderType::STOP:
+        case OrderType::TRAILING_STOP:
+            return order.stopPrice && order.stopPrice->value > 0;
+        case OrderType::STOP_LIMIT:
+            return order.limitPrice && order.limitPrice->value > 0 &&
+                   order.stopPrice && order.stopPrice->value > 0;
+        case OrderType::MARKET:
+            return true;
+    }
+    return false;
+}
+
+OrderBook& OrderManager::bookFor(const std::string& symbol) {
+    auto [it, inserted] = orderBooks.try_emplace(symbol, symbol);
+    if (inserted && bookSignalDepth_ != it->second.getSignals().depthLevels) {
+        it->second.setSignalDepth(bookSignalDepth_);
+    }
+    return it->second;
+}
+
+void OrderManager::refreshPegPrice(Order& order) const {
+    if (order.pegType == PegType::NONE) {
+        return;
+    }
+    auto bookIt = orderBooks.find(order.asset.symbol);
+    if (bookIt != orderBooks.end()) {
+        if (auto price = bookIt->second.getRestingPrice(order)) {
+            order.limitPrice = *price;
+        }
+    }
+}
+
+Trade OrderManager::applyFill(Order& order, double quantity, const Price& price) {
+    double filled = order.filledQuantity.value + quantity;
+    order.averageFillPrice.value =
+        (order.averageFillPrice.value * order.filledQuantity.value + price.value * quantity) / filled;
+    order.filledQuantity.value = filled;
+    order.status = remainingQuantity(order) <= kQuantityEpsilon ? OrderStatus::FILLED : OrderStatus::PARTIAL;
+
+    Trade trade;
+    trade.id = generateTradeId();
+    trade.orderId = order.id;
+    trade.asset = order.asset;
+    trade.side = order.side;
+    trade.quantity = Quantity(quantity);
+    trade.price = price;
+    trade.timestamp = clock_->now();
+    trade.exchange = order.asset.exchange;
+    return trade;
+}
+
+ExecutionResult OrderManager::executeMarketOrder(const Order& order, const MarketTick& tick) {
+    ExecutionResult result;
+    result.updatedOrder = order;
+
+    bool buy = order.side == OrderSide::BUY;
+    Price price = buy ? tick.ask : tick.bid;
+    if (price.value <= 0) {
+        price = tick.last;
+    }
+    if (price.value <= 0) {
+        result.message = "No executable price for " + order.asset.symbol;
+        return result;
+    }
+
+    double remaining = remainingQuantity(order);
+    double available = (buy ? tick.askSize : tick.bidSize).value;
+    double quantity = available > 0 ? std::min(remaining, available) : remaining;
+    if (order.timeInForce == TimeInForce::FOK && quantity < remaining - kQuantityEpsilon) {
+        result.message = "Insufficient liquidity to fill FOK order";
+        return result;
+    }
+
+    result.trades.push_back(applyFill(result.updatedOrder, quantity, price));
+    result.success = true;
+    result.message = "Executed";
+    return result;
+}
+
+ExecutionResult OrderManager::executeLimitOrder(const Order& order, const MarketTick& tick) {
+    ExecutionResult result;
+    result.updatedOrder = order;
+
+    bool buy = order.side == OrderSide::BUY;
+    Price price = buy ? tick.ask : tick.bid;
+    const Price& limit = *order.limitPrice;
+    if (price.value <= 0 || (buy ? price > limit : price < limit)) {
+        result.message = "Limit not marketable";
+        return result;
+    }
+
+    double remaining = remainingQuantity(order);
+    double available = (buy ? tick.askSize : tick.bidSize).value;
+    double quantity = available > 0 ? std::min(remaining, available) : remaining;
+    if (order.timeInForce == TimeInForce::FOK && quantity < remaining - kQuantityEpsilon) {
+        result.message = "Insufficient liquidity to fill FOK order";
+        return result;
+    }
+
+    result.trades.push_back(applyFill(result.updatedOrder, quantity, price));
+    result.success = true;
+    result.message = "Executed";
+    return result;
+}
+
+void OrderManager::applyExecution(const ExecutionResult& result, PendingEvents& events, bool updateBook) {
+    auto it = activeOrders.find(result.updatedOrder.id);
+    if (it == activeOrders.end()) {
+        return;
+    }
+
+    OrderNode& active = it->second;
+    Order& order = active.order;
+    order = result.updatedOrder;
+    auto& trades = orderTrades[order.id];
+    trades.insert(trades.end(), result.trades.begin(), result.trades.end());
+    if (tradeCallback_) {
+        events.trades.insert(events.trades.end(), result.trades.begin(), result.trades.end());
+    }
+    if (executionCallback_) {
+        events.executions.push_back(result);
+    }
+    if (orderUpdateCallback_) {
+        events.orderUpdates.push_back(order);
+    }
+
+    if (updateBook) {
+        auto& book = bookFor(order.asset.symbol);
+        if (order.status == OrderStatus::FILLED) {
+            book.removeOrder(order);
+        } else {
+            book.updateOrder(order);
+        }
+    }
+    if (order.status == OrderStatus::FILLED) {
+        removeActiveOrder(active);
+    } else {
+        reindexStatus(active);
+    }
+}
+
+void OrderManager::finishOrder(OrderNode& active, OrderStatus status, PendingEvents& events) {
+    Order& order = active.order;
+    bookFor(order.asset.symbol).removeOrder(order);
+    order.status = status;
+    if (orderUpdateCallback_) {
+        events.orderUpdates.push_back(order);
+    }
+    removeActiveOrder(active);
+}
+
+OrderNode& OrderManager::addActiveOrder(const Order& order) {
+    OrderNode& active = activeOrders.try_emplace(order.id, order).first->second;
+    active.symbolList = &ordersBySymbol_.try_emplace(order.asset.symbol, OrderIndexKind::SYMBOL).first->second;
+    active.accountList = &ordersByAccount_.try_emplace(order.accountId, OrderIndexKind::ACCOUNT).first->second;
+    active.symbolList->pushBack(active);
+    active.accountList->pushBack(active);
+    statusList(order.status).pushBack(active);
+    return active;
+}
+
+void OrderManager::removeActiveOrder(OrderNode& active) {
+    active.symbolList->remove(active);
+    active.accountList->remove(active);
+    statusList(active.indexedStatus).remove(active);
+
+    // Relink the map node itself: no copy, no allocation
+    std::string orderId = active.order.id;
+    completedOrders.insert(activeOrders.extract(orderId));
+    retainCompleted(orderId);
+}
+
+void OrderManager::retainCompleted(const std::string& orderId) {
+    completionOrder_.push_back(orderId);
+    evictCompleted();
+}
+
+void OrderManager::evictCompleted() {
+    while (completionOrder_.size() > completedRetention_) {
+        completedOrders.erase(completionOrder_.front());
+        orderTrades.erase(completionOrder_.front());
+        completionOrder_.pop_front();
+    }
+}
+
+void OrderManager::reindexStatus(OrderNode& active) {
+    if (active.indexedStatus != active.order.status) {
+        statusList(active.indexedStatus).remove(active);
+        statusList(active.order.status).pushBack(active);
+        active.indexedStatus = active.order.status;
+    }
+}
+
+void OrderManager::processOrderBookUpdate(const std::string& symbol, PendingEvents& events) {
+    auto tickIt = lastTicks.find(symbol);
+    if (tickIt == lastTicks.end()) {
+        return;
+    }
+    const MarketTick& tick = tickIt->second;
+
+    auto indexIt = ordersBySymbol_.find(symbol);
+    if (indexIt == ordersBySymbol_.end() || indexIt->second.empty()) {
+        return;
+    }
+    // Executions unlink orders from the index, so walk a snapshot of the ids
+    std::vector<std::string> candidates;
+    candidates.reserve(indexIt->second.size());
+    for (const Order& order : indexIt->second) {
+        candidates.push_back(order.id);
+    }
+
+    for (const auto& id : candidates) {
+        tryExecute(id, tick, events);
+    }
+}
+
+void OrderManager::tryExecute(const std::string& orderId, const MarketTick& tick, PendingEvents& events) {
+    auto it = activeOrders.find(orderId);
+    if (it == activeOrders.end()) {
+        return;
+    }
+    Order& order = it->second.order;
+
+    // Stops trigger on the last trade price; trailing stops use the stop price as set.
+    // A triggered stop-limit enters the book at its limit price from here.
+    if (order.type == OrderType::STOP || order.type == OrderType::TRAILING_STOP ||
+        order.type == OrderType::STOP_LIMIT) {
+        bool buy = order.side == OrderSide::BUY;
+        bool triggered = tick.last.value > 0 &&
+                         (buy ? tick.last >= *order.stopPrice : tick.last <= *order.stopPrice);
+        if (!triggered) {
+            return;
+        }
+        order.type = order.type == OrderType::STOP_LIMIT ? OrderType::LIMIT : OrderType::MARKET;
+        if (isBookedAtPrice(order)) {
+            order.timestamp = clock_->now();  // Queues from the trigger, not the submit
+            bookFor(order.asset.symbol).addOrder(order);
+        }
+    }
+    refreshPegPrice(order);
+
+    ExecutionResult result = order.type == OrderType::MARKET ? executeMarketOrder(order, tick)
+                                                             : executeLimitOrder(order, tick);
+    if (result.success) {
+        applyExecution(result, events);
+    }
+
+    it = activeOrders.find(orderId);
+    if (it != activeOrders.end() &&
+        (it->second.order.timeInForce == TimeInForce::IOC || it->second.order.timeInForce == TimeInForce::FOK)) {
+        finishOrder(it->second, OrderStatus::CANCELLED, events);
+    }
+}
+
+void OrderManager::publishIndicative(const std::string& symbol, PendingEvents& events) {
+    if (!indicativePriceCallback_) {
+        return;  // Nobody listening; getIndicativeUncross computes on demand
+    }
+
+    auto bookIt = orderBooks.find(symbol);
+    if (bookIt == orderBooks.end() || bookIt->second.getPhase() != TradingPhase::AUCTION) {
+        return;
+    }
+
+    std::optional<Price> reference;
+    auto tickIt = lastTicks.find(symbol);
+    if (tickIt != lastTicks.end() && tickIt->second.last.value > 0) {
+        reference = tickIt->second.last;
+    }
+
+    AuctionUncross indicative = bookIt->second.calculateUncross(reference);
+    auto [it, inserted] = lastIndicative.try_emplace(symbol, indicative);
+    if (inserted || !(it->second == indicative)) {
+        it->second = indicative;
+        events.indicatives.emplace_back(symbol, indicative);
+    }
+}
+
+void OrderManager::dispatch(PendingEvents& events) {
+    if (orderUpdateCallback_) {
+        for (const auto& order : events.orderUpdates) orderUpdateCallback_(order);
+    }
+    if (tradeCallback_) {
+        for (const auto& trade : events.trades) tradeCallback_(trade);
+    }
+    if (executionCallback_) {
+        for (const auto& execution : events.executions) executionCallback_(execution);
+    }
+    if (indicativePriceCallback_) {
+        for (const auto& [symbol, indicative] : events.indicatives) indicativePriceCallback_(symbol, indicative);
+    }
+    if (!events.massCancels.empty()) {
+        if (massCancelCallback_) {
+            massCancelCallback_(events.massCancels);
+        } else if (orderUpdateCallback_) {
+            for (const auto& order : events.massCancels) orderUpdateCallback_(order);
+        }
+    }
+}
+
+std::string OrderManager::submitOrder(const Order& order) {
+    Order newOrder = order;
+    newOrder.id = generateOrderId();
+    return enterOrder(std::move(newOrder));
+}
+
+std::string OrderManager::enterOrder(Order newOrder) {
+    newOrder.status = OrderStatus::PENDING;
+    newOrder.timestamp = clock_->now();
+    newOrder.filledQuantity = Quantity(0.0);
+    newOrder.averageFillPrice = Price(0.0);
+
+    PendingEvents events;
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        const std::string symbol = newOrder.asset.symbol;
+        if (newOrder.pegType != PegType::NONE) {
+            // Starts at the peg's current price; the book keeps it there from now on
+            auto tickIt = lastTicks.find(symbol);
+            std::optional<Price> price;
+            if (tickIt != lastTicks.end()) {
+                price = pegPrice(PegKey{newOrder.pegType, newOrder.pegOffset}, newOrder.side, tickIt->second);
+            }
+            if (!price) {
+                logger_->warn("Rejected pegged order for {}: no quote to peg to", symbol);
+                return "";
+            }
+            newOrder.limitPrice = *price;
+        }
+        if (!checkOrderValidity(newOrder)) {
+            logger_->warn("Rejected invalid order for {}", symbol);
+            return "";
+        }
+
+        auto& book = bookFor(symbol);
+        Order& stored = addActiveOrder(newOrder).order;
+        if (orderUpdateCallback_) {
+            events.orderUpdates.push_back(stored);
+        }
+
+        if (book.getPhase() == TradingPhase::AUCTION) {
+            // Call period: accumulate only. Untriggered stops stay out of the
+            // book and the uncross until a tick triggers them.
+            book.addOrder(stored);
+            publishIndicative(symbol, events);
+        } else {
+            if (isBookedAtPrice(stored)) {
+                book.addOrder(stored);
+            }
+            processOrderBookUpdate(symbol, events);
+        }
+    }
+
+    logger_->debug("Order {} submitted for {}", newOrder.id, newOrder.asset.symbol);
+    dispatch(events);
+    return newOrder.id;
+}
+
+bool OrderManager::cancelOrder(const std::string& orderId) {
+    PendingEvents events;
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        auto it = activeOrders.find(orderId);
+        if (it == activeOrders.end()) {
+            return false;
+        }
+        std::string symbol = it->second.order.asset.symbol;
+        finishOrder(it->second, OrderStatus::CANCELLED, events);
+        publishIndicative(symbol, events);
+    }
+    dispatch(events);
+    return true;
+}
+
+bool OrderManager::modifyOrder(const std::string& orderId, const Order& newOrder) {
+    PendingEvents events;
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        auto it = activeOrders.find(orderId);
+        if (it == activeOrders.end()) {
+            return false;
+        }
+
+        Order updated = it->second.order;
+        updated.quantity = newOrder.quantity;
+        updated.limitPrice = newOrder.limitPrice;
+        updated.stopPrice = newOrder.stopPrice;
+        updated.timeInForce = newOrder.timeInForce;
+        refreshPegPrice(updated);  // A pegged order's price is not the caller's to set
+        if (updated.pegType != PegType::NONE) {
+            updated.limitPrice = it->second.order.limitPrice;
+        }
+        if (!checkOrderValidity(updated) || remainingQuantity(updated) <= kQuantityEpsilon) {
+            return false;
+        }
+
+        // Replace loses time priority
+        auto& book = bookFor(updated.asset.symbol);
+        book.removeOrder(it->second.order);
+        updated.timestamp = clock_->now();
+        it->second.order = updated;
+        book.addOrder(it->second.order);
+        if (orderUpdateCallback_) {
+            events.orderUpdates.push_back(it->second.order);
+        }
+
+        if (book.getPhase() == TradingPhase::AUCTION) {
+            publishIndicative(updated.asset.symbol, events);
+        } else {
+            processOrderBookUpdate(updated.asset.symbol, events);
+        }
+    }
+    dispatch(events);
+    return true;
+}
+
+size_t OrderManager::massCancel(const MassCancelScope& scope) {
+    PendingEvents events;
+    size_t cancelled = 0;
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        auto matches = [&](const Order& order) {
+            return (!scope.accountId || order.accountId == *scope.accountId) &&
+                   (!scope.symbol || order.asset.symbol == *scope.symbol) &&
+                   (!scope.side || order.side == *scope.side);
+        };
+
+        // Walk the narrowest index available; the status lists together hold every active order
+        std::vector<const OrderList*> lists;
+        if (scope.accountId) {
+            auto it = ordersByAccount_.find(*scope.accountId);
+            if (it != ordersByAccount_.end()) lists.push_back(&it->second);
+        } else if (scope.symbol) {
+            auto it = ordersBySymbol_.find(*scope.symbol);
+            if (it != ordersBySymbol_.end()) lists.push_back(&it->second);
+        } else {
+            for (const auto& list : ordersByStatus_) lists.push_back(&list);
+        }
+
+        std::vector<OrderNode*> targets;
+        std::unordered_map<std::string, std::vector<const Order*>> bySymbol;
+        for (const OrderList* list : lists) {
+            list->forEachNode([&](OrderNode& active) {
+                if (matches(active.order)) {
+                    targets.push_back(&active);
+                    bySymbol[active.order.asset.symbol].push_back(&active.order);
+                }
+            });
+        }
+        if (targets.empty()) {
+            return 0;
+        }
+
+        // Books first, level by level, while the orders are still in place
+        for (const auto& [symbol, orders] : bySymbol) {
+            bookFor(symbol).removeOrders(orders);
+        }
+
+        bool report = massCancelCallback_ || orderUpdateCallback_;
+        if (report) {
+            events.massCancels.reserve(targets.size());
+        }
+        completedOrders.reserve(completedOrders.size() + targets.size());
+        for (OrderNode* active : targets) {
+            active->order.status = OrderStatus::CANCELLED;
+            if (report) {
+                events.massCancels.push_back(active->order);
+            }
+            removeActiveOrder(*active);
+        }
+        for (const auto& [symbol, orders] : bySymbol) {
+            publishIndicative(symbol, events);
+        }
+        cancelled = targets.size();
+    }
+
+    logger_->info("Mass cancel removed {} orders", cancelled);
+    dispatch(events);
+    return cancelled;
+}
+
+bool OrderManager::amendOrder(const std::string& orderId, std::optional<double> newQuantity,
+                              std::optional<Price> newLimitPrice) {
+    PendingEvents events;
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        auto it = activeOrders.find(orderId);
+        if (it == activeOrders.end()) {
+            return false;
+        }
+        Order& order = it->second.order;
+        refreshPegPrice(order);
+
+        double quantity = newQuantity.value_or(order.quantity.value);
+        if (quantity <= order.filledQuantity.value + kQuantityEpsilon) {
+            return false;  // Use cancel to remove the remainder
+        }
+        if (newLimitPrice && (!order.limitPrice || newLimitPrice->value <= 0 || order.pegType != PegType::NONE)) {
+            return false;
+        }
+
+        Price price = newLimitPrice.value_or(order.limitPrice.value_or(Price(0.0)));
+        double remaining = quantity - order.filledQuantity.value;
+        bool keepsPriority = remaining <= remainingQuantity(order) + kQuantityEpsilon &&
+                             (!newLimitPrice || samePrice(*newLimitPrice, *order.limitPrice));
+
+        auto& book = bookFor(order.asset.symbol);
+        book.amendOrder(order, price, remaining);  // No-op for orders not resting in the book
+        order.quantity.value = quantity;
+        if (newLimitPrice) {
+            order.limitPrice = price;
+        }
+        if (!keepsPriority) {
+            order.timestamp = clock_->now();
+        }
+        if (orderUpdateCallback_) {
+            events.orderUpdates.push_back(order);
+        }
+
+        if (book.getPhase() == TradingPhase::AUCTION) {
+            publishIndicative(order.asset.symbol, events);
+        } else if (newLimitPrice) {
+            // Only the amended order can have become marketable
+            auto tickIt = lastTicks.find(order.asset.symbol);
+            if (tickIt != lastTicks.end()) {
+                tryExecute(orderId, tickIt->second, events);
+            }
+        }
+    }
+    dispatch(events);
+    return true;
+}
+
+std::string OrderManager::enqueueCommand(EngineCommand command) {
+    CommandLane lane = CommandLane::PRIORITY;
+    switch (command.type) {
+        case CommandType::NEW_ORDER:
+            command.order.id = generateOrderId();
+            command.orderId = command.order.id;
+            {
+                std::lock_guard<std::mutex> lock(queuedIdsMutex_);
+                queuedNewOrders_.insert(command.orderId);
+            }
+            lane = riskReducing_ && riskReducing_(command.order) ? CommandLane::PRIORITY : CommandLane::NEW_ORDER;
+            break;
+        case CommandType::AMEND:
+            lane = CommandLane::AMEND;
+            break;
+        case CommandType::CANCEL:
+        case CommandType::MASS_CANCEL:
+            break;
+    }
+    std::string orderId = command.orderId;
+    commands_.push(std::move(command), lane);
+    return orderId;
+}
+
+size_t OrderManager::processCommands(size_t maxCommands) {
+    std::lock_guard<std::mutex> lock(commandMutex_);
+    size_t processed = 0;
+    EngineCommand command;
+    while (processed < maxCommands && commands_.pop(command)) {
+        executeCommand(command);
+        ++processed;
+    }
+    return processed;
+}
+
+bool OrderManager::isQueuedNewOrder(const std::string& orderId) {
+    std::lock_guard<std::mutex> lock(queuedIdsMutex_);
+    return queuedNewOrders_.count(orderId) > 0;
+}
+
+void OrderManager::finishQueuedOrder(Order& order, OrderStatus status) {
+    order.status = status;
+    order.timestamp = clock_->now();
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        if (completedOrders.try_emplace(order.id, order).second) {
+            retainCompleted(order.id);
+        }
+    }
+    if (orderUpdateCallback_) {
+        orderUpdateCallback_(order);
+    }
+}
+
+void OrderManager::executeCommand(EngineCommand& command) {
+    switch (command.type) {
+        case CommandType::NEW_ORDER: {
+            {
+                std::lock_guard<std::mutex> lock(queuedIdsMutex_);
+                queuedNewOrders_.erase(command.orderId);
+            }
+            auto held = heldCommands_.extract(command.orderId);
+            bool cancelled = !held.empty() &&
+                             std::any_of(held.mapped().begin(), held.mapped().end(),
+                                         [](const EngineCommand& c) { return c.type == CommandType::CANCEL; });
+            if (cancelled) {
+                // Cancelled before it was entered: it never reaches the book
+                finishQueuedOrder(command.order, OrderStatus::CANCELLED);
+                return;
+            }
+            Order order = command.order;
+            if (enterOrder(std::move(command.order)).empty()) {
+                // Invalid, or a peg with no quote: the sender still hears of it
+                finishQueuedOrder(order, OrderStatus::REJECTED);
+            }
+            if (!held.empty()) {
+                for (auto& amend : held.mapped()) {
+                    executeCommand(amend);
+                }
+            }
+            return;
+        }
+        case CommandType::AMEND:
+            if (amendOrder(command.orderId, command.newQuantity, command.newLimitPrice)) {
+                return;
+            }
+            if (isQueuedNewOrder(command.orderId)) {
+                heldCommands_[command.orderId].push_back(std::move(command));
+            } else if (commandRejectCallback_) {
+                commandRejectCallback_(command, "Amend rejected");
+            }
+            return;
+        case CommandType::CANCEL:
+            if (cancelOrder(command.orderId)) {
+                return;
+            }
+            if (isQueuedNewOrder(command.orderId)) {
+                heldCommands_[command.orderId].push_back(std::move(command));
+            } else if (commandRejectCallback_) {
+                commandRejectCallback_(command, "Too late to cancel");
+            }
+            return;
+        case CommandType::MASS_CANCEL:
+            massCancel(command.scope);
+            return;
+    }
+}
+
+Order OrderManager::getOrder(const std::string& orderId) const {
+    std::scoped_lock lock(orderMutex_, bookMutex_);
+    auto it = activeOrders.find(orderId);
+    if (it != activeOrders.end()) {
+        Order order = it->second.order;
+        refreshPegPrice(order);
+        return order;
+    }
+    auto done = completedOrders.find(orderId);
+    return done != completedOrders.end() ? done->second.order : Order();
+}
+
+std::vector<Order> OrderManager::getActiveOrders() const {
+    std::lock_guard<std::mutex> lock(orderMutex_);
+    std::vector<Order> orders;
+    orders.reserve(activeOrders.size());
+    for (const auto& [id, active] : activeOrders) {
+        orders.push_back(active.order);
+    }
+    return orders;
+}
+
+std::vector<Order> OrderManager::getOrdersBySymbol(const std::string& symbol) const {
+    OrderView view = viewOrdersBySymbol(symbol);
+    return std::vector<Order>(view.begin(), view.end());
+}
+
+OrderView OrderManager::viewOrdersBySymbol(const std::string& symbol) const {
+    std::unique_lock<std::mutex> lock(orderMutex_);
+    auto it = ordersBySymbol_.find(symbol);
+    return OrderView(std::move(lock), it != ordersBySymbol_.end() ? &it->second : nullptr);
+}
+
+OrderView OrderManager::viewOrdersByAccount(const std::string& accountId) const {
+    std::unique_lock<std::mutex> lock(orderMutex_);
+    auto it = ordersByAccount_.find(accountId);
+    return OrderView(std::move(lock), it != ordersByAccount_.end() ? &it->second : nullptr);
+}
+
+OrderView OrderManager::viewOrdersByStatus(OrderStatus status) const {
+    std::unique_lock<std::mutex> lock(orderMutex_);
+    return OrderView(std::move(lock), &ordersByStatus_[static_cast<size_t>(status)]);
+}
+
+std::vector<Trade> OrderManager::getOrderTrades(const std::string& orderId) const {
+    std::lock_guard<std::mutex> lock(orderMutex_);
+    auto it = orderTrades.find(orderId);
+    return it != orderTrades.end() ? it->second : std::vector<Trade>();
+}
+
+void OrderManager::setCompletedOrderRetention(size_t orders) {
+    std::lock_guard<std::mutex> lock(orderMutex_);
+    completedRetention_ = orders;
+    evictCompleted();
+}
+
+size_t OrderManager::getCompletedOrderCount() const {
+    std::lock_guard<std::mutex> lock(orderMutex_);
+    return completedOrders.size();
+}
+
+OrderBook OrderManager::getOrderBook(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(bookMutex_);
+    auto it = orderBooks.find(symbol);
+    return it != orderBooks.end() ? it->second : OrderBook(symbol);
+}
+
+std::optional<BookSignals> OrderManager::getBookSignals(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(bookMutex_);
+    auto it = orderBooks.find(symbol);
+    if (it == orderBooks.end()) {
+        return std::nullopt;
+    }
+    return it->second.getSignals();
+}
+
+void OrderManager::setBookSignalDepth(size_t levels) {
+    std::lock_guard<std::mutex> lock(bookMutex_);
+    bookSignalDepth_ = std::max<size_t>(levels, 1);
+    for (auto& [symbol, book] : orderBooks) {
+        book.setSignalDepth(bookSignalDepth_);
+    }
+}
+
+std::vector<std::string> OrderManager::getSymbols() const {
+    std::lock_guard<std::mutex> lock(bookMutex_);
+    std::vector<std::string> symbols;
+    symbols.reserve(orderBooks.size());
+    for (const auto& [symbol, book] : orderBooks) {
+        symbols.push_back(symbol);
+    }
+    return symbols;
+}
+
+void OrderManager::processMarketTick(const MarketTick& tick) {
+    PendingEvents events;
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        const std::string& symbol = tick.asset.symbol;
+        lastTicks[symbol] = tick;
+
+        auto bookIt = orderBooks.find(symbol);
+        if (bookIt == orderBooks.end()) {
+            return;
+        }
+        bookIt->second.repricePegs(tick);
+        if (bookIt->second.getPhase() == TradingPhase::AUCTION) {
+            // The reference price may break ties, so the indicative can move
+            publishIndicative(symbol, events);
+        } else {
+            processOrderBookUpdate(symbol, events);
+        }
+    }
+    dispatch(events);
+}
+
+void OrderManager::startAuction(const std::string& symbol) {
+    PendingEvents events;
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        bookFor(symbol).setPhase(TradingPhase::AUCTION);
+        lastIndicative.erase(symbol);
+        publishIndicative(symbol, events);
+    }
+    logger_->info("Auction call period started for {}", symbol);
+    dispatch(events);
+}
+
+AuctionUncross OrderManager::getIndicativeUncross(const std::string& symbol) const {
+    std::scoped_lock lock(orderMutex_, bookMutex_);
+    auto bookIt = orderBooks.find(symbol);
+    if (bookIt == orderBooks.end()) {
+        return AuctionUncross();
+    }
+
+    std::optional<Price> reference;
+    auto tickIt = lastTicks.find(symbol);
+    if (tickIt != lastTicks.end() && tickIt->second.last.value > 0) {
+        reference = tickIt->second.last;
+    }
+    return bookIt->second.calculateUncross(reference);
+}
+
+AuctionUncross OrderManager::uncrossAuction(const std::string& symbol) {
+    PendingEvents events;
+    AuctionUncross uncross;
+    {
+        std::scoped_lock lock(orderMutex_, bookMutex_);
+        auto bookIt = orderBooks.find(symbol);
+        if (bookIt == orderBooks.end() || bookIt->second.getPhase() != TradingPhase::AUCTION) {
+            return uncross;
+        }
+        auto& book = bookIt->second;
+
+        std::optional<Price> reference;
+        auto tickIt = lastTicks.find(symbol);
+        if (tickIt != lastTicks.end() && tickIt->second.last.value > 0) {
+            reference = tickIt->second.last;
+        }
+        uncross = book.calculateUncross(reference);
+
+        auto [buys, sells] = book.allocateUncross(uncross);
+        for (const auto* allocations : {&buys, &sells}) {
+            for (const auto& [orderId, quantity] : *allocations) {
+                auto it = activeOrders.find(orderId);
+                if (it == activeOrders.end()) {
+                    continue;
+                }
+                ExecutionResult result;
+                result.updatedOrder = it->second.order;
+                result.trades.push_back(applyFill(result.updatedOrder, quantity, uncross.price));
+                result.success = true;
+                result.message = "Auction uncross";
+                applyExecution(result, events, false);  // Already taken out of the book
+            }
+        }
+
+        // Unfilled auction market orders do not carry into continuous trading
+        for (const auto& orderId : book.takeAuctionMarketOrders()) {
+            auto it = activeOrders.find(orderId);
+            if (it != activeOrders.end()) {
+                finishOrder(it->second, OrderStatus::EXPIRED, events);
+            }
+        }
+
+        book.setPhase(TradingPhase::CONTINUOUS);
+        lastIndicative.erase(symbol);
+        processOrderBookUpdate(symbol, events);
+    }
+
+    logger_->info("Auction uncross for {}: {} @ {:.4f}", symbol, uncross.matchedQuantity, uncross.price.value);
+    dispatch(events);
+    return uncross;
+}
+
+TradingPhase OrderManager::getTradingPhase(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(bookMutex_);
+    auto it = orderBooks.find(symbol);
+    return it != orderBooks.end() ? it->second.getPhase() : TradingPhase::CONTINUOUS;
+}
+
+size_t OrderManager::getActiveOrderCount() const {
+    std::lock_guard<std::mutex> lock(orderMutex_);
+    return activeOrders.size();
+}
+
+size_t OrderManager::getOrderBookCount() const {
+    std::lock_guard<std::mutex> lock(bookMutex_);
+    return orderBooks.size();
+}
+
+bool OrderManager::checkRiskLimits(const Order& order, const RiskLimits& limits) const {
+    if ((order.asset.type == AssetType::OPTIONS && !limits.allowOptions) ||
+        (order.asset.type == AssetType::FUTURES && !limits.allowFutures)) {
+        return false;
+    }
+
+    double price = order.limitPrice ? order.limitPrice->value : 0.0;
+    if (price <= 0) {
+        std::lock_guard<std::mutex> lock(orderMutex_);
+        auto it = lastTicks.find(order.asset.symbol);
+        if (it != lastTicks.end()) {
+            price = it->second.last.value;
+        }
+    }
+    return order.quantity.value * price <= limits.maxPositionSize;
+}
+
+void OrderManager::cancelAllOrders() {
+    massCancel(MassCancelScope());
+    logger_->info("Cancelled all active orders");
+}
+
+void OrderManager::clearOrderBooks() {
+    cancelAllOrders();
+
+    std::scoped_lock lock(orderMutex_, bookMutex_);
+    orderBooks.clear();
+    lastIndicative.clear();
+}
+
+} // namespace trading
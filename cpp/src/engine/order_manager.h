@@ -1,13 +1,21 @@
 #pragma once
 
 #include "types.h"
+#include "order_index.h"
+#include "command_queue.h"
+#include "clock.h"
+#include <deque>
+#include <list>
+#include <map>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <queue>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <optional>
 #include <spdlog/spdlog.h>
 
 namespace trading {
@@ -23,35 +31,166 @@ struct OrderBookEntry {
         : price(p), quantity(q), orderId(id) {}
 };
 
+// Pegged orders with the same side, peg type and offset always share a price,
+// so they rest together in one level that moves as a unit.
+struct PegKey {
+    PegType type;
+    double offset;
+    
+    bool operator<(const PegKey& other) const {
+        return type != other.type ? type < other.type : offset < other.offset;
+    }
+};
+
+// Peg price for a side against the current quote, or nullopt without a usable reference
+std::optional<Price> pegPrice(const PegKey& peg, OrderSide side, const MarketTick& tick);
+
+// Resting orders at one price, in time priority, with their total quantity.
+// List nodes splice between levels on amend without reallocating.
+struct PriceLevel {
+    Price price;
+    double totalQuantity = 0.0;
+    std::list<OrderBookEntry> orders;
+    std::optional<PegKey> peg;  // Set on a peg group's level
+};
+
+// The best N prices of one side, kept current as levels change
+struct DepthSummary {
+    double bestPrice = 0.0;
+    double bestQuantity = 0.0;
+    double weightedQuantity = 0.0;  // Level i of N weighted 1 - i/N
+    double boundary = 0.0;          // Price of the Nth level once there are N
+    size_t levels = 0;
+};
+
+// Microstructure signals of one book, updated with it
+struct BookSignals {
+    double microprice = 0.0;          // Mid leaning toward the thinner side: (b*Qa + a*Qb) / (Qa + Qb)
+    double topImbalance = 0.0;        // (Qb - Qa) / (Qb + Qa) at the touch, in [-1, 1]
+    double depthImbalance = 0.0;      // Same over the top N levels, depth-weighted
+    double orderFlowImbalance = 0.0;  // Cumulative OFI (Cont, Kukanov & Stoikov) over top-of-book changes
+    uint64_t topUpdates = 0;          // Top-of-book changes counted into the OFI
+    size_t depthLevels = 5;
+};
+
 // Order book side (bids or asks)
 class OrderBookSide {
 private:
-    std::map<Price, std::vector<OrderBookEntry>, std::greater<Price>> entries; // Bids: highest first
-    std::mutex mutex_;
+    // Highest first on both sides. A price holds at most one plain level plus
+    // any peg groups currently at it; equal prices fill in arrival order.
+    using Levels = std::multimap<Price, PriceLevel, std::greater<Price>>;
+    struct EntryRef {
+        PriceLevel* level;  // Stable while a peg group's node is re-keyed
+        std::list<OrderBookEntry>::iterator entry;
+    };
+    
+    Levels entries;
+    std::unordered_map<std::string, EntryRef> index_;  // orderId -> resting entry
+    std::map<PegKey, Levels::iterator> pegGroups_;
+    bool bidSide_;
+    double totalQuantity_ = 0.0;
+    size_t depthLevels_ = 5;
+    DepthSummary depth_;
+    
+    Levels::iterator levelFor(const Order& order);
+    Levels::iterator plainLevel(const Price& price);
+    Levels::iterator findLevel(const PriceLevel& level);
+    void eraseLevel(Levels::iterator levelIt);
+    void eraseEntry(std::unordered_map<std::string, EntryRef>::iterator ref);
+    void rebuildIndex();
+    // A change at `price` can only move the summary if it is within the top N
+    bool withinDepth(double price) const;
+    void touched(double price);
+    void refreshDepth();
     
 public:
+    explicit OrderBookSide(bool bidSide) : bidSide_(bidSide) {}
+    OrderBookSide(const OrderBookSide& other);
+    OrderBookSide& operator=(const OrderBookSide& other);
+    OrderBookSide(OrderBookSide&&) = default;
+    OrderBookSide& operator=(OrderBookSide&&) = default;
+    
     void addOrder(const Order& order);
-    void removeOrder(const std::string& orderId);
+    void removeOrder(const Order& order);
+    void removeOrders(const std::vector<const Order*>& orders);
     void updateOrder(const Order& order);
+    // Quantity down at the same price keeps time priority; a price change or
+    // quantity up moves the entry to the back of its (new) level
+    bool amendOrder(const std::string& orderId, const Price& newPrice, double newRemaining);
+    // Move each peg group to its new price: one level move per group,
+    // however many orders it holds
+    size_t repricePegs(const MarketTick& tick);
+    std::optional<Price> getRestingPrice(const std::string& orderId) const;
     std::vector<OrderBookEntry> getTopLevels(size_t levels = 5) const;
+    Price getBestPrice() const;
     bool isEmpty() const;
     void clear();
+    
+    const Levels& getLevels() const { return entries; }
+    double getTotalQuantity() const { return totalQuantity_; }
+    size_t getPegGroupCount() const { return pegGroups_.size(); }
+    const DepthSummary& getDepth() const { return depth_; }
+    void setDepthLevels(size_t levels);
+    
+    // Take up to `volume` from levels at or better than `limit`, best level first and
+    // in time priority within a level. Returns (orderId, quantity) allocations.
+    std::vector<std::pair<std::string, double>> allocate(const Price& limit, double volume);
+};
+
+// Trading phase of a single book
+enum class TradingPhase {
+    CONTINUOUS,
+    AUCTION     // Call period: orders accumulate without matching until uncrossed
+};
+
+// Result of an auction uncross calculation
+struct AuctionUncross {
+    bool valid = false;
+    Price price;
+    double matchedQuantity = 0.0;
+    double buyQuantity = 0.0;    // Executable demand at price
+    double sellQuantity = 0.0;   // Executable supply at price
+    
+    double imbalance() const { return buyQuantity - sellQuantity; }
+    
+    bool operator==(const AuctionUncross& other) const {
+        return valid == other.valid && price.value == other.price.value &&
+               matchedQuantity == other.matchedQuantity && buyQuantity == other.buyQuantity &&
+               sellQuantity == other.sellQuantity;
+    }
 };
 
 // Complete order book
 class OrderBook {
 private:
-    OrderBookSide bids;
-    OrderBookSide asks;
+    OrderBookSide bids{true};
+    OrderBookSide asks{false};
     std::string symbol;
-    mutable std::mutex mutex_;
+    
+    // Auction state: market orders carry no price and execute first at the uncross
+    TradingPhase phase_ = TradingPhase::CONTINUOUS;
+    std::vector<OrderBookEntry> auctionMarketBuys_;
+    std::vector<OrderBookEntry> auctionMarketSells_;
+    double auctionMarketBuyQuantity_ = 0.0;
+    double auctionMarketSellQuantity_ = 0.0;
+    
+    BookSignals signals_;
+    double lastBidPrice_ = 0.0, lastBidQuantity_ = 0.0;
+    double lastAskPrice_ = 0.0, lastAskQuantity_ = 0.0;
+    
+    // O(1) from the sides' summaries; called after every change to the book
+    void refreshSignals();
     
 public:
     explicit OrderBook(const std::string& sym) : symbol(sym) {}
     
     void addOrder(const Order& order);
-    void removeOrder(const std::string& orderId);
+    void removeOrder(const Order& order);
+    void removeOrders(const std::vector<const Order*>& orders);
     void updateOrder(const Order& order);
+    bool amendOrder(const Order& order, const Price& newPrice, double newRemaining);
+    size_t repricePegs(const MarketTick& tick);
+    std::optional<Price> getRestingPrice(const Order& order) const;
     
     std::pair<std::vector<OrderBookEntry>, std::vector<OrderBookEntry>> 
     getTopLevels(size_t levels = 5) const;
@@ -61,6 +200,20 @@ public:
     Price getSpread() const;
     
     std::string getSymbol() const { return symbol; }
+    
+    const BookSignals& getSignals() const { return signals_; }
+    void setSignalDepth(size_t levels);
+    
+    // Auction support
+    TradingPhase getPhase() const { return phase_; }
+    void setPhase(TradingPhase phase) { phase_ = phase; }
+    AuctionUncross calculateUncross(std::optional<Price> referencePrice = std::nullopt) const;
+    
+    // Remove the executable quantity of an uncross from the book. Returns the
+    // buy and sell allocations; unfilled auction market orders stay queued.
+    std::pair<std::vector<std::pair<std::string, double>>, std::vector<std::pair<std::string, double>>>
+    allocateUncross(const AuctionUncross& uncross);
+    std::vector<std::string> takeAuctionMarketOrders();
 };
 
 // Order execution result
@@ -75,20 +228,57 @@ struct ExecutionResult {
 
 // Order manager callbacks
 using OrderCallback = std::function<void(const Order&)>;
+using OrderBatchCallback = std::function<void(const std::vector<Order>&)>;
 using TradeCallback = std::function<void(const Trade&)>;
 using ExecutionCallback = std::function<void(const ExecutionResult&)>;
+using IndicativePriceCallback = std::function<void(const std::string&, const AuctionUncross&)>;
+using CommandRejectCallback = std::function<void(const EngineCommand&, const std::string& reason)>;
+using RiskReducingPredicate = std::function<bool(const Order&)>;
 
 // Main order manager class
 class OrderManager {
 private:
     std::unordered_map<std::string, OrderBook> orderBooks;
-    std::unordered_map<std::string, Order> activeOrders;
+    std::unordered_map<std::string, OrderNode> activeOrders;  // Node-based: links stay valid
+    std::unordered_map<std::string, OrderNode> completedOrders;  // Nodes move over unlinked
+    std::deque<std::string> completionOrder_;                    // Ids in completedOrders, oldest first
+    size_t completedRetention_ = 100000;
     std::unordered_map<std::string, std::vector<Trade>> orderTrades;
+    std::unordered_map<std::string, MarketTick> lastTicks;
+    std::unordered_map<std::string, AuctionUncross> lastIndicative;
+    
+    // Secondary indexes over activeOrders, maintained on every transition
+    std::unordered_map<std::string, OrderList> ordersBySymbol_;
+    std::unordered_map<std::string, OrderList> ordersByAccount_;
+    std::array<OrderList, 6> ordersByStatus_{  // Indexed by OrderStatus
+        OrderList(OrderIndexKind::STATUS), OrderList(OrderIndexKind::STATUS), OrderList(OrderIndexKind::STATUS),
+        OrderList(OrderIndexKind::STATUS), OrderList(OrderIndexKind::STATUS), OrderList(OrderIndexKind::STATUS)};
     
     // Callbacks
     OrderCallback orderUpdateCallback_;
     TradeCallback tradeCallback_;
     ExecutionCallback executionCallback_;
+    IndicativePriceCallback indicativePriceCallback_;
+    OrderBatchCallback massCancelCallback_;
+    CommandRejectCallback commandRejectCallback_;
+    RiskReducingPredicate riskReducing_;
+    
+    // Command intake. Cancels and amends can overtake the new order they
+    // target; they wait in heldCommands_ until it has been entered.
+    CommandQueue commands_;
+    std::mutex commandMutex_;  // One consumer at a time
+    std::mutex queuedIdsMutex_;
+    std::unordered_set<std::string> queuedNewOrders_;
+    std::unordered_map<std::string, std::vector<EngineCommand>> heldCommands_;
+    
+    // Events collected under the locks and delivered after they are released
+    struct PendingEvents {
+        std::vector<Order> orderUpdates;
+        std::vector<Trade> trades;
+        std::vector<ExecutionResult> executions;
+        std::vector<std::pair<std::string, AuctionUncross>> indicatives;
+        std::vector<Order> massCancels;  // Delivered as one batch
+    };
     
     // Thread safety
     mutable std::mutex orderMutex_;
@@ -96,43 +286,126 @@ private:
     
     // Order ID generation
     std::atomic<uint64_t> orderIdCounter_{0};
+    std::atomic<uint64_t> tradeIdCounter_{0};
+    
+    size_t bookSignalDepth_ = 5;
+    
+    // Stamps orders and trades; set before the manager is shared between threads
+    std::shared_ptr<Clock> clock_;
     
     // Logging
     std::shared_ptr<spdlog::logger> logger_;
     
     // Internal methods
     std::string generateOrderId();
+    std::string generateTradeId();
     ExecutionResult executeMarketOrder(const Order& order, const MarketTick& tick);
     ExecutionResult executeLimitOrder(const Order& order, const MarketTick& tick);
-    void processOrderBookUpdate(const std::string& symbol);
+    void processOrderBookUpdate(const std::string& symbol, PendingEvents& events);
+    void tryExecute(const std::string& orderId, const MarketTick& tick, PendingEvents& events);
     bool checkOrderValidity(const Order& order) const;
     
+    OrderBook& bookFor(const std::string& symbol);
+    // A repricing moves only the book's peg level, so a pegged order's stored
+    // limitPrice lags; this copies the book's current price into it
+    void refreshPegPrice(Order& order) const;
+    Trade applyFill(Order& order, double quantity, const Price& price);
+    void applyExecution(const ExecutionResult& result, PendingEvents& events, bool updateBook = true);
+    void finishOrder(OrderNode& active, OrderStatus status, PendingEvents& events);
+    OrderNode& addActiveOrder(const Order& order);
+    void removeActiveOrder(OrderNode& active);  // Moves the order to completedOrders
+    // Records a newly completed order and evicts the oldest past the retention limit
+    void retainCompleted(const std::string& orderId);
+    void evictCompleted();
+    void reindexStatus(OrderNode& active);
+    OrderList& statusList(OrderStatus status) { return ordersByStatus_[static_cast<size_t>(status)]; }
+    void publishIndicative(const std::string& symbol, PendingEvents& events);
+    void dispatch(PendingEvents& events);
+    std::string enterOrder(Order newOrder);
+    void executeCommand(EngineCommand& command);
+    // A queued new order that never became active: record it and report it
+    void finishQueuedOrder(Order& order, OrderStatus status);
+    bool isQueuedNewOrder(const std::string& orderId);
+    
 public:
-    OrderManager();
+    explicit OrderManager(std::shared_ptr<Clock> clock = defaultClock());
     ~OrderManager() = default;
+    OrderManager(const OrderManager&) = delete;
+    OrderManager& operator=(const OrderManager&) = delete;
     
     // Order management
     std::string submitOrder(const Order& order);
     bool cancelOrder(const std::string& orderId);
     bool modifyOrder(const std::string& orderId, const Order& newOrder);
     
+    // Amend in place. A smaller quantity at the same price keeps time priority;
+    // a new price moves the resting entry to the back of its new level.
+    bool amendOrder(const std::string& orderId, std::optional<double> newQuantity,
+                    std::optional<Price> newLimitPrice = std::nullopt);
+    
+    // Cancel every active order in scope. Walks the account or symbol index,
+    // sweeps each book level once and reports the cancels as a single batch.
+    size_t massCancel(const MassCancelScope& scope);
+    
+    // Queued intake, for ingress threads. New orders get their id here and
+    // are entered when processed; one refused then (invalid, or a peg with no
+    // quote) gets a REJECTED order update. Returns the order id the command targets.
+    std::string enqueueCommand(EngineCommand command);
+    // Drain queued commands in lane order on the calling thread
+    size_t processCommands(size_t maxCommands = SIZE_MAX);
+    bool waitForCommands(std::chrono::milliseconds timeout) { return commands_.waitForCommand(timeout); }
+    LaneStats getLaneStats(CommandLane lane) const { return commands_.getStats(lane); }
+    size_t getQueuedCommandCount() const { return commands_.size(); }
+    
     // Order queries
     Order getOrder(const std::string& orderId) const;
     std::vector<Order> getActiveOrders() const;
     std::vector<Order> getOrdersBySymbol(const std::string& symbol) const;
+    
+    // Index-backed queries over active orders; see OrderView for the locking rules
+    OrderView viewOrdersBySymbol(const std::string& symbol) const;
+    OrderView viewOrdersByAccount(const std::string& accountId) const;
+    OrderView viewOrdersByStatus(OrderStatus status) const;
     std::vector<Trade> getOrderTrades(const std::string& orderId) const;
     
+    // Finished orders, with their trades, stay visible to getOrder and
+    // getOrderTrades until this many newer ones have finished (100000 by
+    // default); older ones are forgotten
+    void setCompletedOrderRetention(size_t orders);
+    size_t getCompletedOrderCount() const;
+    
     // Order book queries
     OrderBook getOrderBook(const std::string& symbol) const;
     std::vector<std::string> getSymbols() const;
+    // Microprice, imbalances and order-flow imbalance; nullopt before the symbol's first order
+    std::optional<BookSignals> getBookSignals(const std::string& symbol) const;
+    void setBookSignalDepth(size_t levels);
+    
+    const Clock& clock() const { return *clock_; }
+    void setClock(std::shared_ptr<Clock> clock) { clock_ = std::move(clock); }
     
     // Market data processing
     void processMarketTick(const MarketTick& tick);
     
+    // Opening/closing auctions
+    void startAuction(const std::string& symbol);
+    AuctionUncross getIndicativeUncross(const std::string& symbol) const;
+    AuctionUncross uncrossAuction(const std::string& symbol);
+    TradingPhase getTradingPhase(const std::string& symbol) const;
+    
     // Callback registration
     void setOrderUpdateCallback(OrderCallback callback) { orderUpdateCallback_ = callback; }
     void setTradeCallback(TradeCallback callback) { tradeCallback_ = callback; }
     void setExecutionCallback(ExecutionCallback callback) { executionCallback_ = callback; }
+    void setIndicativePriceCallback(IndicativePriceCallback callback) { indicativePriceCallback_ = callback; }
+    // When set, mass cancels arrive here in one call instead of one order update each
+    void setMassCancelCallback(OrderBatchCallback callback) { massCancelCallback_ = callback; }
+    // Queued amends and cancels that change nothing (unknown or finished order,
+    // quantity at or below filled, price on a market or pegged order) emit no
+    // order update; they are reported here instead
+    void setCommandRejectCallback(CommandRejectCallback callback) { commandRejectCallback_ = callback; }
+    // New orders it accepts (e.g. ones that shrink a position) take the priority lane
+    void setRiskReducingPredicate(RiskReducingPredicate predicate) { riskReducing_ = predicate; }
     
     // Statistics
     size_t getActiveOrderCount() const;
@@ -0,0 +1,178 @@
+#include "tsc_clock.h"
+#include <algorithm>
+#include <mutex>
+
+#if defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+namespace trading {
+
+TscClock::State TscClock::state_;
+
+namespace {
+
+int64_t systemNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Written only by the thread holding renewing (or by the call_once);
+// ticksPerNs is also read by ticksPerNs() on any thread
+struct Calibration {
+    bool tsc = false;
+    uint64_t anchorTsc = 0;        // First sample; the tick rate is measured from here
+    int64_t anchorSteadyNs = 0;
+    std::atomic<double> ticksPerNs{0.0};
+    std::atomic<int64_t> intervalNs{1'000'000'000};
+    std::atomic_flag renewing = ATOMIC_FLAG_INIT;
+    std::once_flag calibrated;
+};
+
+Calibration calibration;
+
+#if defined(__x86_64__)
+bool invariantTsc() {
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8));
+}
+
+struct Sample {
+    uint64_t tsc;
+    int64_t wallNs;
+    int64_t steadyNs;
+};
+
+// TSC taken as the midpoint of the tightest of a few brackets around the clock reads
+Sample sample() {
+    Sample best{};
+    uint64_t bestWidth = UINT64_MAX;
+    for (int i = 0; i < 5; ++i) {
+        unsigned int aux;
+        uint64_t before = __rdtscp(&aux);
+        int64_t wall = systemNs();
+        int64_t steady = steadyNs();
+        uint64_t after = __rdtscp(&aux);
+        if (after - before < bestWidth) {
+            bestWidth = after - before;
+            best = {before + (after - before) / 2, wall, steady};
+        }
+    }
+    return best;
+}
+#endif
+
+} // namespace
+
+bool TscClock::usesTsc() {
+    nowNs();
+    return calibration.tsc;
+}
+
+double TscClock::ticksPerNs() {
+    nowNs();
+    return calibration.ticksPerNs.load(std::memory_order_relaxed);
+}
+
+void TscClock::setRecalibrationInterval(std::chrono::nanoseconds interval) {
+    calibration.intervalNs.store(std::max<int64_t>(interval.count(), 1'000'000), std::memory_order_relaxed);
+}
+
+void TscClock::recalibrate() {
+    nowNs();
+    if (calibration.tsc && !calibration.renewing.test_and_set(std::memory_order_acquire)) {
+        renew();
+        calibration.renewing.clear(std::memory_order_release);
+    }
+}
+
+int64_t TscClock::slowNowNs() noexcept {
+#if defined(__x86_64__)
+    std::call_once(calibration.calibrated, [] {
+        if (!invariantTsc()) {
+            return;
+        }
+        // A first rate over a few milliseconds; renewals refine it
+        Sample first = sample();
+        Sample last = first;
+        while (last.steadyNs - first.steadyNs < 2'000'000) {
+            last = sample();
+        }
+        calibration.tsc = true;
+        calibration.anchorTsc = first.tsc;
+        calibration.anchorSteadyNs = first.steadyNs;
+        double ticksPerNs =
+            static_cast<double>(last.tsc - first.tsc) / static_cast<double>(last.steadyNs - first.steadyNs);
+        calibration.ticksPerNs.store(ticksPerNs, std::memory_order_relaxed);
+        state_.baseTsc.store(last.tsc, std::memory_order_relaxed);
+        state_.baseNs.store(last.wallNs, std::memory_order_relaxed);
+        state_.nsPerTick.store(1.0 / ticksPerNs, std::memory_order_relaxed);
+        state_.renewAtTsc.store(last.tsc + static_cast<uint64_t>(
+            static_cast<double>(calibration.intervalNs.load(std::memory_order_relaxed)) * ticksPerNs),
+            std::memory_order_relaxed);
+        state_.sequence.store(2, std::memory_order_release);
+    });
+    if (!calibration.tsc) {
+        return systemNs();
+    }
+    // One stamp renews; the others carry on with the current calibration meanwhile
+    if (!calibration.renewing.test_and_set(std::memory_order_acquire)) {
+        int64_t ns = 0;
+        if (!read(ns, false)) {
+            renew();
+        }
+        calibration.renewing.clear(std::memory_order_release);
+    }
+    int64_t ns = 0;
+    read(ns, true);
+    return ns;
+#else
+    return systemNs();
+#endif
+}
+
+void TscClock::renew() {
+#if defined(__x86_64__)
+    Sample now = sample();
+    int64_t elapsedNs = now.steadyNs - calibration.anchorSteadyNs;
+    double ticksPerNs = calibration.ticksPerNs.load(std::memory_order_relaxed);
+    if (elapsedNs > 0 && now.tsc > calibration.anchorTsc) {
+        ticksPerNs = static_cast<double>(now.tsc - calibration.anchorTsc) / static_cast<double>(elapsedNs);
+        calibration.ticksPerNs.store(ticksPerNs, std::memory_order_relaxed);
+    }
+
+    // Offset from system_clock at the sample: slew up to half the interval, step forward past that
+    double intervalNs = static_cast<double>(calibration.intervalNs.load(std::memory_order_relaxed));
+    auto convert = [](uint64_t tsc) {
+        return state_.baseNs.load(std::memory_order_relaxed) +
+            static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(tsc - state_.baseTsc.load(
+                std::memory_order_relaxed))) * state_.nsPerTick.load(std::memory_order_relaxed));
+    };
+    double errorNs = static_cast<double>(now.wallNs - convert(now.tsc));
+    double slewNs = std::clamp(errorNs, -intervalNs / 2, intervalNs / 2);
+    int64_t stepNs = static_cast<int64_t>(errorNs - slewNs);
+    double nsPerTick = (intervalNs + slewNs) / (intervalNs * ticksPerNs);
+
+    // Rebase at a TSC read inside the write section so readers that saw the
+    // old calibration all stamped before it. rdtscp does not wait for
+    // stores, so the odd sequence is made visible first.
+    uint64_t sequence = state_.sequence.load(std::memory_order_relaxed);
+    state_.sequence.store(sequence + 1, std::memory_order_relaxed);
+    _mm_mfence();
+    unsigned int aux;
+    uint64_t tsc = __rdtscp(&aux);
+    int64_t baseNs = convert(tsc) + std::max<int64_t>(stepNs, 0);
+    state_.baseTsc.store(tsc, std::memory_order_relaxed);
+    state_.baseNs.store(baseNs, std::memory_order_relaxed);
+    state_.nsPerTick.store(nsPerTick, std::memory_order_relaxed);
+    state_.renewAtTsc.store(tsc + static_cast<uint64_t>(intervalNs * ticksPerNs), std::memory_order_relaxed);
+    state_.sequence.store(sequence + 2, std::memory_order_release);
+#endif
+}
+
+} // namespace trading
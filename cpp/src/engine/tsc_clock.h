@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace trading {
+
+// Wall-clock time from the invariant TSC. A stamp is one rdtscp and a
+// multiply-add against a calibration (TSC base, wall-clock base, ns per
+// tick) published under a sequence lock; no system call or vDSO read.
+//
+// The calibration is renewed by whichever stamp first finds it older than
+// the recalibration interval (1s by default). The tick rate is measured
+// against steady_clock over the whole run, and the offset from
+// system_clock is slewed out over the next interval, with forward
+// corrections beyond that stepped. The conversion stays continuous across
+// renewals, so stamps never go backwards, including between threads.
+//
+// Without an invariant TSC (or off x86-64) it is system_clock.
+class TscClock {
+public:
+    using duration = std::chrono::system_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::system_clock::time_point;
+    static constexpr bool is_steady = false;
+
+    static time_point now() noexcept {
+        return time_point(std::chrono::duration_cast<duration>(std::chrono::nanoseconds(nowNs())));
+    }
+
+    // Nanoseconds since the Unix epoch
+    static int64_t nowNs() noexcept {
+        int64_t ns = 0;
+        if (read(ns, false)) {
+            return ns;
+        }
+        return slowNowNs();
+    }
+
+    static bool usesTsc();
+    static double ticksPerNs();
+    static void setRecalibrationInterval(std::chrono::nanoseconds interval);
+    // Renew the calibration now instead of at the next due stamp
+    static void recalibrate();
+
+private:
+    struct State {
+        std::atomic<uint64_t> sequence{0};      // Odd while rewritten; 0 until calibrated
+        std::atomic<uint64_t> baseTsc{0};
+        std::atomic<int64_t> baseNs{0};
+        std::atomic<double> nsPerTick{0.0};
+        std::atomic<uint64_t> renewAtTsc{0};    // First TSC that renews the calibration
+    };
+    static State state_;
+
+    static int64_t slowNowNs() noexcept;
+    static void renew();
+
+    // False before calibration or, unless `anyAge`, once it is due for renewal
+    static bool read(int64_t& ns, bool anyAge) noexcept {
+#if defined(__x86_64__)
+        for (;;) {
+            uint64_t sequence = state_.sequence.load(std::memory_order_acquire);
+            if (sequence == 0) {
+                return false;
+            }
+            if (sequence & 1) {
+                continue;
+            }
+            uint64_t baseTsc = state_.baseTsc.load(std::memory_order_relaxed);
+            int64_t baseNs = state_.baseNs.load(std::memory_order_relaxed);
+            double nsPerTick = state_.nsPerTick.load(std::memory_order_relaxed);
+            uint64_t renewAt = state_.renewAtTsc.load(std::memory_order_relaxed);
+            unsigned int aux;
+            uint64_t tsc = __rdtscp(&aux);  // Waits for the loads above
+            _mm_lfence();                   // and keeps the re-check below from running ahead of it
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (state_.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;
+            }
+            if (!anyAge && tsc >= renewAt) {
+                return false;
+            }
+            ns = baseNs + static_cast<int64_t>(static_cast<double>(static_cast<int64_t>(tsc - baseTsc)) * nsPerTick);
+            return true;
+        }
+#else
+        (void)ns;
+        (void)anyAge;
+        return false;
+#endif
+    }
+};
+
+} // namespace trading
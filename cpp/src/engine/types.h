@@ -2,6 +2,7 @@
 
 #include <string>
 #include <chrono>
+#include <cmath>
 #include <variant>
 #include <optional>
 #include <nlohmann/json.hpp>
@@ -51,6 +52,15 @@ enum class TimeInForce {
     FOK   // Fill or Kill
 };
 
+// Reference a pegged order tracks. PRIMARY follows the same side of the
+// quote, MARKET the opposite side, MIDPOINT the middle.
+enum class PegType {
+    NONE,
+    PRIMARY,
+    MIDPOINT,
+    MARKET
+};
+
 // Price representation with precision
 struct Price {
     double value;
@@ -66,6 +76,18 @@ struct Price {
         return value < other.value;
     }
     
+    bool operator>(const Price& other) const {
+        return value > other.value;
+    }
+    
+    bool operator!=(const Price& other) const { return !(*this == other); }
+    bool operator<=(const Price& other) const { return !(*this > other); }
+    bool operator>=(const Price& other) const { return !(*this < other); }
+    
+    Price operator+(const Price& other) const { return Price(value + other.value, precision); }
+    Price operator-(const Price& other) const { return Price(value - other.value, precision); }
+    Price operator/(double divisor) const { return Price(value / divisor, precision); }
+    
     std::string toString() const;
 };
 
@@ -127,13 +149,20 @@ struct Order {
     OrderStatus status;
     std::chrono::system_clock::time_point timestamp;
     std::string clientOrderId;
+    std::string accountId;
+    
+    // Pegged limit orders: limitPrice follows the reference, pegOffset away
+    // from it on the passive side
+    PegType pegType;
+    double pegOffset;
     
     // Filled quantities and prices
     Quantity filledQuantity;
     Price averageFillPrice;
     
     Order() : type(OrderType::MARKET), side(OrderSide::BUY), 
-              timeInForce(TimeInForce::DAY), status(OrderStatus::PENDING) {}
+              timeInForce(TimeInForce::DAY), status(OrderStatus::PENDING),
+              pegType(PegType::NONE), pegOffset(0.0) {}
 };
 
 // Trade execution
@@ -203,12 +232,55 @@ struct RiskLimits {
                    allowShortSelling(false), allowOptions(false), allowFutures(false) {}
 };
 
+} // namespace trading
+
+// JSON support for the std types used in the structs below
+namespace nlohmann {
+
+template <typename T>
+struct adl_serializer<std::optional<T>> {
+    static void to_json(json& j, const std::optional<T>& opt) {
+        if (opt) {
+            j = *opt;
+        } else {
+            j = nullptr;
+        }
+    }
+    
+    static void from_json(const json& j, std::optional<T>& opt) {
+        if (j.is_null()) {
+            opt.reset();
+        } else {
+            opt = j.get<T>();
+        }
+    }
+};
+
+// Timestamps travel as milliseconds since the Unix epoch
+template <>
+struct adl_serializer<std::chrono::system_clock::time_point> {
+    static void to_json(json& j, const std::chrono::system_clock::time_point& tp) {
+        j = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+    }
+    
+    static void from_json(const json& j, std::chrono::system_clock::time_point& tp) {
+        tp = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::milliseconds(j.get<int64_t>())));
+    }
+};
+
+} // namespace nlohmann
+
+namespace trading {
+
 // JSON serialization
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Price, value, precision)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Quantity, value, precision)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Asset, symbol, exchange, type, name, currency, tickSize, lotSize)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Order, id, asset, type, side, quantity, limitPrice, stopPrice, 
-                                   timeInForce, status, timestamp, clientOrderId, filledQuantity, averageFillPrice)
+                                   timeInForce, status, timestamp, clientOrderId, accountId, pegType, pegOffset,
+                                   filledQuantity, averageFillPrice)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Trade, id, orderId, asset, side, quantity, price, timestamp, exchange, commission)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Position, asset, quantity, averagePrice, currentPrice, unrealizedPnL, realizedPnL, lastUpdate)
 NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Account, id, name, currency, cash, buyingPower, equity, marginUsed, marginAvailable, lastUpdate)
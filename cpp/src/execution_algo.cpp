@@ -0,0 +1,281 @@
+#include "frontier/execution_algo.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace frontier {
+
+namespace {
+
+constexpr double kQuantityEpsilon = 1e-9;
+
+double seconds_between(TimerWheel::TimePoint from, TimerWheel::TimePoint to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+TimerWheel::TimePoint start_of_day(TimerWheel::TimePoint t) {
+    return t - (t.time_since_epoch() % std::chrono::hours(24));
+}
+
+} // namespace
+
+ExecutionAlgoEngine::ExecutionAlgoEngine(ChildOrderSink sink, std::chrono::milliseconds resolution,
+                                         TimerWheel::TimePoint start)
+    : sink_(std::move(sink)), wheel_(resolution, 4096, start) {}
+
+void ExecutionAlgoEngine::set_volume_profile(const std::string& symbol, VolumeProfile profile) {
+    auto& state = symbols_[symbol];
+    state.profile = std::move(profile);
+    state.profile_cumulative.assign(1, 0.0);
+    for (double weight : state.profile.weights) {
+        state.profile_cumulative.push_back(state.profile_cumulative.back() + std::max(weight, 0.0));
+    }
+}
+
+uint64_t ExecutionAlgoEngine::submit(const ParentOrderSpec& spec, TimerWheel::TimePoint now) {
+    bool scheduled = spec.algo != AlgoType::POV;
+    if (spec.symbol.empty() || spec.quantity <= 0 || (scheduled && spec.end_time <= spec.start_time) ||
+        (spec.algo == AlgoType::POV && (spec.participation_rate <= 0 || spec.participation_rate > 1))) {
+        return 0;
+    }
+
+    uint32_t index;
+    if (!free_slots_.empty()) {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    auto& slot = slots_[index];
+    slot.in_use = true;
+    slot.pov_owed = 0.0;
+    slot.timer = kNoTimer;
+    slot.order = ParentOrder();
+    slot.order.id = (static_cast<uint64_t>(++slot.generation) << 32) | index;
+    slot.order.spec = spec;
+    ++active_count_;
+
+    auto& state = symbols_[spec.symbol];
+    if (spec.algo == AlgoType::POV) {
+        slot.pov_index = state.pov_parents.size();
+        state.pov_parents.push_back(index);
+        // POV only needs a timer to stop at its end time
+        if (spec.end_time > spec.start_time) {
+            slot.timer = wheel_.schedule(spec.end_time, slot.order.id);
+        }
+    } else if (spec.start_time > now) {
+        slot.timer = wheel_.schedule(spec.start_time, slot.order.id);
+    } else {
+        // Already started: the first slice goes out now, not on the next wheel tick
+        uint64_t id = slot.order.id;
+        on_slice(index, now);
+        return id;
+    }
+
+    return slot.order.id;
+}
+
+bool ExecutionAlgoEngine::cancel(uint64_t parent_id) {
+    Slot* slot = find(parent_id);
+    if (!slot) {
+        return false;
+    }
+    finish(static_cast<uint32_t>(parent_id & 0xFFFFFFFFu), AlgoStatus::Cancelled);
+    return true;
+}
+
+const ParentOrder* ExecutionAlgoEngine::get(uint64_t parent_id) const {
+    auto index = static_cast<uint32_t>(parent_id & 0xFFFFFFFFu);
+    if (index < slots_.size() && slots_[index].in_use && slots_[index].order.id == parent_id) {
+        return &slots_[index].order;
+    }
+    auto it = finished_.find(parent_id);
+    return it != finished_.end() ? &it->second : nullptr;
+}
+
+void ExecutionAlgoEngine::set_finished_retention(size_t parents) {
+    finished_retention_ = parents;
+    evict_finished();
+}
+
+void ExecutionAlgoEngine::evict_finished() {
+    while (finish_order_.size() > finished_retention_) {
+        finished_.erase(finish_order_.front());
+        finish_order_.pop_front();
+    }
+}
+
+ExecutionAlgoEngine::Slot* ExecutionAlgoEngine::find(uint64_t parent_id) {
+    auto index = static_cast<uint32_t>(parent_id & 0xFFFFFFFFu);
+    if (index < slots_.size() && slots_[index].in_use && slots_[index].order.id == parent_id) {
+        return &slots_[index];
+    }
+    return nullptr;
+}
+
+void ExecutionAlgoEngine::on_timer(TimerWheel::TimePoint now) {
+    wheel_.advance(now, [&](TimerWheel::TimerId, uint64_t parent_id) {
+        if (find(parent_id)) {
+            on_slice(static_cast<uint32_t>(parent_id & 0xFFFFFFFFu), now);
+        }
+    });
+}
+
+void ExecutionAlgoEngine::on_tick(const MarketData& tick, TimerWheel::TimePoint now) {
+    auto& state = symbols_[tick.symbol];
+    state.bid = tick.bid;
+    state.ask = tick.ask;
+    state.last = tick.last;
+
+    double traded = 0.0;
+    if (state.cumulative_volume >= 0 && tick.volume > state.cumulative_volume) {
+        traded = tick.volume - state.cumulative_volume;
+    }
+    state.cumulative_volume = tick.volume;
+
+    // Walk backwards: finishing a parent swap-removes it from this list
+    for (size_t i = state.pov_parents.size(); i-- > 0;) {
+        uint32_t index = state.pov_parents[i];
+        auto& slot = slots_[index];
+        if (now < slot.order.spec.start_time) {
+            continue;
+        }
+        slot.pov_owed += traded * slot.order.spec.participation_rate;
+
+        double child = std::min(slot.pov_owed, slot.order.remaining());
+        if (child >= slot.order.spec.min_child_quantity - kQuantityEpsilon ||
+            child >= slot.order.remaining() - kQuantityEpsilon) {
+            slot.pov_owed -= send_child(slot, child);
+        }
+        if (slot.order.remaining() <= kQuantityEpsilon) {
+            finish(index, AlgoStatus::Completed);
+        }
+    }
+
+    on_timer(now);
+}
+
+void ExecutionAlgoEngine::on_slice(uint32_t index, TimerWheel::TimePoint now) {
+    auto& slot = slots_[index];
+    const auto& spec = slot.order.spec;
+
+    if (spec.algo == AlgoType::POV) {
+        finish(index, slot.order.remaining() <= kQuantityEpsilon ? AlgoStatus::Completed : AlgoStatus::Expired);
+        return;
+    }
+
+    // Each slice trades up front what the schedule calls for by the end of its interval
+    auto horizon = std::min(now + spec.slice_interval, spec.end_time);
+    bool final_slice = horizon >= spec.end_time;
+    double child = spec.quantity * target_fraction(slot, horizon) - slot.order.executed_quantity;
+    child = std::min(child, slot.order.remaining());
+    if (child > kQuantityEpsilon && (child >= spec.min_child_quantity || final_slice)) {
+        send_child(slot, child);
+    }
+
+    if (slot.order.remaining() <= kQuantityEpsilon) {
+        finish(index, AlgoStatus::Completed);
+    } else if (now >= spec.end_time) {
+        finish(index, AlgoStatus::Expired);
+    } else {
+        slot.timer = wheel_.schedule(std::min(now + spec.slice_interval, spec.end_time), slot.order.id);
+    }
+}
+
+double ExecutionAlgoEngine::send_child(Slot& slot, double quantity) {
+    auto it = symbols_.find(slot.order.spec.symbol);
+    if (it == symbols_.end() || quantity <= kQuantityEpsilon) {
+        return 0.0;
+    }
+
+    const auto& spec = slot.order.spec;
+    double price = reference_price(it->second, spec.side);
+    if (price <= 0) {
+        return 0.0;  // No market data yet; the schedule catches up on a later slice
+    }
+    if (spec.limit_price > 0 &&
+        (spec.side == Side::Buy ? price > spec.limit_price : price < spec.limit_price)) {
+        return 0.0;
+    }
+
+    double executed = std::clamp(sink_(slot.order, quantity, price), 0.0, quantity);
+    if (executed > 0) {
+        slot.order.executed_quantity += executed;
+        slot.order.executed_notional += executed * price;
+        ++slot.order.child_count;
+    }
+    return executed;
+}
+
+void ExecutionAlgoEngine::finish(uint32_t index, AlgoStatus status) {
+    auto& slot = slots_[index];
+    wheel_.cancel(slot.timer);
+
+    if (slot.pov_index != SIZE_MAX) {
+        auto& parents = symbols_[slot.order.spec.symbol].pov_parents;
+        uint32_t moved = parents.back();
+        parents[slot.pov_index] = moved;
+        slots_[moved].pov_index = slot.pov_index;
+        parents.pop_back();
+        slot.pov_index = SIZE_MAX;
+    }
+
+    slot.order.status = status;
+    finished_.emplace(slot.order.id, slot.order);
+    finish_order_.push_back(slot.order.id);
+    evict_finished();
+    slot.in_use = false;
+    free_slots_.push_back(index);
+    --active_count_;
+}
+
+double ExecutionAlgoEngine::target_fraction(const Slot& slot, TimerWheel::TimePoint at) const {
+    const auto& spec = slot.order.spec;
+    if (at >= spec.end_time) {
+        return 1.0;
+    }
+    if (at <= spec.start_time) {
+        return 0.0;
+    }
+
+    if (spec.algo == AlgoType::VWAP) {
+        auto it = symbols_.find(spec.symbol);
+        if (it != symbols_.end() && it->second.profile_cumulative.size() > 1) {
+            auto day = start_of_day(spec.start_time);
+            double begin = profile_volume_until(it->second, day, spec.start_time);
+            double total = profile_volume_until(it->second, day, spec.end_time) - begin;
+            if (total > 0) {
+                return std::clamp((profile_volume_until(it->second, day, at) - begin) / total, 0.0, 1.0);
+            }
+        }
+        // No usable profile over the window: fall back to time weighting
+    }
+
+    return seconds_between(spec.start_time, at) / seconds_between(spec.start_time, spec.end_time);
+}
+
+double ExecutionAlgoEngine::profile_volume_until(const SymbolState& state, TimerWheel::TimePoint day_start,
+                                                 TimerWheel::TimePoint at) const {
+    const auto& cumulative = state.profile_cumulative;
+    size_t buckets = cumulative.size() - 1;
+    double position = seconds_between(day_start + state.profile.session_open, at) /
+                      std::chrono::duration<double>(state.profile.bucket_width).count();
+    if (position <= 0) {
+        return 0.0;
+    }
+    if (position >= static_cast<double>(buckets)) {
+        return cumulative.back();
+    }
+
+    auto bucket = static_cast<size_t>(position);
+    double within = position - static_cast<double>(bucket);
+    return cumulative[bucket] + within * (cumulative[bucket + 1] - cumulative[bucket]);
+}
+
+double ExecutionAlgoEngine::reference_price(const SymbolState& state, Side side) const {
+    double price = side == Side::Buy ? state.ask : state.bid;
+    return price > 0 ? price : state.last;
+}
+
+} // namespace frontier
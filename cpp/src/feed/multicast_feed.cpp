@@ -0,0 +1,474 @@
+#include "multicast_feed.h"
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace trading {
+
+namespace {
+
+[[noreturn]] void throwErrno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+sockaddr_in makeAddress(const std::string& host, uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+        throw std::system_error(EINVAL, std::generic_category(), "bad IPv4 address " + host);
+    }
+    return address;
+}
+
+const feedwire::Tick& tickAt(const char* ticks, size_t index) {
+    return *reinterpret_cast<const feedwire::Tick*>(ticks + index * sizeof(feedwire::Tick));
+}
+
+} // namespace
+
+namespace feedwire {
+
+void decodeTick(const Tick& wire, MarketTick& tick) {
+    tick.asset.symbol.assign(wire.symbol, strnlen(wire.symbol, SYMBOL_LENGTH));
+    tick.bid.value = static_cast<double>(wire.bid) / PRICE_SCALE;
+    tick.ask.value = static_cast<double>(wire.ask) / PRICE_SCALE;
+    tick.last.value = static_cast<double>(wire.last) / PRICE_SCALE;
+    tick.bidSize.value = wire.bidSize;
+    tick.askSize.value = wire.askSize;
+    tick.volume.value = static_cast<double>(wire.volume);
+    tick.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(wire.timestampNs)));
+}
+
+void encodeTick(const MarketTick& tick, Tick& wire) {
+    std::memset(wire.symbol, 0, SYMBOL_LENGTH);
+    std::memcpy(wire.symbol, tick.asset.symbol.data(), std::min(tick.asset.symbol.size(), SYMBOL_LENGTH));
+    wire.bid = std::llround(tick.bid.value * PRICE_SCALE);
+    wire.ask = std::llround(tick.ask.value * PRICE_SCALE);
+    wire.last = std::llround(tick.last.value * PRICE_SCALE);
+    wire.bidSize = static_cast<uint32_t>(tick.bidSize.value);
+    wire.askSize = static_cast<uint32_t>(tick.askSize.value);
+    wire.volume = static_cast<uint64_t>(tick.volume.value);
+    wire.timestampNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(tick.timestamp.time_since_epoch()).count();
+}
+
+size_t encodePacket(PacketType type, uint64_t sequence, const Tick* ticks, size_t count, uint8_t flags, char* out) {
+    count = std::min(count, MAX_TICKS_PER_PACKET);
+    PacketHeader header{MAGIC, type, flags, static_cast<uint16_t>(count), sequence};
+    std::memcpy(out, &header, sizeof(header));
+    if (ticks != nullptr && count > 0) {
+        std::memcpy(out + sizeof(header), ticks, count * sizeof(Tick));
+    }
+    return sizeof(header) + count * sizeof(Tick);
+}
+
+} // namespace feedwire
+
+// ---- Receiver ----
+
+MulticastFeedReceiver::MulticastFeedReceiver(MulticastFeedConfig config, TickHandler handler)
+    : config_(std::move(config)), handler_(std::move(handler)) {
+    static std::atomic<int> instance_count{0};
+    logger_ = spdlog::stdout_color_mt("multicast_feed_" + std::to_string(instance_count++));
+    logger_->set_level(spdlog::level::info);
+
+    config_.batchSize = std::max<size_t>(config_.batchSize, 1);
+    config_.reorderCapacity = std::max<size_t>(config_.reorderCapacity, 1);
+    buffers_.resize(config_.batchSize * feedwire::MAX_PACKET);
+    messages_.resize(config_.batchSize);
+    iovecs_.resize(config_.batchSize);
+    for (size_t i = 0; i < config_.batchSize; ++i) {
+        iovecs_[i].iov_base = buffers_.data() + i * feedwire::MAX_PACKET;
+        iovecs_[i].iov_len = feedwire::MAX_PACKET;
+        messages_[i] = {};
+        messages_[i].msg_hdr.msg_iov = &iovecs_[i];
+        messages_[i].msg_hdr.msg_iovlen = 1;
+    }
+    reorder_.resize(config_.reorderCapacity);
+    tick_.asset.symbol.reserve(feedwire::SYMBOL_LENGTH);  // Decoded symbols never reallocate
+}
+
+MulticastFeedReceiver::~MulticastFeedReceiver() {
+    stop();
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void MulticastFeedReceiver::open() {
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) {
+        throwErrno("socket");
+    }
+    int one = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    // The kernel may clamp this to rmem_max; a short buffer only costs gaps
+    setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &config_.receiveBufferBytes, sizeof(config_.receiveBufferBytes));
+
+    sockaddr_in address = makeAddress(config_.bindAddress, config_.port);
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        throwErrno("bind " + config_.bindAddress + ":" + std::to_string(config_.port));
+    }
+    socklen_t length = sizeof(address);
+    getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &length);
+    port_ = ntohs(address.sin_port);
+
+    if (!config_.group.empty()) {
+        ip_mreq membership{};
+        membership.imr_multiaddr = makeAddress(config_.group, 0).sin_addr;
+        membership.imr_interface = makeAddress(config_.interfaceAddress, 0).sin_addr;
+        if (setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+            throwErrno("join " + config_.group);
+        }
+    }
+    if (config_.snapshotPort != 0) {
+        setSnapshotSource(config_.snapshotHost, config_.snapshotPort);
+    }
+    logger_->info("Feed receiver on {}:{}{}", config_.bindAddress, port_,
+                  config_.group.empty() ? "" : " group " + config_.group);
+}
+
+void MulticastFeedReceiver::setSnapshotSource(const std::string& host, uint16_t port) {
+    snapshotAddress_ = makeAddress(host, port);
+    config_.snapshotHost = host;
+    config_.snapshotPort = port;
+}
+
+size_t MulticastFeedReceiver::poll(int timeoutMs) {
+    pollfd pfd{fd_, POLLIN, 0};
+    if (::poll(&pfd, 1, timeoutMs) <= 0) {
+        checkGap(Clock::now());
+        return 0;
+    }
+    int received = recvmmsg(fd_, messages_.data(), static_cast<unsigned>(config_.batchSize), MSG_DONTWAIT, nullptr);
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0;
+        }
+        throwErrno("recvmmsg");
+    }
+    auto now = Clock::now();
+    size_t delivered = 0;
+    for (int i = 0; i < received; ++i) {
+        if (messages_[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            ++stats_.malformed;
+            continue;
+        }
+        delivered += processPacket(static_cast<const char*>(iovecs_[i].iov_base), messages_[i].msg_len, now);
+    }
+    checkGap(now);
+    return delivered;
+}
+
+void MulticastFeedReceiver::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread([this] {
+        while (running_.load(std::memory_order_relaxed)) {
+            try {
+                poll(100);
+            } catch (const std::exception& e) {
+                logger_->error("Feed receive failed: {}", e.what());
+                running_ = false;
+            }
+        }
+    });
+}
+
+void MulticastFeedReceiver::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+size_t MulticastFeedReceiver::processPacket(const char* data, size_t length, Clock::time_point now) {
+    feedwire::PacketHeader header;
+    if (length < sizeof(header)) {
+        ++stats_.malformed;
+        return 0;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != feedwire::MAGIC || length < sizeof(header) + header.count * sizeof(feedwire::Tick)) {
+        ++stats_.malformed;
+        return 0;
+    }
+    ++stats_.packets;
+    const char* ticks = data + sizeof(header);
+
+    if (header.type == feedwire::PacketType::SNAPSHOT) {
+        return applySnapshot(header, ticks, now);
+    }
+    if (header.type != feedwire::PacketType::TICKS) {
+        ++stats_.malformed;
+        return 0;
+    }
+    if (expected_ == 0) {
+        expected_ = header.sequence;   // Join the stream where we find it
+    }
+
+    uint64_t before = stats_.messages;
+    for (size_t i = 0; i < header.count; ++i) {
+        uint64_t sequence = header.sequence + i;
+        if (sequence < expected_) {
+            ++stats_.duplicates;
+        } else if (sequence == expected_) {
+            deliver(tickAt(ticks, i), sequence);
+            ++expected_;
+        } else {
+            buffer(tickAt(ticks, i), sequence, now);
+        }
+    }
+    if (gapOpen_) {
+        drainReorder();
+    }
+    return static_cast<size_t>(stats_.messages - before);
+}
+
+void MulticastFeedReceiver::deliver(const feedwire::Tick& wire, uint64_t sequence) {
+    feedwire::decodeTick(wire, tick_);
+    ++stats_.messages;
+    handler_(tick_, sequence);
+}
+
+void MulticastFeedReceiver::buffer(const feedwire::Tick& wire, uint64_t sequence, Clock::time_point now) {
+    size_t capacity = reorder_.size();
+    if (sequence >= expected_ + capacity) {
+        if (config_.snapshotPort != 0) {
+            ++stats_.dropped;                  // The snapshot will cover it
+            overflow_ = true;
+            return;
+        }
+        skipTo(sequence - capacity + 1);       // Give up on the oldest holes to make room
+        if (sequence == expected_) {
+            deliver(wire, expected_++);
+            return;
+        }
+    }
+    if (!gapOpen_) {
+        gapOpen_ = true;
+        gapSince_ = now;
+        ++stats_.gaps;
+    }
+    Slot& slot = reorder_[sequence % capacity];
+    if (slot.sequence == sequence) {
+        ++stats_.duplicates;
+        return;
+    }
+    slot.sequence = sequence;
+    slot.tick = wire;
+    ++buffered_;
+    highestBuffered_ = std::max(highestBuffered_, sequence);
+}
+
+void MulticastFeedReceiver::drainReorder() {
+    size_t capacity = reorder_.size();
+    while (buffered_ > 0) {
+        Slot& slot = reorder_[expected_ % capacity];
+        if (slot.sequence != expected_) {
+            break;
+        }
+        slot.sequence = 0;
+        --buffered_;
+        ++stats_.reordered;
+        deliver(slot.tick, expected_++);
+    }
+    if (buffered_ == 0 && !overflow_) {
+        gapOpen_ = false;
+        recovering_ = false;
+    }
+}
+
+void MulticastFeedReceiver::skipTo(uint64_t sequence) {
+    size_t capacity = reorder_.size();
+    while (expected_ < sequence) {
+        Slot& slot = reorder_[expected_ % capacity];
+        if (slot.sequence == expected_) {
+            slot.sequence = 0;
+            --buffered_;
+            ++stats_.reordered;
+            deliver(slot.tick, expected_);
+        } else {
+            ++stats_.dropped;
+        }
+        ++expected_;
+    }
+    drainReorder();
+}
+
+size_t MulticastFeedReceiver::applySnapshot(const feedwire::PacketHeader& header, const char* ticks,
+                                            Clock::time_point now) {
+    // Unsolicited, or older than what the stream already gave us
+    if (!recovering_ || header.sequence + 1 < expected_) {
+        return 0;
+    }
+    for (size_t i = 0; i < header.count; ++i) {
+        deliver(tickAt(ticks, i), header.sequence);
+    }
+    if (header.flags & feedwire::FLAG_LAST) {
+        expected_ = header.sequence + 1;
+        for (Slot& slot : reorder_) {
+            if (slot.sequence != 0 && slot.sequence < expected_) {
+                slot.sequence = 0;
+                --buffered_;
+            }
+        }
+        overflow_ = false;
+        recovering_ = false;
+        ++stats_.snapshotsApplied;
+        logger_->info("Snapshot applied; resuming at {}", expected_);
+        drainReorder();
+        gapSince_ = now;
+    }
+    return header.count;
+}
+
+void MulticastFeedReceiver::checkGap(Clock::time_point now) {
+    if (!gapOpen_) {
+        return;
+    }
+    if (config_.snapshotPort == 0) {
+        if (now - gapSince_ >= config_.gapTimeout) {
+            skipTo(highestBuffered_ + 1);
+        }
+        return;
+    }
+    bool due = overflow_ || now - gapSince_ >= config_.gapTimeout;
+    if (due && (!recovering_ || now - lastSnapshotRequest_ >= config_.snapshotRetry)) {
+        requestSnapshot(now);
+    }
+}
+
+void MulticastFeedReceiver::requestSnapshot(Clock::time_point now) {
+    char packet[sizeof(feedwire::PacketHeader)];
+    size_t length = feedwire::encodePacket(feedwire::PacketType::SNAPSHOT_REQUEST, expected_, nullptr, 0, 0, packet);
+    if (sendto(fd_, packet, length, 0, reinterpret_cast<const sockaddr*>(&snapshotAddress_),
+               sizeof(snapshotAddress_)) < 0) {
+        logger_->warn("Snapshot request failed: {}", std::strerror(errno));
+    } else if (!recovering_) {
+        logger_->warn("Gap at {}; requesting snapshot", expected_);
+    }
+    recovering_ = true;
+    lastSnapshotRequest_ = now;
+    ++stats_.snapshotRequests;
+}
+
+// ---- Publisher ----
+
+MulticastFeedPublisher::MulticastFeedPublisher(const std::string& host, uint16_t port, uint16_t snapshotPort,
+                                               int ttl) {
+    destination_ = makeAddress(host, port);
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd_ < 0) {
+        throwErrno("socket");
+    }
+    sockaddr_in local = makeAddress("0.0.0.0", snapshotPort);
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&local), sizeof(local)) < 0) {
+        int saved = errno;
+        ::close(fd_);
+        errno = saved;
+        throwErrno("bind snapshot port " + std::to_string(snapshotPort));
+    }
+    socklen_t length = sizeof(local);
+    getsockname(fd_, reinterpret_cast<sockaddr*>(&local), &length);
+    snapshotPort_ = ntohs(local.sin_port);
+    if (IN_MULTICAST(ntohl(destination_.sin_addr.s_addr))) {
+        unsigned char hops = static_cast<unsigned char>(ttl);
+        unsigned char loop = 1;
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &hops, sizeof(hops));
+        setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    }
+    pending_.reserve(feedwire::MAX_TICKS_PER_PACKET);
+}
+
+MulticastFeedPublisher::~MulticastFeedPublisher() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void MulticastFeedPublisher::publish(const MarketTick& tick) {
+    pending_.emplace_back();
+    feedwire::encodeTick(tick, pending_.back());
+    auto it = latest_.find(tick.asset.symbol);
+    if (it == latest_.end()) {
+        latest_.emplace(tick.asset.symbol, pending_.back());
+    } else {
+        it->second = pending_.back();
+    }
+    if (pending_.size() == feedwire::MAX_TICKS_PER_PACKET) {
+        flush();
+    }
+}
+
+void MulticastFeedPublisher::flush() {
+    if (pending_.empty()) {
+        return;
+    }
+    size_t length = feedwire::encodePacket(feedwire::PacketType::TICKS, nextSequence_, pending_.data(),
+                                           pending_.size(), 0, packet_);
+    if (sendto(fd_, packet_, length, 0, reinterpret_cast<const sockaddr*>(&destination_), sizeof(destination_)) < 0) {
+        throwErrno("sendto feed");
+    }
+    nextSequence_ += pending_.size();
+    pending_.clear();
+}
+
+void MulticastFeedPublisher::skip(uint64_t count) {
+    flush();
+    nextSequence_ += count;
+}
+
+size_t MulticastFeedPublisher::serveSnapshots() {
+    size_t served = 0;
+    char request[64];
+    sockaddr_in from{};
+    socklen_t fromLength = sizeof(from);
+    ssize_t n;
+    while ((n = recvfrom(fd_, request, sizeof(request), MSG_DONTWAIT, reinterpret_cast<sockaddr*>(&from),
+                         &fromLength)) >= 0) {
+        feedwire::PacketHeader header;
+        if (static_cast<size_t>(n) < sizeof(header)) {
+            continue;
+        }
+        std::memcpy(&header, request, sizeof(header));
+        if (header.magic != feedwire::MAGIC || header.type != feedwire::PacketType::SNAPSHOT_REQUEST) {
+            continue;
+        }
+        // Everything published so far is in latest_, so the snapshot is as of the last sequence sent
+        flush();
+        uint64_t asOf = nextSequence_ - 1;
+        feedwire::Tick chunk[feedwire::MAX_TICKS_PER_PACKET];
+        size_t count = 0;
+        size_t remaining = latest_.size();
+        auto send = [&](bool last) {
+            size_t length = feedwire::encodePacket(feedwire::PacketType::SNAPSHOT, asOf, chunk, count,
+                                                   last ? feedwire::FLAG_LAST : 0, packet_);
+            sendto(fd_, packet_, length, 0, reinterpret_cast<const sockaddr*>(&from), fromLength);
+            count = 0;
+        };
+        for (const auto& [symbol, tick] : latest_) {
+            chunk[count++] = tick;
+            --remaining;
+            if (count == feedwire::MAX_TICKS_PER_PACKET && remaining > 0) {
+                send(false);
+            }
+        }
+        send(true);
+        ++served;
+        fromLength = sizeof(from);
+    }
+    return served;
+}
+
+} // namespace trading
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "engine/types.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <netinet/in.h>
+#include <spdlog/spdlog.h>
+
+namespace trading {
+
+// Binary feed format, little-endian. A packet is a header and `count`
+// fixed-size ticks; tick i carries sequence header.sequence + i. Snapshot
+// packets carry the full book as of `sequence` and the receiver resumes at
+// sequence + 1 after the packet flagged LAST.
+namespace feedwire {
+
+constexpr uint32_t MAGIC = 0x31444D46;  // "FMD1"
+constexpr uint8_t FLAG_LAST = 0x01;
+constexpr size_t MAX_PACKET = 1472;     // One Ethernet frame of UDP payload
+constexpr int64_t PRICE_SCALE = 100000000;
+constexpr size_t SYMBOL_LENGTH = 8;
+
+enum class PacketType : uint8_t {
+    TICKS = 1,
+    SNAPSHOT = 2,
+    SNAPSHOT_REQUEST = 3   // sequence = receiver's next expected
+};
+
+#pragma pack(push, 1)
+struct PacketHeader {
+    uint32_t magic;
+    PacketType type;
+    uint8_t flags;
+    uint16_t count;
+    uint64_t sequence;
+};
+
+struct Tick {
+    char symbol[SYMBOL_LENGTH];   // NUL padded
+    int64_t bid;                  // Prices in 1e-8 units
+    int64_t ask;
+    int64_t last;
+    uint32_t bidSize;
+    uint32_t askSize;
+    uint64_t volume;
+    int64_t timestampNs;          // Since the epoch
+};
+#pragma pack(pop)
+
+static_assert(sizeof(PacketHeader) == 16 && sizeof(Tick) == 56, "feed wire layout");
+constexpr size_t MAX_TICKS_PER_PACKET = (MAX_PACKET - sizeof(PacketHeader)) / sizeof(Tick);
+
+// Decode into a caller-owned tick. Symbols up to the small-string capacity
+// reuse the tick's storage, so steady-state decoding does not allocate.
+void decodeTick(const Tick& wire, MarketTick& tick);
+void encodeTick(const MarketTick& tick, Tick& wire);
+
+// Header plus ticks into `out` (at least MAX_PACKET bytes); returns the length
+size_t encodePacket(PacketType type, uint64_t sequence, const Tick* ticks, size_t count, uint8_t flags, char* out);
+
+} // namespace feedwire
+
+struct MulticastFeedConfig {
+    std::string group;                         // Multicast group; empty receives unicast
+    std::string interfaceAddress = "0.0.0.0";  // Interface to join the group on
+    std::string bindAddress = "0.0.0.0";
+    uint16_t port = 0;                         // 0 picks a free port (unicast tests)
+    std::string snapshotHost = "127.0.0.1";    // Where snapshot requests go
+    uint16_t snapshotPort = 0;                 // 0 skips gaps after gapTimeout instead
+    size_t batchSize = 64;                     // Datagrams per recvmmsg
+    size_t reorderCapacity = 4096;             // Ticks held while a gap is open
+    std::chrono::milliseconds gapTimeout{20};  // Wait this long for a late packet
+    std::chrono::milliseconds snapshotRetry{200};
+    int receiveBufferBytes = 8 * 1024 * 1024;
+};
+
+struct FeedStats {
+    uint64_t packets = 0;
+    uint64_t messages = 0;          // Ticks delivered, snapshot ticks included
+    uint64_t duplicates = 0;
+    uint64_t gaps = 0;              // Times a gap opened
+    uint64_t reordered = 0;         // Delivered from the reorder buffer
+    uint64_t dropped = 0;           // Beyond the reorder ring, or skipped without a snapshot source
+    uint64_t snapshotRequests = 0;
+    uint64_t snapshotsApplied = 0;
+    uint64_t malformed = 0;
+};
+
+// Sequenced binary feed over UDP. Datagrams are read recvmmsg batches at a
+// time into preallocated buffers and decoded into one reused MarketTick, so
+// the receive path does not allocate. Ticks ahead of a gap wait in a fixed
+// ring; if the gap is not filled within gapTimeout, or the ring would
+// overflow, a snapshot is requested and the stream resumes after it.
+// Either drive poll() from your own thread or call start().
+class MulticastFeedReceiver {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TickHandler = std::function<void(const MarketTick&, uint64_t sequence)>;
+
+private:
+    struct Slot {
+        uint64_t sequence = 0;   // 0 when empty
+        feedwire::Tick tick;
+    };
+
+    MulticastFeedConfig config_;
+    TickHandler handler_;
+    std::shared_ptr<spdlog::logger> logger_;
+    int fd_ = -1;
+    uint16_t port_ = 0;
+    sockaddr_in snapshotAddress_{};
+
+    std::vector<char> buffers_;
+    std::vector<struct mmsghdr> messages_;
+    std::vector<struct iovec> iovecs_;
+
+    uint64_t expected_ = 0;              // Next sequence to deliver; 0 until the first packet
+    std::vector<Slot> reorder_;
+    uint64_t buffered_ = 0;
+    uint64_t highestBuffered_ = 0;
+    bool gapOpen_ = false;
+    bool recovering_ = false;            // Snapshot requested
+    bool overflow_ = false;              // Ring overflowed; request without waiting
+    Clock::time_point gapSince_;
+    Clock::time_point lastSnapshotRequest_;
+    MarketTick tick_;
+    FeedStats stats_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    void deliver(const feedwire::Tick& wire, uint64_t sequence);
+    void drainReorder();
+    void skipTo(uint64_t sequence);
+    void buffer(const feedwire::Tick& wire, uint64_t sequence, Clock::time_point now);
+    size_t applySnapshot(const feedwire::PacketHeader& header, const char* ticks, Clock::time_point now);
+    void checkGap(Clock::time_point now);
+    void requestSnapshot(Clock::time_point now);
+
+public:
+    MulticastFeedReceiver(MulticastFeedConfig config, TickHandler handler);
+    ~MulticastFeedReceiver();
+
+    MulticastFeedReceiver(const MulticastFeedReceiver&) = delete;
+    MulticastFeedReceiver& operator=(const MulticastFeedReceiver&) = delete;
+
+    // Bind, size the socket buffer and join the group. Throws std::system_error.
+    void open();
+    // Where snapshot requests go, when not known up front
+    void setSnapshotSource(const std::string& host, uint16_t port);
+    // One recvmmsg batch, waiting up to timeoutMs; returns ticks delivered
+    size_t poll(int timeoutMs);
+    // Run poll() on an owned thread
+    void start();
+    void stop();
+
+    // Sequencing and decode for one datagram; poll() calls this per packet
+    size_t processPacket(const char* data, size_t length, Clock::time_point now);
+
+    uint16_t getPort() const { return port_; }
+    uint64_t getExpectedSequence() const { return expected_; }
+    bool isRecovering() const { return recovering_; }
+    // Owner thread only, or after stop()
+    const FeedStats& getStats() const { return stats_; }
+};
+
+// Sender side, for tests and benchmarks: batches ticks into sequenced
+// packets and answers snapshot requests, which arrive on the same socket,
+// with the latest tick per symbol.
+class MulticastFeedPublisher {
+private:
+    int fd_ = -1;
+    uint16_t snapshotPort_ = 0;
+    sockaddr_in destination_{};
+    uint64_t nextSequence_ = 1;
+    std::vector<feedwire::Tick> pending_;
+    std::unordered_map<std::string, feedwire::Tick> latest_;
+    char packet_[feedwire::MAX_PACKET];
+
+public:
+    // Destination is a multicast group or a unicast address. Throws std::system_error.
+    MulticastFeedPublisher(const std::string& host, uint16_t port, uint16_t snapshotPort = 0, int ttl = 1);
+    ~MulticastFeedPublisher();
+
+    MulticastFeedPublisher(const MulticastFeedPublisher&) = delete;
+    MulticastFeedPublisher& operator=(const MulticastFeedPublisher&) = delete;
+
+    // Queue a tick; a full packet is sent at once
+    void publish(const MarketTick& tick);
+    void flush();
+    // Non-blocking; answers every queued request. Returns requests served.
+    size_t serveSnapshots();
+
+    // Skip sequence numbers without sending, to simulate loss
+    void skip(uint64_t count);
+    uint64_t getNextSequence() const { return nextSequence_; }
+    uint16_t getSnapshotPort() const { return snapshotPort_; }
+};
+
+} // namespace trading
@@ -0,0 +1,502 @@
+#include "fix_gateway.h"
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
+#include <poll.h>
+
+namespace trading {
+
+namespace {
+
+constexpr int POLL_INTERVAL_MS = 100;   // Also the session timer resolution
+
+std::string orderKey(const std::string& compId, const std::string& clOrdId) {
+    std::string key;
+    key.reserve(compId.size() + clOrdId.size() + 1);
+    key.append(compId).push_back(FIX_SOH);
+    key.append(clOrdId);
+    return key;
+}
+
+char ordStatusCode(OrderStatus status) {
+    switch (status) {
+        case OrderStatus::PENDING: return '0';
+        case OrderStatus::PARTIAL: return '1';
+        case OrderStatus::FILLED: return '2';
+        case OrderStatus::CANCELLED: return '4';
+        case OrderStatus::REJECTED: return '8';
+        case OrderStatus::EXPIRED: return 'C';
+    }
+    return '0';
+}
+
+bool isTerminal(OrderStatus status) {
+    return status == OrderStatus::FILLED || status == OrderStatus::CANCELLED || status == OrderStatus::REJECTED ||
+           status == OrderStatus::EXPIRED;
+}
+
+} // namespace
+
+FixGateway::FixGateway(OrderManager& orderManager, FixGatewayConfig config)
+    : orders_(orderManager), config_(std::move(config)), port_(config_.port) {
+    static std::atomic<int> instance_count{0};
+    logger_ = spdlog::stdout_color_mt("fix_gateway_" + std::to_string(instance_count++));
+    logger_->set_level(spdlog::level::info);
+}
+
+FixGateway::~FixGateway() {
+    stop();
+}
+
+void FixGateway::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    listenFd_ = frontier::wire::tcp_listen(config_.host, config_.port, &port_);
+    thread_ = std::thread([this] { run(); });
+    logger_->info("FIX gateway {} listening on {}:{}", config_.senderCompId, config_.host, port_);
+}
+
+void FixGateway::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    waker_.notify();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    std::vector<uint64_t> ids;
+    for (const auto& [id, connection] : connections_) {
+        ids.push_back(id);
+    }
+    for (uint64_t id : ids) {
+        closeConnection(id);
+    }
+    frontier::wire::close_fd(listenFd_);
+}
+
+void FixGateway::onOrderUpdate(const Order& order) {
+    {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        updates_.push_back(order);
+    }
+    waker_.notify();
+}
+
+void FixGateway::onCommandRejected(const EngineCommand& command, const std::string& reason) {
+    {
+        std::lock_guard<std::mutex> lock(updateMutex_);
+        rejects_.emplace_back(command, reason);
+    }
+    waker_.notify();
+}
+
+void FixGateway::run() {
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    std::vector<Order> updates;
+    std::vector<std::pair<EngineCommand, std::string>> rejects;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        fds.clear();
+        ids.clear();
+        fds.push_back({waker_.fd(), POLLIN, 0});
+        fds.push_back({listenFd_, POLLIN, 0});
+        for (auto& [id, connection] : connections_) {
+            short events = POLLIN;
+            if (connection->outOffset < connection->out.size()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({connection->fd, events, 0});
+            ids.push_back(id);
+        }
+        if (poll(fds.data(), fds.size(), POLL_INTERVAL_MS) < 0) {
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            waker_.drain();
+        }
+        if (fds[1].revents & POLLIN) {
+            acceptConnections();
+        }
+        for (size_t i = 0; i < ids.size(); ++i) {
+            auto it = connections_.find(ids[i]);
+            if (it != connections_.end() && (fds[i + 2].revents & (POLLIN | POLLERR | POLLHUP))) {
+                onReadable(ids[i], *it->second);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(updateMutex_);
+            updates.swap(updates_);
+            rejects.swap(rejects_);
+        }
+        for (const auto& order : updates) {
+            publishUpdate(order);
+        }
+        updates.clear();
+        for (const auto& [command, reason] : rejects) {
+            publishReject(command, reason);
+        }
+        rejects.clear();
+
+        auto now = FixSession::Clock::now();
+        for (auto& [compId, session] : sessions_) {
+            session->onTimer(now);
+        }
+
+        // Flush, then drop connections whose session asked to disconnect
+        // and those still without a Logon after the timeout
+        std::vector<uint64_t> closing;
+        for (auto& [id, connection] : connections_) {
+            if (connection->compId.empty() && now - connection->accepted >= std::chrono::seconds(config_.logonTimeout)) {
+                logger_->warn("Connection {} sent no Logon in {}s", id, config_.logonTimeout);
+                connection->closing = true;
+            }
+            if (!frontier::wire::write_pending(connection->fd, connection->out, connection->outOffset)) {
+                connection->closing = true;
+            }
+            if (connection->outOffset == connection->out.size()) {
+                connection->out.clear();
+                connection->outOffset = 0;
+            }
+            auto session = sessions_.find(connection->compId);
+            if (connection->closing || (session != sessions_.end() && session->second->shouldDisconnect())) {
+                closing.push_back(id);
+            }
+        }
+        for (uint64_t id : closing) {
+            closeConnection(id);
+        }
+    }
+}
+
+void FixGateway::acceptConnections() {
+    while (true) {
+        int fd = frontier::wire::tcp_accept(listenFd_);
+        if (fd < 0) {
+            return;
+        }
+        auto connection = std::make_unique<Connection>();
+        connection->fd = fd;
+        connection->accepted = FixSession::Clock::now();
+        connections_.emplace(nextConnectionId_++, std::move(connection));
+    }
+}
+
+void FixGateway::onReadable(uint64_t id, Connection& connection) {
+    if (!frontier::wire::read_available(connection.fd, connection.in)) {
+        connection.closing = true;
+    }
+
+    FixMessage message;
+    size_t offset = 0;
+    while (offset < connection.in.size() && !connection.closing) {
+        size_t consumed = 0;
+        auto status = FixParser::parse(connection.in.data() + offset, connection.in.size() - offset, message, consumed);
+        if (status == FixParseStatus::INCOMPLETE) {
+            break;
+        }
+        if (status == FixParseStatus::VIOLATION) {
+            logger_->warn("Closing connection {}: message over {} bytes or with an over-long tag", id,
+                          FixParser::MAX_MESSAGE_LENGTH);
+            connection.closing = true;
+            break;
+        }
+        offset += consumed;
+        if (status == FixParseStatus::INVALID) {
+            logger_->warn("Dropped {} garbled bytes from connection {}", consumed, id);
+            continue;
+        }
+        messagesReceived_.fetch_add(1, std::memory_order_relaxed);
+
+        if (connection.compId.empty() && !bindSession(id, connection, message)) {
+            connection.closing = true;
+            break;
+        }
+        FixSession& session = *sessions_.at(connection.compId);
+        session.onMessage(message);
+        if (session.shouldDisconnect()) {
+            break;
+        }
+    }
+    connection.in.erase(0, offset);
+}
+
+bool FixGateway::bindSession(uint64_t id, Connection& connection, const FixMessage& logon) {
+    std::string compId(logon.get(fixtag::SenderCompID));
+    if (logon.msgType() != "A" || compId.empty()) {
+        logger_->warn("Connection {} did not open with a Logon", id);
+        return false;
+    }
+    if (!config_.allowedCompIds.empty() &&
+        std::find(config_.allowedCompIds.begin(), config_.allowedCompIds.end(), compId) ==
+            config_.allowedCompIds.end()) {
+        logger_->warn("Refused Logon from unknown CompID {}", compId);
+        return false;
+    }
+    if (sessionConnections_.count(compId)) {
+        logger_->warn("Refused second connection for {}", compId);
+        return false;
+    }
+
+    auto& session = sessions_[compId];
+    if (!session) {
+        FixSessionConfig sessionConfig;
+        sessionConfig.senderCompId = config_.senderCompId;
+        sessionConfig.targetCompId = compId;
+        sessionConfig.heartbeatInterval = config_.heartbeatInterval;
+        if (!config_.journalDirectory.empty()) {
+            sessionConfig.journalPath = config_.journalDirectory + "/" + config_.senderCompId + "-" + compId + ".journal";
+        }
+        session = std::make_unique<FixSession>(sessionConfig);
+        session->setApplicationHandler([this, compId](const FixMessage& message) { onApplication(compId, message); });
+    }
+    connection.compId = compId;
+    sessionConnections_[compId] = id;
+    sessionCount_ = sessionConnections_.size();
+    session->attach([this, id](const std::string& bytes) {
+        auto it = connections_.find(id);
+        if (it != connections_.end()) {
+            it->second->out += bytes;
+        }
+    });
+    return true;
+}
+
+void FixGateway::closeConnection(uint64_t id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) {
+        return;
+    }
+    Connection& connection = *it->second;
+    if (!connection.compId.empty()) {
+        sessions_.at(connection.compId)->detach();
+        sessionConnections_.erase(connection.compId);
+        sessionCount_ = sessionConnections_.size();
+    }
+    frontier::wire::close_fd(connection.fd);
+    connections_.erase(it);
+}
+
+void FixGateway::onApplication(const std::string& compId, const FixMessage& message) {
+    FixSession& session = *sessions_.at(compId);
+    FixOrderCommand decoded;
+    std::string error;
+    std::string_view type = message.msgType();
+    bool orderEntry = type == "D" || type == "F" || type == "G";
+
+    if (!orderEntry) {
+        FixFields fields;
+        fields.add(fixtag::RefSeqNum, message.get(fixtag::MsgSeqNum))
+            .add(fixtag::RefMsgType, type)
+            .add(fixtag::BusinessRejectReason, 3)  // Unsupported message type
+            .add(fixtag::Text, "Unsupported MsgType");
+        session.send("j", fields);
+        return;
+    }
+    if (!decodeOrderCommand(message, decoded, error)) {
+        if (type == "D") {
+            rejectOrder(session, message, error);
+        } else {
+            decoded.clOrdId = std::string(message.get(fixtag::ClOrdID));
+            decoded.origClOrdId = std::string(message.get(fixtag::OrigClOrdID));
+            rejectCancel(session, decoded, type == "G", error);
+        }
+        return;
+    }
+    if (type == "D") {
+        onNewOrder(session, compId, decoded);
+    } else {
+        onCancelOrReplace(session, compId, decoded, type == "G");
+    }
+}
+
+void FixGateway::onNewOrder(FixSession& session, const std::string& compId, FixOrderCommand& decoded) {
+    std::string key = orderKey(compId, decoded.clOrdId);
+    if (clOrdIndex_.count(key)) {
+        FixFields fields;
+        fields.add(fixtag::OrderID, "NONE")
+            .add(fixtag::ClOrdID, decoded.clOrdId)
+            .add(fixtag::ExecID, nextExecId_++)
+            .add(fixtag::ExecType, '8')
+            .add(fixtag::OrdStatus, '8')
+            .add(fixtag::Symbol, decoded.command.order.asset.symbol)
+            .add(fixtag::Side, decoded.command.order.side == OrderSide::BUY ? '1' : '2')
+            .add(fixtag::LeavesQty, 0)
+            .add(fixtag::CumQty, 0)
+            .add(fixtag::AvgPx, 0)
+            .add(fixtag::Text, "Duplicate ClOrdID");
+        session.send("8", fields);
+        return;
+    }
+    // The engine's PENDING update acknowledges it as New
+    std::string orderId = orders_.enqueueCommand(std::move(decoded.command));
+    ClientOrder& client = clientOrders_[orderId];
+    client.compId = compId;
+    client.clOrdId = decoded.clOrdId;
+    client.keys.push_back(key);
+    clOrdIndex_[key] = orderId;
+}
+
+void FixGateway::onCancelOrReplace(FixSession& session, const std::string& compId, FixOrderCommand& decoded,
+                                   bool replace) {
+    auto indexed = clOrdIndex_.find(orderKey(compId, decoded.origClOrdId));
+    if (indexed == clOrdIndex_.end()) {
+        rejectCancel(session, decoded, replace, "Unknown order");
+        return;
+    }
+    const std::string& orderId = indexed->second;
+    ClientOrder& client = clientOrders_.at(orderId);
+    if (isTerminal(client.lastStatus)) {
+        rejectCancel(session, decoded, replace, "Too late to cancel");
+        return;
+    }
+    if (!client.pendingClOrdId.empty()) {
+        rejectCancel(session, decoded, replace, "Cancel or replace already pending");
+        return;
+    }
+    client.pendingClOrdId = decoded.clOrdId;
+    client.pendingReplace = replace;
+    client.keys.push_back(orderKey(compId, decoded.clOrdId));
+    clOrdIndex_[client.keys.back()] = orderId;
+    decoded.command.orderId = orderId;
+    orders_.enqueueCommand(std::move(decoded.command));
+}
+
+void FixGateway::publishUpdate(const Order& order) {
+    auto it = clientOrders_.find(order.id);
+    if (it == clientOrders_.end()) {
+        return;  // Not entered through this gateway
+    }
+    ClientOrder& client = it->second;
+    auto session = sessions_.find(client.compId);
+    if (session == sessions_.end()) {
+        return;
+    }
+
+    double cumQty = order.filledQuantity.value;
+    double notional = cumQty * order.averageFillPrice.value;
+    double lastQty = cumQty - client.cumQty;
+    bool fill = lastQty > 1e-9;
+
+    char execType = ordStatusCode(order.status);
+    std::string clOrdId = client.clOrdId;
+    std::string origClOrdId;
+    if (fill) {
+        execType = 'F';
+    } else if (!client.pendingClOrdId.empty() &&
+               (order.status == OrderStatus::CANCELLED || (client.pendingReplace && !isTerminal(order.status)))) {
+        execType = order.status == OrderStatus::CANCELLED ? '4' : '5';
+        origClOrdId = client.clOrdId;
+        clOrdId = client.pendingClOrdId;
+        client.clOrdId = client.pendingClOrdId;
+        client.pendingClOrdId.clear();
+        client.pendingReplace = false;
+    }
+
+    FixFields fields;
+    fields.add(fixtag::OrderID, order.id).add(fixtag::ClOrdID, clOrdId);
+    if (!origClOrdId.empty()) {
+        fields.add(fixtag::OrigClOrdID, origClOrdId);
+    }
+    fields.add(fixtag::ExecID, nextExecId_++)
+        .add(fixtag::ExecType, execType)
+        .add(fixtag::OrdStatus, ordStatusCode(order.status))
+        .add(fixtag::Symbol, order.asset.symbol)
+        .add(fixtag::Side, order.side == OrderSide::BUY ? '1' : '2')
+        .add(fixtag::OrderQty, order.quantity.value)
+        .add(fixtag::CumQty, cumQty)
+        .add(fixtag::LeavesQty, isTerminal(order.status) ? 0.0 : std::max(order.quantity.value - cumQty, 0.0))
+        .add(fixtag::AvgPx, order.averageFillPrice.value);
+    if (fill) {
+        fields.add(fixtag::LastQty, lastQty).add(fixtag::LastPx, (notional - client.notional) / lastQty);
+    }
+    session->second->send("8", fields);
+
+    bool finished = isTerminal(order.status) && !isTerminal(client.lastStatus);
+    client.cumQty = cumQty;
+    client.notional = notional;
+    client.lastStatus = order.status;
+
+    if (isTerminal(order.status) && !client.pendingClOrdId.empty()) {
+        // Finished before the engine reached the cancel or replace
+        FixOrderCommand late;
+        late.clOrdId = client.pendingClOrdId;
+        late.origClOrdId = client.clOrdId;
+        rejectCancel(*session->second, late, client.pendingReplace, "Too late to cancel");
+        client.pendingClOrdId.clear();
+        client.pendingReplace = false;
+    }
+    if (finished) {
+        retainFinished(order.id);
+    }
+}
+
+// Finished orders stay indexed so late cancels and reused ClOrdIDs get a
+// proper answer; past the retention the oldest are forgotten
+void FixGateway::retainFinished(const std::string& orderId) {
+    finishedOrders_.push_back(orderId);
+    while (finishedOrders_.size() > config_.finishedOrderRetention) {
+        auto it = clientOrders_.find(finishedOrders_.front());
+        finishedOrders_.pop_front();
+        if (it == clientOrders_.end()) {
+            continue;
+        }
+        for (const std::string& key : it->second.keys) {
+            auto indexed = clOrdIndex_.find(key);
+            if (indexed != clOrdIndex_.end() && indexed->second == it->first) {
+                clOrdIndex_.erase(indexed);
+            }
+        }
+        clientOrders_.erase(it);
+    }
+}
+
+void FixGateway::rejectOrder(FixSession& session, const FixMessage& message, const std::string& reason) {
+    FixFields fields;
+    fields.add(fixtag::OrderID, "NONE")
+        .add(fixtag::ClOrdID, message.get(fixtag::ClOrdID))
+        .add(fixtag::ExecID, nextExecId_++)
+        .add(fixtag::ExecType, '8')
+        .add(fixtag::OrdStatus, '8')
+        .add(fixtag::Symbol, message.get(fixtag::Symbol))
+        .add(fixtag::Side, message.get(fixtag::Side))
+        .add(fixtag::LeavesQty, 0)
+        .add(fixtag::CumQty, 0)
+        .add(fixtag::AvgPx, 0)
+        .add(fixtag::Text, reason);
+    session.send("8", fields);
+}
+
+void FixGateway::publishReject(const EngineCommand& command, const std::string& reason) {
+    auto it = clientOrders_.find(command.orderId);
+    if (it == clientOrders_.end() || it->second.pendingClOrdId.empty() ||
+        it->second.pendingReplace != (command.type == CommandType::AMEND)) {
+        return;  // Not the request this gateway is waiting on
+    }
+    ClientOrder& client = it->second;
+    std::string clOrdId = std::move(client.pendingClOrdId);
+    bool replace = client.pendingReplace;
+    client.pendingClOrdId.clear();
+    client.pendingReplace = false;
+    clOrdIndex_.erase(orderKey(client.compId, clOrdId));  // It never became the order's ClOrdID
+
+    auto session = sessions_.find(client.compId);
+    if (session != sessions_.end()) {
+        rejectCancel(*session->second, command.orderId, clOrdId, client.clOrdId, replace, reason);
+    }
+}
+
+void FixGateway::rejectCancel(FixSession& session, const std::string& orderId, const std::string& clOrdId,
+                              const std::string& origClOrdId, bool replace, const std::string& reason) {
+    FixFields fields;
+    fields.add(fixtag::OrderID, orderId)
+        .add(fixtag::ClOrdID, clOrdId)
+        .add(fixtag::OrigClOrdID, origClOrdId)
+        .add(fixtag::OrdStatus, '8')
+        .add(fixtag::CxlRejResponseTo, replace ? '2' : '1')
+        .add(fixtag::Text, reason);
+    session.send("9", fields);
+}
+
+} // namespace trading
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "engine/order_manager.h"
+#include "fix_session.h"
+#include "frontier/http_wire.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace trading {
+
+struct FixGatewayConfig {
+    std::string host = "0.0.0.0";
+    uint16_t port = 9878;                      // 0 picks a free port
+    std::string senderCompId = "FRONTIER";
+    std::vector<std::string> allowedCompIds;   // Empty accepts any client
+    std::string journalDirectory;              // Empty keeps session journals in memory
+    int heartbeatInterval = 30;                // Until the client's Logon says otherwise
+    int logonTimeout = 10;                     // Seconds a new connection has to send its Logon
+    size_t finishedOrderRetention = 10000;     // Finished orders kept to answer late cancels
+};
+
+// FIX order entry in front of the OrderManager. One poll thread owns the
+// sockets and sessions; sessions are keyed by the client's SenderCompID and
+// outlive connections, so a reconnecting client resumes its sequence numbers.
+// NewOrderSingle, OrderCancelRequest and OrderCancelReplaceRequest become
+// queued EngineCommands; engine order updates, fed in through
+// onOrderUpdate(), go back as ExecutionReports.
+class FixGateway {
+private:
+    // Engine order as its client knows it
+    struct ClientOrder {
+        std::string compId;
+        std::string clOrdId;               // Current ClOrdID
+        std::string pendingClOrdId;        // Cancel or replace awaiting its update
+        bool pendingReplace = false;
+        double cumQty = 0.0;
+        double notional = 0.0;             // cumQty * average price so far
+        OrderStatus lastStatus = OrderStatus::PENDING;
+        std::vector<std::string> keys;     // Every clOrdIndex_ entry made for it
+    };
+
+    struct Connection {
+        int fd = -1;
+        std::string in;
+        std::string out;
+        size_t outOffset = 0;
+        std::string compId;                // Set by the Logon
+        FixSession::Clock::time_point accepted;
+        bool closing = false;
+    };
+
+    OrderManager& orders_;
+    FixGatewayConfig config_;
+    std::shared_ptr<spdlog::logger> logger_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    frontier::wire::Waker waker_;
+    int listenFd_ = -1;
+    uint16_t port_ = 0;
+
+    std::mutex updateMutex_;
+    std::vector<Order> updates_;
+    std::vector<std::pair<EngineCommand, std::string>> rejects_;  // Failed amends and cancels, with reasons
+
+    // Poll thread only
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections_;
+    std::unordered_map<std::string, std::unique_ptr<FixSession>> sessions_;
+    std::unordered_map<std::string, uint64_t> sessionConnections_;      // compId -> connection
+    std::unordered_map<std::string, ClientOrder> clientOrders_;          // Engine order id ->
+    std::unordered_map<std::string, std::string> clOrdIndex_;            // compId SOH ClOrdID -> order id
+    std::deque<std::string> finishedOrders_;                             // Terminal order ids, oldest first
+    uint64_t nextConnectionId_ = 1;
+    uint64_t nextExecId_ = 1;
+
+    std::atomic<size_t> sessionCount_{0};
+    std::atomic<uint64_t> messagesReceived_{0};
+
+    void run();
+    void acceptConnections();
+    void onReadable(uint64_t id, Connection& connection);
+    bool bindSession(uint64_t id, Connection& connection, const FixMessage& logon);
+    void closeConnection(uint64_t id);
+    void onApplication(const std::string& compId, const FixMessage& message);
+    void onNewOrder(FixSession& session, const std::string& compId, FixOrderCommand& decoded);
+    void onCancelOrReplace(FixSession& session, const std::string& compId, FixOrderCommand& decoded,
+                           bool replace);
+    void publishUpdate(const Order& order);
+    void publishReject(const EngineCommand& command, const std::string& reason);
+    void retainFinished(const std::string& orderId);
+    void rejectOrder(FixSession& session, const FixMessage& message, const std::string& reason);
+    void rejectCancel(FixSession& session, const FixOrderCommand& decoded, bool replace, const std::string& reason) {
+        rejectCancel(session, "NONE", decoded.clOrdId, decoded.origClOrdId, replace, reason);
+    }
+    void rejectCancel(FixSession& session, const std::string& orderId, const std::string& clOrdId,
+                      const std::string& origClOrdId, bool replace, const std::string& reason);
+
+public:
+    FixGateway(OrderManager& orderManager, FixGatewayConfig config);
+    ~FixGateway();
+
+    FixGateway(const FixGateway&) = delete;
+    FixGateway& operator=(const FixGateway&) = delete;
+
+    void start();
+    void stop();
+    uint16_t getPort() const { return port_; }
+
+    // Thread-safe; wire to OrderManager::setOrderUpdateCallback
+    void onOrderUpdate(const Order& order);
+    // Thread-safe; wire to OrderManager::setCommandRejectCallback. Answers the
+    // pending cancel or replace with an OrderCancelReject.
+    void onCommandRejected(const EngineCommand& command, const std::string& reason);
+
+    size_t getSessionCount() const { return sessionCount_.load(std::memory_order_relaxed); }
+    uint64_t getMessagesReceived() const { return messagesReceived_.load(std::memory_order_relaxed); }
+};
+
+} // namespace trading
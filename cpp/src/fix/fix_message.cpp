@@ -0,0 +1,383 @@
+#include "fix_message.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace trading {
+
+namespace {
+
+constexpr size_t TRAILER_LENGTH = 7;   // "10=NNN" + SOH
+constexpr size_t MAX_HEADER_SCAN = 64; // BeginString and BodyLength fit well inside this
+
+// Bit i set when data[i] is SOH, for the first `count` (<= 16) bytes.
+// `readable` says whether 16 bytes may be loaded from data.
+inline uint32_t sohMask(const char* data, size_t count, bool readable) {
+#if defined(__SSE2__)
+    if (readable) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(FIX_SOH))));
+        return count < 16 ? mask & ((1u << count) - 1) : mask;
+    }
+#else
+    (void)readable;
+#endif
+    uint32_t mask = 0;
+    for (size_t i = 0; i < count; ++i) {
+        mask |= static_cast<uint32_t>(data[i] == FIX_SOH) << i;
+    }
+    return mask;
+}
+
+inline size_t findSoh(const char* data, size_t from, size_t to, size_t length) {
+    for (size_t block = from; block < to; block += 16) {
+        size_t count = std::min<size_t>(16, to - block);
+        uint32_t mask = sohMask(data + block, count, block + 16 <= length);
+        if (mask) {
+            return block + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    return std::string_view::npos;
+}
+
+bool parseUnsigned(std::string_view text, int64_t& value) {
+    if (text.empty() || text.size() > 18) {
+        return false;
+    }
+    int64_t result = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        result = result * 10 + (c - '0');
+    }
+    value = result;
+    return true;
+}
+
+// Plain decimal ("-12.345"); FIX prices and quantities carry no exponent
+bool parseDecimal(std::string_view text, double& value) {
+    size_t i = 0;
+    bool negative = !text.empty() && text[0] == '-';
+    i += negative;
+    int64_t whole = 0;
+    int64_t fraction = 0;
+    double scale = 1.0;
+    bool digits = false;
+    for (size_t start = i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+        if (i - start == 18) {
+            return false;  // Would overflow the whole part
+        }
+        whole = whole * 10 + (text[i] - '0');
+        digits = true;
+    }
+    if (i < text.size() && text[i] == '.') {
+        for (++i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+            if (scale < 1e15) {
+                fraction = fraction * 10 + (text[i] - '0');
+                scale *= 10.0;
+            }
+            digits = true;
+        }
+    }
+    if (!digits || i != text.size()) {
+        return false;
+    }
+    double result = static_cast<double>(whole) + static_cast<double>(fraction) / scale;
+    value = negative ? -result : result;
+    return true;
+}
+
+// Index of the next "8=" that could start a message, or length
+size_t resyncPoint(const char* data, size_t length) {
+    for (size_t i = 1; i + 1 < length; ++i) {
+        if (data[i] == '8' && data[i + 1] == '=' && data[i - 1] == FIX_SOH) {
+            return i;
+        }
+    }
+    return length > 0 && data[length - 1] == FIX_SOH ? length : length - (length > 1 ? 1 : 0);
+}
+
+} // namespace
+
+std::string_view FixMessage::get(int tag) const {
+    for (size_t i = 0; i < count_; ++i) {
+        if (fields_[i].tag == tag) {
+            return fields_[i].value;
+        }
+    }
+    return {};
+}
+
+bool FixMessage::has(int tag) const {
+    for (size_t i = 0; i < count_; ++i) {
+        if (fields_[i].tag == tag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FixMessage::getInt(int tag, int64_t& value) const {
+    return parseUnsigned(get(tag), value);
+}
+
+bool FixMessage::getDouble(int tag, double& value) const {
+    return parseDecimal(get(tag), value);
+}
+
+bool FixMessage::isAdmin() const {
+    // Heartbeat, TestRequest, ResendRequest, Reject, SequenceReset, Logout, Logon
+    return msgType_.size() == 1 && std::strchr("012345A", msgType_[0]) != nullptr;
+}
+
+uint8_t FixParser::checksum(const char* data, size_t length) {
+    uint64_t sum = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i total = _mm_setzero_si128();
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        total = _mm_add_epi64(total, _mm_sad_epu8(chunk, zero));
+    }
+    sum = static_cast<uint64_t>(_mm_cvtsi128_si64(total)) +
+          static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(total, total)));
+#endif
+    for (; i < length; ++i) {
+        sum += static_cast<unsigned char>(data[i]);
+    }
+    return static_cast<uint8_t>(sum & 0xFF);
+}
+
+FixParseStatus FixParser::parse(const char* data, size_t length, FixMessage& message, size_t& consumed) {
+    consumed = 0;
+    if (length < 2) {
+        return length == 1 && data[0] != '8' ? (consumed = 1, FixParseStatus::INVALID) : FixParseStatus::INCOMPLETE;
+    }
+    if (data[0] != '8' || data[1] != '=') {
+        consumed = std::max<size_t>(resyncPoint(data, length), 1);
+        return FixParseStatus::INVALID;
+    }
+
+    // 8=BeginString SOH 9=BodyLength SOH
+    size_t scan = std::min(length, MAX_HEADER_SCAN);
+    size_t beginEnd = findSoh(data, 2, scan, length);
+    size_t lengthEnd = beginEnd == std::string_view::npos ? beginEnd : findSoh(data, beginEnd + 1, scan, length);
+    if (lengthEnd == std::string_view::npos) {
+        if (length < MAX_HEADER_SCAN) {
+            return FixParseStatus::INCOMPLETE;
+        }
+        consumed = std::max<size_t>(resyncPoint(data, length), 1);
+        return FixParseStatus::INVALID;
+    }
+    int64_t bodyLength = 0;
+    if (data[beginEnd + 1] != '9' || data[beginEnd + 2] != '=' ||
+        !parseUnsigned(std::string_view(data + beginEnd + 3, lengthEnd - beginEnd - 3), bodyLength)) {
+        consumed = std::max<size_t>(resyncPoint(data, length), 1);
+        return FixParseStatus::INVALID;
+    }
+    size_t trailer = lengthEnd + 1 + static_cast<size_t>(bodyLength);
+    size_t total = trailer + TRAILER_LENGTH;
+    if (total > MAX_MESSAGE_LENGTH) {
+        return FixParseStatus::VIOLATION;
+    }
+    if (length < total) {
+        return FixParseStatus::INCOMPLETE;
+    }
+    int64_t expected = 0;
+    if (std::memcmp(data + trailer, "10=", 3) != 0 || data[total - 1] != FIX_SOH ||
+        !parseUnsigned(std::string_view(data + trailer + 3, 3), expected)) {
+        // BodyLength does not land on the trailer: resynchronise past this "8="
+        consumed = std::max<size_t>(resyncPoint(data, length), 1);
+        return FixParseStatus::INVALID;
+    }
+    if (checksum(data, trailer) != expected) {
+        consumed = total;  // Garbled in transit: drop it, as the spec says
+        return FixParseStatus::INVALID;
+    }
+
+    // Tokenise: walk each 16-byte block's SOH bitmask
+    message.count_ = 0;
+    size_t fieldStart = 0;
+    for (size_t block = 0; block < total; block += 16) {
+        uint32_t mask = sohMask(data + block, std::min<size_t>(16, total - block), block + 16 <= length);
+        while (mask) {
+            size_t end = block + static_cast<size_t>(__builtin_ctz(mask));
+            mask &= mask - 1;
+            int tag = 0;
+            size_t i = fieldStart;
+            for (; i < end && data[i] >= '0' && data[i] <= '9'; ++i) {
+                if (i - fieldStart == MAX_TAG_DIGITS) {
+                    consumed = total;
+                    return FixParseStatus::VIOLATION;
+                }
+                tag = tag * 10 + (data[i] - '0');
+            }
+            if (i == fieldStart || i == end || data[i] != '=' || message.count_ == FixMessage::MAX_FIELDS) {
+                consumed = total;
+                return FixParseStatus::INVALID;
+            }
+            message.fields_[message.count_++] = FixField{tag, std::string_view(data + i + 1, end - i - 1)};
+            fieldStart = end + 1;
+        }
+    }
+    if (message.count_ < 4 || message.fields_[2].tag != fixtag::MsgType) {
+        consumed = total;
+        return FixParseStatus::INVALID;
+    }
+    message.msgType_ = message.fields_[2].value;
+    message.raw_ = std::string_view(data, total);
+    consumed = total;
+    return FixParseStatus::OK;
+}
+
+FixFields& FixFields::add(int tag, std::string_view value) {
+    char prefix[16];
+    int n = std::snprintf(prefix, sizeof(prefix), "%d=", tag);
+    data_.append(prefix, static_cast<size_t>(n));
+    data_.append(value);
+    data_.push_back(FIX_SOH);
+    return *this;
+}
+
+FixFields& FixFields::add(int tag, int64_t value) {
+    char buffer[40];
+    int n = std::snprintf(buffer, sizeof(buffer), "%d=%lld", tag, static_cast<long long>(value));
+    data_.append(buffer, static_cast<size_t>(n));
+    data_.push_back(FIX_SOH);
+    return *this;
+}
+
+FixFields& FixFields::add(int tag, double value) {
+    char buffer[48];
+    int n = std::snprintf(buffer, sizeof(buffer), "%d=%.10g", tag, value);
+    data_.append(buffer, static_cast<size_t>(n));
+    data_.push_back(FIX_SOH);
+    return *this;
+}
+
+std::string fixFrame(std::string_view beginString, std::string_view msgType, const std::string& fields) {
+    // BodyLength counts from after its own SOH up to the checksum field
+    size_t bodyLength = 3 + msgType.size() + 1 + fields.size();
+    char header[64];
+    int n = std::snprintf(header, sizeof(header), "8=%.*s%c9=%zu%c35=%.*s%c", static_cast<int>(beginString.size()),
+                          beginString.data(), FIX_SOH, bodyLength, FIX_SOH, static_cast<int>(msgType.size()),
+                          msgType.data(), FIX_SOH);
+    std::string frame;
+    frame.reserve(static_cast<size_t>(n) + fields.size() + TRAILER_LENGTH);
+    frame.append(header, static_cast<size_t>(n));
+    frame.append(fields);
+    char trailer[8];
+    std::snprintf(trailer, sizeof(trailer), "10=%03u%c", FixParser::checksum(frame.data(), frame.size()), FIX_SOH);
+    frame.append(trailer, TRAILER_LENGTH);
+    return frame;
+}
+
+bool decodeOrderCommand(const FixMessage& message, FixOrderCommand& out, std::string& error) {
+    std::string_view type = message.msgType();
+    out = FixOrderCommand{};
+    out.clOrdId = std::string(message.get(fixtag::ClOrdID));
+    if (out.clOrdId.empty()) {
+        error = "Missing ClOrdID";
+        return false;
+    }
+    EngineCommand& command = out.command;
+
+    if (type == "D") {
+        std::string_view symbol = message.get(fixtag::Symbol);
+        std::string_view side = message.get(fixtag::Side);
+        std::string_view ordType = message.get(fixtag::OrdType);
+        double quantity = 0.0;
+        if (symbol.empty() || side.size() != 1 || ordType.size() != 1) {
+            error = "Missing Symbol, Side or OrdType";
+            return false;
+        }
+        if (!message.getDouble(fixtag::OrderQty, quantity) || quantity <= 0.0) {
+            error = "Missing or bad OrderQty";
+            return false;
+        }
+
+        Order& order = command.order;
+        command.type = CommandType::NEW_ORDER;
+        order.asset = Asset(std::string(symbol));
+        order.quantity = Quantity(quantity);
+        order.clientOrderId = out.clOrdId;
+        order.accountId = std::string(message.get(fixtag::Account));
+
+        switch (side[0]) {
+            case '1': order.side = OrderSide::BUY; break;
+            case '2':
+            case '5': order.side = OrderSide::SELL; break;  // Sell short books as a sell
+            default: error = "Unsupported Side"; return false;
+        }
+        bool needsPrice = false;
+        bool needsStop = false;
+        switch (ordType[0]) {
+            case '1': order.type = OrderType::MARKET; break;
+            case '2': order.type = OrderType::LIMIT; needsPrice = true; break;
+            case '3': order.type = OrderType::STOP; needsStop = true; break;
+            case '4': order.type = OrderType::STOP_LIMIT; needsPrice = needsStop = true; break;
+            default: error = "Unsupported OrdType"; return false;
+        }
+        double price = 0.0;
+        if (needsPrice) {
+            if (!message.getDouble(fixtag::Price, price) || price <= 0.0) {
+                error = "Missing or bad Price";
+                return false;
+            }
+            order.limitPrice = Price(price);
+        }
+        if (needsStop) {
+            if (!message.getDouble(fixtag::StopPx, price) || price <= 0.0) {
+                error = "Missing or bad StopPx";
+                return false;
+            }
+            order.stopPrice = Price(price);
+        }
+        std::string_view tif = message.get(fixtag::TimeInForce);
+        switch (tif.empty() ? '0' : tif[0]) {
+            case '0': order.timeInForce = TimeInForce::DAY; break;
+            case '1': order.timeInForce = TimeInForce::GTC; break;
+            case '3': order.timeInForce = TimeInForce::IOC; break;
+            case '4': order.timeInForce = TimeInForce::FOK; break;
+            default: error = "Unsupported TimeInForce"; return false;
+        }
+        return true;
+    }
+
+    if (type == "F" || type == "G") {
+        out.origClOrdId = std::string(message.get(fixtag::OrigClOrdID));
+        if (out.origClOrdId.empty()) {
+            error = "Missing OrigClOrdID";
+            return false;
+        }
+        command.orderId = std::string(message.get(fixtag::OrderID));
+        if (type == "F") {
+            command.type = CommandType::CANCEL;
+            return true;
+        }
+        command.type = CommandType::AMEND;
+        double value = 0.0;
+        if (message.getDouble(fixtag::OrderQty, value)) {
+            command.newQuantity = value;
+        }
+        if (message.getDouble(fixtag::Price, value)) {
+            command.newLimitPrice = Price(value);
+        }
+        if (!command.newQuantity && !command.newLimitPrice) {
+            error = "Cancel/replace changes neither OrderQty nor Price";
+            return false;
+        }
+        return true;
+    }
+
+    error = "Unsupported MsgType";
+    return false;
+}
+
+} // namespace trading
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "engine/command_queue.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace trading {
+
+constexpr char FIX_SOH = '\x01';
+
+// Tags the gateway reads or writes
+namespace fixtag {
+constexpr int Account = 1;
+constexpr int AvgPx = 6;
+constexpr int BeginSeqNo = 7;
+constexpr int BeginString = 8;
+constexpr int BodyLength = 9;
+constexpr int CheckSum = 10;
+constexpr int ClOrdID = 11;
+constexpr int CumQty = 14;
+constexpr int EndSeqNo = 16;
+constexpr int ExecID = 17;
+constexpr int LastPx = 31;
+constexpr int LastQty = 32;
+constexpr int MsgSeqNum = 34;
+constexpr int MsgType = 35;
+constexpr int NewSeqNo = 36;
+constexpr int OrderID = 37;
+constexpr int OrderQty = 38;
+constexpr int OrdStatus = 39;
+constexpr int OrdType = 40;
+constexpr int OrigClOrdID = 41;
+constexpr int PossDupFlag = 43;
+constexpr int Price = 44;
+constexpr int RefSeqNum = 45;
+constexpr int SenderCompID = 49;
+constexpr int SendingTime = 52;
+constexpr int Side = 54;
+constexpr int Symbol = 55;
+constexpr int TargetCompID = 56;
+constexpr int Text = 58;
+constexpr int TimeInForce = 59;
+constexpr int StopPx = 99;
+constexpr int EncryptMethod = 98;
+constexpr int CxlRejReason = 102;
+constexpr int HeartBtInt = 108;
+constexpr int TestReqID = 112;
+constexpr int OrigSendingTime = 122;
+constexpr int GapFillFlag = 123;
+constexpr int ResetSeqNumFlag = 141;
+constexpr int ExecType = 150;
+constexpr int LeavesQty = 151;
+constexpr int RefMsgType = 372;
+constexpr int BusinessRejectReason = 380;
+constexpr int CxlRejResponseTo = 434;
+} // namespace fixtag
+
+struct FixField {
+    int tag = 0;
+    std::string_view value;
+};
+
+// One framed message. Field values are views into the caller's buffer and
+// are valid only while it is.
+class FixMessage {
+public:
+    static constexpr size_t MAX_FIELDS = 128;
+
+private:
+    std::array<FixField, MAX_FIELDS> fields_;
+    size_t count_ = 0;
+    std::string_view raw_;
+    std::string_view msgType_;
+
+    friend class FixParser;
+
+public:
+    std::string_view raw() const { return raw_; }
+    std::string_view msgType() const { return msgType_; }
+    size_t fieldCount() const { return count_; }
+    const FixField& field(size_t index) const { return fields_[index]; }
+
+    // First occurrence; empty when absent
+    std::string_view get(int tag) const;
+    bool has(int tag) const;
+    bool getInt(int tag, int64_t& value) const;
+    bool getDouble(int tag, double& value) const;
+    bool isAdmin() const;
+};
+
+enum class FixParseStatus {
+    OK,
+    INCOMPLETE,   // Need more bytes
+    INVALID,      // Garbled; skip `consumed` bytes and resynchronise
+    VIOLATION     // Over MAX_MESSAGE_LENGTH or an over-long tag; drop the connection
+};
+
+// Frames and tokenises tag=value messages in place. Delimiter search and the
+// checksum run 16 bytes at a time with SSE2 where available.
+class FixParser {
+public:
+    static constexpr size_t MAX_MESSAGE_LENGTH = 64 * 1024;
+    static constexpr size_t MAX_TAG_DIGITS = 9;
+
+    // Parse the message at the front of data. On OK, consumed is its length;
+    // on INVALID, the bytes to drop before the next "8=" candidate.
+    static FixParseStatus parse(const char* data, size_t length, FixMessage& message, size_t& consumed);
+
+    // Sum of bytes mod 256, as carried in tag 10
+    static uint8_t checksum(const char* data, size_t length);
+};
+
+// Builder for a run of tag=value fields
+class FixFields {
+private:
+    std::string data_;
+
+public:
+    FixFields& add(int tag, std::string_view value);
+    FixFields& add(int tag, int64_t value);
+    FixFields& add(int tag, double value);
+    FixFields& add(int tag, char value) { return add(tag, std::string_view(&value, 1)); }
+    FixFields& add(int tag, const char* value) { return add(tag, std::string_view(value)); }
+    FixFields& add(int tag, const std::string& value) { return add(tag, std::string_view(value)); }
+    FixFields& add(int tag, int value) { return add(tag, static_cast<int64_t>(value)); }
+    FixFields& add(int tag, uint64_t value) { return add(tag, static_cast<int64_t>(value)); }
+
+    const std::string& str() const { return data_; }
+    bool empty() const { return data_.empty(); }
+    void clear() { data_.clear(); }
+};
+
+// Wrap header and body fields with BeginString, BodyLength and CheckSum
+std::string fixFrame(std::string_view beginString, std::string_view msgType, const std::string& fields);
+
+// An order-entry message decoded for the engine. The client's ids stay with
+// it: the gateway maps them to engine order ids and echoes them back.
+struct FixOrderCommand {
+    EngineCommand command;
+    std::string clOrdId;
+    std::string origClOrdId;   // Cancel and cancel/replace
+};
+
+// NewOrderSingle (D), OrderCancelRequest (F) and OrderCancelReplaceRequest
+// (G). Returns false with a reason for other types or missing/bad fields.
+bool decodeOrderCommand(const FixMessage& message, FixOrderCommand& out, std::string& error);
+
+} // namespace trading
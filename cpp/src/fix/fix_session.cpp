@@ -0,0 +1,412 @@
+#include "fix_session.h"
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <atomic>
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+
+namespace trading {
+
+namespace {
+
+constexpr const char* INCOMING_MARK = "<";
+
+bool isAdminType(std::string_view msgType) {
+    return msgType == "0" || msgType == "1" || msgType == "2" || msgType == "3" || msgType == "4" ||
+           msgType == "5" || msgType == "A";
+}
+
+} // namespace
+
+// Record: "seqNum msgType sendingTime length\n" then `length` bytes of fields and "\n".
+// An inbound high-water mark is the same record with msgType "<" and no fields.
+FixJournal::FixJournal(std::string path) : path_(std::move(path)) {
+    if (path_.empty()) {
+        return;
+    }
+    std::ifstream in(path_, std::ios::binary);
+    std::string header;
+    while (std::getline(in, header)) {
+        std::istringstream parts(header);
+        FixJournalEntry entry;
+        size_t length = 0;
+        if (!(parts >> entry.seqNum >> entry.msgType >> entry.sendingTime >> length)) {
+            break;
+        }
+        entry.fields.resize(length);
+        if (!in.read(entry.fields.data(), static_cast<std::streamsize>(length)) || in.get() != '\n') {
+            break;  // Torn final record from a crash mid-append
+        }
+        if (entry.msgType == INCOMING_MARK) {
+            lastIncoming_ = entry.seqNum;
+            continue;
+        }
+        entries_[entry.seqNum] = std::move(entry);
+    }
+    file_.open(path_, std::ios::binary | std::ios::app);
+}
+
+void FixJournal::append(FixJournalEntry entry) {
+    if (file_.is_open()) {
+        file_ << entry.seqNum << ' ' << entry.msgType << ' ' << entry.sendingTime << ' ' << entry.fields.size()
+              << '\n'
+              << entry.fields << '\n';
+        file_.flush();
+    }
+    uint64_t seqNum = entry.seqNum;
+    entries_[seqNum] = std::move(entry);
+}
+
+void FixJournal::recordIncoming(uint64_t seqNum) {
+    if (seqNum <= lastIncoming_) {
+        return;
+    }
+    lastIncoming_ = seqNum;
+    if (file_.is_open()) {
+        file_ << seqNum << ' ' << INCOMING_MARK << " - 0\n\n";
+        file_.flush();
+    }
+}
+
+std::vector<const FixJournalEntry*> FixJournal::range(uint64_t begin, uint64_t end) const {
+    std::vector<const FixJournalEntry*> result;
+    for (auto it = entries_.lower_bound(begin); it != entries_.end() && it->first <= end; ++it) {
+        result.push_back(&it->second);
+    }
+    return result;
+}
+
+void FixJournal::reset() {
+    entries_.clear();
+    lastIncoming_ = 0;
+    if (!path_.empty()) {
+        file_.close();
+        file_.open(path_, std::ios::binary | std::ios::trunc);
+    }
+}
+
+FixSession::FixSession(FixSessionConfig config)
+    : config_(std::move(config)), journal_(config_.journalPath) {
+    static std::atomic<int> instance_count{0};
+    logger_ = spdlog::stdout_color_mt("fix_session_" + std::to_string(instance_count++));
+    logger_->set_level(spdlog::level::info);
+    nextOutgoing_ = journal_.lastSeqNum() + 1;
+    nextIncoming_ = journal_.lastIncoming() + 1;
+}
+
+void FixSession::attach(SendFunction send, Clock::time_point now) {
+    send_ = std::move(send);
+    disconnectRequested_ = false;
+    resendTarget_ = 0;
+    pendingTestRequest_.clear();
+    lastSent_ = lastReceived_ = now;
+    if (config_.initiator) {
+        state_ = FixSessionState::LOGON_SENT;
+        FixFields fields;
+        fields.add(fixtag::EncryptMethod, 0).add(fixtag::HeartBtInt, config_.heartbeatInterval);
+        sendMessage("A", fields);
+    } else {
+        state_ = FixSessionState::AWAITING_LOGON;
+    }
+}
+
+void FixSession::detach() {
+    send_ = nullptr;
+    state_ = FixSessionState::DISCONNECTED;
+}
+
+std::string FixSession::sendingTime() const {
+    auto now = std::chrono::system_clock::now();
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+    char buffer[7 * 11 + 5];  // Seven ints at their widest, four separators and the NUL
+    std::snprintf(buffer, sizeof(buffer), "%04d%02d%02d-%02d:%02d:%02d.%03d", utc.tm_year + 1900, utc.tm_mon + 1,
+                  utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec, static_cast<int>(millis));
+    return buffer;
+}
+
+uint64_t FixSession::sendMessage(std::string_view msgType, const FixFields& fields, bool transmit) {
+    uint64_t seqNum = nextOutgoing_++;
+    std::string time = sendingTime();
+    if (transmit && send_) {
+        FixFields header;
+        header.add(fixtag::SenderCompID, config_.senderCompId)
+            .add(fixtag::TargetCompID, config_.targetCompId)
+            .add(fixtag::MsgSeqNum, seqNum)
+            .add(fixtag::SendingTime, time);
+        send_(fixFrame(config_.beginString, msgType, header.str() + fields.str()));
+        lastSent_ = Clock::now();
+    }
+    journal_.append(FixJournalEntry{seqNum, std::string(msgType), std::move(time), fields.str()});
+    return seqNum;
+}
+
+void FixSession::sendResend(uint64_t seqNum, const FixJournalEntry& entry) {
+    FixFields header;
+    header.add(fixtag::SenderCompID, config_.senderCompId)
+        .add(fixtag::TargetCompID, config_.targetCompId)
+        .add(fixtag::MsgSeqNum, seqNum)
+        .add(fixtag::PossDupFlag, 'Y')
+        .add(fixtag::SendingTime, sendingTime())
+        .add(fixtag::OrigSendingTime, entry.sendingTime);
+    send_(fixFrame(config_.beginString, entry.msgType, header.str() + entry.fields));
+    lastSent_ = Clock::now();
+}
+
+void FixSession::sendGapFill(uint64_t seqNum, uint64_t newSeqNo) {
+    std::string time = sendingTime();
+    FixFields fields;
+    fields.add(fixtag::SenderCompID, config_.senderCompId)
+        .add(fixtag::TargetCompID, config_.targetCompId)
+        .add(fixtag::MsgSeqNum, seqNum)
+        .add(fixtag::PossDupFlag, 'Y')
+        .add(fixtag::SendingTime, time)
+        .add(fixtag::OrigSendingTime, time)
+        .add(fixtag::GapFillFlag, 'Y')
+        .add(fixtag::NewSeqNo, newSeqNo);
+    send_(fixFrame(config_.beginString, "4", fields.str()));
+    lastSent_ = Clock::now();
+}
+
+void FixSession::onMessage(const FixMessage& message, Clock::time_point now) {
+    lastReceived_ = now;
+    pendingTestRequest_.clear();
+
+    int64_t seqNum = 0;
+    if (!message.getInt(fixtag::MsgSeqNum, seqNum)) {
+        requestDisconnect("Message without MsgSeqNum");
+        return;
+    }
+    std::string_view type = message.msgType();
+    if (state_ == FixSessionState::AWAITING_LOGON && type != "A") {
+        requestDisconnect("First message is not a Logon");
+        return;
+    }
+    if (type == "4" && message.get(fixtag::GapFillFlag) != "Y") {
+        handleSequenceReset(message);  // Reset mode ignores MsgSeqNum
+        return;
+    }
+    if (type == "A") {
+        handleLogon(message);
+        if (disconnectRequested_) {
+            return;
+        }
+    }
+
+    uint64_t seq = static_cast<uint64_t>(seqNum);
+    if (seq > nextIncoming_) {
+        // Gap: serve what the peer asks for, then ask for what we missed
+        if (type == "5") {
+            handleLogout(message);
+            return;
+        }
+        if (type == "2") {
+            handleResendRequest(message);
+        }
+        if (resendTarget_ == 0) {
+            logger_->warn("{} sequence gap: expected {}, got {}", config_.targetCompId, nextIncoming_, seq);
+            FixFields fields;
+            fields.add(fixtag::BeginSeqNo, nextIncoming_).add(fixtag::EndSeqNo, 0);
+            sendMessage("2", fields);
+            resendTarget_ = seq;
+        }
+        return;
+    }
+    if (seq < nextIncoming_) {
+        if (message.get(fixtag::PossDupFlag) == "Y") {
+            return;  // Already processed
+        }
+        std::string text = "MsgSeqNum too low, expecting " + std::to_string(nextIncoming_) + " but received " +
+                           std::to_string(seq);
+        logout(text);
+        requestDisconnect(text);
+        return;
+    }
+
+    nextIncoming_ = seq + 1;
+    journal_.recordIncoming(seq);
+    if (resendTarget_ != 0 && nextIncoming_ > resendTarget_) {
+        resendTarget_ = 0;
+    }
+    switch (type.size() == 1 ? type[0] : '\0') {
+        case 'A':
+        case '0':
+            break;
+        case '1': {
+            FixFields fields;
+            fields.add(fixtag::TestReqID, message.get(fixtag::TestReqID));
+            sendMessage("0", fields);
+            break;
+        }
+        case '2':
+            handleResendRequest(message);
+            break;
+        case '3':
+            logger_->warn("{} rejected our message {}: {}", config_.targetCompId, message.get(fixtag::RefSeqNum),
+                          message.get(fixtag::Text));
+            break;
+        case '4':
+            handleSequenceReset(message);
+            break;
+        case '5':
+            handleLogout(message);
+            break;
+        default:
+            if (state_ == FixSessionState::ACTIVE && application_) {
+                application_(message);
+            }
+            break;
+    }
+}
+
+void FixSession::handleLogon(const FixMessage& message) {
+    if (state_ != FixSessionState::AWAITING_LOGON && state_ != FixSessionState::LOGON_SENT) {
+        logger_->warn("{} sent a Logon on an active session; ignored", config_.targetCompId);
+        return;
+    }
+    if (message.get(fixtag::TargetCompID) != config_.senderCompId ||
+        (!config_.targetCompId.empty() && message.get(fixtag::SenderCompID) != config_.targetCompId)) {
+        requestDisconnect("Logon with unexpected CompIDs");
+        return;
+    }
+
+    bool reset = message.get(fixtag::ResetSeqNumFlag) == "Y";
+    if (reset) {
+        journal_.reset();
+        nextOutgoing_ = 1;
+        nextIncoming_ = 1;
+    }
+    if (state_ == FixSessionState::AWAITING_LOGON) {
+        int64_t heartbeat = 0;
+        if (message.getInt(fixtag::HeartBtInt, heartbeat) && heartbeat > 0) {
+            config_.heartbeatInterval = static_cast<int>(heartbeat);
+        }
+        state_ = FixSessionState::ACTIVE;
+        FixFields fields;
+        fields.add(fixtag::EncryptMethod, 0).add(fixtag::HeartBtInt, config_.heartbeatInterval);
+        if (reset) {
+            fields.add(fixtag::ResetSeqNumFlag, 'Y');
+        }
+        sendMessage("A", fields);
+    } else {
+        state_ = FixSessionState::ACTIVE;
+    }
+    logger_->info("{} logged on (next out {}, next in {})", config_.targetCompId, nextOutgoing_, nextIncoming_);
+}
+
+void FixSession::handleResendRequest(const FixMessage& message) {
+    int64_t begin = 0;
+    int64_t end = 0;
+    if (!message.getInt(fixtag::BeginSeqNo, begin) || !message.getInt(fixtag::EndSeqNo, end) || begin < 1) {
+        logger_->warn("{} sent a malformed ResendRequest", config_.targetCompId);
+        return;
+    }
+    uint64_t last = nextOutgoing_ - 1;
+    uint64_t stop = end == 0 ? last : std::min<uint64_t>(static_cast<uint64_t>(end), last);
+    if (static_cast<uint64_t>(begin) > stop) {
+        return;
+    }
+
+    // Application messages go again as PossDup; admin messages and anything
+    // missing from the journal collapse into gap fills
+    uint64_t gapStart = 0;
+    uint64_t next = static_cast<uint64_t>(begin);
+    for (const FixJournalEntry* entry : journal_.range(next, stop)) {
+        if (entry->seqNum > next && gapStart == 0) {
+            gapStart = next;
+        }
+        if (isAdminType(entry->msgType)) {
+            gapStart = gapStart == 0 ? entry->seqNum : gapStart;
+        } else {
+            if (gapStart != 0) {
+                sendGapFill(gapStart, entry->seqNum);
+                gapStart = 0;
+            }
+            sendResend(entry->seqNum, *entry);
+        }
+        next = entry->seqNum + 1;
+    }
+    if (gapStart == 0 && next <= stop) {
+        gapStart = next;
+    }
+    if (gapStart != 0) {
+        sendGapFill(gapStart, stop + 1);
+    }
+}
+
+void FixSession::handleSequenceReset(const FixMessage& message) {
+    int64_t newSeqNo = 0;
+    if (!message.getInt(fixtag::NewSeqNo, newSeqNo)) {
+        return;
+    }
+    if (static_cast<uint64_t>(newSeqNo) < nextIncoming_) {
+        logger_->warn("{} SequenceReset to {} below expected {}; ignored", config_.targetCompId, newSeqNo,
+                      nextIncoming_);
+        return;
+    }
+    nextIncoming_ = static_cast<uint64_t>(newSeqNo);
+    journal_.recordIncoming(nextIncoming_ - 1);
+    if (resendTarget_ != 0 && nextIncoming_ > resendTarget_) {
+        resendTarget_ = 0;
+    }
+}
+
+void FixSession::handleLogout(const FixMessage& message) {
+    if (state_ != FixSessionState::LOGOUT_SENT) {
+        sendMessage("5", FixFields());
+    }
+    requestDisconnect("Logout: " + std::string(message.get(fixtag::Text)));
+}
+
+void FixSession::requestDisconnect(const std::string& reason) {
+    logger_->info("Disconnecting {}: {}", config_.targetCompId.empty() ? "session" : config_.targetCompId, reason);
+    disconnectRequested_ = true;
+}
+
+void FixSession::onTimer(Clock::time_point now) {
+    if (state_ == FixSessionState::DISCONNECTED || disconnectRequested_) {
+        return;
+    }
+    auto interval = std::chrono::seconds(config_.heartbeatInterval);
+    auto silence = now - lastReceived_;
+    if (state_ == FixSessionState::AWAITING_LOGON || state_ == FixSessionState::LOGON_SENT) {
+        if (silence >= interval) {
+            requestDisconnect("Logon timed out");
+        }
+        return;
+    }
+
+    if (now - lastSent_ >= interval) {
+        sendMessage("0", FixFields());
+    }
+    // Allow 20% for transmission before probing, and one more interval for the answer
+    auto grace = interval + interval / 5;
+    if (pendingTestRequest_.empty() && silence >= grace) {
+        pendingTestRequest_ = "TEST-" + std::to_string(++testRequestCounter_);
+        FixFields fields;
+        fields.add(fixtag::TestReqID, pendingTestRequest_);
+        sendMessage("1", fields);
+    } else if (!pendingTestRequest_.empty() && silence >= grace + interval) {
+        requestDisconnect("No answer to TestRequest " + pendingTestRequest_);
+    }
+}
+
+uint64_t FixSession::send(std::string_view msgType, const FixFields& fields) {
+    return sendMessage(msgType, fields, state_ == FixSessionState::ACTIVE);
+}
+
+void FixSession::logout(const std::string& text) {
+    if (state_ != FixSessionState::ACTIVE) {
+        return;
+    }
+    FixFields fields;
+    if (!text.empty()) {
+        fields.add(fixtag::Text, text);
+    }
+    sendMessage("5", fields);
+    state_ = FixSessionState::LOGOUT_SENT;
+}
+
+} // namespace trading
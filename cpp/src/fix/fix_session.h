@@ -0,0 +1,133 @@
+#pragma once
+
+#include "fix_message.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+namespace trading {
+
+// One sent message, kept so a ResendRequest can be answered
+struct FixJournalEntry {
+    uint64_t seqNum = 0;
+    std::string msgType;
+    std::string sendingTime;
+    std::string fields;        // Everything after the standard header
+};
+
+// Journal of a FIX session: every message sent, plus the last inbound
+// MsgSeqNum processed. With a path, records are appended to a file as they
+// happen and reloaded on construction, so both sequence numbers and resends
+// survive a gateway restart, and a counterparty's PossDup replay of
+// messages already processed is recognised as such.
+class FixJournal {
+private:
+    std::map<uint64_t, FixJournalEntry> entries_;
+    uint64_t lastIncoming_ = 0;
+    std::string path_;
+    std::ofstream file_;
+
+public:
+    explicit FixJournal(std::string path = "");
+
+    void append(FixJournalEntry entry);
+    // Entries with begin <= seqNum <= end, in order
+    std::vector<const FixJournalEntry*> range(uint64_t begin, uint64_t end) const;
+    uint64_t lastSeqNum() const { return entries_.empty() ? 0 : entries_.rbegin()->first; }
+    // Inbound messages up to seqNum have been processed
+    void recordIncoming(uint64_t seqNum);
+    uint64_t lastIncoming() const { return lastIncoming_; }
+    // Drop everything, as on a sequence reset
+    void reset();
+};
+
+struct FixSessionConfig {
+    std::string beginString = "FIX.4.4";
+    std::string senderCompId;
+    std::string targetCompId;
+    int heartbeatInterval = 30;          // Seconds; an acceptor adopts the client's HeartBtInt
+    bool initiator = false;
+    std::string journalPath;             // Empty keeps the journal in memory
+};
+
+enum class FixSessionState {
+    DISCONNECTED,
+    AWAITING_LOGON,    // Acceptor connected, no Logon yet
+    LOGON_SENT,        // Initiator waiting for the Logon reply
+    ACTIVE,
+    LOGOUT_SENT
+};
+
+// Session layer of FIX 4.4: logon, heartbeats and test requests, sequence
+// number checks with ResendRequest on a gap, and resends replayed from the
+// journal (admin messages collapse into SequenceReset-GapFill). It owns no
+// socket: the transport hands it framed messages and timer ticks, and it
+// writes through the send function given to attach(). Not thread-safe.
+class FixSession {
+public:
+    using Clock = std::chrono::steady_clock;
+    using SendFunction = std::function<void(const std::string&)>;
+    using ApplicationHandler = std::function<void(const FixMessage&)>;
+
+private:
+    FixSessionConfig config_;
+    FixJournal journal_;
+    SendFunction send_;
+    ApplicationHandler application_;
+    std::shared_ptr<spdlog::logger> logger_;
+
+    FixSessionState state_ = FixSessionState::DISCONNECTED;
+    uint64_t nextOutgoing_ = 1;
+    uint64_t nextIncoming_ = 1;
+    uint64_t resendTarget_ = 0;           // Gap being filled by a ResendRequest; 0 when none
+    bool disconnectRequested_ = false;
+
+    Clock::time_point lastSent_;
+    Clock::time_point lastReceived_;
+    std::string pendingTestRequest_;
+    uint64_t testRequestCounter_ = 0;
+
+    uint64_t sendMessage(std::string_view msgType, const FixFields& fields, bool transmit = true);
+    void sendResend(uint64_t seqNum, const FixJournalEntry& entry);
+    void sendGapFill(uint64_t seqNum, uint64_t newSeqNo);
+    void handleLogon(const FixMessage& message);
+    void handleResendRequest(const FixMessage& message);
+    void handleSequenceReset(const FixMessage& message);
+    void handleLogout(const FixMessage& message);
+    void requestDisconnect(const std::string& reason);
+    std::string sendingTime() const;
+
+public:
+    explicit FixSession(FixSessionConfig config);
+
+    void setApplicationHandler(ApplicationHandler handler) { application_ = std::move(handler); }
+
+    // A transport connected; an initiator sends its Logon now
+    void attach(SendFunction send, Clock::time_point now = Clock::now());
+    void detach();
+
+    void onMessage(const FixMessage& message, Clock::time_point now = Clock::now());
+    // Heartbeats, test requests and the missed-heartbeat disconnect
+    void onTimer(Clock::time_point now);
+
+    // Application message; returns its MsgSeqNum. While not logged on it is
+    // only journaled, and reaches the client through the resend at next logon.
+    uint64_t send(std::string_view msgType, const FixFields& fields);
+    void logout(const std::string& text = "");
+
+    // Set when the transport should close the connection
+    bool shouldDisconnect() const { return disconnectRequested_; }
+
+    FixSessionState getState() const { return state_; }
+    uint64_t getNextOutgoingSeqNum() const { return nextOutgoing_; }
+    uint64_t getNextIncomingSeqNum() const { return nextIncoming_; }
+    const FixSessionConfig& getConfig() const { return config_; }
+};
+
+} // namespace trading
@@ -0,0 +1,59 @@
+#include "frontier/guardrails.hpp"
+#include "risk/risk_manager.h"
+#include <algorithm>
+#include <cmath>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace frontier {
+
+void evaluate_guardrail_flags(const double* position, const double* quantity, const double* price,
+                              const double* stop, size_t count, double max_position_value,
+                              double loss_headroom, uint8_t* max_pos_ok, uint8_t* daily_loss_ok) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128d sign = _mm_set1_pd(-0.0);
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d limit = _mm_set1_pd(max_position_value);
+    const __m128d headroom = _mm_set1_pd(loss_headroom);
+    for (; i + 2 <= count; i += 2) {
+        __m128d q = _mm_loadu_pd(quantity + i);
+        __m128d p = _mm_loadu_pd(price + i);
+        __m128d s = _mm_loadu_pd(stop + i);
+        __m128d projected = _mm_mul_pd(_mm_andnot_pd(sign, _mm_add_pd(_mm_loadu_pd(position + i), q)), p);
+        __m128d loss = _mm_mul_pd(_mm_andnot_pd(sign, q), _mm_andnot_pd(sign, _mm_sub_pd(p, s)));
+        loss = _mm_and_pd(loss, _mm_cmpgt_pd(s, zero));
+        int pos_bits = _mm_movemask_pd(_mm_cmple_pd(projected, limit));
+        int loss_bits = _mm_movemask_pd(_mm_cmple_pd(loss, headroom));
+        max_pos_ok[i] = pos_bits & 1;
+        max_pos_ok[i + 1] = (pos_bits >> 1) & 1;
+        daily_loss_ok[i] = loss_bits & 1;
+        daily_loss_ok[i + 1] = (loss_bits >> 1) & 1;
+    }
+#endif
+    for (; i < count; ++i) {
+        double projected = std::fabs(position[i] + quantity[i]) * price[i];
+        double loss = stop[i] > 0.0 ? std::fabs(quantity[i]) * std::fabs(price[i] - stop[i]) : 0.0;
+        max_pos_ok[i] = projected <= max_position_value;
+        daily_loss_ok[i] = loss <= loss_headroom;
+    }
+}
+
+void size_guardrail_candidate(const GuardrailCandidate& candidate, double equity, const GuardrailLimits& limits,
+                              GuardrailResult& result) {
+    if (result.price <= 0.0 || equity <= 0.0) {
+        return;
+    }
+    double cap = limits.max_position_fraction * equity / result.price;
+    result.kelly_fraction =
+        trading::RiskCalculator::calculateKellyCriterion(candidate.win_rate, candidate.avg_win, candidate.avg_loss);
+    result.kelly_quantity = std::min(result.kelly_fraction * equity / result.price, cap);
+    if (candidate.stop_price > 0.0) {
+        double per_unit_loss = std::fabs(result.price - candidate.stop_price);
+        result.optimal_quantity = std::min(
+            trading::RiskCalculator::calculateOptimalPositionSize(equity, limits.risk_per_trade, per_unit_loss), cap);
+    }
+}
+
+} // namespace frontier
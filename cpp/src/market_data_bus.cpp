@@ -0,0 +1,304 @@
+#include "frontier/market_data_bus.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace frontier {
+
+namespace bus {
+
+size_t region_size(uint32_t slot_capacity, uint32_t ring_capacity) {
+    return sizeof(BusHeader) + sizeof(BusQuoteSlot) * slot_capacity +
+           sizeof(BusTickRecord) * ring_capacity;
+}
+
+} // namespace bus
+
+namespace {
+
+constexpr int kMaxReadAttempts = 64;
+
+std::string shm_path(const std::string& name) {
+    return name.empty() || name[0] == '/' ? name : "/" + name;
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+MarketDataBusWriter::MarketDataBusWriter(const std::string& name, uint32_t slot_capacity,
+                                         uint32_t ring_capacity)
+    : name_(shm_path(name)) {
+    if (slot_capacity == 0 || ring_capacity == 0 || (ring_capacity & (ring_capacity - 1)) != 0) {
+        throw std::invalid_argument("market data bus: ring capacity must be a power of two");
+    }
+
+    size_ = bus::region_size(slot_capacity, ring_capacity);
+
+    // Remove a region left behind by a crashed engine so readers never see a stale layout
+    shm_unlink(name_.c_str());
+    int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        throw_errno("shm_open " + name_);
+    }
+    if (ftruncate(fd, static_cast<off_t>(size_)) != 0) {
+        int saved = errno;
+        close(fd);
+        shm_unlink(name_.c_str());
+        errno = saved;
+        throw_errno("ftruncate " + name_);
+    }
+    base_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base_ == MAP_FAILED) {
+        shm_unlink(name_.c_str());
+        throw_errno("mmap " + name_);
+    }
+
+    // ftruncate zero-fills, so every sequence starts at 0 (never written)
+    auto* bytes = static_cast<char*>(base_);
+    header_ = reinterpret_cast<bus::BusHeader*>(bytes);
+    slots_ = reinterpret_cast<bus::BusQuoteSlot*>(bytes + sizeof(bus::BusHeader));
+    ring_ = reinterpret_cast<bus::BusTickRecord*>(bytes + sizeof(bus::BusHeader) +
+                                                  sizeof(bus::BusQuoteSlot) * slot_capacity);
+
+    header_->version = bus::kVersion;
+    header_->slot_capacity = slot_capacity;
+    header_->ring_capacity = ring_capacity;
+    header_->slot_count.store(0, std::memory_order_relaxed);
+    header_->ring_head.store(0, std::memory_order_relaxed);
+    // Magic goes last: readers refuse to attach until the header is complete
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = bus::kMagic;
+}
+
+MarketDataBusWriter::~MarketDataBusWriter() {
+    if (base_ && base_ != MAP_FAILED) {
+        munmap(base_, size_);
+        shm_unlink(name_.c_str());
+    }
+}
+
+int32_t MarketDataBusWriter::slot_for(const std::string& symbol) {
+    auto it = slot_index_.find(symbol);
+    if (it != slot_index_.end()) {
+        return static_cast<int32_t>(it->second);
+    }
+
+    uint32_t count = header_->slot_count.load(std::memory_order_relaxed);
+    if (symbol.size() >= FRONTIER_BUS_SYMBOL_LENGTH || count >= header_->slot_capacity) {
+        return -1;
+    }
+
+    auto& slot = slots_[count];
+    std::memset(slot.symbol, 0, sizeof(slot.symbol));
+    std::memcpy(slot.symbol, symbol.data(), symbol.size());
+    header_->slot_count.store(count + 1, std::memory_order_release);
+
+    slot_index_.emplace(symbol, count);
+    return static_cast<int32_t>(count);
+}
+
+bool MarketDataBusWriter::publish(const MarketData& data, int64_t timestamp_ns) {
+    int32_t index = slot_for(data.symbol);
+    if (index < 0) {
+        return false;
+    }
+
+    auto& slot = slots_[index];
+    uint64_t seq = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.bid = data.bid;
+    slot.ask = data.ask;
+    slot.last = data.last;
+    slot.volume = data.volume;
+    slot.timestamp_ns = timestamp_ns;
+    slot.sequence.store(seq + 2, std::memory_order_release);
+
+    uint64_t position = header_->ring_head.load(std::memory_order_relaxed);
+    auto& record = ring_[position & (header_->ring_capacity - 1)];
+    record.sequence.store(2 * position + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.slot = static_cast<uint32_t>(index);
+    record.bid = data.bid;
+    record.ask = data.ask;
+    record.last = data.last;
+    record.volume = data.volume;
+    record.timestamp_ns = timestamp_ns;
+    record.sequence.store(2 * position + 2, std::memory_order_release);
+    header_->ring_head.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+MarketDataBusReader::MarketDataBusReader(const std::string& name) {
+    std::string path = shm_path(name);
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw_errno("shm_open " + path);
+    }
+
+    struct stat st {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(bus::BusHeader)) {
+        close(fd);
+        throw std::runtime_error("market data bus " + path + " is not initialised");
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    base_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base_ == MAP_FAILED) {
+        throw_errno("mmap " + path);
+    }
+
+    const auto* bytes = static_cast<const char*>(base_);
+    header_ = reinterpret_cast<const bus::BusHeader*>(bytes);
+    if (header_->magic != bus::kMagic || header_->version != bus::kVersion ||
+        bus::region_size(header_->slot_capacity, header_->ring_capacity) != size_) {
+        munmap(base_, size_);
+        base_ = nullptr;
+        throw std::runtime_error("market data bus " + path + " has an incompatible layout");
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    slots_ = reinterpret_cast<const bus::BusQuoteSlot*>(bytes + sizeof(bus::BusHeader));
+    ring_ = reinterpret_cast<const bus::BusTickRecord*>(
+        bytes + sizeof(bus::BusHeader) + sizeof(bus::BusQuoteSlot) * header_->slot_capacity);
+
+    // New readers only see ticks published after they attach
+    cursor_ = header_->ring_head.load(std::memory_order_acquire);
+}
+
+MarketDataBusReader::~MarketDataBusReader() {
+    if (base_ && base_ != MAP_FAILED) {
+        munmap(base_, size_);
+    }
+}
+
+int32_t MarketDataBusReader::find_symbol(std::string_view symbol) const {
+    uint32_t count = slot_count();
+    for (uint32_t i = 0; i < count; ++i) {
+        if (std::string_view(slots_[i].symbol) == symbol) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
+
+bool MarketDataBusReader::read_quote(uint32_t slot_index, frontier_bus_quote& out) const {
+    if (slot_index >= slot_count()) {
+        return false;
+    }
+
+    const auto& slot = slots_[slot_index];
+    for (int attempt = 0; attempt < kMaxReadAttempts; ++attempt) {
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        out.bid = slot.bid;
+        out.ask = slot.ask;
+        out.last = slot.last;
+        out.volume = slot.volume;
+        out.timestamp_ns = slot.timestamp_ns;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            if (before == 0) {
+                return false;  // Registered but no quote yet
+            }
+            std::memcpy(out.symbol, slot.symbol, sizeof(out.symbol));
+            out.slot = slot_index;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t MarketDataBusReader::poll_ticks(frontier_bus_quote* out, size_t max_ticks, uint64_t* dropped) {
+    const uint64_t capacity = header_->ring_capacity;
+    const uint64_t head = header_->ring_head.load(std::memory_order_acquire);
+    uint64_t lost = 0;
+
+    if (head - cursor_ > capacity) {
+        lost += head - capacity - cursor_;
+        cursor_ = head - capacity;
+    }
+
+    size_t copied = 0;
+    while (copied < max_ticks && cursor_ < head) {
+        const auto& record = ring_[cursor_ & (capacity - 1)];
+        const uint64_t expected = 2 * cursor_ + 2;
+
+        uint64_t before = record.sequence.load(std::memory_order_acquire);
+        auto& tick = out[copied];
+        tick.slot = record.slot;
+        tick.bid = record.bid;
+        tick.ask = record.ask;
+        tick.last = record.last;
+        tick.volume = record.volume;
+        tick.timestamp_ns = record.timestamp_ns;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = record.sequence.load(std::memory_order_relaxed);
+
+        ++cursor_;
+        if (before != expected || after != expected) {
+            ++lost;  // Overwritten by the writer's next lap while we were reading
+            continue;
+        }
+        std::memcpy(tick.symbol, slots_[tick.slot].symbol, sizeof(tick.symbol));
+        ++copied;
+    }
+
+    if (dropped) {
+        *dropped += lost;
+    }
+    return copied;
+}
+
+} // namespace frontier
+
+// ---- C ABI ----
+
+struct frontier_bus {
+    frontier::MarketDataBusReader reader;
+    explicit frontier_bus(const char* name) : reader(name) {}
+};
+
+extern "C" {
+
+frontier_bus* frontier_bus_open(const char* name) {
+    if (!name) {
+        return nullptr;
+    }
+    try {
+        return new frontier_bus(name);
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void frontier_bus_close(frontier_bus* bus) {
+    delete bus;
+}
+
+int32_t frontier_bus_find_symbol(const frontier_bus* bus, const char* symbol) {
+    return bus && symbol ? bus->reader.find_symbol(symbol) : -1;
+}
+
+int frontier_bus_read_quote(const frontier_bus* bus, uint32_t slot, frontier_bus_quote* out) {
+    return bus && out && bus->reader.read_quote(slot, *out) ? 1 : 0;
+}
+
+size_t frontier_bus_poll_ticks(frontier_bus* bus, frontier_bus_quote* out, size_t max_ticks,
+                               uint64_t* dropped) {
+    return bus && out ? bus->reader.poll_ticks(out, max_ticks, dropped) : 0;
+}
+
+} // extern "C"
@@ -0,0 +1,284 @@
+#include "frontier/market_data_fanout.hpp"
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+namespace frontier {
+
+namespace {
+
+uint64_t make_id(uint32_t generation, uint32_t slot) {
+    return (static_cast<uint64_t>(generation) << 32) | slot;
+}
+
+std::string json_string(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+    return out;
+}
+
+// JSON has no NaN or infinity, so those go out as null
+void append_number(std::string& out, double value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.10g", value);
+    out.append(buffer, static_cast<size_t>(length));
+}
+
+} // namespace
+
+MarketDataFanout::MarketDataFanout(bool websocket_frames) : websocket_frames_(websocket_frames) {}
+
+uint64_t MarketDataFanout::open_session() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t slot;
+    if (!free_sessions_.empty()) {
+        slot = free_sessions_.back();
+        free_sessions_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(sessions_.size());
+        sessions_.emplace_back();
+    }
+    Session& session = sessions_[slot];
+    session.open = true;
+    ++open_sessions_;
+    return make_id(session.generation, slot);
+}
+
+MarketDataFanout::Session* MarketDataFanout::find_session(uint64_t session_id) {
+    uint32_t slot = static_cast<uint32_t>(session_id);
+    if (slot >= sessions_.size()) {
+        return nullptr;
+    }
+    Session& session = sessions_[slot];
+    return session.open && session.generation == static_cast<uint32_t>(session_id >> 32) ? &session : nullptr;
+}
+
+void MarketDataFanout::close_session(uint64_t session_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Session* session = find_session(session_id);
+    if (!session) {
+        return;
+    }
+    uint32_t slot = static_cast<uint32_t>(session_id);
+    while (!session->subscriptions.empty()) {
+        remove_subscription(slot, static_cast<uint32_t>(session->subscriptions.size() - 1));
+    }
+    session->open = false;
+    ++session->generation;   // Stale ids stop matching once the slot is reused
+    session->outbound.clear();
+    session->outbound.shrink_to_fit();
+    free_sessions_.push_back(slot);
+    --open_sessions_;
+}
+
+size_t MarketDataFanout::subscribe(uint64_t session_id, const std::vector<std::string>& symbols) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Session* session = find_session(session_id);
+    if (!session) {
+        return 0;
+    }
+    uint32_t slot = static_cast<uint32_t>(session_id);
+    size_t added = 0;
+    for (const auto& symbol : symbols) {
+        auto [it, inserted] = symbol_index_.emplace(symbol, static_cast<uint32_t>(symbols_.size()));
+        if (inserted) {
+            symbols_.push_back(SymbolEntry{symbol, json_string(symbol), {}, {}});
+        }
+        uint32_t id = it->second;
+        // Watchlists are tens of symbols, so a scan beats a per-session set
+        bool already = std::any_of(session->subscriptions.begin(), session->subscriptions.end(),
+                                   [id](const Subscription& s) { return s.symbol == id; });
+        if (already) {
+            continue;
+        }
+        auto& subscribers = symbols_[id].subscribers;
+        subscribers.push_back({slot, static_cast<uint32_t>(session->subscriptions.size())});
+        session->subscriptions.push_back({id, static_cast<uint32_t>(subscribers.size() - 1), false});
+        ++added;
+    }
+    return added;
+}
+
+size_t MarketDataFanout::unsubscribe(uint64_t session_id, const std::vector<std::string>& symbols) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Session* session = find_session(session_id);
+    if (!session) {
+        return 0;
+    }
+    uint32_t slot = static_cast<uint32_t>(session_id);
+    size_t removed = 0;
+    for (const auto& symbol : symbols) {
+        auto it = symbol_index_.find(symbol);
+        if (it == symbol_index_.end()) {
+            continue;
+        }
+        for (uint32_t i = 0; i < session->subscriptions.size(); ++i) {
+            if (session->subscriptions[i].symbol == it->second) {
+                remove_subscription(slot, i);
+                ++removed;
+                break;
+            }
+        }
+    }
+    return removed;
+}
+
+void MarketDataFanout::remove_subscription(uint32_t session_slot, uint32_t index) {
+    Session& session = sessions_[session_slot];
+    Subscription removed = session.subscriptions[index];
+
+    // Swap-remove from the symbol's list, repointing the entry moved into the hole
+    auto& subscribers = symbols_[removed.symbol].subscribers;
+    Subscriber moved = subscribers.back();
+    subscribers[removed.position] = moved;
+    sessions_[moved.session].subscriptions[moved.slot].position = removed.position;
+    subscribers.pop_back();
+
+    // Same for the session's list; dirty indices follow the move
+    if (removed.dirty) {
+        session.dirty.erase(std::find(session.dirty.begin(), session.dirty.end(), index));
+    }
+    uint32_t last = static_cast<uint32_t>(session.subscriptions.size() - 1);
+    if (index != last) {
+        Subscription tail = session.subscriptions[last];
+        session.subscriptions[index] = tail;
+        symbols_[tail.symbol].subscribers[tail.position].slot = index;
+        if (tail.dirty) {
+            *std::find(session.dirty.begin(), session.dirty.end(), last) = index;
+        }
+    }
+    session.subscriptions.pop_back();
+}
+
+void MarketDataFanout::serialize(SymbolEntry& entry, const MarketData& data, int64_t timestamp_ns) {
+    // One snprintf on the stack covers ordinary quotes. Non-finite values,
+    // or a symbol long enough to overflow the buffer, are built field by field.
+    char payload[256];
+    int length = -1;
+    if (std::isfinite(data.bid) && std::isfinite(data.ask) && std::isfinite(data.last) && std::isfinite(data.volume)) {
+        length = std::snprintf(payload, sizeof(payload),
+                               "{\"type\":\"quote\",\"symbol\":%s,\"bid\":%.10g,\"ask\":%.10g,\"last\":%.10g,"
+                               "\"volume\":%.10g,\"ts\":%" PRId64 "}",
+                               entry.quoted.c_str(), data.bid, data.ask, data.last, data.volume, timestamp_ns);
+    }
+    const char* body = payload;
+    size_t size = static_cast<size_t>(length);
+    if (length < 0 || size >= sizeof(payload)) {
+        scratch_.assign("{\"type\":\"quote\",\"symbol\":").append(entry.quoted);
+        scratch_ += ",\"bid\":";
+        append_number(scratch_, data.bid);
+        scratch_ += ",\"ask\":";
+        append_number(scratch_, data.ask);
+        scratch_ += ",\"last\":";
+        append_number(scratch_, data.last);
+        scratch_ += ",\"volume\":";
+        append_number(scratch_, data.volume);
+        scratch_.append(",\"ts\":").append(std::to_string(timestamp_ns)).push_back('}');
+        body = scratch_.data();
+        size = scratch_.size();
+    }
+
+    entry.frame.clear();
+    if (websocket_frames_) {
+        // Server frames are unmasked
+        entry.frame.push_back(static_cast<char>(0x81));
+        if (size < 126) {
+            entry.frame.push_back(static_cast<char>(size));
+        } else if (size <= 0xffff) {
+            entry.frame.push_back(static_cast<char>(126));
+            entry.frame.push_back(static_cast<char>(size >> 8));
+            entry.frame.push_back(static_cast<char>(size & 0xff));
+        } else {
+            entry.frame.push_back(static_cast<char>(127));
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                entry.frame.push_back(static_cast<char>((static_cast<uint64_t>(size) >> shift) & 0xff));
+            }
+        }
+        entry.frame.append(body, size);
+    } else {
+        entry.frame.append(body, size);
+        entry.frame.push_back('\n');
+    }
+    ++frames_serialized_;
+}
+
+void MarketDataFanout::publish(const MarketData& data, int64_t timestamp_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = symbol_index_.find(data.symbol);
+    if (it == symbol_index_.end() || symbols_[it->second].subscribers.empty()) {
+        return;
+    }
+    SymbolEntry& entry = symbols_[it->second];
+    serialize(entry, data, timestamp_ns);
+    for (const Subscriber& subscriber : entry.subscribers) {
+        Session& session = sessions_[subscriber.session];
+        Subscription& subscription = session.subscriptions[subscriber.slot];
+        if (subscription.dirty) {
+            continue;   // Coalesced: the flush sends whatever frame is latest
+        }
+        subscription.dirty = true;
+        session.dirty.push_back(subscriber.slot);
+        if (!session.queued) {
+            session.queued = true;
+            pending_.push_back(subscriber.session);
+        }
+    }
+}
+
+size_t MarketDataFanout::flush(const Sink& sink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t written = 0;
+    for (uint32_t slot : pending_) {
+        Session& session = sessions_[slot];
+        session.queued = false;
+        if (!session.open || session.dirty.empty()) {
+            continue;
+        }
+        session.outbound.clear();
+        for (uint32_t index : session.dirty) {
+            Subscription& subscription = session.subscriptions[index];
+            subscription.dirty = false;
+            session.outbound += symbols_[subscription.symbol].frame;
+        }
+        session.dirty.clear();
+        sink(make_id(session.generation, slot), session.outbound);
+        ++written;
+    }
+    pending_.clear();
+    return written;
+}
+
+size_t MarketDataFanout::session_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_sessions_;
+}
+
+size_t MarketDataFanout::subscriber_count(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = symbol_index_.find(symbol);
+    return it != symbol_index_.end() ? symbols_[it->second].subscribers.size() : 0;
+}
+
+uint64_t MarketDataFanout::frames_serialized() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return frames_serialized_;
+}
+
+} // namespace frontier
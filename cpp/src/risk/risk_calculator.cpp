@@ -0,0 +1,167 @@
+#include "risk_manager.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace trading {
+
+namespace {
+
+double mean(const std::vector<double>& values) {
+    return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+// Inverse standard normal CDF (Acklam's rational approximation, |error| < 1.2e-9)
+double normalQuantile(double p) {
+    static const double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                               1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                               6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                               -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                               3.754408661907416e+00};
+    constexpr double kLow = 0.02425;
+    if (p <= 0.0 || p >= 1.0) {
+        return p <= 0.0 ? -INFINITY : INFINITY;
+    }
+    if (p < kLow || p > 1.0 - kLow) {
+        double q = std::sqrt(-2.0 * std::log(p < kLow ? p : 1.0 - p));
+        double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                   ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1.0);
+        return p < kLow ? x : -x;
+    }
+    double q = p - 0.5;
+    double r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1.0);
+}
+
+} // namespace
+
+// VaR is reported as a positive loss fraction
+
+double RiskCalculator::calculateHistoricalVaR(const std::vector<double>& returns, double confidence) {
+    if (returns.empty()) {
+        return 0.0;
+    }
+    std::vector<double> sorted(returns);
+    size_t index = std::min(static_cast<size_t>((1.0 - confidence) * sorted.size()), sorted.size() - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return std::max(0.0, -sorted[index]);
+}
+
+double RiskCalculator::calculateParametricVaR(double mean, double stdDev, double confidence) {
+    return std::max(0.0, -(mean + normalQuantile(1.0 - confidence) * stdDev));
+}
+
+double RiskCalculator::calculateMonteCarloVaR(const std::vector<double>& returns, int simulations) {
+    if (returns.empty() || simulations <= 0) {
+        return 0.0;
+    }
+    // Bootstrap from the observed returns; fixed seed so reports are reproducible
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, returns.size() - 1);
+    std::vector<double> simulated(static_cast<size_t>(simulations));
+    for (double& value : simulated) {
+        value = returns[pick(rng)];
+    }
+    return calculateHistoricalVaR(simulated, 0.95);
+}
+
+double RiskCalculator::calculateVolatility(const std::vector<double>& returns) {
+    if (returns.size() < 2) {
+        return 0.0;
+    }
+    double m = mean(returns);
+    double sum = 0.0;
+    for (double r : returns) {
+        sum += (r - m) * (r - m);
+    }
+    return std::sqrt(sum / (returns.size() - 1));
+}
+
+double RiskCalculator::calculateExponentialVolatility(const std::vector<double>& returns, double lambda) {
+    if (returns.empty()) {
+        return 0.0;
+    }
+    double variance = returns.front() * returns.front();
+    for (size_t i = 1; i < returns.size(); ++i) {
+        variance = lambda * variance + (1.0 - lambda) * returns[i] * returns[i];
+    }
+    return std::sqrt(variance);
+}
+
+double RiskCalculator::calculateCorrelation(const std::vector<double>& x, const std::vector<double>& y) {
+    size_t n = std::min(x.size(), y.size());
+    if (n < 2) {
+        return 0.0;
+    }
+    double mx = std::accumulate(x.begin(), x.begin() + n, 0.0) / n;
+    double my = std::accumulate(y.begin(), y.begin() + n, 0.0) / n;
+    double sxy = 0.0, sxx = 0.0, syy = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        sxy += (x[i] - mx) * (y[i] - my);
+        sxx += (x[i] - mx) * (x[i] - mx);
+        syy += (y[i] - my) * (y[i] - my);
+    }
+    return sxx > 0.0 && syy > 0.0 ? sxy / std::sqrt(sxx * syy) : 0.0;
+}
+
+double RiskCalculator::calculateBeta(const std::vector<double>& assetReturns, const std::vector<double>& marketReturns) {
+    size_t n = std::min(assetReturns.size(), marketReturns.size());
+    if (n < 2) {
+        return 0.0;
+    }
+    double ma = std::accumulate(assetReturns.begin(), assetReturns.begin() + n, 0.0) / n;
+    double mm = std::accumulate(marketReturns.begin(), marketReturns.begin() + n, 0.0) / n;
+    double covariance = 0.0, variance = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        covariance += (assetReturns[i] - ma) * (marketReturns[i] - mm);
+        variance += (marketReturns[i] - mm) * (marketReturns[i] - mm);
+    }
+    return variance > 0.0 ? covariance / variance : 0.0;
+}
+
+// Drawdowns are fractions of the running peak
+
+double RiskCalculator::calculateMaxDrawdown(const std::vector<double>& values) {
+    double peak = 0.0;
+    double worst = 0.0;
+    for (double value : values) {
+        peak = std::max(peak, value);
+        if (peak > 0.0) {
+            worst = std::max(worst, (peak - value) / peak);
+        }
+    }
+    return worst;
+}
+
+double RiskCalculator::calculateCurrentDrawdown(const std::vector<double>& values) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    double peak = *std::max_element(values.begin(), values.end());
+    return peak > 0.0 ? (peak - values.back()) / peak : 0.0;
+}
+
+// Fraction of capital to commit: p - (1 - p) / (avgWin / avgLoss), clamped
+// to [0, 1]. A negative edge means don't trade, so it returns 0.
+double RiskCalculator::calculateKellyCriterion(double winRate, double avgWin, double avgLoss) {
+    if (winRate <= 0.0 || avgWin <= 0.0 || avgLoss <= 0.0) {
+        return 0.0;
+    }
+    double payoff = avgWin / avgLoss;
+    return std::clamp(winRate - (1.0 - winRate) / payoff, 0.0, 1.0);
+}
+
+// Units such that hitting the stop (a per-unit loss) costs riskPerTrade of the account
+double RiskCalculator::calculateOptimalPositionSize(double accountSize, double riskPerTrade, double stopLoss) {
+    if (accountSize <= 0.0 || riskPerTrade <= 0.0 || stopLoss <= 0.0) {
+        return 0.0;
+    }
+    return accountSize * riskPerTrade / stopLoss;
+}
+
+} // namespace trading
@@ -1,12 +1,29 @@
 #include "frontier/rpc.hpp"
+#include "engine/clock.h"
+#include "engine/order_manager.h"
 #include <spdlog/spdlog.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <atomic>
+#include <cmath>
 #include <sstream>
 
 namespace frontier {
 
+namespace {
+
+std::string required_symbol(const nlohmann::json& params) {
+    if (!params.contains("symbol") || !params["symbol"].is_string() || params["symbol"].get<std::string>().empty()) {
+        throw RpcError(RpcErrorCode::InvalidParams, "Invalid symbol");
+    }
+    return params["symbol"].get<std::string>();
+}
+
+} // namespace
+
 RpcServer::RpcServer(std::shared_ptr<TradingEngine> engine) 
     : engine_(engine) {
-    logger_ = spdlog::stdout_color_mt("rpc_server");
+    static std::atomic<int> instance_count{0};
+    logger_ = spdlog::stdout_color_mt("rpc_server_" + std::to_string(instance_count++));
     logger_->set_level(spdlog::level::info);
     logger_->info("RPC Server initialized");
 }
@@ -54,6 +71,24 @@ std::string RpcServer::handle_request(const std::string& request) {
             result = simulate_order(params);
         } else if (method == "check_risk_limits") {
             result = check_risk_limits(params);
+        } else if (method == "screen") {
+            result = screen(params);
+        } else if (method == "set_features") {
+            result = set_features(params);
+        } else if (method == "get_market_status") {
+            result = get_market_status(params);
+        } else if (method == "evaluate_guardrails") {
+            result = evaluate_guardrails(params);
+        } else if (method == "halt_symbol") {
+            result = halt_symbol(params);
+        } else if (method == "resume_symbol") {
+            result = resume_symbol(params);
+        } else if (method == "set_price_band") {
+            result = set_price_band(params);
+        } else if (method == "get_symbol_state") {
+            result = get_symbol_state(params);
+        } else if (method == "get_book_signals") {
+            result = get_book_signals(params);
         } else {
             return serialize_response(create_error_response(
                 static_cast<int>(RpcErrorCode::MethodNotFound),
@@ -70,6 +105,9 @@ std::string RpcServer::handle_request(const std::string& request) {
             static_cast<int>(RpcErrorCode::ParseError),
             "Parse error: " + std::string(e.what())
         ));
+    } catch (const RpcError& e) {
+        logger_->warn("RPC error: {}", e.what());
+        return serialize_response(create_error_response(static_cast<int>(e.code()), e.what()));
     } catch (const std::exception& e) {
         logger_->error("RPC error: {}", e.what());
         return serialize_response(create_error_response(
@@ -95,24 +133,19 @@ nlohmann::json RpcServer::place_market_order(const nlohmann::json& params) {
     
     Side side = (side_str == "buy") ? Side::Buy : Side::Sell;
     
-    std::string error;
-    bool success = engine_->place_market(symbol, side, quantity, price, &error);
-    
-    if (!success) {
-        // Map engine errors to appropriate HTTP status codes
-        if (error.find("insufficient") != std::string::npos || 
-            error.find("buying power") != std::string::npos) {
-            throw std::runtime_error("INSUFFICIENT_BUYING_POWER: " + error);
-        } else if (error.find("risk") != std::string::npos || 
-                   error.find("limit") != std::string::npos) {
-            throw std::runtime_error("RISK_LIMIT: " + error);
-        } else if (error.find("market closed") != std::string::npos) {
-            throw std::runtime_error("MARKET_CLOSED: " + error);
-        } else if (error.find("invalid symbol") != std::string::npos) {
-            throw std::runtime_error("INVALID_SYMBOL: " + error);
-        } else {
-            throw std::runtime_error("ORDER_REJECTED: " + error);
-        }
+    if (!engine_->is_market_open(symbol, engine_->clock().now())) {
+        throw RpcError(RpcErrorCode::MarketClosed, "MARKET_CLOSED: market for " + symbol + " is closed");
+    }
+    SymbolGate gate = engine_->check_symbol_state(symbol, side, price);
+    if (gate != SymbolGate::Ok) {
+        throw RpcError(RpcErrorCode::OrderRejected,
+                       "SYMBOL_STATE: order for " + symbol + " rejected (" + to_string(gate) + ")");
+    }
+    if (!engine_->check_risk_limits(symbol, side, quantity, price)) {
+        throw std::runtime_error("RISK_LIMIT: order for " + symbol + " exceeds risk limits");
+    }
+    if (!engine_->place_market_order(symbol, side, quantity, price)) {
+        throw std::runtime_error("ORDER_REJECTED: order for " + symbol + " was rejected");
     }
     
     // Return fixed-point strings for precision
@@ -163,18 +196,22 @@ nlohmann::json RpcServer::mark_to_market(const nlohmann::json& params) {
 }
 
 nlohmann::json RpcServer::get_positions(const nlohmann::json& params) {
-    const auto& positions = engine_->get_positions();
+    const auto& positions = engine_->get_account().positions;
     nlohmann::json result = nlohmann::json::array();
     
     for (const auto& [symbol, position] : positions) {
         result.push_back(nlohmann::json{
             {"symbol", symbol},
-            {"quantity", position.quantity},
+            {"quantity", position.quantity.to_double()},
             {"average_price", position.average_price},
             {"market_price", position.market_price},
-            {"realized_pnl", position.realized_pnl},
-            {"unrealized_pnl", position.unrealized_pnl},
-            {"market_value", position.market_value()}
+            {"realized_pnl", position.realized_pnl.to_double()},
+            {"unrealized_pnl", position.unrealized_pnl.to_double()},
+            {"market_value", position.market_value()},
+            // Exact fixed-point values, for clients that must not round
+            {"quantity_decimal", position.quantity.to_string()},
+            {"realized_pnl_decimal", position.realized_pnl.to_string()},
+            {"unrealized_pnl_decimal", position.unrealized_pnl.to_string()}
         });
     }
     
@@ -187,7 +224,7 @@ nlohmann::json RpcServer::get_account(const nlohmann::json& params) {
     return nlohmann::json{
         {"cash", account.cash},
         {"equity", account.equity},
-        {"buying_power", account.buying_power},
+        {"buying_power", account.cash},
         {"positions_count", account.positions.size()}
     };
 }
@@ -199,37 +236,28 @@ nlohmann::json RpcServer::simulate_order(const nlohmann::json& params) {
     
     std::string symbol = params["symbol"];
     std::string side_str = params["side"];
-    double quantity = params["quantity"];
-    double price = params["price"];
+    double quantity = std::stod(params["qty"].get<std::string>());
+    double price = std::stod(params.value("price", "0"));
     
     Side side = (side_str == "buy") ? Side::Buy : Side::Sell;
     
-    // Create a temporary engine for simulation
-    auto sim_engine = std::make_shared<TradingEngine>(engine_->get_account().cash);
-    
-    // Copy current positions
-    for (const auto& [sym, pos] : engine_->get_positions()) {
-        // TODO: Implement position copying
-    }
-    
-    std::string error;
-    bool success = sim_engine->place_market(symbol, side, quantity, price, &error);
-    
-    if (!success) {
+    // Paper fills book at the given price, so the cash impact is the notional
+    if (!engine_->check_risk_limits(symbol, side, quantity, price)) {
         return nlohmann::json{
             {"success", false},
-            {"error", error}
+            {"error", "Order exceeds risk limits"}
         };
     }
     
-    const auto& sim_account = sim_engine->get_account();
+    const auto& account = engine_->get_account();
+    double cash_impact = side == Side::Buy ? -quantity * price : quantity * price;
     
     return nlohmann::json{
         {"success", true},
         {"estimated_cost", quantity * price},
-        {"new_cash", sim_account.cash},
-        {"new_equity", sim_account.equity},
-        {"cash_impact", sim_account.cash - engine_->get_account().cash}
+        {"new_cash", account.cash + cash_impact},
+        {"new_equity", account.equity},
+        {"cash_impact", cash_impact}
     };
 }
 
@@ -250,9 +278,13 @@ nlohmann::json RpcServer::check_risk_limits(const nlohmann::json& params) {
     
     // Check position limits
     if (!symbol.empty()) {
-        const auto& positions = engine_->get_positions();
-        auto it = positions.find(symbol);
-        if (it != positions.end() && it->second.quantity > 1000) {
+        const SymbolState* state = engine_->symbol_states().find_state(symbol);
+        if (state && SymbolStateTable::check(*state, Side::Buy, 0.0, engine_->clock().nowNs()) == SymbolGate::Halted) {
+            within_limits = false;
+            violations.push_back("Symbol halted");
+        }
+        const Position* position = engine_->get_position(symbol);
+        if (position && std::abs(position->quantity.to_double()) > 1000) {
             within_limits = false;
             violations.push_back("Position size exceeds limit");
         }
@@ -266,6 +298,231 @@ nlohmann::json RpcServer::check_risk_limits(const nlohmann::json& params) {
     };
 }
 
+nlohmann::json RpcServer::screen(const nlohmann::json& params) {
+    static const std::map<std::string, ScreenOp> ops = {
+        {">", ScreenOp::GT}, {">=", ScreenOp::GE}, {"<", ScreenOp::LT}, {"<=", ScreenOp::LE},
+        {"between", ScreenOp::BETWEEN}
+    };
+    
+    ScreenQuery query;
+    for (const auto& clause : params.value("where", nlohmann::json::array())) {
+        ScreenPredicate predicate;
+        predicate.column = clause.at("column").get<std::string>();
+        auto op = ops.find(clause.value("op", ">"));
+        if (op == ops.end()) {
+            throw std::runtime_error("Invalid screen operator " + clause.value("op", ""));
+        }
+        predicate.op = op->second;
+        predicate.value = clause.at("value").get<double>();
+        predicate.upper = clause.value("upper", 0.0);
+        predicate.relative_to = clause.value("relative_to", "");
+        query.where.push_back(std::move(predicate));
+    }
+    query.order_by = params.value("order_by", "");
+    query.descending = params.value("order", "desc") != "asc";
+    query.limit = params.value("limit", 50);
+    query.select = params.value("select", std::vector<std::string>{});
+    
+    ScreenResult found;
+    try {
+        found = engine_->screen(query);
+    } catch (const std::invalid_argument& e) {
+        throw std::runtime_error(std::string("Invalid screen query: ") + e.what());
+    }
+    
+    std::vector<std::string> columns;
+    if (!query.order_by.empty()) {
+        columns.push_back(query.order_by);
+    }
+    columns.insert(columns.end(), query.select.begin(), query.select.end());
+    
+    nlohmann::json rows = nlohmann::json::array();
+    for (const auto& row : found.rows) {
+        nlohmann::json entry = {{"symbol", row.symbol}};
+        for (size_t i = 0; i < columns.size(); ++i) {
+            entry[columns[i]] = std::isnan(row.values[i]) ? nlohmann::json() : nlohmann::json(row.values[i]);
+        }
+        rows.push_back(std::move(entry));
+    }
+    return nlohmann::json{
+        {"matched", found.matched},
+        {"scanned", found.scanned},
+        {"rows", rows}
+    };
+}
+
+nlohmann::json RpcServer::set_features(const nlohmann::json& params) {
+    // {"features": {"AAPL": {"vol_z": 2.4, "high_20d": 191.2}, ...}}
+    if (!params.contains("features") || !params["features"].is_object()) {
+        throw std::runtime_error("Invalid features");
+    }
+    size_t updated = 0;
+    for (const auto& [symbol, values] : params["features"].items()) {
+        for (const auto& [name, value] : values.items()) {
+            engine_->set_feature(symbol, name, value.get<double>());
+            ++updated;
+        }
+    }
+    return nlohmann::json{
+        {"success", true},
+        {"features_updated", updated}
+    };
+}
+
+nlohmann::json RpcServer::get_market_status(const nlohmann::json& params) {
+    // {"symbols": ["AAPL", "BTC/USD"]}
+    if (!params.contains("symbols") || !params["symbols"].is_array()) {
+        throw std::runtime_error("Invalid symbols");
+    }
+    auto now = engine_->clock().now();
+    nlohmann::json markets = nlohmann::json::object();
+    for (const auto& symbol : params["symbols"]) {
+        std::string name = symbol.get<std::string>();
+        markets[name] = {
+            {"session", to_string(engine_->market_session(name, now))},
+            {"open", engine_->is_market_open(name, now)}
+        };
+    }
+    return nlohmann::json{{"markets", markets}};
+}
+
+nlohmann::json RpcServer::evaluate_guardrails(const nlohmann::json& params) {
+    // {"candidates": [{"symbol": "AAPL", "qty": "50", "limit": "189.5", "stop": "185"}, ...]}
+    if (!params.contains("candidates") || !params["candidates"].is_array()) {
+        throw RpcError(RpcErrorCode::InvalidParams, "Invalid candidates");
+    }
+    // Amounts arrive as fixed-point strings like the order methods, or as numbers
+    auto number = [](const nlohmann::json& candidate, const char* key) {
+        auto it = candidate.find(key);
+        if (it == candidate.end() || it->is_null()) {
+            return 0.0;
+        }
+        return it->is_string() ? std::stod(it->get<std::string>()) : it->get<double>();
+    };
+    std::vector<GuardrailCandidate> candidates;
+    candidates.reserve(params["candidates"].size());
+    for (const auto& entry : params["candidates"]) {
+        GuardrailCandidate candidate;
+        candidate.symbol = entry.at("symbol").get<std::string>();
+        candidate.quantity = number(entry, "qty");
+        if (entry.value("side", "buy") == "sell") {
+            candidate.quantity = -std::fabs(candidate.quantity);
+        }
+        candidate.limit_price = number(entry, "limit");
+        candidate.stop_price = number(entry, "stop");
+        candidate.win_rate = number(entry, "win_rate");
+        candidate.avg_win = number(entry, "avg_win");
+        candidate.avg_loss = number(entry, "avg_loss");
+        candidates.push_back(std::move(candidate));
+    }
+    
+    std::vector<GuardrailResult> evaluated = engine_->evaluate_guardrails(candidates, engine_->clock().now());
+    nlohmann::json results = nlohmann::json::array();
+    for (size_t i = 0; i < evaluated.size(); ++i) {
+        const GuardrailResult& r = evaluated[i];
+        results.push_back({
+            {"symbol", candidates[i].symbol},
+            {"max_pos_ok", r.max_pos_ok},
+            {"daily_loss_ok", r.daily_loss_ok},
+            {"mkt_hours_ok", r.mkt_hours_ok},
+            {"price", r.price},
+            {"projected_position_value", r.projected_position_value},
+            {"kelly_fraction", r.kelly_fraction},
+            {"kelly_qty", r.kelly_quantity},
+            {"optimal_qty", r.optimal_quantity}
+        });
+    }
+    return nlohmann::json{
+        {"equity", engine_->get_account().equity},
+        {"daily_pnl", engine_->daily_pnl()},
+        {"results", results}
+    };
+}
+
+nlohmann::json RpcServer::halt_symbol(const nlohmann::json& params) {
+    // {"symbol": "AAPL", "duration_s": 300}; no duration halts until resume_symbol
+    std::string symbol = required_symbol(params);
+    double duration = params.value("duration_s", 0.0);
+    int64_t until = duration > 0 ? engine_->clock().nowNs() + static_cast<int64_t>(duration * 1e9) : 0;
+    engine_->symbol_states().halt(symbol, HaltReason::Admin, until);
+    logger_->warn("Symbol {} halted by admin{}", symbol, until ? " (timed)" : "");
+    return get_symbol_state(params);
+}
+
+nlohmann::json RpcServer::resume_symbol(const nlohmann::json& params) {
+    std::string symbol = required_symbol(params);
+    engine_->symbol_states().resume(symbol);
+    logger_->info("Symbol {} resumed", symbol);
+    return get_symbol_state(params);
+}
+
+nlohmann::json RpcServer::set_price_band(const nlohmann::json& params) {
+    // {"symbol": "AAPL", "band_pct": 0.05, "reference": 190.0, "block": "buy" | "sell" | "none"}
+    std::string symbol = required_symbol(params);
+    auto& states = engine_->symbol_states();
+    if (params.contains("band_pct")) {
+        states.set_price_band(symbol, params["band_pct"].get<double>(), params.value("reference", 0.0),
+                              engine_->clock().nowNs());
+    }
+    if (params.contains("block")) {
+        std::string block = params["block"];
+        uint32_t set = block == "buy" ? SymbolFlags::BuyBlocked : block == "sell" ? SymbolFlags::SellBlocked : 0;
+        states.set_flags(symbol, set, (SymbolFlags::BuyBlocked | SymbolFlags::SellBlocked) & ~set);
+    }
+    return get_symbol_state(params);
+}
+
+nlohmann::json RpcServer::get_symbol_state(const nlohmann::json& params) {
+    std::string symbol = required_symbol(params);
+    const SymbolState* state = engine_->symbol_states().find_state(symbol);
+    if (!state) {
+        return nlohmann::json{{"symbol", symbol}, {"tradable", true}};
+    }
+    bool halted = SymbolStateTable::check(*state, Side::Buy, 0.0, engine_->clock().nowNs()) == SymbolGate::Halted;
+    return nlohmann::json{
+        {"symbol", symbol},
+        {"tradable", !halted},
+        {"halted", halted},
+        {"halt_reason", to_string(state->halt_reason)},
+        {"buy_blocked", (state->flags & SymbolFlags::BuyBlocked) != 0},
+        {"sell_blocked", (state->flags & SymbolFlags::SellBlocked) != 0},
+        {"limit_state", (state->flags & SymbolFlags::LimitState) != 0},
+        {"band_pct", state->band_pct},
+        {"reference_price", state->reference_price},
+        {"lower_band", state->lower_band},
+        {"upper_band", state->upper_band}
+    };
+}
+
+nlohmann::json RpcServer::get_book_signals(const nlohmann::json& params) {
+    if (!orders_) {
+        throw RpcError(RpcErrorCode::InternalError, "No order manager attached");
+    }
+    std::vector<std::string> symbols;
+    if (params.contains("symbols") && params["symbols"].is_array()) {
+        symbols = params["symbols"].get<std::vector<std::string>>();
+    } else {
+        symbols.push_back(required_symbol(params));
+    }
+    nlohmann::json books = nlohmann::json::object();
+    for (const auto& symbol : symbols) {
+        auto signals = orders_->getBookSignals(symbol);
+        if (!signals) {
+            books[symbol] = nullptr;
+            continue;
+        }
+        books[symbol] = {
+            {"microprice", signals->microprice},
+            {"top_imbalance", signals->topImbalance},
+            {"depth_imbalance", signals->depthImbalance},
+            {"depth_levels", signals->depthLevels},
+            {"ofi", signals->orderFlowImbalance},
+            {"top_updates", signals->topUpdates}
+        };
+    }
+    return nlohmann::json{{"books", books}};
+}
+
 nlohmann::json RpcServer::create_error_response(int code, const std::string& message, const std::string& id) {
     nlohmann::json response;
     response["jsonrpc"] = "2.0";
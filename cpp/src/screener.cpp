@@ -0,0 +1,232 @@
+#include "frontier/screener.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace frontier {
+
+namespace {
+
+constexpr size_t kRowBlock = 64;   // Rows per mask word
+constexpr float kUnset = std::numeric_limits<float>::quiet_NaN();
+
+#if defined(__SSE2__)
+template <ScreenOp Op>
+inline __m128 compare(__m128 v, __m128 low, __m128 high) {
+    switch (Op) {
+        case ScreenOp::GT: return _mm_cmpgt_ps(v, low);
+        case ScreenOp::GE: return _mm_cmpge_ps(v, low);
+        case ScreenOp::LT: return _mm_cmplt_ps(v, low);
+        case ScreenOp::LE: return _mm_cmple_ps(v, low);
+        case ScreenOp::BETWEEN: break;
+    }
+    return _mm_and_ps(_mm_cmpge_ps(v, low), _mm_cmple_ps(v, high));
+}
+#else
+template <ScreenOp Op>
+inline bool compare(float v, float low, float high) {
+    switch (Op) {
+        case ScreenOp::GT: return v > low;
+        case ScreenOp::GE: return v >= low;
+        case ScreenOp::LT: return v < low;
+        case ScreenOp::LE: return v <= low;
+        case ScreenOp::BETWEEN: break;
+    }
+    return v >= low && v <= high;
+}
+#endif
+
+// mask[w] &= predicate over rows [64w, 64w + 64). The operator and whether
+// the bound scales another column are template parameters so the inner
+// loop is straight-line compares. NaN compares false, so unset values and
+// padding never match.
+template <ScreenOp Op, bool Relative>
+void scan(const float* lhs, const float* rhs, float value, float upper, uint64_t* mask, size_t words) {
+    for (size_t w = 0; w < words; ++w) {
+        if (mask[w] == 0) {
+            continue;
+        }
+        const float* x = lhs + w * kRowBlock;
+        const float* r = Relative ? rhs + w * kRowBlock : nullptr;
+        uint64_t bits = 0;
+#if defined(__SSE2__)
+        const __m128 low = _mm_set1_ps(value);
+        const __m128 high = _mm_set1_ps(upper);
+        for (size_t j = 0; j < kRowBlock; j += 4) {
+            __m128 v = _mm_loadu_ps(x + j);
+            __m128 hit;
+            if (Relative) {
+                __m128 reference = _mm_loadu_ps(r + j);
+                hit = compare<Op>(v, _mm_mul_ps(reference, low), _mm_mul_ps(reference, high));
+            } else {
+                hit = compare<Op>(v, low, high);
+            }
+            bits |= static_cast<uint64_t>(_mm_movemask_ps(hit)) << j;
+        }
+#else
+        for (size_t j = 0; j < kRowBlock; ++j) {
+            bool hit = Relative ? compare<Op>(x[j], r[j] * value, r[j] * upper) : compare<Op>(x[j], value, upper);
+            bits |= static_cast<uint64_t>(hit) << j;
+        }
+#endif
+        mask[w] &= bits;
+    }
+}
+
+template <ScreenOp Op>
+void scan(const float* lhs, const float* rhs, float value, float upper, uint64_t* mask, size_t words) {
+    if (rhs) {
+        scan<Op, true>(lhs, rhs, value, upper, mask, words);
+    } else {
+        scan<Op, false>(lhs, rhs, value, upper, mask, words);
+    }
+}
+
+void apply_predicate(const float* lhs, const float* rhs, ScreenOp op, float value, float upper,
+                     uint64_t* mask, size_t words) {
+    switch (op) {
+        case ScreenOp::GT: scan<ScreenOp::GT>(lhs, rhs, value, upper, mask, words); break;
+        case ScreenOp::GE: scan<ScreenOp::GE>(lhs, rhs, value, upper, mask, words); break;
+        case ScreenOp::LT: scan<ScreenOp::LT>(lhs, rhs, value, upper, mask, words); break;
+        case ScreenOp::LE: scan<ScreenOp::LE>(lhs, rhs, value, upper, mask, words); break;
+        case ScreenOp::BETWEEN: scan<ScreenOp::BETWEEN>(lhs, rhs, value, upper, mask, words); break;
+    }
+}
+
+} // namespace
+
+int FeatureTable::column(const std::string& name) {
+    auto it = column_index_.find(name);
+    if (it != column_index_.end()) {
+        return it->second;
+    }
+    int id = static_cast<int>(columns_.size());
+    column_names_.push_back(name);
+    column_index_.emplace(name, id);
+    columns_.emplace_back(capacity_, kUnset);
+    return id;
+}
+
+int FeatureTable::find_column(const std::string& name) const {
+    auto it = column_index_.find(name);
+    return it != column_index_.end() ? it->second : -1;
+}
+
+int FeatureTable::require_column(const std::string& name) const {
+    int id = find_column(name);
+    if (id < 0) {
+        throw std::invalid_argument("unknown column " + name);
+    }
+    return id;
+}
+
+uint32_t FeatureTable::row(const std::string& symbol) {
+    auto it = row_index_.find(symbol);
+    if (it != row_index_.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(symbols_.size());
+    if (symbols_.size() == capacity_) {
+        capacity_ += kRowBlock;
+        for (auto& values : columns_) {
+            values.resize(capacity_, kUnset);
+        }
+    }
+    symbols_.push_back(symbol);
+    row_index_.emplace(symbol, id);
+    return id;
+}
+
+int64_t FeatureTable::find_row(const std::string& symbol) const {
+    auto it = row_index_.find(symbol);
+    return it != row_index_.end() ? static_cast<int64_t>(it->second) : -1;
+}
+
+void FeatureTable::set(const std::string& symbol, const std::string& column_name, double value) {
+    uint32_t r = row(symbol);
+    set(r, column(column_name), value);
+}
+
+double FeatureTable::get(const std::string& symbol, const std::string& column_name) const {
+    int64_t r = find_row(symbol);
+    int c = find_column(column_name);
+    return r < 0 || c < 0 ? std::numeric_limits<double>::quiet_NaN() : get(static_cast<uint32_t>(r), c);
+}
+
+ScreenResult FeatureTable::query(const ScreenQuery& query) const {
+    // Resolve every name before scanning so a typo fails the whole query
+    struct Resolved {
+        const float* lhs;
+        const float* rhs;
+        const ScreenPredicate* predicate;
+    };
+    std::vector<Resolved> predicates;
+    predicates.reserve(query.where.size());
+    for (const auto& predicate : query.where) {
+        const float* rhs =
+            predicate.relative_to.empty() ? nullptr : columns_[require_column(predicate.relative_to)].data();
+        predicates.push_back({columns_[require_column(predicate.column)].data(), rhs, &predicate});
+    }
+    int order_column = query.order_by.empty() ? -1 : require_column(query.order_by);
+    std::vector<int> select_columns;
+    for (const auto& name : query.select) {
+        select_columns.push_back(require_column(name));
+    }
+
+    ScreenResult result;
+    result.scanned = symbols_.size();
+    size_t words = capacity_ / kRowBlock;
+    std::vector<uint64_t> mask(words, ~uint64_t{0});
+    if (words > 0 && symbols_.size() % kRowBlock != 0) {
+        mask[words - 1] = (uint64_t{1} << (symbols_.size() % kRowBlock)) - 1;
+    }
+    for (const auto& p : predicates) {
+        apply_predicate(p.lhs, p.rhs, p.predicate->op, static_cast<float>(p.predicate->value),
+                        static_cast<float>(p.predicate->upper), mask.data(), words);
+    }
+
+    std::vector<uint32_t> matches;
+    for (size_t w = 0; w < words; ++w) {
+        for (uint64_t bits = mask[w]; bits != 0; bits &= bits - 1) {
+            matches.push_back(static_cast<uint32_t>(w * kRowBlock + static_cast<size_t>(__builtin_ctzll(bits))));
+        }
+    }
+    result.matched = matches.size();
+
+    size_t keep = std::min(query.limit, matches.size());
+    if (order_column >= 0) {
+        // Unset sort values go last either way
+        const float* key = columns_[order_column].data();
+        bool descending = query.descending;
+        auto before = [key, descending](uint32_t a, uint32_t b) {
+            float x = key[a];
+            float y = key[b];
+            if (std::isnan(x) || std::isnan(y)) {
+                return !std::isnan(x) && std::isnan(y);
+            }
+            return descending ? x > y : x < y;
+        };
+        std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(keep), matches.end(), before);
+    }
+    matches.resize(keep);
+
+    result.rows.reserve(keep);
+    for (uint32_t r : matches) {
+        ScreenRow row;
+        row.symbol = symbols_[r];
+        if (order_column >= 0) {
+            row.values.push_back(columns_[order_column][r]);
+        }
+        for (int c : select_columns) {
+            row.values.push_back(columns_[c][r]);
+        }
+        result.rows.push_back(std::move(row));
+    }
+    return result;
+}
+
+} // namespace frontier
@@ -0,0 +1,178 @@
+#include "frontier/strategy_plugin.hpp"
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace frontier {
+
+namespace {
+
+bool stat_file(const std::string& path, int64_t& mtime_ns, off_t& size) {
+    struct stat info {};
+    if (::stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    mtime_ns = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    size = info.st_size;
+    return true;
+}
+
+// Private copy of the library: dlopen caches by path, so reopening a
+// rebuilt file in place would hand back the old image
+bool copy_library(const std::string& from, std::string& to, std::string& error) {
+    static std::atomic<uint64_t> copy_count{0};
+    const char* tmp = std::getenv("TMPDIR");
+    to = std::string(tmp && *tmp ? tmp : "/tmp") + "/frontier_strategy_" + std::to_string(::getpid()) + "_" +
+         std::to_string(copy_count++) + ".so";
+
+    int in = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0) {
+        error = "open " + from + ": " + std::strerror(errno);
+        return false;
+    }
+    int out = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0700);
+    if (out < 0) {
+        error = "create " + to + ": " + std::strerror(errno);
+        ::close(in);
+        return false;
+    }
+    char buffer[65536];
+    ssize_t n;
+    bool ok = true;
+    while ((n = ::read(in, buffer, sizeof(buffer))) > 0) {
+        if (::write(out, buffer, static_cast<size_t>(n)) != n) {
+            ok = false;
+            break;
+        }
+    }
+    if (n < 0 || !ok) {
+        error = "copy " + from + ": " + std::strerror(errno);
+        ok = false;
+    }
+    ::close(in);
+    ::close(out);
+    if (!ok) {
+        ::unlink(to.c_str());
+    }
+    return ok;
+}
+
+} // namespace
+
+StrategyPlugin::Image::~Image() {
+    if (handle) {
+        dlclose(handle);
+    }
+}
+
+StrategyPlugin::StrategyPlugin(std::string path, std::string config)
+    : path_(std::move(path)), config_(std::move(config)) {
+    std::string error;
+    if (!load(image_, strategy_, error)) {
+        throw std::runtime_error(error);
+    }
+    ++generation_;
+}
+
+StrategyPlugin::~StrategyPlugin() {
+    release();
+}
+
+void StrategyPlugin::release() {
+    if (strategy_ && image_ && image_->destroy) {
+        image_->destroy(strategy_);
+    }
+    strategy_ = nullptr;
+    image_.reset();
+}
+
+bool StrategyPlugin::load(std::unique_ptr<Image>& image, Strategy*& strategy, std::string& error) {
+    int64_t mtime_ns = 0;
+    off_t size = 0;
+    if (!stat_file(path_, mtime_ns, size)) {
+        error = "stat " + path_ + ": " + std::strerror(errno);
+        return false;
+    }
+    // Remember the attempt so a broken build is not retried until it changes again
+    loaded_mtime_ns_ = mtime_ns;
+    loaded_size_ = size;
+    auto loaded = std::make_unique<Image>();
+    if (!copy_library(path_, loaded->copy_path, error)) {
+        return false;
+    }
+    loaded->handle = dlopen(loaded->copy_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    ::unlink(loaded->copy_path.c_str());   // The mapping outlives the name
+    if (!loaded->handle) {
+        error = std::string("dlopen ") + path_ + ": " + dlerror();
+        return false;
+    }
+
+    auto abi_version = reinterpret_cast<StrategyAbiVersionFn>(dlsym(loaded->handle, "frontier_strategy_abi_version"));
+    auto create = reinterpret_cast<CreateStrategyFn>(dlsym(loaded->handle, "frontier_create_strategy"));
+    loaded->destroy = reinterpret_cast<DestroyStrategyFn>(dlsym(loaded->handle, "frontier_destroy_strategy"));
+    if (!abi_version || !create || !loaded->destroy) {
+        error = path_ + " does not export a strategy (FRONTIER_EXPORT_STRATEGY)";
+        return false;
+    }
+    if (abi_version() != kStrategyAbiVersion) {
+        error = path_ + " was built for strategy ABI " + std::to_string(abi_version()) + ", engine has " +
+                std::to_string(kStrategyAbiVersion);
+        return false;
+    }
+    Strategy* created = nullptr;
+    try {
+        created = create(config_.c_str());
+    } catch (const std::exception& e) {
+        error = path_ + " failed to construct: " + e.what();
+        return false;
+    }
+    if (!created) {
+        error = path_ + " returned no strategy";
+        return false;
+    }
+
+    image = std::move(loaded);
+    strategy = created;
+    return true;
+}
+
+bool StrategyPlugin::changed_on_disk() const {
+    int64_t mtime_ns = 0;
+    off_t size = 0;
+    return stat_file(path_, mtime_ns, size) && (mtime_ns != loaded_mtime_ns_ || size != loaded_size_);
+}
+
+bool StrategyPlugin::reload(std::string* error) {
+    std::unique_ptr<Image> image;
+    Strategy* strategy = nullptr;
+    std::string message;
+    if (!load(image, strategy, message)) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    }
+    // A throw either side of the handover drops the new instance, not the running one
+    try {
+        strategy->restore_state(strategy_->save_state());
+    } catch (const std::exception& e) {
+        image->destroy(strategy);
+        if (error) {
+            *error = path_ + " failed to carry state across: " + e.what();
+        }
+        return false;
+    }
+    release();
+    image_ = std::move(image);
+    strategy_ = strategy;
+    ++generation_;
+    return true;
+}
+
+} // namespace frontier
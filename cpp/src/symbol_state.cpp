@@ -0,0 +1,122 @@
+#include "frontier/symbol_state.hpp"
+
+namespace frontier {
+
+const char* to_string(HaltReason reason) {
+    switch (reason) {
+        case HaltReason::None: return "none";
+        case HaltReason::Admin: return "admin";
+        case HaltReason::LimitUpLimitDown: return "luld";
+        case HaltReason::CircuitBreaker: return "circuit_breaker";
+    }
+    return "none";
+}
+
+const char* to_string(SymbolGate gate) {
+    switch (gate) {
+        case SymbolGate::Ok: return "ok";
+        case SymbolGate::Halted: return "halted";
+        case SymbolGate::SideBlocked: return "side_blocked";
+        case SymbolGate::OutsideBand: return "outside_band";
+    }
+    return "ok";
+}
+
+uint32_t SymbolStateTable::id(const std::string& symbol) {
+    auto [it, inserted] = index_.emplace(symbol, static_cast<uint32_t>(states_.size()));
+    if (inserted) {
+        states_.emplace_back();
+        states_.back().band_pct = config_.default_band_pct;
+    }
+    return it->second;
+}
+
+int64_t SymbolStateTable::find(const std::string& symbol) const {
+    auto it = index_.find(symbol);
+    return it != index_.end() ? static_cast<int64_t>(it->second) : -1;
+}
+
+const SymbolState* SymbolStateTable::find_state(const std::string& symbol) const {
+    int64_t i = find(symbol);
+    return i >= 0 ? &states_[static_cast<size_t>(i)] : nullptr;
+}
+
+SymbolGate SymbolStateTable::check(const std::string& symbol, Side side, double price, int64_t now_ns) const {
+    int64_t i = find(symbol);
+    return i >= 0 ? check(states_[static_cast<size_t>(i)], side, price, now_ns) : SymbolGate::Ok;
+}
+
+void SymbolStateTable::halt(uint32_t id, HaltReason reason, int64_t until_ns) {
+    SymbolState& s = states_[id];
+    s.flags |= SymbolFlags::Halted;
+    s.halt_reason = reason;
+    s.halt_until_ns = until_ns;
+}
+
+void SymbolStateTable::resume(const std::string& symbol) {
+    SymbolState& s = states_[id(symbol)];
+    s.flags &= ~(SymbolFlags::Halted | SymbolFlags::LimitState);
+    s.halt_reason = HaltReason::None;
+    s.halt_until_ns = 0;
+    s.reference_price = 0.0;   // Re-established by the next tick
+}
+
+void SymbolStateTable::set_flags(const std::string& symbol, uint32_t set, uint32_t clear) {
+    SymbolState& s = states_[id(symbol)];
+    s.flags = (s.flags & ~clear) | set;
+}
+
+void SymbolStateTable::set_price_band(const std::string& symbol, double band_pct, double reference_price,
+                                      int64_t now_ns) {
+    SymbolState& s = states_[id(symbol)];
+    s.band_pct = band_pct;
+    recenter(s, reference_price > 0.0 ? reference_price : s.reference_price, now_ns);
+}
+
+void SymbolStateTable::recenter(SymbolState& s, double reference_price, int64_t now_ns) {
+    s.reference_price = reference_price;
+    s.lower_band = reference_price * (1.0 - s.band_pct);
+    s.upper_band = reference_price * (1.0 + s.band_pct);
+    s.reference_ns = now_ns;
+    s.flags &= ~SymbolFlags::LimitState;
+}
+
+void SymbolStateTable::on_tick(uint32_t id, double price, int64_t now_ns) {
+    SymbolState& s = states_[id];
+    if (price <= 0.0) {
+        return;
+    }
+    // A timed halt lifts itself; trading reopens around the first price after it
+    if ((s.flags & SymbolFlags::Halted) && s.halt_until_ns != 0 && now_ns >= s.halt_until_ns) {
+        s.flags &= ~SymbolFlags::Halted;
+        s.halt_reason = HaltReason::None;
+        s.halt_until_ns = 0;
+        recenter(s, price, now_ns);
+        return;
+    }
+    if (s.band_pct <= 0.0) {
+        return;
+    }
+    if (s.reference_price <= 0.0) {
+        recenter(s, price, now_ns);
+        return;
+    }
+    if (price < s.lower_band || price > s.upper_band) {
+        if (!(s.flags & SymbolFlags::LimitState)) {
+            s.flags |= SymbolFlags::LimitState;
+            s.limit_state_since_ns = now_ns;
+        } else if (!(s.flags & SymbolFlags::Halted) &&
+                   now_ns - s.limit_state_since_ns >= config_.limit_state_grace_ns) {
+            s.flags |= SymbolFlags::Halted;
+            s.halt_reason = HaltReason::LimitUpLimitDown;
+            s.halt_until_ns = now_ns + config_.pause_duration_ns;
+        }
+        return;
+    }
+    s.flags &= ~SymbolFlags::LimitState;
+    if (now_ns - s.reference_ns >= config_.reference_interval_ns) {
+        recenter(s, price, now_ns);
+    }
+}
+
+} // namespace frontier
@@ -0,0 +1,139 @@
+#include "frontier/timer_wheel.hpp"
+#include <algorithm>
+
+namespace frontier {
+
+TimerWheel::TimerWheel(std::chrono::milliseconds resolution, size_t slot_count, TimePoint start)
+    : resolution_(resolution.count() > 0 ? resolution : std::chrono::milliseconds(1)),
+      origin_(start),
+      slots_(slot_count > 0 ? slot_count : 1, kNil) {}
+
+uint64_t TimerWheel::to_tick(TimePoint when) const {
+    if (when <= origin_) {
+        return 0;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(when - origin_);
+    // Round up so a timer never fires before its deadline
+    return static_cast<uint64_t>((elapsed.count() + resolution_.count() - 1) / resolution_.count());
+}
+
+TimerWheel::TimePoint TimerWheel::to_time(uint64_t tick) const {
+    return origin_ + resolution_ * static_cast<int64_t>(tick);
+}
+
+void TimerWheel::link(uint32_t index) {
+    auto& timer = timers_[index];
+    uint32_t& head = slots_[timer.deadline_tick % slots_.size()];
+    timer.prev = kNil;
+    timer.next = head;
+    if (head != kNil) {
+        timers_[head].prev = index;
+    }
+    head = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    auto& timer = timers_[index];
+    if (timer.prev != kNil) {
+        timers_[timer.prev].next = timer.next;
+    } else {
+        slots_[timer.deadline_tick % slots_.size()] = timer.next;
+    }
+    if (timer.next != kNil) {
+        timers_[timer.next].prev = timer.prev;
+    }
+    timer.prev = timer.next = kNil;
+}
+
+void TimerWheel::release(uint32_t index) {
+    auto& timer = timers_[index];
+    timer.active = false;
+    timer.due = false;
+    ++timer.generation;
+    free_list_.push_back(index);
+    --pending_;
+}
+
+TimerWheel::TimerId TimerWheel::schedule(TimePoint when, uint64_t payload) {
+    uint32_t index;
+    if (!free_list_.empty()) {
+        index = free_list_.back();
+        free_list_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(timers_.size());
+        timers_.emplace_back();
+    }
+
+    auto& timer = timers_[index];
+    // Anything already due fires on the next advance()
+    timer.deadline_tick = std::max(to_tick(when), current_tick_ + 1);
+    timer.payload = payload;
+    timer.active = true;
+    link(index);
+    ++pending_;
+
+    return (static_cast<uint64_t>(timer.generation) << 32) | index;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    auto index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+    auto generation = static_cast<uint32_t>(id >> 32);
+    if (index >= timers_.size() || !timers_[index].active || timers_[index].generation != generation) {
+        return false;
+    }
+    if (!timers_[index].due) {
+        unlink(index);  // Due timers were unlinked by advance()
+    }
+    release(index);
+    return true;
+}
+
+size_t TimerWheel::advance(TimePoint now, const ExpiryHandler& on_expire) {
+    uint64_t target = now <= origin_ ? 0 :
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count() /
+                              resolution_.count());
+    if (target <= current_tick_) {
+        return 0;
+    }
+
+    // A long jump never needs more than one revolution: each slot is visited once
+    // and every timer with a deadline up to `target` fires from it.
+    uint64_t first = current_tick_ + 1;
+    uint64_t steps = std::min<uint64_t>(target - current_tick_, slots_.size());
+    size_t fired = 0;
+    auto& due = due_;
+    due.clear();
+
+    for (uint64_t tick = first; tick < first + steps; ++tick) {
+        uint32_t index = slots_[tick % slots_.size()];
+        while (index != kNil) {
+            uint32_t next = timers_[index].next;
+            if (timers_[index].deadline_tick <= target) {
+                unlink(index);
+                timers_[index].due = true;
+                due.push_back({timers_[index].deadline_tick, index, timers_[index].generation});
+            }
+            index = next;
+        }
+    }
+    current_tick_ = target;
+
+    if (steps == slots_.size()) {
+        std::sort(due.begin(), due.end());
+    }
+    for (const auto& entry : due) {
+        auto& timer = timers_[entry.index];
+        if (timer.generation != entry.generation) {
+            continue;  // Cancelled by an earlier handler, maybe already reused
+        }
+        TimerId id = (static_cast<uint64_t>(timer.generation) << 32) | entry.index;
+        uint64_t payload = timer.payload;
+        release(entry.index);
+        ++fired;
+        // The handler may schedule new timers, which can grow the pool
+        on_expire(id, payload);
+    }
+    return fired;
+}
+
+} // namespace frontier
@@ -0,0 +1,316 @@
+#include "frontier/trading_calendar.hpp"
+#include <algorithm>
+
+namespace frontier {
+
+namespace {
+
+constexpr int64_t kMinutesPerDay = 1440;
+constexpr int64_t kMinutesPerWord = 32;   // 2 bits each
+
+int64_t floor_div(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// Proleptic Gregorian conversions (H. Hinnant's algorithms)
+int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+struct Civil {
+    int64_t year;
+    unsigned month;
+    unsigned day;
+};
+
+Civil civil_from_days(int64_t z) {
+    z += 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    unsigned d = static_cast<unsigned>(doy - (153 * mp + 2) / 5 + 1);
+    unsigned m = static_cast<unsigned>(mp < 10 ? mp + 3 : mp - 9);
+    return {yoe + era * 400 + (m <= 2), m, d};
+}
+
+// Sunday = 0
+int weekday(int64_t day) {
+    return static_cast<int>(day >= -4 ? (day + 4) % 7 : (day + 5) % 7 + 6);
+}
+
+int64_t nth_weekday(int64_t year, unsigned month, int wday, int n) {
+    int64_t first = days_from_civil(year, month, 1);
+    return first + (wday - weekday(first) + 7) % 7 + 7 * (n - 1);
+}
+
+int64_t easter_sunday(int64_t y) {
+    int64_t a = y % 19, b = y / 100, c = y % 100, d = b / 4, e = b % 4;
+    int64_t f = (b + 8) / 25, g = (b - f + 1) / 3;
+    int64_t h = (19 * a + b - d - g + 15) % 30;
+    int64_t i = c / 4, k = c % 4;
+    int64_t l = (32 + 2 * e + 2 * i - h - k) % 7;
+    int64_t m = (a + 11 * h + 22 * l) / 451;
+    unsigned month = static_cast<unsigned>((h + l - 7 * m + 114) / 31);
+    unsigned day = static_cast<unsigned>((h + l - 7 * m + 114) % 31 + 1);
+    return days_from_civil(y, month, day);
+}
+
+bool in_us_dst(int64_t day) {
+    int64_t year = civil_from_days(day).year;
+    return day >= nth_weekday(year, 3, 0, 2) && day < nth_weekday(year, 11, 0, 1);
+}
+
+// Weekdays only; weekends are closed by the weekly hours anyway
+bool nyse_holiday(int64_t day) {
+    Civil c = civil_from_days(day);
+    int w = weekday(day);
+    // Saturday holidays move to Friday, Sunday ones to Monday
+    auto observed = [&](unsigned month, unsigned date) {
+        return c.month == month &&
+               (c.day == date || (w == 5 && c.day + 1 == date) || (w == 1 && c.day == date + 1));
+    };
+    auto monday_in = [&](unsigned month, unsigned first, unsigned last) {
+        return c.month == month && w == 1 && c.day >= first && c.day <= last;
+    };
+    if (c.month == 1 && (c.day == 1 || (w == 1 && c.day == 2))) {
+        return true;   // A Saturday New Year's Day is not observed on Dec 31
+    }
+    return monday_in(1, 15, 21) ||                          // Martin Luther King Jr. Day
+           monday_in(2, 15, 21) ||                          // Washington's Birthday
+           day == easter_sunday(c.year) - 2 ||              // Good Friday
+           monday_in(5, 25, 31) ||                          // Memorial Day
+           (c.year >= 2022 && observed(6, 19)) ||           // Juneteenth
+           observed(7, 4) ||
+           monday_in(9, 1, 7) ||                            // Labor Day
+           (c.month == 11 && w == 4 && c.day >= 22 && c.day <= 28) ||   // Thanksgiving
+           observed(12, 25);
+}
+
+bool nyse_half_day(int64_t day) {
+    Civil c = civil_from_days(day);
+    int w = weekday(day);
+    return (c.month == 7 && c.day == 3 && w >= 1 && w <= 4) ||
+           (c.month == 11 && w == 5 && c.day >= 23 && c.day <= 29) ||   // Day after Thanksgiving
+           (c.month == 12 && c.day == 24 && w >= 1 && w <= 4);
+}
+
+int64_t minute_of(std::chrono::system_clock::time_point t) {
+    return floor_div(std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count(), 60);
+}
+
+} // namespace
+
+const char* to_string(MarketSession session) {
+    switch (session) {
+        case MarketSession::Closed: return "closed";
+        case MarketSession::PreMarket: return "pre_market";
+        case MarketSession::Regular: return "regular";
+        case MarketSession::PostMarket: return "post_market";
+    }
+    return "closed";
+}
+
+VenueHours VenueHours::us_equities() {
+    VenueHours hours;
+    hours.name = "XNYS";
+    hours.utc_offset_minutes = -300;
+    hours.dst = DstRule::UnitedStates;
+    for (int w = 1; w <= 5; ++w) {
+        hours.regular[w] = {570, 960};
+    }
+    hours.pre_open = 240;
+    hours.post_close = 1200;
+    hours.half_day_close = 780;
+    hours.holidays = HolidayRule::NewYorkStockExchange;
+    return hours;
+}
+
+VenueHours VenueHours::crypto() {
+    VenueHours hours;
+    hours.name = "CRYPTO";
+    hours.always_open = true;
+    return hours;
+}
+
+VenueHours VenueHours::forex() {
+    VenueHours hours;
+    hours.name = "FX";
+    hours.utc_offset_minutes = -300;
+    hours.dst = DstRule::UnitedStates;
+    hours.regular[0] = {1020, 1440};
+    for (int w = 1; w <= 4; ++w) {
+        hours.regular[w] = {0, 1440};
+    }
+    hours.regular[5] = {0, 1020};
+    return hours;
+}
+
+VenueCalendar::VenueCalendar(VenueHours hours, int64_t first_day, int64_t days)
+    : hours_(std::move(hours)),
+      base_minute_(first_day * kMinutesPerDay),
+      minutes_(std::max<int64_t>(days, 0) * kMinutesPerDay) {
+    if (hours_.always_open) {
+        minutes_ = 0;
+        return;
+    }
+    sessions_.assign(static_cast<size_t>((minutes_ + kMinutesPerWord - 1) / kMinutesPerWord), 0);
+    // Local days straddle UTC midnight, so include one either side
+    for (int64_t day = first_day - 1; day <= first_day + days; ++day) {
+        mark_day(day, true);
+    }
+}
+
+std::shared_ptr<VenueCalendar> VenueCalendar::around(VenueHours hours, Clock::time_point center, int years) {
+    int64_t center_day = floor_div(minute_of(center), kMinutesPerDay);
+    int64_t span = 366 * static_cast<int64_t>(std::max(years, 0));
+    return std::make_shared<VenueCalendar>(std::move(hours), center_day - span, 2 * span + 1);
+}
+
+int VenueCalendar::offset_minutes(int64_t local_day) const {
+    bool dst = hours_.dst == DstRule::UnitedStates && in_us_dst(local_day);
+    return hours_.utc_offset_minutes + (dst ? 60 : 0);
+}
+
+bool VenueCalendar::is_holiday(int64_t local_day) const {
+    if (extra_holidays_.count(local_day)) {
+        return true;
+    }
+    return hours_.holidays == HolidayRule::NewYorkStockExchange && nyse_holiday(local_day);
+}
+
+bool VenueCalendar::is_half_day(int64_t local_day) const {
+    if (extra_half_days_.count(local_day)) {
+        return true;
+    }
+    return hours_.holidays == HolidayRule::NewYorkStockExchange && nyse_half_day(local_day);
+}
+
+void VenueCalendar::day_windows(int64_t local_day, std::vector<Window>& out) const {
+    out.clear();
+    auto [open, close] = hours_.regular[weekday(local_day)];
+    if (open >= close || is_holiday(local_day)) {
+        return;
+    }
+    if (hours_.half_day_close >= 0 && is_half_day(local_day)) {
+        close = std::min(close, hours_.half_day_close);
+    }
+    // The offset is taken per day; no venue here trades across a 2am DST switch
+    int64_t midnight = local_day * kMinutesPerDay - offset_minutes(local_day);
+    if (hours_.pre_open >= 0 && hours_.pre_open < open) {
+        out.push_back({midnight + hours_.pre_open, midnight + open, MarketSession::PreMarket});
+    }
+    out.push_back({midnight + open, midnight + close, MarketSession::Regular});
+    if (hours_.post_close > close) {
+        out.push_back({midnight + close, midnight + hours_.post_close, MarketSession::PostMarket});
+    }
+}
+
+void VenueCalendar::mark_day(int64_t local_day, bool set) {
+    std::vector<Window> windows;
+    day_windows(local_day, windows);
+    for (const auto& window : windows) {
+        int64_t begin = std::max(window.start - base_minute_, int64_t{0});
+        int64_t end = std::min(window.end - base_minute_, minutes_);
+        uint64_t code = set ? static_cast<uint64_t>(window.session) : 0;
+        for (int64_t i = begin; i < end; ++i) {
+            uint64_t& word = sessions_[static_cast<size_t>(i / kMinutesPerWord)];
+            unsigned shift = static_cast<unsigned>(i % kMinutesPerWord) * 2;
+            word = (word & ~(uint64_t{3} << shift)) | (code << shift);
+        }
+    }
+}
+
+MarketSession VenueCalendar::evaluate(int64_t minute) const {
+    std::vector<Window> windows;
+    int64_t day = floor_div(minute, kMinutesPerDay);
+    for (int64_t local_day = day - 1; local_day <= day + 1; ++local_day) {
+        day_windows(local_day, windows);
+        for (const auto& window : windows) {
+            if (minute >= window.start && minute < window.end) {
+                return window.session;
+            }
+        }
+    }
+    return MarketSession::Closed;
+}
+
+MarketSession VenueCalendar::session(Clock::time_point t) const {
+    if (hours_.always_open) {
+        return MarketSession::Regular;
+    }
+    int64_t minute = minute_of(t);
+    uint64_t index = static_cast<uint64_t>(minute - base_minute_);
+    if (index >= static_cast<uint64_t>(minutes_)) {
+        return evaluate(minute);
+    }
+    uint64_t word = sessions_[index / kMinutesPerWord];
+    return static_cast<MarketSession>((word >> ((index % kMinutesPerWord) * 2)) & 3);
+}
+
+bool VenueCalendar::is_open(Clock::time_point t, bool extended_hours) const {
+    MarketSession s = session(t);
+    return s == MarketSession::Regular || (extended_hours && s != MarketSession::Closed);
+}
+
+void VenueCalendar::add_holiday(int year, unsigned month, unsigned day) {
+    int64_t local_day = days_from_civil(year, month, day);
+    if (!hours_.always_open) {
+        mark_day(local_day, false);
+    }
+    extra_holidays_.insert(local_day);
+}
+
+void VenueCalendar::add_half_day(int year, unsigned month, unsigned day) {
+    int64_t local_day = days_from_civil(year, month, day);
+    if (hours_.always_open) {
+        extra_half_days_.insert(local_day);
+        return;
+    }
+    mark_day(local_day, false);
+    extra_half_days_.insert(local_day);
+    mark_day(local_day, true);
+}
+
+bool VenueCalendar::is_trading_day(int year, unsigned month, unsigned day) const {
+    if (hours_.always_open) {
+        return true;
+    }
+    int64_t local_day = days_from_civil(year, month, day);
+    auto [open, close] = hours_.regular[weekday(local_day)];
+    return open < close && !is_holiday(local_day);
+}
+
+std::shared_ptr<TradingCalendar> TradingCalendar::standard(Clock::time_point center, int years) {
+    auto calendar = std::make_shared<TradingCalendar>();
+    auto equities = VenueCalendar::around(VenueHours::us_equities(), center, years);
+    calendar->set_venue(AssetType::STOCK, equities);
+    calendar->set_venue(AssetType::ETF, equities);
+    calendar->set_venue(AssetType::OPTIONS, equities);
+    calendar->set_venue(AssetType::CRYPTO, VenueCalendar::around(VenueHours::crypto(), center, years));
+    calendar->set_venue(AssetType::FOREX, VenueCalendar::around(VenueHours::forex(), center, years));
+    return calendar;
+}
+
+void TradingCalendar::set_venue(AssetType type, std::shared_ptr<VenueCalendar> venue) {
+    venues_[static_cast<size_t>(type)] = std::move(venue);
+}
+
+MarketSession TradingCalendar::session(AssetType type, Clock::time_point t) const {
+    const VenueCalendar* v = venue(type);
+    return v ? v->session(t) : MarketSession::Regular;
+}
+
+bool TradingCalendar::is_open(AssetType type, Clock::time_point t, bool extended_hours) const {
+    const VenueCalendar* v = venue(type);
+    return v ? v->is_open(t, extended_hours) : true;
+}
+
+} // namespace frontier
@@ -0,0 +1,137 @@
+#include "frontier/venue_sim.hpp"
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <spdlog/spdlog.h>
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signal_handler(int) {
+    g_running = false;
+}
+
+void usage() {
+    std::cerr << "Usage: frontier_venue_sim [options]\n"
+                 "  --host HOST            Listen address (default 127.0.0.1)\n"
+                 "  --port PORT            Listen port (default 8010)\n"
+                 "  --ack-latency SPEC     e.g. fixed:50, uniform:20,80, normal:50,10,\n"
+                 "                         lognormal:50,0.5, exp:50 (microseconds)\n"
+                 "  --fill-latency SPEC    Same forms, match to fill report\n"
+                 "  --ticks FILE           Replay symbol,bid,ask,bid_size,ask_size,last lines\n"
+                 "  --loop                 Restart the tick file at its end\n"
+                 "  --symbols A,B,...      Synthetic random-walk symbols (default AAPL,MSFT)\n"
+                 "  --rate N               Ticks per second, 0 for as fast as possible (default 1000)\n"
+                 "  --seed N               Latency and synthetic price seed (default 42)\n";
+}
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+
+    frontier::VenueSimulator::Config config;
+    config.port = 8010;
+    std::string tick_file;
+    bool loop = false;
+    std::vector<std::string> symbols = {"AAPL", "MSFT"};
+    double rate = 1000.0;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return argv[++i];
+            };
+            if (arg == "--host") {
+                config.host = value();
+            } else if (arg == "--port") {
+                config.port = static_cast<uint16_t>(std::stoi(value()));
+            } else if (arg == "--ack-latency") {
+                config.ack_latency = frontier::LatencyDistribution::parse(value());
+            } else if (arg == "--fill-latency") {
+                config.fill_latency = frontier::LatencyDistribution::parse(value());
+            } else if (arg == "--ticks") {
+                tick_file = value();
+            } else if (arg == "--loop") {
+                loop = true;
+            } else if (arg == "--symbols") {
+                symbols = split(value());
+            } else if (arg == "--rate") {
+                rate = std::stod(value());
+            } else if (arg == "--seed") {
+                config.seed = std::stoull(value());
+            } else {
+                usage();
+                return arg == "--help" || arg == "-h" ? 0 : 2;
+            }
+        }
+
+        std::vector<frontier::VenueTick> recorded;
+        if (!tick_file.empty()) {
+            recorded = frontier::load_venue_ticks(tick_file);
+            spdlog::info("Loaded {} ticks from {}", recorded.size(), tick_file);
+        }
+        frontier::SyntheticTickSource synthetic(symbols, 100.0, 5.0, 2.0, 500.0, config.seed);
+
+        frontier::VenueSimulator venue(config);
+        venue.start();
+        spdlog::info("Venue simulator on {}:{} (orders at /v2/orders, trade_updates at /stream)", config.host,
+                     venue.port());
+
+        // Tick pacing against an absolute schedule so slow ticks do not drift
+        auto interval = rate > 0.0 ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                         std::chrono::duration<double>(1.0 / rate))
+                                   : std::chrono::steady_clock::duration::zero();
+        auto next = std::chrono::steady_clock::now();
+        size_t cursor = 0;
+        while (g_running) {
+            if (!tick_file.empty()) {
+                if (cursor == recorded.size()) {
+                    if (!loop || recorded.empty()) {
+                        break;
+                    }
+                    cursor = 0;
+                }
+                venue.on_tick(recorded[cursor++]);
+            } else {
+                venue.on_tick(synthetic.next());
+            }
+            if (interval.count() > 0) {
+                next += interval;
+                std::this_thread::sleep_until(next);
+            }
+        }
+        // A finished tick file leaves the books open for orders until signalled
+        while (g_running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        spdlog::info("Shutting down: {} orders, {} fills", venue.orders_received(), venue.fills_sent());
+        venue.stop();
+    } catch (const std::exception& e) {
+        spdlog::error("Venue simulator failed: {}", e.what());
+        return 1;
+    }
+    return 0;
+}
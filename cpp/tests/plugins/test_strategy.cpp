@@ -0,0 +1,51 @@
+// Strategy plug-in for the engine tests, built twice. Variant 1 buys the
+// configured quantity on every tick; variant 2 only watches. Both count
+// callbacks and carry the counts across a hot reload.
+
+#include "frontier/strategy_plugin.hpp"
+#include <sstream>
+
+#ifndef STRATEGY_VARIANT
+#define STRATEGY_VARIANT 1
+#endif
+
+namespace {
+
+class TestStrategy : public frontier::Strategy {
+public:
+    explicit TestStrategy(const std::string& config) : quantity_(config.empty() ? 1.0 : std::stod(config)) {}
+
+    void on_tick(const frontier::MarketData& data, frontier::StrategyContext& context) override {
+        ++ticks_;
+        if (STRATEGY_VARIANT == 1) {
+            context.place_market_order(data.symbol, frontier::Side::Buy, quantity_, data.last);
+        }
+    }
+
+    void on_fill(const frontier::StrategyFill&, frontier::StrategyContext&) override { ++fills_; }
+
+    void on_timer(std::chrono::system_clock::time_point, frontier::StrategyContext&) override { ++timers_; }
+
+    // "variant ticks fills timers"
+    std::string save_state() const override {
+        std::ostringstream out;
+        out << STRATEGY_VARIANT << ' ' << ticks_ << ' ' << fills_ << ' ' << timers_;
+        return out.str();
+    }
+
+    void restore_state(const std::string& state) override {
+        std::istringstream in(state);
+        int variant = 0;
+        in >> variant >> ticks_ >> fills_ >> timers_;
+    }
+
+private:
+    double quantity_;
+    int ticks_ = 0;
+    int fills_ = 0;
+    int timers_ = 0;
+};
+
+} // namespace
+
+FRONTIER_EXPORT_STRATEGY(TestStrategy)
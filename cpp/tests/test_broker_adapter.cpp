@@ -0,0 +1,275 @@
+#include <gtest/gtest.h>
+#include "frontier/alpaca_adapter.hpp"
+#include "frontier/broker_server.hpp"
+#include "frontier/mock_broker.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <optional>
+#include <set>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// Collects handler results from the adapter's I/O thread
+class Collector {
+public:
+    void add(const std::function<void()>& update) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        update();
+        changed_.notify_all();
+    }
+
+    // Polls as well, for state the adapter changes without a handler call
+    bool wait_for(const std::function<bool()>& done, std::chrono::milliseconds timeout = 5s) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            changed_.wait_for(lock, 5ms);
+        }
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+};
+
+frontier::BrokerOrderRequest order(const std::string& client_id, frontier::OrderType type) {
+    frontier::BrokerOrderRequest request;
+    request.client_order_id = client_id;
+    request.symbol = "AAPL";
+    request.quantity = 10;
+    request.type = type;
+    request.limit_price = 150.25;
+    return request;
+}
+
+} // namespace
+
+TEST(HttpWireTest, ParsesPipelinedAndChunkedResponses) {
+    frontier::wire::HttpParser parser(false);
+    std::string stream =
+        "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\n{}"
+        "HTTP/1.1 204 No Content\r\n\r\n"
+        "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n";
+    // Byte at a time, as a slow socket would deliver it
+    std::vector<frontier::wire::HttpMessage> messages;
+    frontier::wire::HttpMessage message;
+    for (char c : stream) {
+        parser.feed(&c, 1);
+        while (parser.next(message)) {
+            messages.push_back(message);
+        }
+    }
+    ASSERT_EQ(messages.size(), 3u);
+    EXPECT_EQ(messages[0].body, "{}");
+    EXPECT_EQ(messages[1].status, 204);
+    EXPECT_EQ(messages[2].body, "abcde");
+}
+
+TEST(HttpWireTest, HttpParserRefusesOversizedBodies) {
+    frontier::wire::HttpMessage message;
+
+    // Content-Length is refused from the headers, before the body arrives
+    frontier::wire::HttpParser declared(true, 1024);
+    std::string request = "POST /v2/orders HTTP/1.1\r\nContent-Length: 1025\r\n\r\n";
+    declared.feed(request.data(), request.size());
+    EXPECT_FALSE(declared.next(message));
+    EXPECT_TRUE(declared.failed());
+    EXPECT_TRUE(declared.too_large());
+
+    // Chunks that are small alone but too big together
+    frontier::wire::HttpParser chunked(false, 1024);
+    std::string response = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" "200\r\n" +
+                           std::string(512, 'a') + "\r\n201\r\n";
+    chunked.feed(response.data(), response.size());
+    EXPECT_FALSE(chunked.next(message));
+    EXPECT_TRUE(chunked.too_large());
+
+    // Exactly at the limit is fine, and reset() clears the failure
+    chunked.reset();
+    response = "HTTP/1.1 200 OK\r\nContent-Length: 1024\r\n\r\n" + std::string(1024, 'b');
+    chunked.feed(response.data(), response.size());
+    ASSERT_TRUE(chunked.next(message));
+    EXPECT_EQ(message.body.size(), 1024u);
+    EXPECT_FALSE(chunked.failed());
+}
+
+TEST(HttpWireTest, WebSocketFramesRoundTrip) {
+    EXPECT_EQ(frontier::wire::websocket_accept("dGhlIHNhbXBsZSBub25jZQ=="), "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+
+    std::string big(70000, 'x');
+    frontier::wire::WsParser parser;
+    parser.feed(frontier::wire::encode_frame(frontier::wire::WsOpcode::Text, "hello", true));
+    parser.feed(frontier::wire::encode_frame(frontier::wire::WsOpcode::Binary, big, false));
+    frontier::wire::WsFrame frame;
+    ASSERT_TRUE(parser.next(frame));
+    EXPECT_EQ(frame.payload, "hello");
+    ASSERT_TRUE(parser.next(frame));
+    EXPECT_EQ(frame.opcode, frontier::wire::WsOpcode::Binary);
+    EXPECT_EQ(frame.payload.size(), big.size());
+    EXPECT_FALSE(parser.next(frame));
+}
+
+TEST(HttpWireTest, WebSocketParserRefusesOversizedMessages) {
+    using frontier::wire::WsOpcode;
+    frontier::wire::WsFrame frame;
+
+    // A 64-bit length is refused from its header, before any payload arrives
+    frontier::wire::WsParser huge(1024);
+    std::string header = frontier::wire::encode_frame(WsOpcode::Binary, std::string(70000, 'x'), false).substr(0, 10);
+    huge.feed(header);
+    EXPECT_FALSE(huge.next(frame));
+    EXPECT_TRUE(huge.failed());
+    EXPECT_TRUE(huge.too_large());
+
+    // Fragments that are small alone but too big together
+    frontier::wire::WsParser fragmented(1024);
+    std::string first = frontier::wire::encode_frame(WsOpcode::Text, std::string(600, 'a'), true);
+    first[0] = static_cast<char>(first[0] & 0x7F);  // Not final
+    fragmented.feed(first);
+    fragmented.feed(frontier::wire::encode_frame(WsOpcode::Continuation, std::string(600, 'b'), true));
+    EXPECT_FALSE(fragmented.next(frame));
+    EXPECT_TRUE(fragmented.too_large());
+    EXPECT_EQ(frontier::wire::close_payload(1009), std::string("\x03\xF1", 2));
+}
+
+TEST(BrokerServerTest, ThrowingHandlerAnswers500AndKeepsServing) {
+    frontier::BrokerServer server("throwing_server");
+    server.set_request_handler([&](const frontier::wire::HttpMessage& request, frontier::BrokerServer::ResponseToken token) {
+        if (request.target == "/boom") {
+            throw std::runtime_error("boom");
+        }
+        server.respond(token, 200, "{}");
+    });
+    server.start();
+
+    auto status_line = [&](const std::string& target) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(server.port());
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        std::string response;
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+            std::string request = "GET " + target + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            timeval timeout{5, 0};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            if (write(fd, request.data(), request.size()) == static_cast<ssize_t>(request.size())) {
+                char buffer[512];
+                while (response.find("\r\n") == std::string::npos) {
+                    ssize_t n = read(fd, buffer, sizeof(buffer));
+                    if (n <= 0) {
+                        break;
+                    }
+                    response.append(buffer, static_cast<size_t>(n));
+                }
+            }
+        }
+        close(fd);
+        return response.substr(0, response.find("\r\n"));
+    };
+    EXPECT_EQ(status_line("/boom"), "HTTP/1.1 500 Internal Server Error");
+    EXPECT_EQ(status_line("/ok"), "HTTP/1.1 200 OK");
+    server.stop();
+}
+
+TEST(BrokerAdapterTest, PipelinesOrdersAndBatchCancelsOverPool) {
+    frontier::MockBrokerServer broker;
+    broker.start();
+
+    frontier::AlpacaConfig config;
+    config.port = broker.port();
+    config.key_id = "key";
+    config.secret_key = "secret";
+    config.pool_size = 2;
+    config.max_pipeline_depth = 32;
+    frontier::AlpacaBrokerAdapter adapter(config);
+
+    Collector collector;
+    std::vector<frontier::BrokerOrderAck> acks;
+    std::vector<frontier::BrokerExecutionReport> reports;
+    adapter.set_execution_handler([&](const frontier::BrokerExecutionReport& report) {
+        collector.add([&] { reports.push_back(report); });
+    });
+    ASSERT_TRUE(adapter.start());
+    ASSERT_TRUE(collector.wait_for([&] { return adapter.stream_ready(); }));
+
+    constexpr size_t kOrders = 200;
+    for (size_t i = 0; i < kOrders; ++i) {
+        auto type = i % 2 ? frontier::OrderType::Limit : frontier::OrderType::Market;
+        adapter.submit_order(order("c" + std::to_string(i), type), [&](const frontier::BrokerOrderAck& ack) {
+            collector.add([&] { acks.push_back(ack); });
+        });
+    }
+    ASSERT_TRUE(collector.wait_for([&] { return acks.size() == kOrders; }));
+
+    std::set<std::string> ids;
+    std::vector<std::string> resting;
+    std::string filled;
+    for (const auto& ack : acks) {
+        EXPECT_TRUE(ack.accepted) << ack.error;
+        ids.insert(ack.broker_order_id);
+        (std::stoi(ack.client_order_id.substr(1)) % 2 ? resting.push_back(ack.broker_order_id)
+                                                       : void(filled = ack.broker_order_id));
+    }
+    EXPECT_EQ(ids.size(), kOrders);
+    EXPECT_LE(broker.connection_count(), 3u);  // Two pooled REST connections plus the stream
+    EXPECT_GT(broker.max_pipeline_depth(), 1u);
+
+    // Limit orders rest and cancel; the filled market orders do not
+    std::vector<frontier::BrokerCancelResult> results;
+    std::vector<std::string> targets = resting;
+    targets.push_back(filled);
+    adapter.cancel_orders(targets, [&](const std::vector<frontier::BrokerCancelResult>& batch) {
+        collector.add([&] { results = batch; });
+    });
+    ASSERT_TRUE(collector.wait_for([&] { return !results.empty(); }));
+    ASSERT_EQ(results.size(), targets.size());
+    for (size_t i = 0; i < resting.size(); ++i) {
+        EXPECT_TRUE(results[i].accepted);
+        EXPECT_EQ(results[i].broker_order_id, resting[i]);
+    }
+    EXPECT_FALSE(results.back().accepted);
+
+    auto count = [&](const std::string& event) {
+        return static_cast<size_t>(std::count_if(reports.begin(), reports.end(),
+                                                 [&](const auto& r) { return r.event == event; }));
+    };
+    ASSERT_TRUE(collector.wait_for([&] { return count("canceled") == resting.size(); }));
+    EXPECT_EQ(count("new"), kOrders);
+    EXPECT_EQ(count("fill"), kOrders / 2);
+    EXPECT_EQ(adapter.in_flight(), 0u);
+
+    adapter.stop();
+    broker.stop();
+}
+
+TEST(BrokerAdapterTest, FailsRequestsWhenBrokerIsDown) {
+    frontier::AlpacaConfig config;
+    config.port = 1;  // Nothing listens here
+    config.enable_stream = false;
+    config.reconnect_delay = 10ms;
+    frontier::AlpacaBrokerAdapter adapter(config);
+    ASSERT_TRUE(adapter.start());
+
+    Collector collector;
+    std::optional<frontier::BrokerOrderAck> ack;
+    adapter.submit_order(order("c1", frontier::OrderType::Market), [&](const frontier::BrokerOrderAck& a) {
+        collector.add([&] { ack = a; });
+    });
+    // Refused connections fail their requests instead of holding them
+    ASSERT_TRUE(collector.wait_for([&] { return ack.has_value(); }));
+    EXPECT_FALSE(ack->accepted);
+    EXPECT_EQ(ack->client_order_id, "c1");
+    EXPECT_EQ(adapter.in_flight(), 0u);
+    adapter.stop();
+}
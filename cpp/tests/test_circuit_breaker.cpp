@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "frontier/engine.hpp"
+#include "frontier/circuit_breaker.hpp"
+
+namespace {
+
+constexpr int64_t kSecond = 1'000'000'000;
+
+} // namespace
+
+TEST(CircuitBreakerTest, TripsOnMoveFromWindowExtremes) {
+    frontier::CircuitBreakerConfig config;
+    config.window_ns = 32 * kSecond;   // One-second buckets
+    config.threshold_pct = 0.05;
+    frontier::VolatilityCircuitBreaker breaker(config);
+    frontier::CircuitBreakerEvent event;
+
+    EXPECT_FALSE(breaker.on_tick(0, 100.0, 0, event));
+    EXPECT_FALSE(breaker.on_tick(0, 102.0, 1 * kSecond, event));
+    EXPECT_FALSE(breaker.on_tick(0, 97.0, 2 * kSecond, event));   // 4.9% below the high
+    EXPECT_DOUBLE_EQ(breaker.window_high(0), 102.0);
+    EXPECT_DOUBLE_EQ(breaker.window_low(0), 97.0);
+    EXPECT_TRUE(breaker.on_tick(0, 96.8, 3 * kSecond, event));
+    EXPECT_DOUBLE_EQ(event.reference_price, 102.0);
+    EXPECT_NEAR(event.move_pct, 96.8 / 102.0 - 1.0, 1e-6);
+    EXPECT_EQ(breaker.window_high(0), 0.0);   // A trip starts the window over
+
+    // Old extremes age out: the 100 high is gone 32 buckets later
+    EXPECT_FALSE(breaker.on_tick(1, 100.0, 0, event));
+    EXPECT_FALSE(breaker.on_tick(1, 96.0, 20 * kSecond, event));
+    EXPECT_FALSE(breaker.on_tick(1, 96.0, 32 * kSecond, event));
+    EXPECT_DOUBLE_EQ(breaker.window_high(1), 96.0);
+    EXPECT_FALSE(breaker.on_tick(1, 92.0, 33 * kSecond, event));   // 4.2% below 96
+
+    // A steady climb of many ticks per bucket stays within the fixed rings
+    for (int i = 0; i < 10000; ++i) {
+        double price = 50.0 + i * 0.0002;
+        ASSERT_FALSE(breaker.on_tick(2, price, i * (kSecond / 100), event)) << i;
+    }
+    EXPECT_NEAR(breaker.window_low(2), 50.0 + 6800 * 0.0002, 0.01);   // 68 seconds in, 32-second window
+}
+
+TEST(CircuitBreakerTest, EngineHaltsSymbolAndPublishesEvent) {
+    frontier::TradingEngine engine;
+    frontier::CircuitBreakerConfig config;
+    config.threshold_pct = 0.08;
+    engine.enable_circuit_breaker(config);
+    std::vector<std::string> tripped;
+    engine.set_circuit_breaker_handler([&](const frontier::CircuitBreakerEvent& event) {
+        tripped.emplace_back(event.symbol);
+        EXPECT_GT(event.halted_until_ns, event.timestamp_ns);
+    });
+
+    auto tick = [&](const std::string& symbol, double last) {
+        frontier::MarketData data;
+        data.symbol = symbol;
+        data.bid = last - 0.01;
+        data.ask = last + 0.01;
+        data.last = last;
+        engine.update_market_data(data);
+    };
+    tick("AAPL", 100.0);
+    tick("MSFT", 400.0);
+    tick("AAPL", 95.0);
+    EXPECT_TRUE(tripped.empty());
+    tick("AAPL", 91.0);
+    ASSERT_EQ(tripped.size(), 1u);
+    EXPECT_EQ(tripped[0], "AAPL");
+    tick("AAPL", 80.0);   // Already halted: no second event
+    EXPECT_EQ(tripped.size(), 1u);
+
+    EXPECT_EQ(engine.check_symbol_state("AAPL", frontier::Side::Sell, 80.0), frontier::SymbolGate::Halted);
+    EXPECT_FALSE(engine.place_market_order("AAPL", frontier::Side::Buy, 1, 80.0));
+    EXPECT_EQ(engine.symbol_states().find_state("AAPL")->halt_reason, frontier::HaltReason::CircuitBreaker);
+    EXPECT_TRUE(engine.place_market_order("MSFT", frontier::Side::Buy, 1, 400.0));
+}
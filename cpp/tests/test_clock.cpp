@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "engine/clock.h"
+#include "engine/order_manager.h"
+#include "frontier/engine.hpp"
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+using TimePoint = trading::Clock::time_point;
+
+// 2024-01-02, a regular session: 14:30 to 21:00 UTC
+const TimePoint kPreOpen = TimePoint(std::chrono::seconds(1704204000));  // 14:00 UTC
+const TimePoint kOpen = kPreOpen + 30min;
+const TimePoint kClose = kOpen + 6h + 30min;
+
+} // namespace
+
+TEST(VirtualClockTest, RunsEventsInTimeOrderAndJumpsBetweenThem) {
+    trading::VirtualClock clock(kOpen);
+    std::vector<std::string> ran;
+    clock.schedule(kOpen + 2h, [&] { ran.push_back("2h"); });
+    clock.schedule(kOpen + 1h, [&] { ran.push_back("1h-a"); });
+    clock.schedule(kOpen + 1h, [&] {
+        ran.push_back("1h-b");
+        EXPECT_EQ(clock.now(), kOpen + 1h);
+        clock.scheduleAfter(30min, [&] { ran.push_back("1h30"); });  // Handlers can schedule
+    });
+    auto cancelled = clock.schedule(kOpen + 90min, [&] { ran.push_back("cancelled"); });
+    EXPECT_TRUE(clock.cancel(cancelled));
+    EXPECT_FALSE(clock.cancel(cancelled));
+
+    EXPECT_EQ(clock.nextEventTime(), kOpen + 1h);
+    EXPECT_TRUE(clock.runNext());  // Both events at 1h
+    EXPECT_EQ(clock.now(), kOpen + 1h);
+    EXPECT_EQ(ran, (std::vector<std::string>{"1h-a", "1h-b"}));
+
+    EXPECT_EQ(clock.runUntil(kOpen + 3h), 2u);
+    EXPECT_EQ(clock.now(), kOpen + 3h);
+    EXPECT_EQ(ran, (std::vector<std::string>{"1h-a", "1h-b", "1h30", "2h"}));
+    EXPECT_FALSE(clock.runNext());
+
+    // Periodic events re-arm until cancelled, including from their own handler
+    int ticks = 0;
+    trading::VirtualClock::EventId every = 0;
+    every = clock.scheduleEvery(1s, [&] {
+        if (++ticks == 5) {
+            clock.cancel(every);
+        }
+    });
+    clock.runFor(1min);
+    EXPECT_EQ(ticks, 5);
+    EXPECT_EQ(clock.pending(), 0u);
+    EXPECT_EQ(clock.now(), kOpen + 3h + 1min);
+}
+
+TEST(VirtualClockTest, OrderManagerStampsWithInjectedClock) {
+    auto clock = std::make_shared<trading::VirtualClock>(kOpen);
+    trading::OrderManager manager(clock);
+    trading::Order order;
+    order.asset = trading::Asset("AAPL", "NASDAQ", trading::AssetType::STOCK);
+    order.type = trading::OrderType::LIMIT;
+    order.quantity = trading::Quantity(10);
+    order.limitPrice = trading::Price(150.0);
+    auto id = manager.submitOrder(order);
+    EXPECT_EQ(manager.getOrder(id).timestamp, kOpen);
+
+    clock->advanceTo(kOpen + 5min);
+    EXPECT_TRUE(manager.amendOrder(id, 20.0));  // Size up restamps the order
+    EXPECT_EQ(manager.getOrder(id).timestamp, kOpen + 5min);
+}
+
+TEST(VirtualClockTest, ReplaysTradingDayAtFullSpeed) {
+    auto clock = std::make_shared<trading::VirtualClock>(kPreOpen);
+    frontier::TradingEngine engine(clock);
+    engine.attach_trading_calendar(frontier::TradingCalendar::standard(kOpen));
+
+    frontier::MarketData quote;
+    quote.symbol = "AAPL";
+    quote.bid = 149.95;
+    quote.ask = 150.05;
+    quote.last = 150.00;
+    engine.update_market_data(quote);
+    EXPECT_FALSE(engine.place_market_order("AAPL", frontier::Side::Buy, 1, 150.05));  // Pre-market
+
+    // TWAP over the whole session in 5-minute slices
+    frontier::ParentOrderSpec spec;
+    spec.symbol = "AAPL";
+    spec.quantity = 78;
+    spec.start_time = kOpen;
+    spec.end_time = kClose;
+    spec.slice_interval = 5min;
+    auto algo = engine.submit_algo_order(spec);
+    ASSERT_NE(algo, 0u);
+
+    // The event loop a live deployment runs: timers every second, a quote every minute
+    clock->scheduleEvery(1s, [&] { engine.process_timers(); });
+    clock->scheduleEvery(1min, [&] { engine.update_market_data(quote); });
+
+    auto started = std::chrono::steady_clock::now();
+    clock->runUntil(kClose + 30min);
+    auto elapsed = std::chrono::steady_clock::now() - started;
+
+    EXPECT_EQ(engine.get_algo_order(algo)->status, frontier::AlgoStatus::Completed);
+    EXPECT_GT(engine.get_algo_order(algo)->child_count, 39u);  // Spread over the session
+    ASSERT_NE(engine.get_position("AAPL"), nullptr);
+    EXPECT_EQ(engine.get_position("AAPL")->quantity, 78.0);
+    EXPECT_FALSE(engine.is_market_open("AAPL", engine.clock().now()));
+    EXPECT_LT(elapsed, 10s);  // 7.5 hours of timers
+}
@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include "frontier/engine.hpp"
+#include "frontier/rpc.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
 
 class TradingEngineTest : public ::testing::Test {
 protected:
@@ -132,6 +136,202 @@ TEST_F(TradingEngineTest, InsufficientShares) {
     EXPECT_EQ(position->quantity, 100.0);  // Quantity should be unchanged
 }
 
+TEST_F(TradingEngineTest, CryptoPositionClosesExactly) {
+    // 0.1 + 0.1 + 0.1 != 0.3 in binary floating point
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(engine_->place_market_order("BTC/USD", frontier::Side::Buy, 0.1, 43210.12345678));
+    }
+    
+    const auto* position = engine_->get_position("BTC/USD");
+    ASSERT_NE(position, nullptr);
+    EXPECT_EQ(position->asset_type, frontier::AssetType::CRYPTO);
+    EXPECT_EQ(position->quantity.units, 30000000);
+    EXPECT_EQ(position->quantity.to_string(), "0.30000000");
+    
+    ASSERT_TRUE(engine_->place_market_order("BTC/USD", frontier::Side::Sell, 0.3, 43210.12345678));
+    EXPECT_EQ(engine_->get_position("BTC/USD"), nullptr);
+    EXPECT_TRUE(engine_->get_account().positions.empty());
+}
+
+TEST(TradingEngineRpcTest, PositionsKeepNumbersAndAddExactStrings) {
+    auto engine = std::make_shared<frontier::TradingEngine>();
+    ASSERT_TRUE(engine->place_market_order("BTC/USD", frontier::Side::Buy, 0.3, 40000.0));
+
+    frontier::RpcServer rpc(engine);
+    nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", "get_positions"}, {"params", nlohmann::json::object()}, {"id", "1"}};
+    auto positions = nlohmann::json::parse(rpc.handle_request(request.dump()))["result"];
+    ASSERT_EQ(positions.size(), 1u);
+    const auto& position = positions[0];
+    ASSERT_TRUE(position["quantity"].is_number());
+    EXPECT_DOUBLE_EQ(position["quantity"].get<double>(), 0.3);
+    EXPECT_TRUE(position["realized_pnl"].is_number());
+    EXPECT_TRUE(position["unrealized_pnl"].is_number());
+    EXPECT_EQ(position["quantity_decimal"], "0.30000000");
+    EXPECT_TRUE(position["realized_pnl_decimal"].is_string());
+    EXPECT_TRUE(position["unrealized_pnl_decimal"].is_string());
+}
+
+TEST_F(TradingEngineTest, PartialSellsReleaseCostExactly) {
+    engine_->set_asset_type("ETH", frontier::AssetType::CRYPTO);
+    ASSERT_TRUE(engine_->place_market_order("ETH", frontier::Side::Buy, 1.0, 3000.00));
+    ASSERT_TRUE(engine_->place_market_order("ETH", frontier::Side::Buy, 2.0, 3001.00));
+    
+    // Average cost 3000.66666666..., so the pro-rata releases do not divide evenly
+    ASSERT_TRUE(engine_->place_market_order("ETH", frontier::Side::Sell, 1.0, 3100.00));
+    ASSERT_TRUE(engine_->place_market_order("ETH", frontier::Side::Sell, 1.0, 3100.00));
+    const auto* position = engine_->get_position("ETH");
+    ASSERT_NE(position, nullptr);
+    EXPECT_EQ(position->quantity.to_string(), "1.00000000");
+    
+    // Whatever rounding the partial releases took is settled by the final close
+    double cash_before_close = engine_->get_account().cash;
+    ASSERT_TRUE(engine_->place_market_order("ETH", frontier::Side::Sell, 1.0, 3100.00));
+    EXPECT_EQ(engine_->get_position("ETH"), nullptr);
+    EXPECT_DOUBLE_EQ(engine_->get_account().cash, cash_before_close + 3100.00);
+    EXPECT_DOUBLE_EQ(engine_->get_account().cash, 100000.0 + 3 * 3100.00 - 3000.00 - 6002.00);
+}
+
+TEST_F(TradingEngineTest, QuantityBelowPrecisionIsRejected) {
+    EXPECT_FALSE(engine_->place_market_order("AAPL", frontier::Side::Buy, 1e-9, 150.00));
+    EXPECT_TRUE(engine_->get_account().positions.empty());
+}
+
+TEST_F(TradingEngineTest, ShortSellingDisabledByDefault) {
+    EXPECT_FALSE(engine_->place_market_order("AAPL", frontier::Side::Sell, 10, 150.00));
+    EXPECT_TRUE(engine_->get_account().positions.empty());
+    EXPECT_EQ(engine_->get_account().cash, 100000.0);
+}
+
+TEST_F(TradingEngineTest, ShortOpenAndCover) {
+    engine_->set_allow_short_selling(true);
+    ASSERT_TRUE(engine_->place_market_order("AAPL", frontier::Side::Sell, 100, 150.00));
+    
+    const auto* position = engine_->get_position("AAPL");
+    ASSERT_NE(position, nullptr);
+    EXPECT_TRUE(position->is_short());
+    EXPECT_EQ(position->quantity, -100.0);
+    EXPECT_EQ(position->average_price, 150.00);
+    EXPECT_EQ(engine_->get_account().cash, 115000.0);
+    
+    engine_->mark_to_market({{"AAPL", 140.00}});
+    EXPECT_EQ(engine_->get_position("AAPL")->unrealized_pnl, 1000.0);
+    
+    // Partial cover realizes the gain on the covered shares
+    ASSERT_TRUE(engine_->place_market_order("AAPL", frontier::Side::Buy, 40, 140.00));
+    EXPECT_EQ(engine_->get_position("AAPL")->quantity, -60.0);
+    EXPECT_EQ(engine_->get_position("AAPL")->realized_pnl, 400.0);
+    
+    ASSERT_TRUE(engine_->place_market_order("AAPL", frontier::Side::Buy, 60, 140.00));
+    EXPECT_EQ(engine_->get_position("AAPL"), nullptr);
+    EXPECT_EQ(engine_->get_account().cash, 101000.0);
+}
+
+TEST_F(TradingEngineTest, SellThroughZeroFlipsToShort) {
+    engine_->set_allow_short_selling(true);
+    ASSERT_TRUE(engine_->place_market_order("AAPL", frontier::Side::Buy, 50, 100.00));
+    ASSERT_TRUE(engine_->place_market_order("AAPL", frontier::Side::Sell, 80, 110.00));
+    
+    const auto* position = engine_->get_position("AAPL");
+    ASSERT_NE(position, nullptr);
+    EXPECT_EQ(position->quantity, -30.0);
+    EXPECT_EQ(position->realized_pnl, 500.0);     // Long leg closed at +$10
+    EXPECT_EQ(position->average_price, 110.00);   // Short leg opened at the fill price
+    EXPECT_EQ(position->cost_basis, -3300.0);
+    
+    // And back through zero to long
+    ASSERT_TRUE(engine_->place_market_order("AAPL", frontier::Side::Buy, 40, 105.00));
+    position = engine_->get_position("AAPL");
+    EXPECT_EQ(position->quantity, 10.0);
+    EXPECT_EQ(position->realized_pnl, 650.0);     // Plus $5 on 30 covered shares
+    EXPECT_EQ(position->average_price, 105.00);
+}
+
+TEST_F(TradingEngineTest, BorrowCostAccruesOnShorts) {
+    engine_->set_allow_short_selling(true);
+    engine_->set_borrow_rate("GME", 0.50);
+    ASSERT_TRUE(engine_->place_market_order("GME", frontier::Side::Sell, 100, 20.00));
+    
+    // One year at 50% on $2000 short
+    engine_->accrue_borrow_costs(std::chrono::system_clock::now() + std::chrono::hours(24 * 365));
+    const auto* position = engine_->get_position("GME");
+    ASSERT_NE(position, nullptr);
+    EXPECT_NEAR(position->borrow_cost, 1000.0, 0.01);
+    EXPECT_NEAR(position->realized_pnl, -1000.0, 0.01);
+    EXPECT_NEAR(engine_->get_account().cash, 101000.0, 0.01);
+}
+
+#if defined(TEST_STRATEGY_V1) && defined(TEST_STRATEGY_V2)
+TEST_F(TradingEngineTest, StrategyPluginTradesAndHotReloads) {
+    namespace fs = std::filesystem;
+    fs::path library = fs::temp_directory_path() / ("test_strategy_" + std::to_string(::getpid()) + ".so");
+    auto install = [&](const char* build) {
+        auto previous = fs::exists(library) ? fs::last_write_time(library) : fs::file_time_type::min();
+        fs::copy_file(build, library, fs::copy_options::overwrite_existing);
+        // Coarse filesystem clocks could otherwise leave the timestamp unchanged
+        fs::last_write_time(library, std::max(fs::last_write_time(library), previous + std::chrono::seconds(1)));
+    };
+    install(TEST_STRATEGY_V1);
+
+    frontier::MarketData data;
+    data.symbol = "AAPL";
+    data.last = 150.00;
+    uint64_t id = engine_->load_strategy(library.string(), "2");
+    frontier::StrategyPlugin* plugin = engine_->get_strategy(id);
+    ASSERT_NE(plugin, nullptr);
+
+    // Variant 1 buys 2 shares per tick and hears about its own fills
+    engine_->update_market_data(data);
+    engine_->update_market_data(data);
+    engine_->process_timers();
+    EXPECT_DOUBLE_EQ(engine_->get_position("AAPL")->quantity.to_double(), 4.0);
+    EXPECT_EQ(plugin->strategy().save_state(), "1 2 2 1");
+    EXPECT_EQ(plugin->generation(), 1u);
+
+    // A new build is picked up between ticks and keeps the counts
+    install(TEST_STRATEGY_V2);
+    engine_->process_timers();
+    EXPECT_EQ(plugin->generation(), 2u);
+    engine_->update_market_data(data);
+    EXPECT_EQ(plugin->strategy().save_state(), "2 3 2 2");
+    EXPECT_DOUBLE_EQ(engine_->get_position("AAPL")->quantity.to_double(), 4.0);
+
+    // A broken build leaves the running one in place
+    { std::ofstream(library, std::ios::trunc) << "not a shared library"; }
+    EXPECT_EQ(engine_->reload_changed_strategies(), 0u);
+    EXPECT_EQ(plugin->generation(), 2u);
+    engine_->update_market_data(data);
+    EXPECT_EQ(plugin->strategy().save_state(), "2 4 2 2");
+
+    EXPECT_THROW(engine_->load_strategy(library.string()), std::runtime_error);
+    EXPECT_TRUE(engine_->unload_strategy(id));
+    EXPECT_EQ(engine_->strategy_count(), 0u);
+    fs::remove(library);
+}
+
+TEST_F(TradingEngineTest, StrategiesOnlyHearTheirOwnFills) {
+    namespace fs = std::filesystem;
+    fs::path library = fs::temp_directory_path() / ("test_strategy_fills_" + std::to_string(::getpid()) + ".so");
+    fs::copy_file(TEST_STRATEGY_V1, library, fs::copy_options::overwrite_existing);
+    uint64_t first = engine_->load_strategy(library.string(), "2");
+    uint64_t second = engine_->load_strategy(library.string(), "3");
+
+    // Each buys on the tick and counts one fill, not both
+    frontier::MarketData data;
+    data.symbol = "AAPL";
+    data.last = 150.00;
+    engine_->update_market_data(data);
+    EXPECT_DOUBLE_EQ(engine_->get_position("AAPL")->quantity.to_double(), 5.0);
+    EXPECT_EQ(engine_->get_strategy(first)->strategy().save_state(), "1 1 1 0");
+    EXPECT_EQ(engine_->get_strategy(second)->strategy().save_state(), "1 1 1 0");
+
+    // An order from outside any strategy reaches neither
+    EXPECT_TRUE(engine_->place_market_order("AAPL", frontier::Side::Buy, 1, 150.00));
+    EXPECT_EQ(engine_->get_strategy(first)->strategy().save_state(), "1 1 1 0");
+    EXPECT_EQ(engine_->get_strategy(second)->strategy().save_state(), "1 1 1 0");
+    fs::remove(library);
+}
+#endif
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
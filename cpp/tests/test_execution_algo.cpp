@@ -0,0 +1,232 @@
+#include <gtest/gtest.h>
+#include "frontier/engine.hpp"
+#include "frontier/execution_algo.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+using TimePoint = frontier::TimerWheel::TimePoint;
+
+// 2024-01-02 14:30:00 UTC (09:30 New York)
+const TimePoint kOpen = TimePoint(std::chrono::seconds(1704205800));
+
+struct Child {
+    double quantity;
+    double price;
+};
+
+frontier::MarketData quote(const std::string& symbol, double bid, double ask, double volume) {
+    frontier::MarketData data;
+    data.symbol = symbol;
+    data.bid = bid;
+    data.ask = ask;
+    data.last = (bid + ask) / 2.0;
+    data.volume = volume;
+    return data;
+}
+
+} // namespace
+
+class ExecutionAlgoTest : public ::testing::Test {
+protected:
+    std::vector<Child> children_;
+    frontier::ExecutionAlgoEngine algos_{
+        [this](const frontier::ParentOrder&, double quantity, double price) {
+            children_.push_back({quantity, price});
+            return quantity;
+        },
+        100ms, kOpen};
+};
+
+TEST(TimerWheelTest, FiresInDeadlineOrderAcrossRevolutions) {
+    frontier::TimerWheel wheel(10ms, 8, kOpen);
+    std::vector<uint64_t> fired;
+    auto record = [&](frontier::TimerWheel::TimerId, uint64_t payload) { fired.push_back(payload); };
+
+    wheel.schedule(kOpen + 500ms, 3);   // Several revolutions out
+    wheel.schedule(kOpen + 20ms, 1);
+    auto cancelled = wheel.schedule(kOpen + 30ms, 99);
+    wheel.schedule(kOpen + 90ms, 2);
+    EXPECT_TRUE(wheel.cancel(cancelled));
+    EXPECT_FALSE(wheel.cancel(cancelled));
+
+    EXPECT_EQ(wheel.advance(kOpen + 100ms, record), 2u);
+    EXPECT_EQ(fired, (std::vector<uint64_t>{1, 2}));
+    EXPECT_EQ(wheel.pending(), 1u);
+
+    EXPECT_EQ(wheel.advance(kOpen + 10s, record), 1u);
+    EXPECT_EQ(fired.back(), 3u);
+    EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST(TimerWheelTest, HandlerCancelsTimerDueInSameBatch) {
+    frontier::TimerWheel wheel(10ms, 8, kOpen);
+    std::vector<uint64_t> fired;
+    frontier::TimerWheel::TimerId victim = 0;
+    frontier::TimerWheel::TimerId later = 0;
+    wheel.schedule(kOpen + 20ms, 1);
+    victim = wheel.schedule(kOpen + 30ms, 2);
+    wheel.schedule(kOpen + 30ms, 3);   // Shares the victim's slot
+    auto handler = [&](frontier::TimerWheel::TimerId, uint64_t payload) {
+        fired.push_back(payload);
+        if (payload == 1) {
+            EXPECT_TRUE(wheel.cancel(victim));
+            later = wheel.schedule(kOpen + 200ms, 4);  // May take the victim's pool entry
+        }
+    };
+
+    EXPECT_EQ(wheel.advance(kOpen + 50ms, handler), 2u);
+    EXPECT_EQ(fired, (std::vector<uint64_t>{1, 3}));
+    EXPECT_FALSE(wheel.cancel(victim));
+    EXPECT_EQ(wheel.pending(), 1u);
+
+    EXPECT_EQ(wheel.advance(kOpen + 300ms, handler), 1u);
+    EXPECT_EQ(fired.back(), 4u);
+    EXPECT_FALSE(wheel.cancel(later));
+    EXPECT_EQ(wheel.pending(), 0u);
+}
+
+TEST_F(ExecutionAlgoTest, TwapSlicesEvenly) {
+    algos_.on_tick(quote("AAPL", 150.00, 150.10, 1000), kOpen);
+
+    frontier::ParentOrderSpec spec;
+    spec.symbol = "AAPL";
+    spec.side = frontier::Side::Buy;
+    spec.quantity = 1000;
+    spec.start_time = kOpen;
+    spec.end_time = kOpen + 10min;
+    spec.slice_interval = 1min;
+    auto id = algos_.submit(spec, kOpen);
+    ASSERT_NE(id, 0u);
+
+    for (int minute = 0; minute <= 10; ++minute) {
+        algos_.on_timer(kOpen + std::chrono::minutes(minute));
+    }
+
+    ASSERT_EQ(children_.size(), 10u);
+    for (const auto& child : children_) {
+        EXPECT_NEAR(child.quantity, 100.0, 1e-9);
+        EXPECT_EQ(child.price, 150.10);
+    }
+    const auto* parent = algos_.get(id);
+    ASSERT_NE(parent, nullptr);
+    EXPECT_EQ(parent->status, frontier::AlgoStatus::Completed);
+    EXPECT_EQ(algos_.active_count(), 0u);
+}
+
+TEST_F(ExecutionAlgoTest, VwapFollowsVolumeProfile) {
+    frontier::VolumeProfile profile;
+    profile.session_open = std::chrono::hours(14) + std::chrono::minutes(30);
+    profile.bucket_width = std::chrono::minutes(1);
+    profile.weights = {3, 1, 1, 3};  // U-shaped day in four buckets
+    algos_.set_volume_profile("MSFT", profile);
+    algos_.on_tick(quote("MSFT", 300.00, 300.05, 0), kOpen);
+
+    frontier::ParentOrderSpec spec;
+    spec.symbol = "MSFT";
+    spec.side = frontier::Side::Sell;
+    spec.quantity = 800;
+    spec.algo = frontier::AlgoType::VWAP;
+    spec.start_time = kOpen;
+    spec.end_time = kOpen + 4min;
+    spec.slice_interval = 1min;
+    algos_.submit(spec, kOpen);
+
+    for (int minute = 0; minute <= 4; ++minute) {
+        algos_.on_timer(kOpen + std::chrono::minutes(minute));
+    }
+
+    ASSERT_EQ(children_.size(), 4u);
+    EXPECT_NEAR(children_[0].quantity, 300.0, 1e-9);
+    EXPECT_NEAR(children_[1].quantity, 100.0, 1e-9);
+    EXPECT_NEAR(children_[2].quantity, 100.0, 1e-9);
+    EXPECT_NEAR(children_[3].quantity, 300.0, 1e-9);
+    EXPECT_EQ(children_[0].price, 300.00);
+}
+
+TEST_F(ExecutionAlgoTest, PovTracksTradedVolume) {
+    algos_.on_tick(quote("TSLA", 200.00, 200.10, 10000), kOpen);
+
+    frontier::ParentOrderSpec spec;
+    spec.symbol = "TSLA";
+    spec.side = frontier::Side::Buy;
+    spec.quantity = 50;
+    spec.algo = frontier::AlgoType::POV;
+    spec.participation_rate = 0.1;
+    spec.min_child_quantity = 5;
+    auto id = algos_.submit(spec, kOpen);
+
+    algos_.on_tick(quote("TSLA", 200.00, 200.10, 10030), kOpen + 1s);  // 3 owed, below minimum
+    EXPECT_TRUE(children_.empty());
+    algos_.on_tick(quote("TSLA", 200.00, 200.10, 10100), kOpen + 2s);  // 10 owed
+    ASSERT_EQ(children_.size(), 1u);
+    EXPECT_NEAR(children_[0].quantity, 10.0, 1e-9);
+
+    algos_.on_tick(quote("TSLA", 200.00, 200.10, 20000), kOpen + 3s);  // Capped at remaining
+    ASSERT_EQ(children_.size(), 2u);
+    EXPECT_NEAR(children_[1].quantity, 40.0, 1e-9);
+    EXPECT_EQ(algos_.get(id)->status, frontier::AlgoStatus::Completed);
+}
+
+TEST_F(ExecutionAlgoTest, CancelStopsSchedule) {
+    algos_.on_tick(quote("AAPL", 150.00, 150.10, 0), kOpen);
+
+    frontier::ParentOrderSpec spec;
+    spec.symbol = "AAPL";
+    spec.quantity = 1000;
+    spec.start_time = kOpen;
+    spec.end_time = kOpen + 10min;
+    spec.slice_interval = 1min;
+    auto id = algos_.submit(spec, kOpen);
+
+    algos_.on_timer(kOpen);
+    EXPECT_TRUE(algos_.cancel(id));
+    algos_.on_timer(kOpen + 10min);
+
+    EXPECT_EQ(children_.size(), 1u);
+    EXPECT_EQ(algos_.get(id)->status, frontier::AlgoStatus::Cancelled);
+    EXPECT_FALSE(algos_.cancel(id));
+}
+
+TEST_F(ExecutionAlgoTest, ForgetsOldestFinishedParents) {
+    algos_.set_finished_retention(2);
+    frontier::ParentOrderSpec spec;
+    spec.symbol = "AAPL";
+    spec.quantity = 1000;
+    spec.start_time = kOpen;
+    spec.end_time = kOpen + 10min;
+    spec.slice_interval = 1min;
+    std::vector<uint64_t> ids;
+    for (int i = 0; i < 3; ++i) {
+        ids.push_back(algos_.submit(spec, kOpen));
+        EXPECT_TRUE(algos_.cancel(ids.back()));
+    }
+
+    EXPECT_EQ(algos_.finished_count(), 2u);
+    EXPECT_EQ(algos_.get(ids[0]), nullptr);
+    ASSERT_NE(algos_.get(ids[2]), nullptr);
+    EXPECT_EQ(algos_.get(ids[2])->status, frontier::AlgoStatus::Cancelled);
+
+    algos_.set_finished_retention(1);
+    EXPECT_EQ(algos_.get(ids[1]), nullptr);
+    EXPECT_NE(algos_.get(ids[2]), nullptr);
+}
+
+TEST(EngineAlgoTest, AlgoChildrenExecuteThroughEngine) {
+    frontier::TradingEngine engine;
+    engine.update_market_data(quote("AAPL", 150.00, 150.00, 0));
+
+    frontier::ParentOrderSpec spec;
+    spec.symbol = "AAPL";
+    spec.quantity = 20;
+    spec.start_time = std::chrono::system_clock::now() - 1min;
+    spec.end_time = spec.start_time + 1min;
+    auto id = engine.submit_algo_order(spec);
+    ASSERT_NE(id, 0u);
+
+    engine.process_timers();
+    const auto* position = engine.get_position("AAPL");
+    ASSERT_NE(position, nullptr);
+    EXPECT_EQ(position->quantity, 20.0);
+    EXPECT_EQ(engine.get_algo_order(id)->status, frontier::AlgoStatus::Completed);
+}
@@ -0,0 +1,431 @@
+#include <gtest/gtest.h>
+#include "fix/fix_gateway.h"
+#include <arpa/inet.h>
+#include <cstdio>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::string newOrderSingle(const std::string& clOrdId, const std::string& extra = "") {
+    trading::FixFields fields;
+    fields.add(trading::fixtag::SenderCompID, "CLIENT")
+        .add(trading::fixtag::TargetCompID, "FRONTIER")
+        .add(trading::fixtag::MsgSeqNum, 7)
+        .add(trading::fixtag::ClOrdID, clOrdId)
+        .add(trading::fixtag::Symbol, "AAPL")
+        .add(trading::fixtag::Side, '1')
+        .add(trading::fixtag::OrderQty, 100)
+        .add(trading::fixtag::OrdType, '2')
+        .add(trading::fixtag::Price, 150.25)
+        .add(trading::fixtag::TimeInForce, '1');
+    return trading::fixFrame("FIX.4.4", "D", fields.str() + extra);
+}
+
+// Field of a message held as raw bytes
+std::string field(const std::string& raw, int tag) {
+    trading::FixMessage message;
+    size_t consumed = 0;
+    if (trading::FixParser::parse(raw.data(), raw.size(), message, consumed) != trading::FixParseStatus::OK) {
+        return "";
+    }
+    return std::string(message.get(tag));
+}
+
+// Feed every complete message in `wire` to the session
+void deliver(std::string& wire, trading::FixSession& session) {
+    trading::FixMessage message;
+    size_t consumed = 0;
+    while (trading::FixParser::parse(wire.data(), wire.size(), message, consumed) == trading::FixParseStatus::OK) {
+        session.onMessage(message);
+        wire.erase(0, consumed);
+    }
+}
+
+} // namespace
+
+TEST(FixParserTest, FramesAndDecodesNewOrderSingle) {
+    std::string first = newOrderSingle("ORD-1");
+    std::string stream = first + newOrderSingle("ORD-2");
+
+    trading::FixMessage message;
+    size_t consumed = 0;
+    ASSERT_EQ(trading::FixParser::parse(stream.data(), stream.size(), message, consumed), trading::FixParseStatus::OK);
+    EXPECT_EQ(consumed, first.size());
+    EXPECT_EQ(message.msgType(), "D");
+    EXPECT_EQ(message.get(trading::fixtag::ClOrdID), "ORD-1");
+    // Values point into the caller's buffer
+    EXPECT_GE(message.get(trading::fixtag::Symbol).data(), stream.data());
+    EXPECT_LT(message.get(trading::fixtag::Symbol).data(), stream.data() + first.size());
+
+    trading::FixOrderCommand decoded;
+    std::string error;
+    ASSERT_TRUE(trading::decodeOrderCommand(message, decoded, error)) << error;
+    const trading::Order& order = decoded.command.order;
+    EXPECT_EQ(decoded.command.type, trading::CommandType::NEW_ORDER);
+    EXPECT_EQ(decoded.clOrdId, "ORD-1");
+    EXPECT_EQ(order.asset.symbol, "AAPL");
+    EXPECT_EQ(order.side, trading::OrderSide::BUY);
+    EXPECT_EQ(order.type, trading::OrderType::LIMIT);
+    EXPECT_DOUBLE_EQ(order.quantity.value, 100);
+    EXPECT_DOUBLE_EQ(order.limitPrice->value, 150.25);
+    EXPECT_EQ(order.timeInForce, trading::TimeInForce::GTC);
+
+    // Split delivery, then a corrupted checksum
+    EXPECT_EQ(trading::FixParser::parse(first.data(), first.size() - 3, message, consumed),
+              trading::FixParseStatus::INCOMPLETE);
+    std::string garbled = first;
+    garbled[garbled.find("AAPL")] = 'B';
+    EXPECT_EQ(trading::FixParser::parse(garbled.data(), garbled.size(), message, consumed),
+              trading::FixParseStatus::INVALID);
+    EXPECT_EQ(consumed, garbled.size());
+
+    // A limit order without a price is refused with a reason
+    trading::FixFields fields;
+    fields.add(trading::fixtag::MsgSeqNum, 1)
+        .add(trading::fixtag::ClOrdID, "ORD-3")
+        .add(trading::fixtag::Symbol, "AAPL")
+        .add(trading::fixtag::Side, '2')
+        .add(trading::fixtag::OrderQty, 5)
+        .add(trading::fixtag::OrdType, '2');
+    std::string noPrice = trading::fixFrame("FIX.4.4", "D", fields.str());
+    ASSERT_EQ(trading::FixParser::parse(noPrice.data(), noPrice.size(), message, consumed),
+              trading::FixParseStatus::OK);
+    EXPECT_FALSE(trading::decodeOrderCommand(message, decoded, error));
+    EXPECT_EQ(error, "Missing or bad Price");
+}
+
+TEST(FixSessionTest, ResendsFromJournalWithGapFill) {
+    trading::FixSessionConfig serverConfig;
+    serverConfig.senderCompId = "FRONTIER";
+    serverConfig.targetCompId = "CLIENT";
+    trading::FixSessionConfig clientConfig;
+    clientConfig.senderCompId = "CLIENT";
+    clientConfig.targetCompId = "FRONTIER";
+    clientConfig.initiator = true;
+    trading::FixSession server(serverConfig);
+    trading::FixSession client(clientConfig);
+
+    std::string toServer;
+    std::string toClient;
+    std::vector<std::string> received;
+    client.setApplicationHandler([&](const trading::FixMessage& message) {
+        received.push_back(std::string(message.get(trading::fixtag::ClOrdID)));
+    });
+    server.attach([&](const std::string& bytes) { toClient += bytes; });
+    client.attach([&](const std::string& bytes) { toServer += bytes; });
+    deliver(toServer, server);
+    deliver(toClient, client);
+    ASSERT_EQ(server.getState(), trading::FixSessionState::ACTIVE);
+    ASSERT_EQ(client.getState(), trading::FixSessionState::ACTIVE);
+
+    // Reports 2 and 4 with a heartbeat between them are lost; 5 arrives
+    auto report = [&](const std::string& clOrdId) {
+        trading::FixFields fields;
+        fields.add(trading::fixtag::ClOrdID, clOrdId).add(trading::fixtag::ExecType, '0');
+        return server.send("8", fields);
+    };
+    EXPECT_EQ(report("A"), 2u);
+    server.onTimer(trading::FixSession::Clock::now() + 31s);
+    EXPECT_EQ(report("B"), 4u);
+    toClient.clear();
+    EXPECT_EQ(report("C"), 5u);
+    deliver(toClient, client);
+    EXPECT_TRUE(received.empty());
+
+    // The client asks from 2; the server replays A and B, gap-fills the heartbeat
+    deliver(toServer, server);
+    std::vector<std::string> replay;
+    for (std::string copy = toClient; !copy.empty();) {
+        trading::FixMessage message;
+        size_t consumed = 0;
+        ASSERT_EQ(trading::FixParser::parse(copy.data(), copy.size(), message, consumed), trading::FixParseStatus::OK);
+        replay.push_back(std::string(message.msgType()) + ":" + std::string(message.get(trading::fixtag::MsgSeqNum)));
+        EXPECT_EQ(message.get(trading::fixtag::PossDupFlag), "Y");
+        copy.erase(0, consumed);
+    }
+    EXPECT_EQ(replay, (std::vector<std::string>{"8:2", "4:3", "8:4", "8:5"}));
+
+    deliver(toClient, client);
+    EXPECT_EQ(received, (std::vector<std::string>{"A", "B", "C"}));
+    EXPECT_EQ(client.getNextIncomingSeqNum(), 6u);
+}
+
+TEST(FixSessionTest, RestartResumesInboundSequence) {
+    std::string journal = ::testing::TempDir() + "fix_restart_journal";
+    std::remove(journal.c_str());
+    trading::FixSessionConfig serverConfig;
+    serverConfig.senderCompId = "FRONTIER";
+    serverConfig.targetCompId = "CLIENT";
+    serverConfig.journalPath = journal;
+    trading::FixSessionConfig clientConfig;
+    clientConfig.senderCompId = "CLIENT";
+    clientConfig.targetCompId = "FRONTIER";
+    clientConfig.initiator = true;
+    trading::FixSession client(clientConfig);
+
+    std::string toServer;
+    std::string toClient;
+    std::vector<std::string> entered;
+    auto start = [&](trading::FixSession& server) {
+        server.setApplicationHandler([&](const trading::FixMessage& message) {
+            entered.push_back(std::string(message.get(trading::fixtag::ClOrdID)));
+        });
+        server.attach([&](const std::string& bytes) { toClient += bytes; });
+    };
+    client.attach([&](const std::string& bytes) { toServer += bytes; });
+
+    trading::FixFields order;
+    order.add(trading::fixtag::ClOrdID, "ORD-1");
+    {
+        auto server = std::make_unique<trading::FixSession>(serverConfig);
+        start(*server);
+        deliver(toServer, *server);
+        deliver(toClient, client);
+        ASSERT_EQ(client.getState(), trading::FixSessionState::ACTIVE);
+        client.send("D", order);
+        deliver(toServer, *server);
+        EXPECT_EQ(server->getNextIncomingSeqNum(), 3u);
+    }
+    EXPECT_EQ(entered, (std::vector<std::string>{"ORD-1"}));
+
+    // The restarted server expects 3, so a PossDup resend of 2 is not entered again
+    trading::FixSession server(serverConfig);
+    start(server);
+    EXPECT_EQ(server.getNextIncomingSeqNum(), 3u);
+    client.detach();
+    client.attach([&](const std::string& bytes) { toServer += bytes; });
+    deliver(toServer, server);
+    deliver(toClient, client);
+    ASSERT_EQ(server.getState(), trading::FixSessionState::ACTIVE);
+    trading::FixFields replay;
+    replay.add(trading::fixtag::SenderCompID, "CLIENT")
+        .add(trading::fixtag::TargetCompID, "FRONTIER")
+        .add(trading::fixtag::MsgSeqNum, 2)
+        .add(trading::fixtag::PossDupFlag, 'Y')
+        .add(trading::fixtag::ClOrdID, "ORD-1");
+    std::string resend = trading::fixFrame("FIX.4.4", "D", replay.str());
+    deliver(resend, server);
+    EXPECT_EQ(entered, (std::vector<std::string>{"ORD-1"}));
+    EXPECT_EQ(server.getNextIncomingSeqNum(), 4u);
+    std::remove(journal.c_str());
+}
+
+TEST(FixParserTest, EnforcesLengthAndDigitLimits) {
+    trading::FixMessage message;
+    size_t consumed = 0;
+
+    // Refused from the BodyLength alone, before the body arrives
+    std::string huge = "8=FIX.4.4\x01" "9=999999\x01" "35=D\x01";
+    EXPECT_EQ(trading::FixParser::parse(huge.data(), huge.size(), message, consumed),
+              trading::FixParseStatus::VIOLATION);
+
+    std::string longTag = newOrderSingle("ORD-1", "1234567890=X\x01");
+    EXPECT_EQ(trading::FixParser::parse(longTag.data(), longTag.size(), message, consumed),
+              trading::FixParseStatus::VIOLATION);
+
+    std::string longPrice = newOrderSingle("ORD-2", "99=1234567890123456789012.5\x01");
+    ASSERT_EQ(trading::FixParser::parse(longPrice.data(), longPrice.size(), message, consumed),
+              trading::FixParseStatus::OK);
+    double value = 0.0;
+    EXPECT_FALSE(message.getDouble(trading::fixtag::StopPx, value));
+    EXPECT_TRUE(message.getDouble(trading::fixtag::Price, value));
+}
+
+TEST(FixGatewayTest, DropsSilentAndOversizedConnections) {
+    trading::OrderManager manager;
+    trading::FixGatewayConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.logonTimeout = 1;
+    trading::FixGateway gateway(manager, config);
+    gateway.start();
+
+    auto open = [&]() {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(gateway.getPort());
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+        EXPECT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+        return fd;
+    };
+    // True once the gateway closes the socket
+    auto closedWithin = [](int fd, std::chrono::milliseconds limit) {
+        pollfd pfd{fd, POLLIN, 0};
+        char buffer[256];
+        return poll(&pfd, 1, static_cast<int>(limit.count())) > 0 && read(fd, buffer, sizeof(buffer)) == 0;
+    };
+
+    int oversized = open();
+    std::string header = "8=FIX.4.4\x01" "9=999999\x01";
+    ASSERT_EQ(write(oversized, header.data(), header.size()), static_cast<ssize_t>(header.size()));
+    EXPECT_TRUE(closedWithin(oversized, 500ms));
+
+    int silent = open();
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(closedWithin(silent, 3s));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, 900ms);
+
+    close(oversized);
+    close(silent);
+    gateway.stop();
+}
+
+TEST(FixGatewayTest, RoutesOrdersAndReportsExecutions) {
+    trading::OrderManager manager;
+    trading::FixGatewayConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.finishedOrderRetention = 1;
+    trading::FixGateway gateway(manager, config);
+    manager.setOrderUpdateCallback([&](const trading::Order& order) { gateway.onOrderUpdate(order); });
+    manager.setCommandRejectCallback([&](const trading::EngineCommand& command, const std::string& reason) {
+        gateway.onCommandRejected(command, reason);
+    });
+    gateway.start();
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(gateway.getPort());
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+    trading::FixSessionConfig clientConfig;
+    clientConfig.senderCompId = "CLIENT";
+    clientConfig.targetCompId = "FRONTIER";
+    clientConfig.initiator = true;
+    trading::FixSession client(clientConfig);
+    std::vector<std::string> reports;
+    client.setApplicationHandler([&](const trading::FixMessage& message) { reports.emplace_back(message.raw()); });
+    client.attach([&](const std::string& bytes) { ASSERT_EQ(write(fd, bytes.data(), bytes.size()), (ssize_t)bytes.size()); });
+
+    // Read and drain the engine until `done` holds
+    std::string inbound;
+    auto pump = [&](const std::function<bool()>& done) {
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            manager.processCommands();
+            pollfd pfd{fd, POLLIN, 0};
+            if (poll(&pfd, 1, 10) > 0) {
+                char buffer[4096];
+                ssize_t n = read(fd, buffer, sizeof(buffer));
+                if (n <= 0) {
+                    break;
+                }
+                inbound.append(buffer, static_cast<size_t>(n));
+                deliver(inbound, client);
+            }
+        }
+        return done();
+    };
+    auto awaitReports = [&](size_t count) { return pump([&] { return reports.size() >= count; }); };
+    auto sendOrder = [&](const char* msgType, trading::FixFields fields) { client.send(msgType, fields); };
+
+    ASSERT_TRUE(pump([&] { return client.getState() == trading::FixSessionState::ACTIVE; }));
+    EXPECT_EQ(gateway.getSessionCount(), 1u);
+
+    trading::FixFields order;
+    order.add(trading::fixtag::ClOrdID, "ORD-1")
+        .add(trading::fixtag::Symbol, "AAPL")
+        .add(trading::fixtag::Side, '1')
+        .add(trading::fixtag::OrderQty, 100)
+        .add(trading::fixtag::OrdType, '2')
+        .add(trading::fixtag::Price, 150.0);
+    sendOrder("D", order);
+    ASSERT_TRUE(awaitReports(1));
+    EXPECT_EQ(field(reports[0], trading::fixtag::MsgType), "8");
+    EXPECT_EQ(field(reports[0], trading::fixtag::ExecType), "0");
+    EXPECT_EQ(field(reports[0], trading::fixtag::ClOrdID), "ORD-1");
+    std::string orderId = field(reports[0], trading::fixtag::OrderID);
+    EXPECT_EQ(manager.getOrder(orderId).clientOrderId, "ORD-1");
+
+    trading::FixFields cancel;
+    cancel.add(trading::fixtag::ClOrdID, "CXL-1").add(trading::fixtag::OrigClOrdID, "ORD-1");
+    sendOrder("F", cancel);
+    ASSERT_TRUE(awaitReports(2));
+    EXPECT_EQ(field(reports[1], trading::fixtag::ExecType), "4");
+    EXPECT_EQ(field(reports[1], trading::fixtag::ClOrdID), "CXL-1");
+    EXPECT_EQ(field(reports[1], trading::fixtag::OrigClOrdID), "ORD-1");
+    EXPECT_EQ(manager.getOrder(orderId).status, trading::OrderStatus::CANCELLED);
+
+    // Cancelling it again is too late; a bad order is rejected with its reason
+    trading::FixFields again;
+    again.add(trading::fixtag::ClOrdID, "CXL-2").add(trading::fixtag::OrigClOrdID, "ORD-1");
+    sendOrder("F", again);
+    trading::FixFields noPrice;
+    noPrice.add(trading::fixtag::ClOrdID, "ORD-2")
+        .add(trading::fixtag::Symbol, "AAPL")
+        .add(trading::fixtag::Side, '1')
+        .add(trading::fixtag::OrderQty, 10)
+        .add(trading::fixtag::OrdType, '2');
+    sendOrder("D", noPrice);
+    ASSERT_TRUE(awaitReports(4));
+    EXPECT_EQ(field(reports[2], trading::fixtag::MsgType), "9");
+    EXPECT_EQ(field(reports[2], trading::fixtag::Text), "Too late to cancel");
+    EXPECT_EQ(field(reports[3], trading::fixtag::ExecType), "8");
+    EXPECT_EQ(field(reports[3], trading::fixtag::Text), "Missing or bad Price");
+
+    // A replace the engine refuses (quantity below filled) is rejected and
+    // leaves the order cancellable
+    trading::FixFields partial;
+    partial.add(trading::fixtag::ClOrdID, "ORD-3")
+        .add(trading::fixtag::Symbol, "AAPL")
+        .add(trading::fixtag::Side, '1')
+        .add(trading::fixtag::OrderQty, 100)
+        .add(trading::fixtag::OrdType, '2')
+        .add(trading::fixtag::Price, 150.0);
+    sendOrder("D", partial);
+    ASSERT_TRUE(awaitReports(5));
+    trading::MarketTick tick;
+    tick.asset = trading::Asset("AAPL", "NASDAQ", trading::AssetType::STOCK);
+    tick.bid = trading::Price(149.9);
+    tick.ask = trading::Price(150.0);
+    tick.askSize = trading::Quantity(40);
+    tick.last = trading::Price(150.0);
+    manager.processMarketTick(tick);
+    ASSERT_TRUE(awaitReports(6));
+    EXPECT_EQ(field(reports[5], trading::fixtag::ExecType), "F");
+
+    trading::FixFields shrink;
+    shrink.add(trading::fixtag::ClOrdID, "RPL-3")
+        .add(trading::fixtag::OrigClOrdID, "ORD-3")
+        .add(trading::fixtag::Symbol, "AAPL")
+        .add(trading::fixtag::Side, '1')
+        .add(trading::fixtag::OrderQty, 30)
+        .add(trading::fixtag::OrdType, '2')
+        .add(trading::fixtag::Price, 150.0);
+    sendOrder("G", shrink);
+    ASSERT_TRUE(awaitReports(7));
+    EXPECT_EQ(field(reports[6], trading::fixtag::MsgType), "9");
+    EXPECT_EQ(field(reports[6], trading::fixtag::ClOrdID), "RPL-3");
+    EXPECT_EQ(field(reports[6], trading::fixtag::OrigClOrdID), "ORD-3");
+    EXPECT_EQ(field(reports[6], trading::fixtag::CxlRejResponseTo), "2");
+
+    trading::FixFields cancelPartial;
+    cancelPartial.add(trading::fixtag::ClOrdID, "CXL-3").add(trading::fixtag::OrigClOrdID, "ORD-3");
+    sendOrder("F", cancelPartial);
+    ASSERT_TRUE(awaitReports(8));
+    EXPECT_EQ(field(reports[7], trading::fixtag::ExecType), "4");
+    EXPECT_EQ(field(reports[7], trading::fixtag::ClOrdID), "CXL-3");
+    EXPECT_EQ(field(reports[7], trading::fixtag::OrigClOrdID), "ORD-3");
+
+    // Only the last finished order is remembered; ORD-1 has been forgotten
+    trading::FixFields forgotten;
+    forgotten.add(trading::fixtag::ClOrdID, "CXL-4").add(trading::fixtag::OrigClOrdID, "ORD-1");
+    sendOrder("F", forgotten);
+    trading::FixFields remembered;
+    remembered.add(trading::fixtag::ClOrdID, "CXL-5").add(trading::fixtag::OrigClOrdID, "CXL-3");
+    sendOrder("F", remembered);
+    ASSERT_TRUE(awaitReports(10));
+    EXPECT_EQ(field(reports[8], trading::fixtag::Text), "Unknown order");
+    EXPECT_EQ(field(reports[9], trading::fixtag::Text), "Too late to cancel");
+
+    close(fd);
+    gateway.stop();
+}
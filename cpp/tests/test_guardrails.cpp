@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "frontier/rpc.hpp"
+#include "frontier/guardrails.hpp"
+#include "risk/risk_manager.h"
+#include <cmath>
+#include <random>
+
+TEST(GuardrailsTest, KernelMatchesScalarDefinition) {
+    // Odd count exercises the SIMD pairs and the scalar tail
+    constexpr size_t n = 101;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> qty(-500.0, 500.0), px(1.0, 200.0);
+    std::vector<double> position(n), quantity(n), price(n), stop(n);
+    for (size_t i = 0; i < n; ++i) {
+        position[i] = qty(rng);
+        quantity[i] = qty(rng);
+        price[i] = px(rng);
+        stop[i] = i % 3 == 0 ? 0.0 : px(rng);
+    }
+    std::vector<uint8_t> max_pos_ok(n), daily_loss_ok(n);
+    frontier::evaluate_guardrail_flags(position.data(), quantity.data(), price.data(), stop.data(), n, 20000.0,
+                                       5000.0, max_pos_ok.data(), daily_loss_ok.data());
+    for (size_t i = 0; i < n; ++i) {
+        double loss = stop[i] > 0.0 ? std::fabs(quantity[i]) * std::fabs(price[i] - stop[i]) : 0.0;
+        EXPECT_EQ(max_pos_ok[i], std::fabs(position[i] + quantity[i]) * price[i] <= 20000.0) << i;
+        EXPECT_EQ(daily_loss_ok[i], loss <= 5000.0) << i;
+    }
+
+    EXPECT_NEAR(trading::RiskCalculator::calculateKellyCriterion(0.5, 1.2, 1.0), 0.5 - 0.5 / 1.2, 1e-12);
+    EXPECT_EQ(trading::RiskCalculator::calculateKellyCriterion(0.3, 1.0, 1.0), 0.0);   // Negative edge
+    EXPECT_DOUBLE_EQ(trading::RiskCalculator::calculateOptimalPositionSize(100000.0, 0.01, 10.0), 100.0);
+}
+
+TEST(GuardrailsTest, FillsAreValuedWithoutAManualMark) {
+    frontier::TradingEngine engine;
+    engine.set_allow_short_selling(true);
+    ASSERT_TRUE(engine.place_market_order("AAPL", frontier::Side::Buy, 100, 100.0));
+    ASSERT_TRUE(engine.place_market_order("MSFT", frontier::Side::Sell, 100, 100.0));
+    EXPECT_NEAR(engine.daily_pnl(), 0.0, 1e-6);
+    EXPECT_NEAR(engine.get_account().equity, 100000.0, 1e-6);
+
+    frontier::GuardrailCandidate candidate;
+    candidate.symbol = "AAPL";
+    candidate.quantity = 10;
+    candidate.limit_price = 100.0;
+    auto results = engine.evaluate_guardrails({candidate}, std::chrono::system_clock::now());
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].daily_loss_ok);
+
+    // Ticks move the mark from there
+    frontier::MarketData quote;
+    quote.symbol = "AAPL";
+    quote.last = 90.0;
+    engine.update_market_data(quote);
+    EXPECT_NEAR(engine.daily_pnl(), -1000.0, 1e-6);
+    EXPECT_NEAR(engine.get_position("AAPL")->unrealized_pnl, -1000.0, 1e-6);
+}
+
+TEST(GuardrailsTest, BatchRpcEvaluatesAgainstOneSnapshot) {
+    auto engine = std::make_shared<frontier::TradingEngine>();
+    frontier::MarketData quote;
+    quote.symbol = "AAPL";
+    quote.bid = 99.99;
+    quote.ask = 100.01;
+    quote.last = 100.0;
+    engine->update_market_data(quote);
+    ASSERT_TRUE(engine->place_market_order("AAPL", frontier::Side::Buy, 100, 100.0));
+    engine->start_trading_day();
+    engine->mark_to_market({{"AAPL", 80.0}});   // Down 2000 on the day
+    ASSERT_NEAR(engine->daily_pnl(), -2000.0, 1e-6);
+    double max_value = 0.2 * engine->get_account().equity;   // 19600
+
+    frontier::RpcServer rpc(engine);
+    nlohmann::json request = {
+        {"jsonrpc", "2.0"}, {"method", "evaluate_guardrails"}, {"id", "1"},
+        {"params", {{"candidates", {
+            {{"symbol", "AAPL"}, {"qty", "145"}, {"limit", "80"}},
+            {{"symbol", "AAPL"}, {"qty", "146"}, {"limit", "80"}},
+            {{"symbol", "AAPL"}, {"qty", "100"}, {"side", "sell"}, {"limit", "80"}, {"stop", "50"}},
+            {{"symbol", "AAPL"}, {"qty", 100}, {"limit", 80}, {"stop", 49}},
+            {{"symbol", "MSFT"}, {"qty", 10}},
+            {{"symbol", "AAPL"}, {"qty", 10}, {"limit", 80}, {"stop", 72},
+             {"win_rate", 0.5}, {"avg_win", 1.2}, {"avg_loss", 1.0}}
+        }}}}
+    };
+    auto response = nlohmann::json::parse(rpc.handle_request(request.dump()));
+    const auto& results = response["result"]["results"];
+    ASSERT_EQ(results.size(), 6u);
+
+    // 245 * 80 = 19600 sits exactly on the limit
+    EXPECT_TRUE(results[0]["max_pos_ok"]);
+    EXPECT_FALSE(results[1]["max_pos_ok"]);
+    // 3000 of headroom left: 100 * 30 fits, 100 * 31 does not
+    EXPECT_TRUE(results[2]["daily_loss_ok"]);
+    EXPECT_EQ(results[2]["projected_position_value"], 0.0);
+    EXPECT_FALSE(results[3]["daily_loss_ok"]);
+    EXPECT_TRUE(results[0]["daily_loss_ok"]);   // No stop
+    // No quote and no limit: can't be priced
+    EXPECT_FALSE(results[4]["max_pos_ok"]);
+    EXPECT_TRUE(results[4]["mkt_hours_ok"]);   // No calendar attached
+
+    double equity = engine->get_account().equity;
+    double kelly = 0.5 - 0.5 / 1.2;
+    EXPECT_NEAR(results[5]["kelly_fraction"].get<double>(), kelly, 1e-9);
+    EXPECT_NEAR(results[5]["kelly_qty"].get<double>(), kelly * equity / 80.0, 1e-6);
+    EXPECT_NEAR(results[5]["optimal_qty"].get<double>(), std::min(equity * 0.01 / 8.0, max_value / 80.0), 1e-6);
+
+    auto calendar = std::make_shared<frontier::TradingCalendar>();
+    calendar->set_venue(frontier::AssetType::STOCK,
+                        std::make_shared<frontier::VenueCalendar>(frontier::VenueHours{}, 0, 1));
+    engine->attach_trading_calendar(calendar);
+    auto closed = engine->evaluate_guardrails({{"AAPL", 1.0, 80.0}}, std::chrono::system_clock::now());
+    ASSERT_EQ(closed.size(), 1u);
+    EXPECT_FALSE(closed[0].mkt_hours_ok);
+}
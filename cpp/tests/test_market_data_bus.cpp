@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include "frontier/engine.hpp"
+#include "frontier/market_data_bus.hpp"
+#include <unistd.h>
+
+namespace {
+
+std::string unique_bus_name(const char* tag) {
+    return std::string("/frontier_test_") + tag + "_" + std::to_string(getpid());
+}
+
+frontier::MarketData make_quote(const std::string& symbol, double bid, double ask) {
+    frontier::MarketData data;
+    data.symbol = symbol;
+    data.bid = bid;
+    data.ask = ask;
+    data.last = (bid + ask) / 2.0;
+    data.volume = 100.0;
+    return data;
+}
+
+} // namespace
+
+TEST(MarketDataBusTest, ReaderSeesLatestQuote) {
+    auto name = unique_bus_name("quote");
+    frontier::MarketDataBusWriter writer(name, 16, 64);
+    frontier::MarketDataBusReader reader(name);
+
+    EXPECT_EQ(reader.find_symbol("AAPL"), -1);
+
+    ASSERT_TRUE(writer.publish(make_quote("AAPL", 150.00, 150.10), 1));
+    ASSERT_TRUE(writer.publish(make_quote("AAPL", 150.20, 150.30), 2));
+
+    int32_t slot = reader.find_symbol("AAPL");
+    ASSERT_EQ(slot, 0);
+
+    frontier_bus_quote quote{};
+    ASSERT_TRUE(reader.read_quote(slot, quote));
+    EXPECT_STREQ(quote.symbol, "AAPL");
+    EXPECT_EQ(quote.bid, 150.20);
+    EXPECT_EQ(quote.ask, 150.30);
+    EXPECT_EQ(quote.timestamp_ns, 2);
+}
+
+TEST(MarketDataBusTest, TickStreamAndOverrun) {
+    auto name = unique_bus_name("ticks");
+    frontier::MarketDataBusWriter writer(name, 16, 8);
+    frontier::MarketDataBusReader reader(name);
+
+    for (int i = 0; i < 5; ++i) {
+        writer.publish(make_quote(i % 2 ? "MSFT" : "AAPL", 100.0 + i, 100.5 + i), i);
+    }
+
+    frontier_bus_quote ticks[16];
+    uint64_t dropped = 0;
+    ASSERT_EQ(reader.poll_ticks(ticks, 16, &dropped), 5u);
+    EXPECT_EQ(dropped, 0u);
+    EXPECT_STREQ(ticks[0].symbol, "AAPL");
+    EXPECT_STREQ(ticks[1].symbol, "MSFT");
+    EXPECT_EQ(ticks[4].bid, 104.0);
+
+    // Lap the ring: only the newest 8 ticks survive
+    for (int i = 0; i < 20; ++i) {
+        writer.publish(make_quote("AAPL", 200.0 + i, 200.5 + i), 100 + i);
+    }
+    ASSERT_EQ(reader.poll_ticks(ticks, 16, &dropped), 8u);
+    EXPECT_EQ(dropped, 12u);
+    EXPECT_EQ(ticks[7].bid, 219.0);
+}
+
+TEST(MarketDataBusTest, CInterfaceAndEnginePublish) {
+    auto name = unique_bus_name("engine");
+    auto writer = std::make_shared<frontier::MarketDataBusWriter>(name, 16, 64);
+    frontier::TradingEngine engine;
+    engine.attach_market_data_bus(writer);
+
+    frontier_bus* bus = frontier_bus_open(name.c_str());
+    ASSERT_NE(bus, nullptr);
+
+    engine.update_market_data(make_quote("GOOGL", 2800.00, 2800.50));
+
+    int32_t slot = frontier_bus_find_symbol(bus, "GOOGL");
+    ASSERT_GE(slot, 0);
+    frontier_bus_quote quote{};
+    ASSERT_EQ(frontier_bus_read_quote(bus, static_cast<uint32_t>(slot), &quote), 1);
+    EXPECT_EQ(quote.ask, 2800.50);
+
+    frontier_bus_quote ticks[4];
+    EXPECT_EQ(frontier_bus_poll_ticks(bus, ticks, 4, nullptr), 1u);
+
+    frontier_bus_close(bus);
+    EXPECT_EQ(frontier_bus_open("/frontier_test_missing_bus"), nullptr);
+}
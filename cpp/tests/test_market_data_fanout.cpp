@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "frontier/engine.hpp"
+#include "frontier/http_wire.hpp"
+#include <cmath>
+#include <limits>
+#include <map>
+#include <nlohmann/json.hpp>
+
+namespace {
+
+frontier::MarketData quote(const std::string& symbol, double last) {
+    frontier::MarketData data;
+    data.symbol = symbol;
+    data.bid = last - 0.01;
+    data.ask = last + 0.01;
+    data.last = last;
+    return data;
+}
+
+// Flush into per-session message lists, unwrapping WebSocket frames
+std::map<uint64_t, std::vector<std::string>> drain(frontier::MarketDataFanout& fanout) {
+    std::map<uint64_t, std::vector<std::string>> out;
+    fanout.flush([&](uint64_t session, std::string_view bytes) {
+        frontier::wire::WsParser parser;
+        parser.feed(bytes.data(), bytes.size());
+        frontier::wire::WsFrame message;
+        while (parser.next(message)) {
+            out[session].push_back(message.payload);
+        }
+    });
+    return out;
+}
+
+} // namespace
+
+TEST(MarketDataFanoutTest, CoalescesPerSessionAndSerializesOnce) {
+    auto fanout = std::make_shared<frontier::MarketDataFanout>();
+    frontier::TradingEngine engine;
+    engine.attach_market_data_fanout(fanout);
+
+    uint64_t watchlist = fanout->open_session();
+    uint64_t panel = fanout->open_session();
+    EXPECT_EQ(fanout->subscribe(watchlist, {"AAPL", "MSFT", "AAPL"}), 2u);
+    EXPECT_EQ(fanout->subscribe(panel, {"AAPL"}), 1u);
+
+    // Three AAPL ticks between flushes reach each session once, as the latest
+    engine.update_market_data(quote("AAPL", 190.0));
+    engine.update_market_data(quote("AAPL", 190.5));
+    engine.update_market_data(quote("MSFT", 410.0));
+    engine.update_market_data(quote("AAPL", 191.0));
+    engine.update_market_data(quote("TSLA", 250.0));   // Nobody watches; never serialized
+    EXPECT_EQ(fanout->frames_serialized(), 4u);
+
+    auto sent = drain(*fanout);
+    ASSERT_EQ(sent[watchlist].size(), 2u);
+    auto first = nlohmann::json::parse(sent[watchlist][0]);
+    EXPECT_EQ(first["symbol"], "AAPL");
+    EXPECT_DOUBLE_EQ(first["last"].get<double>(), 191.0);
+    EXPECT_EQ(nlohmann::json::parse(sent[watchlist][1])["symbol"], "MSFT");
+    ASSERT_EQ(sent[panel].size(), 1u);
+    EXPECT_EQ(nlohmann::json::parse(sent[panel][0])["last"], 191.0);
+    EXPECT_TRUE(drain(*fanout).empty());
+
+    // Unsubscribing a pending symbol drops it; a closed session's id goes stale
+    engine.update_market_data(quote("AAPL", 192.0));
+    engine.update_market_data(quote("MSFT", 411.0));
+    EXPECT_EQ(fanout->unsubscribe(watchlist, {"AAPL"}), 1u);
+    fanout->close_session(panel);
+    uint64_t reused = fanout->open_session();
+    EXPECT_NE(reused, panel);
+    EXPECT_EQ(fanout->subscribe(panel, {"MSFT"}), 0u);
+    sent = drain(*fanout);
+    EXPECT_EQ(sent.size(), 1u);
+    ASSERT_EQ(sent[watchlist].size(), 1u);
+    EXPECT_EQ(nlohmann::json::parse(sent[watchlist][0])["symbol"], "MSFT");
+    EXPECT_EQ(fanout->subscriber_count("AAPL"), 0u);
+    EXPECT_EQ(fanout->subscriber_count("MSFT"), 1u);
+    EXPECT_EQ(fanout->session_count(), 2u);
+}
+
+TEST(MarketDataFanoutTest, QuotesStayValidJson) {
+    frontier::MarketDataFanout fanout;
+    uint64_t session = fanout.open_session();
+    std::string odd = "A\"B\\C\n";
+    std::string long_symbol(300, 'X');
+    fanout.subscribe(session, {odd, long_symbol, "NAN"});
+
+    auto nan = quote("NAN", 10.0);
+    nan.bid = std::nan("");
+    nan.ask = std::numeric_limits<double>::infinity();
+    fanout.publish(quote(odd, 10.0), 1);
+    fanout.publish(quote(long_symbol, 20.0), 2);
+    fanout.publish(nan, 3);
+
+    auto sent = drain(fanout)[session];
+    ASSERT_EQ(sent.size(), 3u);
+    std::map<std::string, nlohmann::json> by_symbol;
+    for (const auto& text : sent) {
+        auto message = nlohmann::json::parse(text);
+        by_symbol[message["symbol"].get<std::string>()] = message;
+    }
+    EXPECT_DOUBLE_EQ(by_symbol.at(odd)["last"].get<double>(), 10.0);
+    EXPECT_EQ(by_symbol.at(long_symbol)["ts"], 2);
+    EXPECT_DOUBLE_EQ(by_symbol.at(long_symbol)["last"].get<double>(), 20.0);
+    EXPECT_TRUE(by_symbol.at("NAN")["bid"].is_null());
+    EXPECT_TRUE(by_symbol.at("NAN")["ask"].is_null());
+    EXPECT_DOUBLE_EQ(by_symbol.at("NAN")["last"].get<double>(), 10.0);
+}
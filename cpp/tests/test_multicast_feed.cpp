@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include "feed/multicast_feed.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+trading::feedwire::Tick wireTick(const std::string& symbol, double bid, double ask) {
+    trading::MarketTick tick;
+    tick.asset.symbol = symbol;
+    tick.bid = trading::Price(bid);
+    tick.ask = trading::Price(ask);
+    tick.last = trading::Price(ask);
+    tick.bidSize = trading::Quantity(300);
+    tick.askSize = trading::Quantity(200);
+    tick.volume = trading::Quantity(12345);
+    tick.timestamp = std::chrono::system_clock::time_point(std::chrono::nanoseconds(1767225600123456789LL));
+    trading::feedwire::Tick wire;
+    trading::feedwire::encodeTick(tick, wire);
+    return wire;
+}
+
+std::string packet(uint64_t sequence, std::vector<trading::feedwire::Tick> ticks) {
+    char out[trading::feedwire::MAX_PACKET];
+    size_t length = trading::feedwire::encodePacket(trading::feedwire::PacketType::TICKS, sequence, ticks.data(),
+                                                    ticks.size(), 0, out);
+    return std::string(out, length);
+}
+
+} // namespace
+
+TEST(MulticastFeedTest, DecodesAndReordersLatePackets) {
+    std::vector<uint64_t> sequences;
+    std::vector<trading::MarketTick> ticks;
+    trading::MulticastFeedReceiver receiver({}, [&](const trading::MarketTick& tick, uint64_t sequence) {
+        sequences.push_back(sequence);
+        ticks.push_back(tick);
+    });
+    auto feed = [&](const std::string& bytes) {
+        return receiver.processPacket(bytes.data(), bytes.size(), trading::MulticastFeedReceiver::Clock::now());
+    };
+
+    EXPECT_EQ(feed(packet(1, {wireTick("AAPL", 150.25, 150.27), wireTick("MSFT", 410.5, 410.52)})), 2u);
+    EXPECT_EQ(feed(packet(5, {wireTick("AAPL", 150.26, 150.28)})), 0u);   // 3 and 4 are late
+    EXPECT_EQ(feed(packet(3, {wireTick("MSFT", 410.51, 410.53), wireTick("AAPL", 150.24, 150.26)})), 3u);
+    EXPECT_EQ(feed(packet(2, {wireTick("MSFT", 1.0, 2.0)})), 0u);         // Duplicate
+    EXPECT_EQ(feed("garbage"), 0u);
+
+    EXPECT_EQ(sequences, (std::vector<uint64_t>{1, 2, 3, 4, 5}));
+    EXPECT_EQ(ticks[0].asset.symbol, "AAPL");
+    EXPECT_DOUBLE_EQ(ticks[0].bid.value, 150.25);
+    EXPECT_DOUBLE_EQ(ticks[0].ask.value, 150.27);
+    EXPECT_DOUBLE_EQ(ticks[0].bidSize.value, 300);
+    EXPECT_DOUBLE_EQ(ticks[0].volume.value, 12345);
+    EXPECT_EQ(std::chrono::duration_cast<std::chrono::nanoseconds>(ticks[0].timestamp.time_since_epoch()).count(),
+              1767225600123456789LL);
+    EXPECT_EQ(ticks[4].asset.symbol, "AAPL");
+    EXPECT_DOUBLE_EQ(ticks[4].bid.value, 150.26);
+
+    const trading::FeedStats& stats = receiver.getStats();
+    EXPECT_EQ(stats.gaps, 1u);
+    EXPECT_EQ(stats.reordered, 1u);
+    EXPECT_EQ(stats.duplicates, 1u);
+    EXPECT_EQ(stats.malformed, 1u);
+    EXPECT_EQ(receiver.getExpectedSequence(), 6u);
+    EXPECT_FALSE(receiver.isRecovering());
+}
+
+TEST(MulticastFeedTest, RecoversLostPacketsFromSnapshot) {
+    trading::MulticastFeedConfig config;
+    config.bindAddress = "127.0.0.1";
+    config.gapTimeout = 5ms;
+    std::vector<std::pair<std::string, uint64_t>> received;
+    trading::MulticastFeedReceiver receiver(config, [&](const trading::MarketTick& tick, uint64_t sequence) {
+        received.emplace_back(tick.asset.symbol, sequence);
+    });
+    receiver.open();
+    trading::MulticastFeedPublisher publisher("127.0.0.1", receiver.getPort());
+    receiver.setSnapshotSource("127.0.0.1", publisher.getSnapshotPort());
+
+    auto tick = [](const std::string& symbol, double price) {
+        trading::MarketTick t;
+        t.asset.symbol = symbol;
+        t.bid = trading::Price(price);
+        t.ask = trading::Price(price + 0.01);
+        return t;
+    };
+    auto pumpUntil = [&](const std::function<bool()>& done) {
+        auto deadline = std::chrono::steady_clock::now() + 2s;
+        while (!done() && std::chrono::steady_clock::now() < deadline) {
+            receiver.poll(5);
+            publisher.serveSnapshots();
+        }
+        return done();
+    };
+
+    publisher.publish(tick("AAPL", 150.0));
+    publisher.publish(tick("MSFT", 410.0));
+    publisher.flush();
+    ASSERT_TRUE(pumpUntil([&] { return received.size() == 2; }));
+
+    // Sequences 3-5 never arrive; 6 waits behind the gap until the snapshot as of 6
+    publisher.skip(3);
+    publisher.publish(tick("AAPL", 151.0));
+    publisher.flush();
+    ASSERT_TRUE(pumpUntil([&] { return receiver.getStats().snapshotsApplied == 1; }));
+    EXPECT_EQ(receiver.getExpectedSequence(), 7u);
+    EXPECT_FALSE(receiver.isRecovering());
+    ASSERT_EQ(received.size(), 4u);
+    EXPECT_EQ(received[2].second, 6u);
+    EXPECT_EQ(received[3].second, 6u);
+
+    publisher.publish(tick("MSFT", 411.0));
+    publisher.flush();
+    ASSERT_TRUE(pumpUntil([&] { return received.size() == 5; }));
+    EXPECT_EQ(received[4], std::make_pair(std::string("MSFT"), uint64_t{7}));
+
+    const trading::FeedStats& stats = receiver.getStats();
+    EXPECT_EQ(stats.gaps, 1u);
+    EXPECT_GE(stats.snapshotRequests, 1u);
+    EXPECT_EQ(stats.reordered, 0u);   // The buffered tick was superseded by the snapshot
+}
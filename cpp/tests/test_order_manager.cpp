@@ -0,0 +1,583 @@
+#include <gtest/gtest.h>
+#include "engine/clock.h"
+#include "engine/order_manager.h"
+#include "frontier/rpc.hpp"
+#include <random>
+
+namespace {
+
+trading::Order makeOrder(const std::string& symbol, trading::OrderSide side, double quantity,
+                         std::optional<double> limit = std::nullopt) {
+    trading::Order order;
+    order.asset = trading::Asset(symbol, "NASDAQ", trading::AssetType::STOCK);
+    order.side = side;
+    order.quantity = trading::Quantity(quantity);
+    if (limit) {
+        order.type = trading::OrderType::LIMIT;
+        order.limitPrice = trading::Price(*limit);
+    }
+    return order;
+}
+
+trading::MarketTick makeTick(const std::string& symbol, double bid, double ask, double last) {
+    trading::MarketTick tick;
+    tick.asset = trading::Asset(symbol, "NASDAQ", trading::AssetType::STOCK);
+    tick.bid = trading::Price(bid);
+    tick.ask = trading::Price(ask);
+    tick.last = trading::Price(last);
+    return tick;
+}
+
+} // namespace
+
+class OrderManagerTest : public ::testing::Test {
+protected:
+    trading::OrderManager manager_;
+};
+
+TEST_F(OrderManagerTest, LimitOrderFillsWhenMarketCrosses) {
+    auto id = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 150.00));
+    ASSERT_FALSE(id.empty());
+    EXPECT_EQ(manager_.getActiveOrderCount(), 1u);
+    EXPECT_EQ(manager_.getOrderBook("AAPL").getBestBid().value, 150.00);
+
+    manager_.processMarketTick(makeTick("AAPL", 150.10, 150.20, 150.15));
+    EXPECT_EQ(manager_.getOrder(id).status, trading::OrderStatus::PENDING);
+
+    manager_.processMarketTick(makeTick("AAPL", 149.90, 149.95, 149.92));
+    auto order = manager_.getOrder(id);
+    EXPECT_EQ(order.status, trading::OrderStatus::FILLED);
+    EXPECT_DOUBLE_EQ(order.averageFillPrice.value, 149.95);
+    EXPECT_EQ(manager_.getActiveOrderCount(), 0u);
+    EXPECT_TRUE(manager_.getOrderBook("AAPL").getTopLevels().first.empty());
+}
+
+TEST_F(OrderManagerTest, AuctionAccumulatesWithoutMatching) {
+    manager_.processMarketTick(makeTick("AAPL", 150.00, 150.10, 150.05));
+    manager_.startAuction("AAPL");
+
+    auto buy = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 151.00));
+    manager_.processMarketTick(makeTick("AAPL", 149.00, 149.10, 149.05));
+
+    EXPECT_EQ(manager_.getTradingPhase("AAPL"), trading::TradingPhase::AUCTION);
+    EXPECT_EQ(manager_.getOrder(buy).status, trading::OrderStatus::PENDING);
+}
+
+TEST_F(OrderManagerTest, UncrossMaximizesExecutableVolume) {
+    std::vector<std::pair<std::string, trading::AuctionUncross>> published;
+    manager_.setIndicativePriceCallback([&](const std::string& symbol, const trading::AuctionUncross& u) {
+        published.emplace_back(symbol, u);
+    });
+    manager_.startAuction("AAPL");
+
+    // Demand: 300 @ >=10.00, 200 @ >=10.10, 100 @ >=10.20
+    // Supply: 150 @ <=10.00, 250 @ <=10.10, 400 @ <=10.20
+    auto b1 = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 10.20));
+    auto b2 = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 10.10));
+    auto b3 = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 10.00));
+    auto s1 = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::SELL, 150, 10.00));
+    auto s2 = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::SELL, 100, 10.10));
+    auto s3 = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::SELL, 150, 10.20));
+
+    auto indicative = manager_.getIndicativeUncross("AAPL");
+    ASSERT_TRUE(indicative.valid);
+    EXPECT_DOUBLE_EQ(indicative.price.value, 10.10);
+    EXPECT_DOUBLE_EQ(indicative.matchedQuantity, 200.0);
+    EXPECT_DOUBLE_EQ(indicative.imbalance(), -50.0);
+
+    ASSERT_FALSE(published.empty());
+    EXPECT_DOUBLE_EQ(published.back().second.price.value, 10.10);
+
+    auto uncross = manager_.uncrossAuction("AAPL");
+    EXPECT_DOUBLE_EQ(uncross.price.value, 10.10);
+    EXPECT_EQ(manager_.getTradingPhase("AAPL"), trading::TradingPhase::CONTINUOUS);
+
+    EXPECT_EQ(manager_.getOrder(b1).status, trading::OrderStatus::FILLED);
+    EXPECT_EQ(manager_.getOrder(b2).status, trading::OrderStatus::FILLED);
+    EXPECT_EQ(manager_.getOrder(b3).status, trading::OrderStatus::PENDING);
+    EXPECT_EQ(manager_.getOrder(s1).status, trading::OrderStatus::FILLED);
+    EXPECT_DOUBLE_EQ(manager_.getOrder(s2).filledQuantity.value, 50.0);
+    EXPECT_EQ(manager_.getOrder(s3).status, trading::OrderStatus::PENDING);
+
+    for (const auto& trade : manager_.getOrderTrades(s2)) {
+        EXPECT_DOUBLE_EQ(trade.price.value, 10.10);
+    }
+}
+
+TEST_F(OrderManagerTest, UntriggeredStopsStayOutOfTheAuction) {
+    manager_.startAuction("AAPL");
+    auto stop = makeOrder("AAPL", trading::OrderSide::BUY, 100, 10.50);
+    stop.type = trading::OrderType::STOP_LIMIT;
+    stop.stopPrice = trading::Price(11.00);
+    auto stopId = manager_.submitOrder(stop);
+    auto sell = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::SELL, 100, 10.00));
+
+    EXPECT_TRUE(manager_.getOrderBook("AAPL").getTopLevels().first.empty());
+    EXPECT_FALSE(manager_.getIndicativeUncross("AAPL").valid);
+    manager_.uncrossAuction("AAPL");
+    EXPECT_EQ(manager_.getOrder(stopId).status, trading::OrderStatus::PENDING);
+    EXPECT_EQ(manager_.getOrder(sell).status, trading::OrderStatus::PENDING);
+
+    // Triggered, it joins the book as a limit at 10.50
+    manager_.processMarketTick(makeTick("AAPL", 10.90, 11.10, 11.00));
+    EXPECT_EQ(manager_.getOrder(stopId).type, trading::OrderType::LIMIT);
+    auto bids = manager_.getOrderBook("AAPL").getTopLevels().first;
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_DOUBLE_EQ(bids.front().price.value, 10.50);
+}
+
+TEST_F(OrderManagerTest, UncrossPrefersReferencePriceOnTies) {
+    manager_.processMarketTick(makeTick("MSFT", 0, 0, 20.40));
+    manager_.startAuction("MSFT");
+
+    manager_.submitOrder(makeOrder("MSFT", trading::OrderSide::BUY, 100, 20.50));
+    manager_.submitOrder(makeOrder("MSFT", trading::OrderSide::SELL, 100, 20.00));
+
+    // Every price between 20.00 and 20.50 matches 100 with no imbalance
+    auto indicative = manager_.getIndicativeUncross("MSFT");
+    EXPECT_DOUBLE_EQ(indicative.price.value, 20.50);
+    EXPECT_DOUBLE_EQ(indicative.matchedQuantity, 100.0);
+}
+
+TEST_F(OrderManagerTest, UnfilledAuctionMarketOrdersExpire) {
+    manager_.processMarketTick(makeTick("TSLA", 0, 0, 200.00));
+    manager_.startAuction("TSLA");
+
+    auto buy = manager_.submitOrder(makeOrder("TSLA", trading::OrderSide::BUY, 300));
+    auto sell = manager_.submitOrder(makeOrder("TSLA", trading::OrderSide::SELL, 100, 199.00));
+
+    auto uncross = manager_.uncrossAuction("TSLA");
+    EXPECT_DOUBLE_EQ(uncross.matchedQuantity, 100.0);
+    EXPECT_EQ(manager_.getOrder(sell).status, trading::OrderStatus::FILLED);
+
+    auto order = manager_.getOrder(buy);
+    EXPECT_EQ(order.status, trading::OrderStatus::EXPIRED);
+    EXPECT_DOUBLE_EQ(order.filledQuantity.value, 100.0);
+}
+
+TEST_F(OrderManagerTest, LargeAuctionUncross) {
+    manager_.startAuction("SPY");
+
+    for (int i = 0; i < 50000; ++i) {
+        double quantity = 1 + i % 7;
+        manager_.submitOrder(makeOrder("SPY", trading::OrderSide::BUY, quantity, 400.00 + (i % 500) * 0.01));
+        manager_.submitOrder(makeOrder("SPY", trading::OrderSide::SELL, quantity, 402.00 + (i % 500) * 0.01));
+    }
+    ASSERT_EQ(manager_.getActiveOrderCount(), 100000u);
+
+    auto indicative = manager_.getIndicativeUncross("SPY");
+    auto uncross = manager_.uncrossAuction("SPY");
+    ASSERT_TRUE(uncross.valid);
+    EXPECT_EQ(uncross, indicative);
+    EXPECT_GE(uncross.price.value, 402.00);
+    EXPECT_LE(uncross.price.value, 404.99);
+
+    auto book = manager_.getOrderBook("SPY");
+    EXPECT_LT(book.getBestBid(), book.getBestAsk());
+}
+
+TEST_F(OrderManagerTest, SecondaryIndexesTrackTransitions) {
+    auto submit = [&](const std::string& symbol, const std::string& account, double quantity, double limit) {
+        auto order = makeOrder(symbol, trading::OrderSide::BUY, quantity, limit);
+        order.accountId = account;
+        return manager_.submitOrder(order);
+    };
+    auto a1 = submit("AAPL", "ACC-1", 100, 150.00);
+    auto m1 = submit("MSFT", "ACC-1", 50, 300.00);
+    auto a2 = submit("AAPL", "ACC-2", 200, 149.00);
+
+    {
+        auto view = manager_.viewOrdersBySymbol("AAPL");
+        ASSERT_EQ(view.size(), 2u);
+        std::vector<std::string> ids;
+        for (const auto& order : view) ids.push_back(order.id);
+        EXPECT_EQ(ids, (std::vector<std::string>{a1, a2}));
+    }
+    EXPECT_EQ(manager_.viewOrdersByAccount("ACC-1").size(), 2u);
+    EXPECT_EQ(manager_.viewOrdersByStatus(trading::OrderStatus::PENDING).size(), 3u);
+    EXPECT_TRUE(manager_.viewOrdersBySymbol("TSLA").empty());
+
+    // Partial fill moves the order between status lists
+    auto tick = makeTick("AAPL", 149.50, 149.90, 149.70);
+    tick.askSize = trading::Quantity(40);
+    manager_.processMarketTick(tick);
+    {
+        auto partial = manager_.viewOrdersByStatus(trading::OrderStatus::PARTIAL);
+        ASSERT_EQ(partial.size(), 1u);
+        EXPECT_EQ(partial.begin()->id, a1);
+        EXPECT_DOUBLE_EQ(partial.begin()->filledQuantity.value, 40.0);
+    }
+    EXPECT_EQ(manager_.viewOrdersByStatus(trading::OrderStatus::PENDING).size(), 2u);
+
+    // Terminal states leave every index
+    ASSERT_TRUE(manager_.cancelOrder(m1));
+    EXPECT_EQ(manager_.viewOrdersByAccount("ACC-1").size(), 1u);
+    EXPECT_TRUE(manager_.viewOrdersBySymbol("MSFT").empty());
+    EXPECT_EQ(manager_.getOrdersBySymbol("AAPL").size(), 2u);
+
+    manager_.cancelAllOrders();
+    EXPECT_TRUE(manager_.viewOrdersByStatus(trading::OrderStatus::PENDING).empty());
+    EXPECT_TRUE(manager_.viewOrdersByStatus(trading::OrderStatus::PARTIAL).empty());
+    EXPECT_TRUE(manager_.viewOrdersByAccount("ACC-2").empty());
+}
+
+TEST_F(OrderManagerTest, MassCancelByScope) {
+    auto submit = [&](const std::string& symbol, const std::string& account, trading::OrderSide side, double limit) {
+        auto order = makeOrder(symbol, side, 10, limit);
+        order.accountId = account;
+        return manager_.submitOrder(order);
+    };
+    submit("AAPL", "ACC-1", trading::OrderSide::BUY, 150.00);
+    submit("AAPL", "ACC-1", trading::OrderSide::SELL, 151.00);
+    submit("MSFT", "ACC-1", trading::OrderSide::BUY, 300.00);
+    auto kept = submit("AAPL", "ACC-2", trading::OrderSide::BUY, 150.00);
+
+    size_t batches = 0;
+    std::vector<trading::Order> cancelled;
+    manager_.setMassCancelCallback([&](const std::vector<trading::Order>& orders) {
+        ++batches;
+        cancelled.insert(cancelled.end(), orders.begin(), orders.end());
+    });
+
+    trading::MassCancelScope sells;
+    sells.symbol = "AAPL";
+    sells.side = trading::OrderSide::SELL;
+    EXPECT_EQ(manager_.massCancel(sells), 1u);
+    EXPECT_TRUE(manager_.getOrderBook("AAPL").getTopLevels().second.empty());
+
+    trading::MassCancelScope account;
+    account.accountId = "ACC-1";
+    EXPECT_EQ(manager_.massCancel(account), 2u);
+    EXPECT_EQ(batches, 2u);
+    ASSERT_EQ(cancelled.size(), 3u);
+    for (const auto& order : cancelled) {
+        EXPECT_EQ(order.status, trading::OrderStatus::CANCELLED);
+        EXPECT_EQ(order.accountId, "ACC-1");
+    }
+
+    // The other account's order at the same level keeps its place
+    EXPECT_EQ(manager_.getActiveOrderCount(), 1u);
+    auto bids = manager_.getOrderBook("AAPL").getTopLevels().first;
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_DOUBLE_EQ(bids[0].quantity.value, 10.0);
+    EXPECT_EQ(manager_.getOrder(kept).status, trading::OrderStatus::PENDING);
+    EXPECT_TRUE(manager_.getOrderBook("MSFT").getTopLevels().first.empty());
+    EXPECT_EQ(manager_.massCancel(account), 0u);
+}
+
+TEST(OrderBookSideTest, BatchRemovalSettlesEachLevelOnce) {
+    trading::OrderBookSide bids(true);
+    bids.setDepthLevels(2);
+    std::vector<trading::Order> orders;
+    for (int i = 0; i < 12; ++i) {
+        auto order = makeOrder("SPY", trading::OrderSide::BUY, 10 + i, 100.00 - (i % 4) * 0.01);
+        order.id = "B" + std::to_string(i);
+        bids.addOrder(order);
+        orders.push_back(order);
+    }
+
+    // Clears 100.00 whole and takes one order from 99.99; a repeated order counts once
+    std::vector<const trading::Order*> batch{&orders[0], &orders[4], &orders[8], &orders[1], &orders[0]};
+    bids.removeOrders(batch);
+
+    ASSERT_EQ(bids.getLevels().size(), 3u);
+    EXPECT_DOUBLE_EQ(bids.getTotalQuantity(), 186.0 - (10 + 14 + 18 + 11));
+    const auto& depth = bids.getDepth();
+    EXPECT_EQ(depth.levels, 2u);
+    EXPECT_DOUBLE_EQ(depth.bestPrice, 99.99);
+    EXPECT_DOUBLE_EQ(depth.bestQuantity, 15 + 19);
+    EXPECT_DOUBLE_EQ(depth.boundary, 99.98);
+    EXPECT_FALSE(bids.getRestingPrice("B4").has_value());
+    EXPECT_TRUE(bids.getRestingPrice("B5").has_value());
+}
+
+TEST_F(OrderManagerTest, CompletedOrdersAreRetainedUpToTheLimit) {
+    manager_.setCompletedOrderRetention(2);
+    std::vector<std::string> ids;
+    for (int i = 0; i < 3; ++i) {
+        ids.push_back(manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 10, 100.00 + i)));
+        EXPECT_TRUE(manager_.cancelOrder(ids.back()));
+    }
+
+    EXPECT_EQ(manager_.getCompletedOrderCount(), 2u);
+    EXPECT_TRUE(manager_.getOrder(ids[0]).id.empty());
+    EXPECT_EQ(manager_.getOrder(ids[1]).status, trading::OrderStatus::CANCELLED);
+    EXPECT_EQ(manager_.getOrder(ids[2]).status, trading::OrderStatus::CANCELLED);
+
+    manager_.setCompletedOrderRetention(0);
+    EXPECT_EQ(manager_.getCompletedOrderCount(), 0u);
+    EXPECT_TRUE(manager_.getOrder(ids[2]).id.empty());
+}
+
+TEST_F(OrderManagerTest, KillSwitchOverLargeBook) {
+    for (int i = 0; i < 50000; ++i) {
+        auto order = makeOrder(i % 2 ? "SPY" : "QQQ", trading::OrderSide::BUY, 1, 400.00 - (i % 200) * 0.01);
+        order.accountId = i % 10 ? "FUND" : "OTHER";
+        manager_.submitOrder(order);
+    }
+
+    trading::MassCancelScope scope;
+    scope.accountId = "FUND";
+    EXPECT_EQ(manager_.massCancel(scope), 45000u);
+    EXPECT_EQ(manager_.getActiveOrderCount(), 5000u);
+    EXPECT_TRUE(manager_.viewOrdersByAccount("FUND").empty());
+
+    double resting = 0.0;
+    for (const auto& symbol : {"SPY", "QQQ"}) {
+        for (const auto& level : manager_.getOrderBook(symbol).getTopLevels(1000).first) {
+            resting += level.quantity.value;
+        }
+    }
+    EXPECT_DOUBLE_EQ(resting, 5000.0);
+}
+
+TEST_F(OrderManagerTest, AmendKeepsOrLosesQueuePriority) {
+    manager_.startAuction("AAPL");
+    auto a = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 10.00));
+    auto b = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 10.00));
+    auto c = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 10.00));
+
+    EXPECT_TRUE(manager_.amendOrder(a, 80.0));   // Smaller: stays first
+    EXPECT_TRUE(manager_.amendOrder(b, 150.0));  // Larger: goes behind c
+    EXPECT_FALSE(manager_.amendOrder(c, 0.0));
+    EXPECT_DOUBLE_EQ(manager_.getOrderBook("AAPL").getTopLevels().first.front().quantity.value, 330.0);
+
+    manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::SELL, 150, 10.00));
+    manager_.uncrossAuction("AAPL");
+
+    EXPECT_EQ(manager_.getOrder(a).status, trading::OrderStatus::FILLED);
+    EXPECT_DOUBLE_EQ(manager_.getOrder(a).filledQuantity.value, 80.0);
+    EXPECT_DOUBLE_EQ(manager_.getOrder(c).filledQuantity.value, 70.0);
+    EXPECT_DOUBLE_EQ(manager_.getOrder(b).filledQuantity.value, 0.0);
+}
+
+TEST(OrderManagerPriorityTest, BookAndManagerAgreeOnPriceChanges) {
+    auto clock = std::make_shared<trading::VirtualClock>();
+    trading::OrderManager manager(clock);
+    manager.startAuction("AAPL");
+    auto a = manager.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 100, 10.00));
+    auto stamped = manager.getOrder(a).timestamp;
+    clock->runFor(std::chrono::seconds(1));
+
+    // Within Price ==, but a different book level: the order loses priority in both
+    EXPECT_TRUE(manager.amendOrder(a, std::nullopt, trading::Price(10.001)));
+    EXPECT_EQ(manager.getOrderBook("AAPL").getTopLevels().first.front().price.value, 10.001);
+    EXPECT_GT(manager.getOrder(a).timestamp, stamped);
+}
+
+TEST_F(OrderManagerTest, AmendPriceMovesToBackOfNewLevel) {
+    manager_.processMarketTick(makeTick("MSFT", 19.90, 20.10, 20.00));
+    auto first = manager_.submitOrder(makeOrder("MSFT", trading::OrderSide::BUY, 100, 19.95));
+    auto moved = manager_.submitOrder(makeOrder("MSFT", trading::OrderSide::BUY, 100, 19.80));
+
+    EXPECT_TRUE(manager_.amendOrder(moved, std::nullopt, trading::Price(19.95)));
+    auto bids = manager_.getOrderBook("MSFT").getTopLevels().first;
+    ASSERT_EQ(bids.size(), 1u);
+    EXPECT_DOUBLE_EQ(bids.front().quantity.value, 200.0);
+    EXPECT_EQ(manager_.getOrder(moved).status, trading::OrderStatus::PENDING);
+
+    // Repricing through the offer executes immediately
+    EXPECT_TRUE(manager_.amendOrder(moved, std::nullopt, trading::Price(20.10)));
+    EXPECT_EQ(manager_.getOrder(moved).status, trading::OrderStatus::FILLED);
+    EXPECT_EQ(manager_.getOrder(first).status, trading::OrderStatus::PENDING);
+    EXPECT_DOUBLE_EQ(manager_.getOrderBook("MSFT").getTopLevels().first.front().quantity.value, 100.0);
+}
+
+TEST_F(OrderManagerTest, PeggedOrdersRepriceAsGroups) {
+    auto pegged = [](trading::PegType type, double offset) {
+        auto order = makeOrder("QQQ", trading::OrderSide::BUY, 100, 1.00);  // Price is replaced
+        order.pegType = type;
+        order.pegOffset = offset;
+        return order;
+    };
+    EXPECT_TRUE(manager_.submitOrder(pegged(trading::PegType::PRIMARY, 0.0)).empty());  // Nothing to peg to
+
+    manager_.processMarketTick(makeTick("QQQ", 10.00, 10.10, 10.05));
+    auto primary = manager_.submitOrder(pegged(trading::PegType::PRIMARY, 0.0));
+    manager_.submitOrder(pegged(trading::PegType::PRIMARY, 0.0));
+    auto mid = manager_.submitOrder(pegged(trading::PegType::MIDPOINT, 0.01));
+    manager_.submitOrder(makeOrder("QQQ", trading::OrderSide::BUY, 50, 9.90));
+    EXPECT_DOUBLE_EQ(manager_.getOrder(primary).limitPrice->value, 10.00);
+    EXPECT_DOUBLE_EQ(manager_.getOrder(mid).limitPrice->value, 10.04);
+
+    // The primary group lands on the plain 9.90 level and shows as one price
+    manager_.processMarketTick(makeTick("QQQ", 9.90, 10.00, 9.95));
+    auto bids = manager_.getOrderBook("QQQ").getTopLevels().first;
+    ASSERT_EQ(bids.size(), 2u);
+    EXPECT_DOUBLE_EQ(bids[0].price.value, 9.94);
+    EXPECT_DOUBLE_EQ(bids[1].price.value, 9.90);
+    EXPECT_DOUBLE_EQ(bids[1].quantity.value, 250.0);
+    EXPECT_DOUBLE_EQ(manager_.getOrder(primary).limitPrice->value, 9.90);
+    EXPECT_FALSE(manager_.amendOrder(primary, std::nullopt, trading::Price(9.50)));
+
+    // An aggressive offset becomes marketable once the quote tightens
+    auto aggressive = manager_.submitOrder(pegged(trading::PegType::PRIMARY, -0.05));
+    EXPECT_EQ(manager_.getOrder(aggressive).status, trading::OrderStatus::PENDING);
+    manager_.processMarketTick(makeTick("QQQ", 9.95, 9.99, 9.97));
+    auto filled = manager_.getOrder(aggressive);
+    EXPECT_EQ(filled.status, trading::OrderStatus::FILLED);
+    EXPECT_DOUBLE_EQ(filled.averageFillPrice.value, 9.99);
+    EXPECT_EQ(manager_.getOrder(mid).status, trading::OrderStatus::PENDING);
+}
+
+TEST_F(OrderManagerTest, CommandLanesServeCancelsFirst) {
+    auto resting = manager_.submitOrder(makeOrder("IBM", trading::OrderSide::BUY, 10, 100.00));
+    manager_.setRiskReducingPredicate([](const trading::Order& o) { return o.side == trading::OrderSide::SELL; });
+
+    trading::EngineCommand newOrder;
+    newOrder.order = makeOrder("IBM", trading::OrderSide::BUY, 10, 99.00);
+    for (int i = 0; i < 1000; ++i) {
+        manager_.enqueueCommand(newOrder);
+    }
+    trading::EngineCommand amend;
+    amend.type = trading::CommandType::AMEND;
+    amend.orderId = resting;
+    amend.newQuantity = 5.0;
+    manager_.enqueueCommand(amend);
+    trading::EngineCommand cancel;
+    cancel.type = trading::CommandType::CANCEL;
+    cancel.orderId = resting;
+    manager_.enqueueCommand(cancel);
+    trading::EngineCommand reducing;
+    reducing.order = makeOrder("IBM", trading::OrderSide::SELL, 10, 101.00);
+    auto sell = manager_.enqueueCommand(reducing);
+
+    // The cancel and the risk-reducing sell overtake a thousand new orders
+    EXPECT_EQ(manager_.processCommands(2), 2u);
+    EXPECT_EQ(manager_.getOrder(resting).status, trading::OrderStatus::CANCELLED);
+    EXPECT_EQ(manager_.getOrder(sell).status, trading::OrderStatus::PENDING);
+    EXPECT_EQ(manager_.getActiveOrderCount(), 1u);
+
+    auto priority = manager_.getLaneStats(trading::CommandLane::PRIORITY);
+    auto fresh = manager_.getLaneStats(trading::CommandLane::NEW_ORDER);
+    EXPECT_EQ(priority.processed, 2u);
+    EXPECT_EQ(priority.depth, 0u);
+    EXPECT_EQ(fresh.depth, 1000u);
+    EXPECT_EQ(fresh.maxDepth, 1000u);
+    EXPECT_EQ(fresh.processed, 0u);
+
+    EXPECT_EQ(manager_.processCommands(), 1001u);
+    EXPECT_EQ(manager_.getActiveOrderCount(), 1001u);
+    EXPECT_EQ(manager_.getLaneStats(trading::CommandLane::AMEND).processed, 1u);
+    EXPECT_EQ(manager_.getQueuedCommandCount(), 0u);
+}
+
+TEST_F(OrderManagerTest, RefusedQueuedOrderIsReportedRejected) {
+    std::vector<trading::Order> updates;
+    manager_.setOrderUpdateCallback([&](const trading::Order& order) { updates.push_back(order); });
+
+    trading::EngineCommand pegged;
+    pegged.order = makeOrder("IBM", trading::OrderSide::BUY, 10, 99.00);
+    pegged.order.pegType = trading::PegType::PRIMARY;  // No quote yet to peg to
+    auto id = manager_.enqueueCommand(pegged);
+    EXPECT_EQ(manager_.processCommands(), 1u);
+
+    ASSERT_EQ(updates.size(), 1u);
+    EXPECT_EQ(updates[0].id, id);
+    EXPECT_EQ(updates[0].status, trading::OrderStatus::REJECTED);
+    EXPECT_EQ(manager_.getOrder(id).status, trading::OrderStatus::REJECTED);
+    EXPECT_EQ(manager_.getActiveOrderCount(), 0u);
+}
+
+TEST_F(OrderManagerTest, QueuedCommandsWaitForTheirOrder) {
+    trading::EngineCommand newOrder;
+    newOrder.order = makeOrder("IBM", trading::OrderSide::BUY, 100, 99.00);
+    auto amended = manager_.enqueueCommand(newOrder);
+    auto cancelled = manager_.enqueueCommand(newOrder);
+
+    trading::EngineCommand amend;
+    amend.type = trading::CommandType::AMEND;
+    amend.orderId = amended;
+    amend.newQuantity = 40.0;
+    manager_.enqueueCommand(amend);
+    trading::EngineCommand cancel;
+    cancel.type = trading::CommandType::CANCEL;
+    cancel.orderId = cancelled;
+    manager_.enqueueCommand(cancel);
+
+    EXPECT_EQ(manager_.processCommands(), 4u);
+    EXPECT_DOUBLE_EQ(manager_.getOrder(amended).quantity.value, 40.0);
+    EXPECT_EQ(manager_.getOrder(cancelled).status, trading::OrderStatus::CANCELLED);
+    EXPECT_DOUBLE_EQ(manager_.getOrderBook("IBM").getTopLevels().first.front().quantity.value, 40.0);
+}
+
+TEST(BookSignalsTest, IncrementalSignalsMatchRecomputedBook) {
+    trading::OrderBook book("SPY");
+    book.setSignalDepth(3);
+    std::vector<trading::Order> resting;
+    std::mt19937 rng(7);
+    double bidQ = 0.0, bidP = 0.0, askQ = 0.0, askP = 0.0, ofi = 0.0;
+
+    for (int i = 0; i < 2000; ++i) {
+        int action = resting.empty() ? 0 : static_cast<int>(rng() % 4);
+        if (action <= 1) {
+            bool buy = rng() % 2;
+            auto order = makeOrder("SPY", buy ? trading::OrderSide::BUY : trading::OrderSide::SELL,
+                                   1 + rng() % 50, buy ? 99.90 + (rng() % 10) * 0.01 : 100.01 + (rng() % 10) * 0.01);
+            order.id = "O" + std::to_string(i);
+            book.addOrder(order);
+            resting.push_back(order);
+        } else {
+            size_t pick = rng() % resting.size();
+            trading::Order& order = resting[pick];
+            if (action == 2) {
+                book.removeOrder(order);
+                resting.erase(resting.begin() + static_cast<std::ptrdiff_t>(pick));
+            } else {
+                double step = order.side == trading::OrderSide::BUY ? -0.01 : 0.01;
+                order.limitPrice = trading::Price(order.limitPrice->value + step * static_cast<double>(rng() % 3));
+                order.quantity = trading::Quantity(1 + rng() % 50);
+                book.amendOrder(order, *order.limitPrice, order.quantity.value);
+            }
+        }
+
+        // Recompute everything from a snapshot of the top three levels
+        auto [bids, asks] = book.getTopLevels(3);
+        double nb = bids.empty() ? 0.0 : bids.front().quantity.value;
+        double pb = bids.empty() ? 0.0 : bids.front().price.value;
+        double na = asks.empty() ? 0.0 : asks.front().quantity.value;
+        double pa = asks.empty() ? 0.0 : asks.front().price.value;
+        double wb = 0.0, wa = 0.0;
+        for (size_t l = 0; l < bids.size(); ++l) wb += (1.0 - l / 3.0) * bids[l].quantity.value;
+        for (size_t l = 0; l < asks.size(); ++l) wa += (1.0 - l / 3.0) * asks[l].quantity.value;
+        if (pb != bidP || nb != bidQ || pa != askP || na != askQ) {
+            ofi += (pb >= bidP ? nb : 0.0) - (pb <= bidP ? bidQ : 0.0);
+            ofi += (asks.empty() || (askP > 0.0 && pa >= askP) ? askQ : 0.0) -
+                   (askP == 0.0 || (!asks.empty() && pa <= askP) ? na : 0.0);
+            bidP = pb, bidQ = nb, askP = pa, askQ = na;
+        }
+
+        const auto& signals = book.getSignals();
+        ASSERT_NEAR(signals.topImbalance, nb + na > 0 ? (nb - na) / (nb + na) : 0.0, 1e-9) << i;
+        ASSERT_NEAR(signals.depthImbalance, wb + wa > 0 ? (wb - wa) / (wb + wa) : 0.0, 1e-9) << i;
+        ASSERT_NEAR(signals.microprice, !bids.empty() && !asks.empty() ? (pb * na + pa * nb) / (nb + na) : 0.0, 1e-9);
+        ASSERT_NEAR(signals.orderFlowImbalance, ofi, 1e-6) << i;
+    }
+}
+
+TEST_F(OrderManagerTest, BookSignalsThroughManagerAndRpc) {
+    manager_.startAuction("AAPL");  // Keeps both sides resting
+    manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::BUY, 300, 10.00));
+    auto ask = manager_.submitOrder(makeOrder("AAPL", trading::OrderSide::SELL, 100, 10.10));
+
+    auto signals = manager_.getBookSignals("AAPL");
+    ASSERT_TRUE(signals.has_value());
+    EXPECT_NEAR(signals->microprice, (10.00 * 100 + 10.10 * 300) / 400.0, 1e-12);  // Leans toward the thin ask
+    EXPECT_NEAR(signals->topImbalance, 0.5, 1e-12);
+    EXPECT_NEAR(signals->orderFlowImbalance, 300.0 - 100.0, 1e-12);
+
+    // Ask improves: its whole size counts as new selling pressure
+    manager_.amendOrder(ask, std::nullopt, trading::Price(10.05));
+    EXPECT_NEAR(manager_.getBookSignals("AAPL")->orderFlowImbalance, 100.0, 1e-12);
+    EXPECT_FALSE(manager_.getBookSignals("MSFT").has_value());
+
+    auto engine = std::make_shared<frontier::TradingEngine>();
+    frontier::RpcServer rpc(engine);
+    rpc.attach_order_manager(std::shared_ptr<trading::OrderManager>(&manager_, [](trading::OrderManager*) {}));
+    nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", "get_book_signals"},
+                              {"params", {{"symbols", {"AAPL", "MSFT"}}}}, {"id", "1"}};
+    auto response = nlohmann::json::parse(rpc.handle_request(request.dump()));
+    EXPECT_NEAR(response["result"]["books"]["AAPL"]["ofi"].get<double>(), 100.0, 1e-12);
+    EXPECT_NEAR(response["result"]["books"]["AAPL"]["top_imbalance"].get<double>(), 0.5, 1e-12);
+    EXPECT_TRUE(response["result"]["books"]["MSFT"].is_null());
+}
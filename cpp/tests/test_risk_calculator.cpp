@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "risk/risk_manager.h"
+#include <cmath>
+
+namespace {
+
+// -5% to +14% in 1% steps
+std::vector<double> ladder() {
+    std::vector<double> returns;
+    for (int i = 0; i < 20; ++i) {
+        returns.push_back((i - 5) * 0.01);
+    }
+    return returns;
+}
+
+} // namespace
+
+TEST(RiskCalculatorTest, ValueAtRisk) {
+    using trading::RiskCalculator;
+    // The 5% tail of 20 returns is the second worst
+    EXPECT_NEAR(RiskCalculator::calculateHistoricalVaR(ladder(), 0.95), 0.04, 1e-12);
+    EXPECT_EQ(RiskCalculator::calculateHistoricalVaR({0.01, 0.02, 0.03}), 0.0);  // No loss to report
+    EXPECT_EQ(RiskCalculator::calculateHistoricalVaR({}), 0.0);
+
+    EXPECT_NEAR(RiskCalculator::calculateParametricVaR(0.0, 0.02, 0.95), 1.6448536 * 0.02, 1e-7);
+    EXPECT_NEAR(RiskCalculator::calculateParametricVaR(0.001, 0.02, 0.99), 2.3263479 * 0.02 - 0.001, 1e-7);
+
+    // Bootstrapped from the sample, with a fixed seed
+    double simulated = RiskCalculator::calculateMonteCarloVaR(ladder(), 10000);
+    EXPECT_GE(simulated, 0.03);
+    EXPECT_LE(simulated, 0.05);
+    EXPECT_EQ(simulated, RiskCalculator::calculateMonteCarloVaR(ladder(), 10000));
+    EXPECT_NEAR(RiskCalculator::calculateMonteCarloVaR({-0.02, -0.02}, 100), 0.02, 1e-12);
+    EXPECT_EQ(RiskCalculator::calculateMonteCarloVaR(ladder(), 0), 0.0);
+}
+
+TEST(RiskCalculatorTest, VolatilityCorrelationAndBeta) {
+    using trading::RiskCalculator;
+    std::vector<double> market = {0.01, 0.02, 0.03, 0.04, 0.05};
+    EXPECT_NEAR(RiskCalculator::calculateVolatility(market), std::sqrt(2.5e-4), 1e-12);
+    EXPECT_EQ(RiskCalculator::calculateVolatility({0.01}), 0.0);
+    EXPECT_NEAR(RiskCalculator::calculateExponentialVolatility({0.01, 0.02}, 0.94), std::sqrt(1.18e-4), 1e-12);
+
+    std::vector<double> levered;
+    std::vector<double> inverse;
+    for (double r : market) {
+        levered.push_back(1.5 * r + 0.001);
+        inverse.push_back(-r);
+    }
+    EXPECT_NEAR(RiskCalculator::calculateCorrelation(market, levered), 1.0, 1e-12);
+    EXPECT_NEAR(RiskCalculator::calculateCorrelation(market, inverse), -1.0, 1e-12);
+    EXPECT_EQ(RiskCalculator::calculateCorrelation(market, {0.01, 0.01, 0.01, 0.01, 0.01}), 0.0);
+
+    EXPECT_NEAR(RiskCalculator::calculateBeta(levered, market), 1.5, 1e-12);
+    EXPECT_NEAR(RiskCalculator::calculateBeta(inverse, market), -1.0, 1e-12);
+    EXPECT_EQ(RiskCalculator::calculateBeta({0.01}, {0.02}), 0.0);
+}
+
+TEST(RiskCalculatorTest, DrawdownAndSizing) {
+    using trading::RiskCalculator;
+    std::vector<double> equity = {100, 120, 90, 110, 60, 80};
+    EXPECT_NEAR(RiskCalculator::calculateMaxDrawdown(equity), 0.5, 1e-12);
+    EXPECT_NEAR(RiskCalculator::calculateCurrentDrawdown(equity), 40.0 / 120.0, 1e-12);
+    EXPECT_EQ(RiskCalculator::calculateCurrentDrawdown({}), 0.0);
+
+    EXPECT_NEAR(RiskCalculator::calculateKellyCriterion(0.6, 2.0, 1.0), 0.4, 1e-12);
+    EXPECT_EQ(RiskCalculator::calculateKellyCriterion(0.3, 1.0, 1.0), 0.0);  // No edge
+    EXPECT_NEAR(RiskCalculator::calculateOptimalPositionSize(100000, 0.01, 2.5), 400.0, 1e-9);
+    EXPECT_EQ(RiskCalculator::calculateOptimalPositionSize(100000, 0.01, 0.0), 0.0);
+}
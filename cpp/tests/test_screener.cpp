@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "frontier/rpc.hpp"
+#include "frontier/screener.hpp"
+#include <cmath>
+
+TEST(ScreenerTest, FiltersAcrossBlocksAndRanks) {
+    frontier::FeatureTable table;
+    // 150 symbols span three mask words; every tenth is volatile, every
+    // seventh trades within 2% of its 20-day high
+    for (int i = 0; i < 150; ++i) {
+        std::string symbol = "S" + std::to_string(i);
+        table.set(symbol, "last", 100.0);
+        table.set(symbol, "high_20d", i % 7 == 0 ? 101.0 : 120.0);
+        table.set(symbol, "vol_z", i % 10 == 0 ? 2.0 + i / 100.0 : 0.5);
+    }
+    table.set("NEW", "last", 50.0);   // No vol_z: never matches a vol_z predicate
+
+    frontier::ScreenQuery query;
+    query.where.push_back({"vol_z", frontier::ScreenOp::GT, 2.0, 0.0, ""});
+    query.where.push_back({"last", frontier::ScreenOp::GE, 0.98, 0.0, "high_20d"});
+    query.order_by = "vol_z";
+    query.limit = 2;
+    query.select = {"last"};
+    frontier::ScreenResult result = table.query(query);
+
+    // Multiples of 70 below 150, excluding 0 (vol_z exactly 2.0)
+    EXPECT_EQ(result.scanned, 151u);
+    EXPECT_EQ(result.matched, 2u);
+    ASSERT_EQ(result.rows.size(), 2u);
+    EXPECT_EQ(result.rows[0].symbol, "S140");
+    EXPECT_EQ(result.rows[1].symbol, "S70");
+    EXPECT_FLOAT_EQ(result.rows[0].values[0], 3.4f);
+    EXPECT_DOUBLE_EQ(result.rows[0].values[1], 100.0);
+
+    query.where = {{"vol_z", frontier::ScreenOp::BETWEEN, 2.5, 3.0, ""}};
+    query.descending = false;
+    query.limit = 10;
+    result = table.query(query);
+    ASSERT_EQ(result.rows.size(), 6u);
+    EXPECT_EQ(result.rows[0].symbol, "S50");
+    EXPECT_EQ(result.rows[5].symbol, "S100");
+
+    query.where = {{"no_such_feature", frontier::ScreenOp::GT, 0.0, 0.0, ""}};
+    EXPECT_THROW(table.query(query), std::invalid_argument);
+    EXPECT_TRUE(std::isnan(table.get("NEW", "vol_z")));
+}
+
+TEST(ScreenerTest, EngineTicksFeedTheScreenRpc) {
+    auto engine = std::make_shared<frontier::TradingEngine>();
+    frontier::RpcServer rpc(engine);
+    for (const auto& [symbol, last] : {std::pair<std::string, double>{"AAPL", 190.0}, {"MSFT", 400.0}, {"F", 12.0}}) {
+        frontier::MarketData data;
+        data.symbol = symbol;
+        data.bid = last - 0.01;
+        data.ask = last + 0.01;
+        data.last = last;
+        engine->update_market_data(data);
+    }
+
+    auto call = [&](const std::string& method, const nlohmann::json& params) {
+        nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", method}, {"params", params}, {"id", "1"}};
+        return nlohmann::json::parse(rpc.handle_request(request.dump()));
+    };
+    auto updated = call("set_features", {{"features", {{"AAPL", {{"prev_close", 180.0}}}, {"MSFT", {{"prev_close", 404.0}}}}}});
+    EXPECT_EQ(updated["result"]["features_updated"], 2);
+
+    // change_pct follows the next tick once prev_close is known
+    frontier::MarketData tick;
+    tick.symbol = "AAPL";
+    tick.last = 189.0;
+    engine->update_market_data(tick);
+
+    auto response = call("screen", {{"where", {{{"column", "last"}, {"op", ">"}, {"value", 100}}}},
+                                    {"order_by", "change_pct"},
+                                    {"select", {"last", "spread_bps"}}});
+    ASSERT_TRUE(response.contains("result")) << response.dump();
+    const auto& rows = response["result"]["rows"];
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0]["symbol"], "AAPL");
+    EXPECT_NEAR(rows[0]["change_pct"].get<double>(), 5.0, 1e-4);
+    EXPECT_NEAR(rows[0]["spread_bps"].get<double>(), 0.02 / 190.0 * 1e4, 1e-3);   // Kept from the last quote
+    EXPECT_EQ(rows[1]["symbol"], "MSFT");
+    EXPECT_NEAR(rows[1]["spread_bps"].get<double>(), 0.5, 1e-3);
+
+    auto bad = call("screen", {{"where", {{{"column", "nope"}, {"value", 1}}}}});
+    EXPECT_TRUE(bad.contains("error"));
+}
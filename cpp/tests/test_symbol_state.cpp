@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "engine/clock.h"
+#include "frontier/rpc.hpp"
+#include "frontier/symbol_state.hpp"
+
+using frontier::Side;
+using frontier::SymbolGate;
+
+namespace {
+
+constexpr int64_t kSecond = 1'000'000'000;
+
+} // namespace
+
+TEST(SymbolStateTest, BandsLimitStateAndLuldPause) {
+    frontier::PriceBandConfig config;
+    config.default_band_pct = 0.05;
+    frontier::SymbolStateTable table(config);
+    uint32_t id = table.id("XYZ");
+
+    table.on_tick(id, 100.0, 0);
+    EXPECT_EQ(table.check(id, Side::Buy, 104.0, 0), SymbolGate::Ok);
+    EXPECT_EQ(table.check(id, Side::Buy, 106.0, 0), SymbolGate::OutsideBand);
+    EXPECT_EQ(table.check(id, Side::Sell, 94.0, 0), SymbolGate::OutsideBand);
+    EXPECT_EQ(table.check(id, Side::Sell, 106.0, 0), SymbolGate::Ok);   // Selling above the band is fine
+
+    // Outside the band: limit state, then a pause once it outlasts the grace period
+    table.on_tick(id, 106.0, 1 * kSecond);
+    EXPECT_TRUE(table.state(id).flags & frontier::SymbolFlags::LimitState);
+    table.on_tick(id, 107.0, 16 * kSecond);
+    EXPECT_EQ(table.state(id).halt_reason, frontier::HaltReason::LimitUpLimitDown);
+    EXPECT_EQ(table.check(id, Side::Sell, 107.0, 17 * kSecond), SymbolGate::Halted);
+
+    // The pause expires on its own and trading reopens around the next price
+    EXPECT_EQ(table.check(id, Side::Sell, 107.0, 317 * kSecond), SymbolGate::Ok);
+    table.on_tick(id, 107.0, 317 * kSecond);
+    EXPECT_FALSE(table.state(id).flags & frontier::SymbolFlags::Halted);
+    EXPECT_DOUBLE_EQ(table.state(id).reference_price, 107.0);
+
+    // Back inside the band the reference follows the price every interval
+    table.on_tick(id, 108.0, 340 * kSecond);
+    EXPECT_DOUBLE_EQ(table.state(id).reference_price, 107.0);
+    table.on_tick(id, 109.0, 348 * kSecond);
+    EXPECT_DOUBLE_EQ(table.state(id).reference_price, 109.0);
+
+    table.halt("XYZ", frontier::HaltReason::Admin);
+    EXPECT_EQ(table.check("XYZ", Side::Buy, 0.0, 400 * kSecond), SymbolGate::Halted);
+    table.resume("XYZ");
+    table.set_flags("XYZ", frontier::SymbolFlags::BuyBlocked, 0);
+    EXPECT_EQ(table.check("XYZ", Side::Buy, 0.0, 400 * kSecond), SymbolGate::SideBlocked);
+    EXPECT_EQ(table.check("XYZ", Side::Sell, 0.0, 400 * kSecond), SymbolGate::Ok);
+    EXPECT_EQ(table.check("UNSEEN", Side::Buy, 1.0, 0), SymbolGate::Ok);
+}
+
+TEST(SymbolStateTest, EngineAndAdminRpcsGateOrders) {
+    auto engine = std::make_shared<frontier::TradingEngine>();
+    frontier::PriceBandConfig config;
+    config.default_band_pct = 0.05;
+    engine->symbol_states().set_config(config);
+
+    frontier::MarketData quote;
+    quote.symbol = "AAPL";
+    quote.bid = 99.9;
+    quote.ask = 100.1;
+    quote.last = 100.0;
+    engine->update_market_data(quote);
+    EXPECT_FALSE(engine->place_market_order("AAPL", Side::Buy, 10, 110.0));
+    EXPECT_TRUE(engine->place_market_order("AAPL", Side::Buy, 10, 100.0));
+
+    frontier::RpcServer rpc(engine);
+    auto call = [&](const std::string& method, const nlohmann::json& params) {
+        nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", method}, {"params", params}, {"id", "1"}};
+        return nlohmann::json::parse(rpc.handle_request(request.dump()));
+    };
+    auto halted = call("halt_symbol", {{"symbol", "AAPL"}});
+    EXPECT_EQ(halted["result"]["halted"], true);
+    EXPECT_EQ(halted["result"]["halt_reason"], "admin");
+    auto rejected = call("place_market_order", {{"symbol", "AAPL"}, {"side", "sell"}, {"qty", "5"}, {"price", "100"}});
+    EXPECT_EQ(rejected["error"]["code"], static_cast<int>(frontier::RpcErrorCode::OrderRejected));
+
+    call("resume_symbol", {{"symbol", "AAPL"}});
+    auto banded = call("set_price_band", {{"symbol", "AAPL"}, {"band_pct", 0.1}, {"reference", 100.0}});
+    EXPECT_EQ(banded["result"]["tradable"], true);
+    EXPECT_DOUBLE_EQ(banded["result"]["upper_band"].get<double>(), 110.0);
+    EXPECT_TRUE(engine->place_market_order("AAPL", Side::Sell, 5, 100.0));
+}
+
+TEST(SymbolStateTest, RiskCheckRpcRespectsHaltExpiry) {
+    auto clock = std::make_shared<trading::VirtualClock>(std::chrono::system_clock::time_point(std::chrono::hours(24 * 20000)));
+    auto engine = std::make_shared<frontier::TradingEngine>(clock);
+    EXPECT_DOUBLE_EQ(engine->daily_pnl(), 0.0);  // The day starts from the opening equity
+
+    frontier::RpcServer rpc(engine);
+    auto call = [&](const std::string& method, const nlohmann::json& params) {
+        nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", method}, {"params", params}, {"id", "1"}};
+        return nlohmann::json::parse(rpc.handle_request(request.dump()));
+    };
+    call("halt_symbol", {{"symbol", "AAPL"}, {"duration_s", 60}});
+    auto during = call("check_risk_limits", {{"symbol", "AAPL"}})["result"];
+    EXPECT_EQ(during["within_limits"], false);
+    EXPECT_EQ(during["violations"][0], "Symbol halted");
+
+    clock->runFor(std::chrono::seconds(61));
+    auto after = call("check_risk_limits", {{"symbol", "AAPL"}})["result"];
+    EXPECT_EQ(after["within_limits"], true);
+    EXPECT_TRUE(after["violations"].empty());
+}
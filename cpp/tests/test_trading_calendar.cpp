@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "frontier/rpc.hpp"
+#include "frontier/trading_calendar.hpp"
+#include <ctime>
+
+using frontier::AssetType;
+using frontier::MarketSession;
+
+namespace {
+
+std::chrono::system_clock::time_point utc(int year, int month, int day, int hour, int minute) {
+    std::tm tm{};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    return std::chrono::system_clock::from_time_t(timegm(&tm));
+}
+
+} // namespace
+
+TEST(TradingCalendarTest, UsEquitySessionsHolidaysAndHalfDays) {
+    auto calendar = frontier::TradingCalendar::standard(utc(2026, 6, 1, 0, 0));
+    auto session = [&](int y, int m, int d, int hh, int mm) {
+        return calendar->session(AssetType::STOCK, utc(y, m, d, hh, mm));
+    };
+
+    // Monday 2026-01-05, EST (UTC-5)
+    EXPECT_EQ(session(2026, 1, 5, 14, 0), MarketSession::PreMarket);
+    EXPECT_EQ(session(2026, 1, 5, 14, 30), MarketSession::Regular);
+    EXPECT_EQ(session(2026, 1, 5, 20, 59), MarketSession::Regular);
+    EXPECT_EQ(session(2026, 1, 5, 21, 30), MarketSession::PostMarket);
+    EXPECT_EQ(session(2026, 1, 5, 1, 30), MarketSession::Closed);
+    // Summer time (UTC-4) moves the open an hour earlier in UTC
+    EXPECT_EQ(session(2026, 7, 6, 13, 29), MarketSession::PreMarket);
+    EXPECT_EQ(session(2026, 7, 6, 13, 30), MarketSession::Regular);
+    // Weekend, MLK Day, Good Friday, Independence Day observed on Friday the 3rd
+    EXPECT_EQ(session(2026, 1, 10, 15, 0), MarketSession::Closed);
+    EXPECT_EQ(session(2026, 1, 19, 15, 0), MarketSession::Closed);
+    EXPECT_EQ(session(2026, 4, 3, 15, 0), MarketSession::Closed);
+    EXPECT_EQ(session(2026, 7, 3, 15, 0), MarketSession::Closed);
+    // The day after Thanksgiving closes at 13:00 ET
+    EXPECT_EQ(session(2026, 11, 27, 17, 59), MarketSession::Regular);
+    EXPECT_EQ(session(2026, 11, 27, 18, 0), MarketSession::PostMarket);
+
+    EXPECT_FALSE(calendar->is_open(AssetType::STOCK, utc(2026, 1, 5, 14, 0)));
+    EXPECT_TRUE(calendar->is_open(AssetType::STOCK, utc(2026, 1, 5, 14, 0), true));
+
+    const frontier::VenueCalendar* equities = calendar->venue(AssetType::STOCK);
+    EXPECT_TRUE(equities->is_trading_day(2026, 7, 2));
+    EXPECT_FALSE(equities->is_trading_day(2027, 12, 24));   // Christmas on a Saturday
+    EXPECT_TRUE(equities->is_trading_day(2021, 12, 31));    // New Year's Day 2022 was a Saturday
+
+    calendar->venue(AssetType::STOCK)->add_holiday(2026, 1, 5);
+    EXPECT_EQ(session(2026, 1, 5, 15, 0), MarketSession::Closed);
+    EXPECT_EQ(session(2026, 1, 6, 15, 0), MarketSession::Regular);
+}
+
+TEST(TradingCalendarTest, CryptoAndForexHours) {
+    auto calendar = frontier::TradingCalendar::standard(utc(2026, 6, 1, 0, 0));
+    EXPECT_TRUE(calendar->is_open(AssetType::CRYPTO, utc(2026, 1, 10, 3, 0)));
+    EXPECT_TRUE(calendar->is_open(AssetType::CRYPTO, utc(2026, 12, 25, 12, 0)));
+    // Forex: Sunday 17:00 ET to Friday 17:00 ET
+    EXPECT_FALSE(calendar->is_open(AssetType::FOREX, utc(2026, 1, 4, 21, 59)));
+    EXPECT_TRUE(calendar->is_open(AssetType::FOREX, utc(2026, 1, 4, 22, 0)));
+    EXPECT_TRUE(calendar->is_open(AssetType::FOREX, utc(2026, 1, 7, 3, 0)));
+    EXPECT_TRUE(calendar->is_open(AssetType::FOREX, utc(2026, 1, 9, 21, 59)));
+    EXPECT_FALSE(calendar->is_open(AssetType::FOREX, utc(2026, 1, 9, 22, 0)));
+    // No venue: unrestricted
+    EXPECT_TRUE(calendar->is_open(AssetType::FUTURES, utc(2026, 1, 10, 3, 0)));
+}
+
+TEST(TradingCalendarTest, PrecomputedMinutesMatchTheRules) {
+    // The second calendar's window is decades away, so every lookup evaluates the rules
+    frontier::VenueCalendar cached(frontier::VenueHours::us_equities(), 20454, 366);   // 2026
+    frontier::VenueCalendar rules(frontier::VenueHours::us_equities(), 0, 1);
+    for (auto t = utc(2026, 1, 1, 0, 0); t < utc(2027, 1, 1, 0, 0); t += std::chrono::minutes(7)) {
+        ASSERT_EQ(cached.session(t), rules.session(t));
+    }
+}
+
+TEST(TradingCalendarTest, EngineRejectsOrdersWhenMarketClosed) {
+    auto engine = std::make_shared<frontier::TradingEngine>();
+    auto calendar = std::make_shared<frontier::TradingCalendar>();
+    // A venue with no trading days: stocks are always closed
+    calendar->set_venue(AssetType::STOCK, std::make_shared<frontier::VenueCalendar>(frontier::VenueHours{}, 0, 1));
+    engine->attach_trading_calendar(calendar);
+
+    EXPECT_FALSE(engine->place_market_order("AAPL", frontier::Side::Buy, 10, 100.0));
+    EXPECT_TRUE(engine->place_market_order("BTC/USD", frontier::Side::Buy, 0.5, 100.0));
+
+    frontier::RpcServer rpc(engine);
+    auto call = [&](const std::string& method, const nlohmann::json& params) {
+        nlohmann::json request = {{"jsonrpc", "2.0"}, {"method", method}, {"params", params}, {"id", "1"}};
+        return nlohmann::json::parse(rpc.handle_request(request.dump()));
+    };
+    auto rejected = call("place_market_order", {{"symbol", "AAPL"}, {"side", "buy"}, {"qty", "10"}, {"price", "100"}});
+    EXPECT_EQ(rejected["error"]["code"], static_cast<int>(frontier::RpcErrorCode::MarketClosed));
+
+    auto status = call("get_market_status", {{"symbols", {"AAPL", "BTC/USD"}}});
+    EXPECT_EQ(status["result"]["markets"]["AAPL"]["session"], "closed");
+    EXPECT_EQ(status["result"]["markets"]["BTC/USD"]["open"], true);
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include "engine/tsc_clock.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int64_t systemNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+TEST(TscClockTest, TracksSystemClockAcrossRecalibration) {
+    trading::TscClock::setRecalibrationInterval(std::chrono::milliseconds(5));
+    for (int i = 0; i < 20; ++i) {
+        int64_t before = systemNs();
+        int64_t stamp = trading::TscClock::nowNs();
+        int64_t after = systemNs();
+        // Within the slew allowance of the calibration
+        EXPECT_GT(stamp, before - 1'000'000);
+        EXPECT_LT(stamp, after + 1'000'000);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    trading::TscClock::setRecalibrationInterval(std::chrono::seconds(1));
+}
+
+TEST(TscClockTest, StampsNeverGoBackwardsAcrossThreads) {
+    trading::TscClock::setRecalibrationInterval(std::chrono::milliseconds(1));
+
+    // Each stamp is published through a shared high-water mark; a later reader
+    // must never stamp below a value it has seen
+    std::atomic<int64_t> published{0};
+    std::atomic<bool> backwards{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            int64_t last = 0;
+            for (int i = 0; i < 200000; ++i) {
+                int64_t seen = published.load(std::memory_order_acquire);
+                int64_t stamp = trading::TscClock::nowNs();
+                if (stamp < last || stamp < seen) {
+                    backwards = true;
+                }
+                last = stamp;
+                int64_t expected = seen;
+                while (stamp > expected && !published.compare_exchange_weak(expected, stamp)) {}
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    trading::TscClock::setRecalibrationInterval(std::chrono::seconds(1));
+    EXPECT_FALSE(backwards);
+}
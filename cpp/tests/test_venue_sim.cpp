@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include "frontier/alpaca_adapter.hpp"
+#include "frontier/venue_sim.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+class Collector {
+public:
+    void add(const std::function<void()>& update) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        update();
+        changed_.notify_all();
+    }
+
+    bool wait_for(const std::function<bool()>& done, std::chrono::milliseconds timeout = 5s) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!done()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            changed_.wait_for(lock, 5ms);
+        }
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable changed_;
+};
+
+frontier::VenueTick quote(double bid, double ask, double size) {
+    return frontier::VenueTick{"AAPL", bid, ask, size, size, (bid + ask) / 2.0};
+}
+
+// One POST on its own connection; returns the response status line
+std::string post(uint16_t port, const std::string& path, const std::string& body) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(fd);
+        return "";
+    }
+    std::string request = "POST " + path + " HTTP/1.1\r\nHost: localhost\r\nContent-Type: application/json\r\n"
+                          "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+    if (write(fd, request.data(), request.size()) != static_cast<ssize_t>(request.size())) {
+        close(fd);
+        return "";
+    }
+    std::string response;
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (response.find("\r\n") == std::string::npos && std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 10) > 0) {
+            char buffer[1024];
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0) {
+                break;
+            }
+            response.append(buffer, static_cast<size_t>(n));
+        }
+    }
+    close(fd);
+    return response.substr(0, response.find("\r\n"));
+}
+
+} // namespace
+
+TEST(VenueSimTest, ParsesLatencyDistributions) {
+    using frontier::LatencyDistribution;
+    std::mt19937_64 rng(7);
+
+    EXPECT_EQ(LatencyDistribution::parse("fixed:50").sample(rng), 50us);
+    EXPECT_EQ(LatencyDistribution::parse("75").sample(rng), 75us);
+    auto uniform = LatencyDistribution::parse("uniform:20,80");
+    for (int i = 0; i < 100; ++i) {
+        auto sample = uniform.sample(rng);
+        EXPECT_GE(sample, 20us);
+        EXPECT_LE(sample, 80us);
+    }
+    EXPECT_EQ(LatencyDistribution::parse("lognormal:50,0.5").kind, LatencyDistribution::Kind::LogNormal);
+    EXPECT_THROW(LatencyDistribution::parse("gamma:1,2"), std::invalid_argument);
+    EXPECT_THROW(LatencyDistribution::parse("normal:50"), std::invalid_argument);
+    EXPECT_THROW(LatencyDistribution::parse("normal:50,0"), std::invalid_argument);
+    EXPECT_THROW(LatencyDistribution::parse("normal:50,-10"), std::invalid_argument);
+    EXPECT_THROW(LatencyDistribution::parse("lognormal:50,0"), std::invalid_argument);
+    EXPECT_THROW(LatencyDistribution::parse("lognormal:50,nan"), std::invalid_argument);
+}
+
+TEST(VenueSimTest, MatchesAgainstTicksBehindBrokerProtocol) {
+    frontier::VenueSimulator::Config venue_config;
+    venue_config.ack_latency = frontier::LatencyDistribution::parse("fixed:2000");
+    frontier::VenueSimulator venue(venue_config);
+    venue.start();
+    venue.on_tick(quote(100.00, 100.10, 100));
+
+    frontier::AlpacaConfig config;
+    config.port = venue.port();
+    config.pool_size = 1;
+    frontier::AlpacaBrokerAdapter adapter(config);
+
+    Collector collector;
+    std::vector<frontier::BrokerOrderAck> acks;
+    std::vector<frontier::BrokerExecutionReport> reports;
+    adapter.set_execution_handler([&](const frontier::BrokerExecutionReport& report) {
+        collector.add([&] { reports.push_back(report); });
+    });
+    ASSERT_TRUE(adapter.start());
+    ASSERT_TRUE(collector.wait_for([&] { return adapter.stream_ready(); }));
+
+    auto submit = [&](const std::string& id, frontier::OrderType type, double quantity, double limit) {
+        frontier::BrokerOrderRequest request;
+        request.client_order_id = id;
+        request.symbol = "AAPL";
+        request.type = type;
+        request.quantity = quantity;
+        request.limit_price = limit;
+        adapter.submit_order(request, [&](const frontier::BrokerOrderAck& ack) {
+            collector.add([&] { acks.push_back(ack); });
+        });
+    };
+    // Market order larger than the displayed ask; limit below the touch
+    submit("m1", frontier::OrderType::Market, 150, 0);
+    submit("l1", frontier::OrderType::Limit, 50, 99.50);
+    ASSERT_TRUE(collector.wait_for([&] { return acks.size() == 2; }));
+    for (const auto& ack : acks) {
+        EXPECT_TRUE(ack.accepted) << ack.error;
+        EXPECT_GE(ack.latency_ns, 2'000'000);
+    }
+    EXPECT_EQ(venue.resting_orders(), 2u);
+
+    // The offer drops through the limit: the market remainder takes the
+    // touch and the resting limit fills at its own price
+    venue.on_tick(quote(99.40, 99.45, 1000));
+    auto fills_for = [&](const std::string& id) {
+        std::vector<frontier::BrokerExecutionReport> fills;
+        std::copy_if(reports.begin(), reports.end(), std::back_inserter(fills), [&](const auto& r) {
+            return r.client_order_id == id && r.fill_quantity > 0;
+        });
+        return fills;
+    };
+    ASSERT_TRUE(collector.wait_for([&] { return fills_for("m1").size() == 2 && fills_for("l1").size() == 1; }));
+
+    auto market = fills_for("m1");
+    EXPECT_EQ(market[0].event, "partial_fill");
+    EXPECT_DOUBLE_EQ(market[0].fill_price, 100.10);
+    EXPECT_DOUBLE_EQ(market[0].fill_quantity, 100);
+    EXPECT_EQ(market[1].event, "fill");
+    EXPECT_DOUBLE_EQ(market[1].fill_price, 99.45);
+    EXPECT_DOUBLE_EQ(market[1].filled_quantity, 150);
+
+    auto limit = fills_for("l1");
+    EXPECT_EQ(limit[0].event, "fill");
+    EXPECT_DOUBLE_EQ(limit[0].fill_price, 99.50);
+    EXPECT_EQ(venue.resting_orders(), 0u);
+
+    // Each order's "new" precedes its fills on the stream
+    auto first_new = std::find_if(reports.begin(), reports.end(), [](const auto& r) { return r.event == "new"; });
+    ASSERT_NE(first_new, reports.end());
+    EXPECT_EQ(first_new->client_order_id, "m1");
+    EXPECT_EQ(reports.front().event, "new");
+
+    adapter.stop();
+    venue.stop();
+}
+
+TEST(VenueSimTest, MalformedOrdersGet422) {
+    frontier::VenueSimulator venue(frontier::VenueSimulator::Config{});
+    venue.start();
+    for (const char* body : {R"({"symbol":7,"side":"buy","qty":1})",
+                             R"({"side":"buy","qty":1})",
+                             R"({"symbol":"AAPL","side":"buy","qty":1,"type":3})",
+                             R"({"symbol":"AAPL","side":"buy","qty":1,"client_order_id":[1]})",
+                             R"({"symbol":"AAPL","side":{"x":1},"qty":1})",
+                             R"({"symbol":"AAPL","side":"buy","qty":"inf"})",
+                             R"([1,2])", "not json"}) {
+        EXPECT_EQ(post(venue.port(), "/v2/orders", body), "HTTP/1.1 422 Unprocessable Entity") << body;
+    }
+    // Still serving
+    EXPECT_EQ(post(venue.port(), "/v2/orders", R"({"symbol":"AAPL","side":"buy","qty":1})"), "HTTP/1.1 200 OK");
+    venue.stop();
+}